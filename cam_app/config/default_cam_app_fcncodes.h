@@ -45,5 +45,12 @@
 #define CAM_APP_SECURITY_START_CC  7
 #define CAM_APP_SECURITY_STOP_CC   8
 #define CAM_APP_SECURITY_KEY_CC    9
+#define CAM_APP_SET_STORAGE_MODE_CC 10
+#define CAM_APP_SHOT_BURST_CC       11
+#define CAM_APP_SET_VERIFY_CC       12
+#define CAM_APP_EXTRACT_FRAME_CC    13
+#define CAM_APP_SET_DURABILITY_CC   14
+#define CAM_APP_SET_DOWNLINK_CC     15
+#define CAM_APP_SEND_LATENCY_CC     16
 
 #endif
@@ -41,4 +41,29 @@
  */
 #define CAM_APP_STRING_VAL_LEN 10
 
+/**
+ * \brief Number of capture profiles in the capture table
+ *
+ * The table holds this many profiles, one of which is active at a time.
+ */
+#define CAM_APP_CAPTURE_PROFILE_COUNT 4
+
+/**
+ * \brief Length of the capture profile name, including the terminator
+ */
+#define CAM_APP_CAPTURE_PROFILE_NAME_LEN 16
+
+/**
+ * \brief Length of the photo directory path in the capture table, including the terminator
+ */
+#define CAM_APP_PHOTO_DIR_LEN 64
+
+/**
+ * \brief Bytes of frame data in a full image telemetry packet
+ *
+ * Sized so that a full packet, with a 16 byte telemetry header and the
+ * chunk's own fields, is CFE_MISSION_SB_MAX_SB_MSG_SIZE bytes.
+ */
+#define CAM_APP_IMAGE_CHUNK_SIZE (CFE_MISSION_SB_MAX_SB_MSG_SIZE - 32)
+
 #endif
@@ -35,10 +35,184 @@
 /***********************************************************************/
 #define CAM_APP_PIPE_DEPTH 32 /* Depth of the Command Pipe for Application */
 
-#define CAM_APP_NUMBER_OF_TABLES 1 /* Number of Example Table(s) */
+#define CAM_APP_NUMBER_OF_TABLES 1 /* Number of Capture Table(s) */
 
 #define CAM_APP_TABLE_OUT_OF_RANGE_ERR_CODE -1
 
-#define CAM_APP_TBL_ELEMENT_1_MAX 10
+/*
+** Capture configuration
+**
+** The camera is opened once when shooting starts and streams frames until
+** shooting stops.  Resolution, rate, format and quality come from the active
+** profile in the capture table.  CAM_APP_CAPTURE_BACKEND names the backend:
+**
+**   "v4l2"   - V4L2 mmap streaming from CAM_APP_CAPTURE_V4L2_DEVICE
+**   "stream" - MJPEG piped from CAM_APP_CAPTURE_STREAM_CMD
+**   "shell"  - one CAM_APP_CAPTURE_SHELL_CMD launch per frame
+**
+** If the selected backend cannot be opened the app falls back to "shell".
+** Only "v4l2" can deliver CAM_APP_CAPTURE_FORMAT_YUYV.  To test on a plain
+** Linux host, load the "vivid" module, point the V4L2 device at its capture
+** node and select a YUYV profile.
+**
+** Frame buffers are sized from the active profile when the table is loaded;
+** a profile whose frames could exceed CAM_APP_CAPTURE_MAX_FRAME_SIZE is
+** rejected by table validation.
+*/
+#define CAM_APP_CAPTURE_BACKEND        "stream"
+#define CAM_APP_CAPTURE_MAX_FRAME_SIZE (8 * 1024 * 1024) /* Largest frame buffer a profile may need, in bytes */
+#define CAM_APP_CAPTURE_MAX_DIMENSION  4096 /* Largest width or height a profile may ask for */
+#define CAM_APP_CAPTURE_TIMEOUT_MSEC   2000 /* Longest wait for a frame before the camera is considered stalled */
+
+#define CAM_APP_CAPTURE_V4L2_DEVICE  "/dev/video0"
+#define CAM_APP_CAPTURE_V4L2_BUFFERS 4 /* Number of kernel mmap buffers */
+
+/* Arguments: width, height, frame rate, quality */
+#define CAM_APP_CAPTURE_STREAM_CMD \
+    "exec libcamera-vid -t 0 -n --codec mjpeg --width %d --height %d --framerate %d -q %d -o -"
+
+/* Arguments: output file, warm-up ms, width, height, quality */
+#define CAM_APP_CAPTURE_SHELL_CMD  "libcamera-still -n -o %s -t %d --width %d --height %d -q %d"
+#define CAM_APP_CAPTURE_SHELL_FILE "/tmp/cam_app_shot.jpeg"
+
+/*
+** Capture pipeline configuration
+**
+** Capture, crypto and storage run on separate threads connected by bounded
+** queues of the depths below.  When a queue is full the upstream stage either
+** waits for room (BLOCK) or drops the frame and counts it (DROP).
+*/
+#define CAM_APP_PIPELINE_QUEUE_POLICY_BLOCK 0
+#define CAM_APP_PIPELINE_QUEUE_POLICY_DROP  1
+
+#define CAM_APP_PIPELINE_CRYPTO_QUEUE_DEPTH  2
+#define CAM_APP_PIPELINE_STORAGE_QUEUE_DEPTH 2
+#define CAM_APP_PIPELINE_QUEUE_POLICY        CAM_APP_PIPELINE_QUEUE_POLICY_DROP
+
+/*
+** Frame encryption
+**
+** Frames are encrypted in CTR mode.  A frame larger than one segment is split
+** and its segments shared between the crypto stage and a pool of helper
+** threads, so with three helpers a quad-core board encrypts on every core.
+*/
+#define CAM_APP_CRYPTO_POOL_WORKERS 3
+#define CAM_APP_CRYPTO_SEGMENT_SIZE (32 * 1024) /* Bytes per unit of work, a multiple of 16 */
+
+/*
+** Encrypted file format
+**
+** Encrypted frames are stored as the binary container described in
+** cam_app_container.h.  For ground tools that still read hex text, HEX
+** writes the same container as lowercase hex digits at twice the size.
+** Verification reads files back in the same format.
+*/
+#define CAM_APP_ENCRYPTED_FORMAT_BINARY 0
+#define CAM_APP_ENCRYPTED_FORMAT_HEX    1
+
+#define CAM_APP_ENCRYPTED_FORMAT CAM_APP_ENCRYPTED_FORMAT_BINARY
+
+/*
+** Storage writer
+**
+** The storage stage hands finished files to a background writer and moves on
+** to the next frame; a frame's slot is recycled once its files are written.
+** With io_uring each file is created, preallocated, written and closed by one
+** linked chain of requests.  Without it, or when CAM_APP_WRITER_USE_IO_URING
+** is false, CAM_APP_WRITER_THREADS threads write files with ordinary system
+** calls.  At most CAM_APP_WRITER_MAX_PENDING files are in flight; the
+** storage stage waits for one to finish beyond that.
+**
+** Written files are then committed under the durability policy, which
+** starts out as set below and can be changed by CAM_APP_SET_DURABILITY_CC
+** for the next shot start.  A group counts files, records in SEGMENT mode,
+** and can hold no more than the frames the pipeline has in flight, so a
+** group larger than that closes on time rather than count.
+*/
+#define CAM_APP_WRITER_USE_IO_URING true
+#define CAM_APP_WRITER_THREADS      2
+#define CAM_APP_WRITER_MAX_PENDING  16
+#define CAM_APP_WRITER_DURABILITY   CAM_APP_DURABILITY_GROUP
+#define CAM_APP_WRITER_GROUP_FILES  8   /* Most files committed together */
+#define CAM_APP_WRITER_GROUP_MS     500 /* Longest a group waits for more files after its first */
+
+/*
+** Segment log
+**
+** In CAM_APP_STORAGE_MODE_SEGMENT frames are appended as records to
+** <PhotoDir>/Segments/segment_NNNNNN.log instead of getting a file each.
+** Every segment is preallocated to this size when it is opened and trimmed
+** to what was used when it is closed; a new one starts when the next record
+** would not fit.  CAM_APP_EXTRACT_FRAME_CC copies a frame back out.
+*/
+#define CAM_APP_SEGMENT_SIZE (64 * 1024 * 1024)
+
+/*
+** Storage retention
+**
+** The files stored under PhotoDir are kept within a budget.  Once they take
+** up more than the high watermark, files are deleted until they are back
+** under the low watermark.  EVICT_OLDEST deletes the oldest file of any tier
+** first; EVICT_PRIORITY deletes plaintext frames before encrypted files, and
+** those before segments, oldest first within each.  The segment being
+** appended to is never deleted.  A high watermark of 0 turns eviction off.
+** The watermarks should leave room for many frames, as a file larger than
+** the gap between them can evict itself.
+*/
+#define CAM_APP_RETENTION_EVICT_OLDEST   0
+#define CAM_APP_RETENTION_EVICT_PRIORITY 1
+
+#define CAM_APP_RETENTION_HIGH_WATERMARK (1024ULL * 1024 * 1024) /* Bytes */
+#define CAM_APP_RETENTION_LOW_WATERMARK  (896ULL * 1024 * 1024)  /* Bytes */
+#define CAM_APP_RETENTION_EVICT_POLICY   CAM_APP_RETENTION_EVICT_OLDEST
+
+/*
+** Image telemetry
+**
+** When enabled, each encrypted frame is queued for downlink once it is
+** stored, burst frames ahead of periodic ones, and published on
+** CAM_APP_IMAGE_TLM_MID in packets of up to CAM_APP_IMAGE_CHUNK_SIZE bytes
+** of its container.  Packets go out on CAM_APP_WAKEUP_MID wakeups from the
+** scheduler, within a budget of CAM_APP_DOWNLINK_RATE bytes per second that
+** may build up to CAM_APP_DOWNLINK_BURST bytes between wakeups; both can be
+** changed by CAM_APP_SET_DOWNLINK_CC.  The burst must hold at least one full
+** packet.  Each priority queues at most CAM_APP_DOWNLINK_QUEUE_DEPTH frames;
+** further frames are not sent.  Frames stored unencrypted are not sent.
+*/
+#define CAM_APP_DOWNLINK_ENABLE      true
+#define CAM_APP_DOWNLINK_RATE        (64 * 1024)  /* Bytes per second, packet headers included */
+#define CAM_APP_DOWNLINK_BURST       (128 * 1024) /* Bytes */
+#define CAM_APP_DOWNLINK_QUEUE_DEPTH 64
+
+/*
+** Encrypted file verification
+**
+** Every Nth stored file, as set by the capture profile or
+** CAM_APP_SET_VERIFY_CC, is read back and decrypted on an idle-priority
+** thread and checked against a CRC-32 of the frame taken before it was
+** written.  At most this many checks wait at once; storage skips further
+** checks rather than waiting for the verifier to catch up.
+*/
+#define CAM_APP_PIPELINE_VERIFY_QUEUE_DEPTH 4
+
+/*
+** Shot scheduling
+**
+** Shots fire on absolute deadlines one period apart.  The period comes from
+** the active capture profile and can be changed in milliseconds by
+** CAM_APP_SHOT_PERIOD_CC; both reject values below the minimum.
+*/
+#define CAM_APP_MIN_SHOT_PERIOD_MS 10
+
+/*
+** Burst capture
+**
+** CAM_APP_SHOT_BURST_CC grabs up to CAM_APP_BURST_MAX_FRAMES frames back to
+** back into an arena allocated once at init, then feeds them through
+** encryption and storage.  A burst ends early if the arena fills up.
+*/
+#define CAM_APP_BURST_MAX_FRAMES      32
+#define CAM_APP_BURST_MAX_INTERVAL_MS 1000 /* Longest gap between burst frames */
+#define CAM_APP_BURST_ARENA_SIZE      (4 * 1024 * 1024) /* Bytes shared by all frames of one burst */
 
 #endif
@@ -39,7 +39,7 @@ typedef struct CAM_APP_DisplayParam_Payload
 
 typedef struct CAM_APP_ShotPeriod_Payload
 {
-    uint16 Period;
+    uint32 PeriodMs; /**< Milliseconds between shot deadlines */
 } CAM_APP_ShotPeriod_Payload_t;
 
 typedef struct CAM_APP_SeucirtyKey_Payload
@@ -47,6 +47,70 @@ typedef struct CAM_APP_SeucirtyKey_Payload
     char Key[32];
 } CAM_APP_SecurityKey_Payload_t;
 
+/*
+** Frame storage modes
+**
+** FILE writes the plaintext JPEG alongside the encrypted file.
+** MEMORY only writes the ciphertext, unless the frame was not encrypted.
+** SEGMENT stores the same as MEMORY, but as records appended to a segment
+** log rather than one file per frame.
+*/
+#define CAM_APP_STORAGE_MODE_FILE    0
+#define CAM_APP_STORAGE_MODE_MEMORY  1
+#define CAM_APP_STORAGE_MODE_SEGMENT 2
+
+typedef struct CAM_APP_SetStorageMode_Payload
+{
+    uint8 Mode; /**< CAM_APP_STORAGE_MODE_FILE, _MEMORY or _SEGMENT */
+    uint8 Spare[3];
+} CAM_APP_SetStorageMode_Payload_t;
+
+typedef struct CAM_APP_ShotBurst_Payload
+{
+    uint16 FrameCount; /**< Frames to capture, 1 to CAM_APP_BURST_MAX_FRAMES */
+    uint16 Spare;
+    uint32 IntervalMs; /**< Milliseconds between frames, 0 for the camera's native rate */
+} CAM_APP_ShotBurst_Payload_t;
+
+typedef struct CAM_APP_SetVerify_Payload
+{
+    uint16 Interval; /**< Check every Nth encrypted file, 1 for all, 0 for none */
+    uint16 Spare;
+} CAM_APP_SetVerify_Payload_t;
+
+typedef struct CAM_APP_ExtractFrame_Payload
+{
+    uint32 Segment;  /**< Segment number to look in, 0 for the newest one holding the frame */
+    uint32 Sequence; /**< Capture sequence number of the frame */
+} CAM_APP_ExtractFrame_Payload_t;
+
+/*
+** Storage durability policies
+**
+** NONE leaves flushing stored files to the kernel.
+** FILE syncs each new file under a temporary name, renames it into place
+** and syncs its directory before reporting it stored.
+** GROUP does the same for up to GroupFiles files, or those written within
+** GroupMs of the first, with one filesystem sync and one sync per directory.
+*/
+#define CAM_APP_DURABILITY_NONE  0
+#define CAM_APP_DURABILITY_FILE  1
+#define CAM_APP_DURABILITY_GROUP 2
+
+typedef struct CAM_APP_SetDurability_Payload
+{
+    uint8  Policy;     /**< CAM_APP_DURABILITY_NONE, _FILE or _GROUP */
+    uint8  Spare;
+    uint16 GroupFiles; /**< Most files per group, 1 to CAM_APP_WRITER_MAX_PENDING; GROUP only */
+    uint32 GroupMs;    /**< Longest a group stays open after its first file, milliseconds; GROUP only */
+} CAM_APP_SetDurability_Payload_t;
+
+typedef struct CAM_APP_SetDownlink_Payload
+{
+    uint32 RateBytesPerSec; /**< Image telemetry budget, packet headers included; 0 holds frames */
+    uint32 BurstBytes;      /**< Most the budget may build up to, at least one full image packet */
+} CAM_APP_SetDownlink_Payload_t;
+
 /*************************************************************************/
 /*
 ** Type definition (Cam App housekeeping)
@@ -57,6 +121,90 @@ typedef struct CAM_APP_HkTlm_Payload
     uint8 CommandErrorCounter;
     uint8 CommandCounter;
     uint16 spare[2];
+    /* The compiler pads 2 bytes here, so MissedDeadlines and all after it sit on 4-byte boundaries */
+    uint32 MissedDeadlines;   /**< Shot deadlines skipped because the previous shot overran */
+    uint32 FramesVerified;    /**< Encrypted files read back and found to match the captured frame */
+    uint32 VerifyMismatches;  /**< Encrypted files that were unreadable, failed the MAC or did not match */
+    uint32 VerifySkipped;     /**< Checks skipped because the verifier was still busy */
+    uint32 WriteQueueDepth;   /**< Files handed to the storage writer and not yet written */
+    uint32 WriteQueuePeak;    /**< Most files the storage writer has held at once */
+    uint32 WriteLatencyAvgUs; /**< Mean time from handing a file to the writer to it being written, microseconds */
+    uint32 WriteLatencyMaxUs; /**< Longest such time, microseconds */
+    uint32 WriteErrors;       /**< Files the storage writer failed to write */
+    uint32 FreeSpaceKb;       /**< Space left on the card holding the photo directory, KiB */
+    uint32 RetainedKb;        /**< Size of the stored files the retention manager is keeping, KiB */
+    uint32 FilesEvicted;      /**< Stored files deleted to stay under the retention watermarks */
+    uint32 EvictedKb;         /**< Size of those files, KiB */
+    uint8  DurabilityPolicy;  /**< CAM_APP_DURABILITY_NONE, _FILE or _GROUP, as of the last shot start */
+    uint8  spare2[3];
+    uint32 SyncFileAvgUs;     /**< Mean time to commit one file under the FILE policy, microseconds */
+    uint32 SyncFileMaxUs;     /**< Longest such time, microseconds */
+    uint32 SyncGroupAvgUs;    /**< Mean time to commit one group under the GROUP policy, microseconds */
+    uint32 SyncGroupMaxUs;    /**< Longest such time, microseconds */
+    uint32 SyncGroupFiles;    /**< Mean files per committed group */
+    uint32 ImageChunksSent;   /**< Image telemetry packets published */
+    uint32 ImageChunkErrors;  /**< Image telemetry packets that could not be allocated or sent */
+    uint32 DownlinkBacklog;   /**< Container bytes waiting for downlink */
+    uint32 DownlinkThrottles; /**< Wakeups that left packets waiting for budget */
+    uint32 DownlinkDropped;   /**< Frames not sent, as the queue was full or the file could not be read */
+    uint32 FramesCaptured;    /**< Frames taken from the camera */
+    uint32 FramesEncrypted;   /**< Frames encrypted */
+    uint32 FramesStored;      /**< Frames whose files were all written */
+    uint32 FramesDropped;     /**< Frames dropped because the next stage's queue was full */
+    uint32 CaptureLastUs;     /**< Time to take the last frame from the camera into its slot, microseconds */
+    uint32 CaptureAvgUs;      /**< Mean such time, microseconds */
+    uint32 EncryptLastUs;     /**< Time to encrypt the last frame, microseconds */
+    uint32 EncryptAvgUs;      /**< Mean such time, microseconds */
+    uint32 EncryptKbPerSec;   /**< Bytes encrypted over the time spent encrypting them, KiB per second */
+    uint32 CryptoQueueDepth;  /**< Frames waiting to be encrypted */
+    uint32 StorageQueueDepth; /**< Frames waiting to be stored */
+    uint32 WrittenKb;         /**< Data the storage writer has written, KiB */
+    uint32 FramesFailed;      /**< Frames with a file that could not be written, or no segment to go in */
 } CAM_APP_HkTlm_Payload_t;
 
+/*************************************************************************/
+/*
+** Type definition (Cam App image telemetry)
+**
+** Each encrypted frame is published as a run of packets, in order.  A packet
+** carries DataLength bytes of the frame's container starting at Offset; the
+** frame is complete once Offset plus DataLength reaches TotalLength.  Only
+** the bytes in use are sent, so the last packet of a frame is shorter.
+*/
+
+typedef struct CAM_APP_ImageTlm_Payload
+{
+    uint32 Sequence;    /**< Capture sequence number of the frame */
+    uint32 Offset;      /**< Where this chunk starts in the container, bytes */
+    uint32 TotalLength; /**< Container length, bytes */
+    uint32 DataLength;  /**< Bytes of Data in use */
+    uint8  Data[CAM_APP_IMAGE_CHUNK_SIZE];
+} CAM_APP_ImageTlm_Payload_t;
+
+/*************************************************************************/
+/*
+** Type definition (Cam App latency telemetry)
+**
+** Percentiles come from log-bucket histograms and are within 12.5% above
+** the true value; the maximum is exact.
+*/
+
+typedef struct CAM_APP_LatencyStats
+{
+    uint32 Count; /**< Latencies recorded */
+    uint32 P50Us; /**< Median, microseconds */
+    uint32 P90Us; /**< 90th percentile, microseconds */
+    uint32 P99Us; /**< 99th percentile, microseconds */
+    uint32 MaxUs; /**< Largest, microseconds */
+} CAM_APP_LatencyStats_t;
+
+typedef struct CAM_APP_LatencyTlm_Payload
+{
+    CAM_APP_LatencyStats_t Frame;   /**< Capture to all of a frame's files stored */
+    CAM_APP_LatencyStats_t Capture; /**< Camera to frame slot */
+    CAM_APP_LatencyStats_t Encrypt; /**< Sealing a frame */
+    CAM_APP_LatencyStats_t Write;   /**< A file from submission to the writer to written */
+    CAM_APP_LatencyStats_t Commit;  /**< A durability sync of a file or group */
+} CAM_APP_LatencyTlm_Payload_t;
+
 #endif
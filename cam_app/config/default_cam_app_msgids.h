@@ -26,8 +26,11 @@
 #include "cfe_core_api_base_msgids.h"
 #include "cam_app_topicids.h"
 
-#define CAM_APP_CMD_MID     CFE_PLATFORM_CMD_TOPICID_TO_MIDV(CFE_MISSION_CAM_APP_CMD_TOPICID)
-#define CAM_APP_SEND_HK_MID CFE_PLATFORM_CMD_TOPICID_TO_MIDV(CFE_MISSION_CAM_APP_SEND_HK_TOPICID)
-#define CAM_APP_HK_TLM_MID  CFE_PLATFORM_TLM_TOPICID_TO_MIDV(CFE_MISSION_CAM_APP_HK_TLM_TOPICID)
+#define CAM_APP_CMD_MID         CFE_PLATFORM_CMD_TOPICID_TO_MIDV(CFE_MISSION_CAM_APP_CMD_TOPICID)
+#define CAM_APP_SEND_HK_MID     CFE_PLATFORM_CMD_TOPICID_TO_MIDV(CFE_MISSION_CAM_APP_SEND_HK_TOPICID)
+#define CAM_APP_WAKEUP_MID      CFE_PLATFORM_CMD_TOPICID_TO_MIDV(CFE_MISSION_CAM_APP_WAKEUP_TOPICID)
+#define CAM_APP_HK_TLM_MID      CFE_PLATFORM_TLM_TOPICID_TO_MIDV(CFE_MISSION_CAM_APP_HK_TLM_TOPICID)
+#define CAM_APP_IMAGE_TLM_MID   CFE_PLATFORM_TLM_TOPICID_TO_MIDV(CFE_MISSION_CAM_APP_IMAGE_TLM_TOPICID)
+#define CAM_APP_LATENCY_TLM_MID CFE_PLATFORM_TLM_TOPICID_TO_MIDV(CFE_MISSION_CAM_APP_LATENCY_TLM_TOPICID)
 
 #endif
@@ -82,6 +82,11 @@ typedef struct
     CFE_MSG_CommandHeader_t CommandHeader; /**< \brief Command header */
 } CAM_APP_ShotStopCmd_t;
 
+typedef struct
+{
+    CFE_MSG_CommandHeader_t CommandHeader; /**< \brief Command header */
+} CAM_APP_SendLatencyCmd_t;
+
 typedef struct
 {
     CFE_MSG_CommandHeader_t CommandHeader; /**< \brief Command header */
@@ -98,6 +103,42 @@ typedef struct
     CAM_APP_SecurityKey_Payload_t Payload;
 } CAM_APP_SecurityKeyCmd_t;
 
+typedef struct
+{
+    CFE_MSG_CommandHeader_t CommandHeader; /**< \brief Command header */
+    CAM_APP_SetStorageMode_Payload_t Payload;
+} CAM_APP_SetStorageModeCmd_t;
+
+typedef struct
+{
+    CFE_MSG_CommandHeader_t CommandHeader; /**< \brief Command header */
+    CAM_APP_ShotBurst_Payload_t Payload;
+} CAM_APP_ShotBurstCmd_t;
+
+typedef struct
+{
+    CFE_MSG_CommandHeader_t CommandHeader; /**< \brief Command header */
+    CAM_APP_SetVerify_Payload_t Payload;
+} CAM_APP_SetVerifyCmd_t;
+
+typedef struct
+{
+    CFE_MSG_CommandHeader_t CommandHeader; /**< \brief Command header */
+    CAM_APP_ExtractFrame_Payload_t Payload;
+} CAM_APP_ExtractFrameCmd_t;
+
+typedef struct
+{
+    CFE_MSG_CommandHeader_t CommandHeader; /**< \brief Command header */
+    CAM_APP_SetDurability_Payload_t Payload;
+} CAM_APP_SetDurabilityCmd_t;
+
+typedef struct
+{
+    CFE_MSG_CommandHeader_t CommandHeader; /**< \brief Command header */
+    CAM_APP_SetDownlink_Payload_t Payload;
+} CAM_APP_SetDownlinkCmd_t;
+
 /*************************************************************************/
 /*
 ** Type definition (Cam App housekeeping)
@@ -108,10 +149,37 @@ typedef struct
     CFE_MSG_CommandHeader_t CommandHeader; /**< \brief Command header */
 } CAM_APP_SendHkCmd_t;
 
+typedef struct
+{
+    CFE_MSG_CommandHeader_t CommandHeader; /**< \brief Command header */
+} CAM_APP_WakeupCmd_t;
+
 typedef struct
 {
     CFE_MSG_TelemetryHeader_t  TelemetryHeader; /**< \brief Telemetry header */
     CAM_APP_HkTlm_Payload_t Payload;         /**< \brief Telemetry payload */
 } CAM_APP_HkTlm_t;
 
+/*************************************************************************/
+/*
+** Type definition (Cam App image telemetry)
+*/
+
+typedef struct
+{
+    CFE_MSG_TelemetryHeader_t  TelemetryHeader; /**< \brief Telemetry header */
+    CAM_APP_ImageTlm_Payload_t Payload;         /**< \brief Telemetry payload */
+} CAM_APP_ImageTlm_t;
+
+/*************************************************************************/
+/*
+** Type definition (Cam App latency telemetry)
+*/
+
+typedef struct
+{
+    CFE_MSG_TelemetryHeader_t    TelemetryHeader; /**< \brief Telemetry header */
+    CAM_APP_LatencyTlm_Payload_t Payload;         /**< \brief Telemetry payload */
+} CAM_APP_LatencyTlm_t;
+
 #endif /* CAM_APP_MSGSTRUCT_H */
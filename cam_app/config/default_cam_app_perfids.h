@@ -25,4 +25,16 @@
 
 #define CAM_APP_PERF_ID 91
 
+/*
+** Pipeline steps, each marked once per frame (or per file or packet) on
+** the thread that does it
+*/
+#define CAM_APP_CAPTURE_PERF_ID  92 /* Camera to frame slot */
+#define CAM_APP_ENCRYPT_PERF_ID  93 /* Sealing a frame */
+#define CAM_APP_STORE_PERF_ID    94 /* Storage stage handing a frame's files to the writer */
+#define CAM_APP_WRITE_PERF_ID    95 /* Writing a file, or submitting files to io_uring */
+#define CAM_APP_COMMIT_PERF_ID   96 /* Syncing a file or group under the durability policy */
+#define CAM_APP_VERIFY_PERF_ID   97 /* Reading back and checking a stored file */
+#define CAM_APP_DOWNLINK_PERF_ID 98 /* Reading and sending one image telemetry packet */
+
 #endif
@@ -34,12 +34,44 @@
 #include "cam_app_mission_cfg.h"
 
 /*
-** Example Table structure
+** Capture frame formats
+*/
+#define CAM_APP_CAPTURE_FORMAT_MJPEG 0 /* Motion JPEG, one JPEG image per frame */
+#define CAM_APP_CAPTURE_FORMAT_YUYV  1 /* Packed YUV 4:2:2, 2 bytes per pixel (V4L2 only) */
+
+/*
+** Capture stage enables
+*/
+#define CAM_APP_CAPTURE_STAGE_ENCRYPT 0x01 /* Encrypt frames */
+
+/*
+** One way of shooting: what the camera produces and what the app does with it
+*/
+typedef struct
+{
+    char   Name[CAM_APP_CAPTURE_PROFILE_NAME_LEN];
+    uint16 Width;          /* Pixels */
+    uint16 Height;         /* Pixels */
+    uint16 FrameRate;      /* Frames per second requested from the camera */
+    uint16 WarmupMs;       /* Exposure settling time for one-shot captures */
+    uint32 PeriodMs;       /* Milliseconds between shot deadlines */
+    uint8  Format;         /* CAM_APP_CAPTURE_FORMAT_* */
+    uint8  Quality;        /* JPEG quality, 1 to 100 */
+    uint8  StorageMode;    /* CAM_APP_STORAGE_MODE_FILE, _MEMORY or _SEGMENT */
+    uint8  Stages;         /* CAM_APP_CAPTURE_STAGE_* bits */
+    uint16 VerifyInterval; /* Check every Nth encrypted file, 1 for all, 0 for none */
+    uint16 Spare;
+} CAM_APP_CaptureProfile_t;
+
+/*
+** Capture Table structure
 */
 typedef struct
 {
-    uint16 Int1;
-    uint16 Int2;
-} CAM_APP_ExampleTable_t;
+    uint8                    ActiveProfile; /* Index into Profiles */
+    uint8                    Spare[3];
+    char                     PhotoDir[CAM_APP_PHOTO_DIR_LEN]; /* Root of the photo output directories */
+    CAM_APP_CaptureProfile_t Profiles[CAM_APP_CAPTURE_PROFILE_COUNT];
+} CAM_APP_CaptureTable_t;
 
 #endif
@@ -23,8 +23,11 @@
 #ifndef CAM_APP_TOPICIDS_H
 #define CAM_APP_TOPICIDS_H
 
-#define CFE_MISSION_CAM_APP_CMD_TOPICID       0x88
-#define CFE_MISSION_CAM_APP_SEND_HK_TOPICID   0x89
-#define CFE_MISSION_CAM_APP_HK_TLM_TOPICID    0x89
+#define CFE_MISSION_CAM_APP_CMD_TOPICID         0x88
+#define CFE_MISSION_CAM_APP_SEND_HK_TOPICID     0x89
+#define CFE_MISSION_CAM_APP_HK_TLM_TOPICID      0x89
+#define CFE_MISSION_CAM_APP_WAKEUP_TOPICID      0x8A
+#define CFE_MISSION_CAM_APP_IMAGE_TLM_TOPICID   0x8A
+#define CFE_MISSION_CAM_APP_LATENCY_TLM_TOPICID 0x8B
 
 #endif
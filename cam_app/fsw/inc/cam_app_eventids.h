@@ -45,5 +45,27 @@
 #define CAM_APP_SECURITY_STOP_INF_EID  17
 #define CAM_APP_SECURITY_KEY_INF_EID   18
 #define CAM_APP_SECURITY_PROCESSING_INF_EID   19
+#define CAM_APP_CAPTURE_ERR_EID               20
+#define CAM_APP_STORAGE_MODE_INF_EID          21
+#define CAM_APP_STORAGE_MODE_ERR_EID          22
+#define CAM_APP_PIPELINE_INF_EID              23
+#define CAM_APP_PIPELINE_ERR_EID              24
+#define CAM_APP_PIPELINE_DROP_ERR_EID         25
+#define CAM_APP_SHOT_PERIOD_ERR_EID           26
+#define CAM_APP_SHOT_BURST_INF_EID            27
+#define CAM_APP_SHOT_BURST_ERR_EID            28
+#define CAM_APP_PROFILE_INF_EID               29
+#define CAM_APP_PROFILE_ERR_EID               30
+#define CAM_APP_VERIFY_INF_EID                31
+#define CAM_APP_VERIFY_ERR_EID                32
+#define CAM_APP_SEGMENT_INF_EID               33
+#define CAM_APP_SEGMENT_ERR_EID               34
+#define CAM_APP_RETENTION_INF_EID             35
+#define CAM_APP_RETENTION_ERR_EID             36
+#define CAM_APP_DURABILITY_INF_EID            37
+#define CAM_APP_DURABILITY_ERR_EID            38
+#define CAM_APP_DOWNLINK_ERR_EID              39
+#define CAM_APP_DOWNLINK_INF_EID              40
+#define CAM_APP_SUB_WAKEUP_ERR_EID            41
 
 #endif /* CAM_APP_EVENTS_H */
@@ -25,7 +25,10 @@
 ** Include Files:
 */
 #include "cam_app.h"
+#include "cam_app_aes.h"
+#include "cam_app_burst.h"
 #include "cam_app_cmds.h"
+#include "cam_app_crypto.h"
 #include "cam_app_utils.h"
 #include "cam_app_eventids.h"
 #include "cam_app_dispatch.h"
@@ -115,8 +118,9 @@ void CAM_APP_Main(void)
 /* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
 CFE_Status_t CAM_APP_Init(void)
 {
-    CFE_Status_t status;
-    char         VersionString[CAM_APP_CFG_MAX_VERSION_STR_LEN];
+    CFE_Status_t         status;
+    char                 VersionString[CAM_APP_CFG_MAX_VERSION_STR_LEN];
+    CAM_APP_CryptoKey_t *Key;
 
     /* Zero out the global data structure */
     memset(&CAM_APP_Data, 0, sizeof(CAM_APP_Data));
@@ -131,6 +135,19 @@ CFE_Status_t CAM_APP_Init(void)
     strncpy(CAM_APP_Data.PipeName, "CAM_APP_CMD_PIPE", sizeof(CAM_APP_Data.PipeName));
     CAM_APP_Data.PipeName[sizeof(CAM_APP_Data.PipeName) - 1] = 0;
 
+    /*
+    ** The rest of the shooting setup comes from the capture table; the key
+    ** stays all '0' until CAM_APP_SECURITY_KEY_CC
+    */
+    memset(CAM_APP_Data.SecurityKey, '0', sizeof(CAM_APP_Data.SecurityKey));
+
+    /*
+    ** Durability is not part of a capture profile; start from the defaults
+    */
+    atomic_store(&CAM_APP_Data.Durability, CAM_APP_WRITER_DURABILITY);
+    CAM_APP_Data.GroupFiles = CAM_APP_WRITER_GROUP_FILES;
+    CAM_APP_Data.GroupMs    = CAM_APP_WRITER_GROUP_MS;
+
     /*
     ** Register the events
     */
@@ -146,6 +163,8 @@ CFE_Status_t CAM_APP_Init(void)
          */
         CFE_MSG_Init(CFE_MSG_PTR(CAM_APP_Data.HkTlm.TelemetryHeader), CFE_SB_ValueToMsgId(CAM_APP_HK_TLM_MID),
                      sizeof(CAM_APP_Data.HkTlm));
+        CFE_MSG_Init(CFE_MSG_PTR(CAM_APP_Data.LatencyTlm.TelemetryHeader),
+                     CFE_SB_ValueToMsgId(CAM_APP_LATENCY_TLM_MID), sizeof(CAM_APP_Data.LatencyTlm));
 
         /*
          ** Create Software Bus message pipe.
@@ -171,6 +190,19 @@ CFE_Status_t CAM_APP_Init(void)
         }
     }
 
+    if (status == CFE_SUCCESS)
+    {
+        /*
+        ** Subscribe to scheduler wakeups, which pace image telemetry
+        */
+        status = CFE_SB_Subscribe(CFE_SB_ValueToMsgId(CAM_APP_WAKEUP_MID), CAM_APP_Data.CommandPipe);
+        if (status != CFE_SUCCESS)
+        {
+            CFE_EVS_SendEvent(CAM_APP_SUB_WAKEUP_ERR_EID, CFE_EVS_EventType_ERROR,
+                              "Cam App: Error Subscribing to wakeup, RC = 0x%08lX", (unsigned long)status);
+        }
+    }
+
     if (status == CFE_SUCCESS)
     {
         /*
@@ -187,25 +219,59 @@ CFE_Status_t CAM_APP_Init(void)
     if (status == CFE_SUCCESS)
     {
         /*
-        ** Register Example Table(s)
+        ** Reserve the burst arena up front
+        */
+        status = CAM_APP_BurstInit();
+    }
+
+    if (status == CFE_SUCCESS)
+    {
+        /*
+        ** Expand the default key so frames can be encrypted before one is uploaded
+        */
+        Key = CAM_APP_CryptoKeyCreate(CAM_APP_Data.SecurityKey);
+        if (Key == NULL)
+        {
+            CFE_EVS_SendEvent(CAM_APP_SECURITY_KEY_INF_EID, CFE_EVS_EventType_ERROR,
+                              "Cam App: Error allocating key context");
+            status = CFE_STATUS_EXTERNAL_RESOURCE_FAIL;
+        }
+        else
+        {
+            CAM_APP_CryptoKeyInstall(Key);
+        }
+    }
+
+    if (status == CFE_SUCCESS)
+    {
+        /*
+        ** Register Capture Table(s)
         */
-        status = CFE_TBL_Register(&CAM_APP_Data.TblHandles[0], "ExampleTable", sizeof(CAM_APP_ExampleTable_t),
+        status = CFE_TBL_Register(&CAM_APP_Data.TblHandles[0], "CaptureTable", sizeof(CAM_APP_CaptureTable_t),
                                   CFE_TBL_OPT_DEFAULT, CAM_APP_TblValidationFunc);
         if (status != CFE_SUCCESS)
         {
             CFE_EVS_SendEvent(CAM_APP_TABLE_REG_ERR_EID, CFE_EVS_EventType_ERROR,
-                              "Cam App: Error Registering Example Table, RC = 0x%08lX", (unsigned long)status);
+                              "Cam App: Error Registering Capture Table, RC = 0x%08lX", (unsigned long)status);
         }
         else
         {
             status = CFE_TBL_Load(CAM_APP_Data.TblHandles[0], CFE_TBL_SRC_FILE, CAM_APP_TABLE_FILE);
         }
 
+        /*
+        ** Size the frame buffers for the active profile
+        */
+        if (status == CFE_SUCCESS)
+        {
+            status = CAM_APP_CaptureTableUpdate();
+        }
+
         CFE_Config_GetVersionString(VersionString, CAM_APP_CFG_MAX_VERSION_STR_LEN, "Cam App", CAM_APP_VERSION,
                                     CAM_APP_BUILD_CODENAME, CAM_APP_LAST_OFFICIAL);
 
-        CFE_EVS_SendEvent(CAM_APP_INIT_INF_EID, CFE_EVS_EventType_INFORMATION, "Cam App Initialized.%s",
-                          VersionString);
+        CFE_EVS_SendEvent(CAM_APP_INIT_INF_EID, CFE_EVS_EventType_INFORMATION,
+                          "Cam App Initialized.%s AES backend: %s", VersionString, CAM_APP_AesBackendName());
     }
 
     return status;
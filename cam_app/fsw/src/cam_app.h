@@ -31,12 +31,15 @@
 #include "cfe.h"
 #include "cfe_config.h"
 
+#include <stdatomic.h>
+
 #include "cam_app_mission_cfg.h"
 #include "cam_app_platform_cfg.h"
 
 #include "cam_app_perfids.h"
 #include "cam_app_msgids.h"
 #include "cam_app_msg.h"
+#include "cam_app_tbl.h"
 
 /************************************************************************
 ** Type Definitions
@@ -58,11 +61,41 @@ typedef struct
     */
     CAM_APP_HkTlm_t HkTlm;
 
+    /*
+    ** Latency telemetry packet, sent on command...
+    */
+    CAM_APP_LatencyTlm_t LatencyTlm;
+
     /*
     ** Run Status variable used in the main processing loop
     */
     uint32 RunStatus;
 
+    /*
+    ** Shooting configuration, seeded from the capture profile and changed by
+    ** command; the pipeline threads read it while shooting, so it is atomic
+    */
+    atomic_uint   ShotPeriodMs;    /* Milliseconds between capture deadlines */
+    atomic_uchar  StorageMode;     /* CAM_APP_STORAGE_MODE_FILE, _MEMORY or _SEGMENT */
+    atomic_bool   SecurityEnabled; /* Encrypt captured frames */
+    atomic_ushort VerifyInterval;  /* Check every Nth encrypted file, 0 for none */
+    atomic_uchar  Durability;      /* CAM_APP_DURABILITY_NONE, _FILE or _GROUP */
+
+    /*
+    ** Shooting configuration only read by the main task
+    */
+    uint16 GroupFiles;      /* Most files per durability group */
+    uint32 GroupMs;         /* Longest a durability group stays open, milliseconds */
+    uint8  SecurityKey[32]; /* AES-256 key */
+
+    /*
+    ** Active capture profile, copied from the capture table while not shooting
+    */
+    CAM_APP_CaptureProfile_t Profile;
+    char                     PhotoDir[CAM_APP_PHOTO_DIR_LEN];
+    uint32                   FrameBufferSize; /* Bytes per frame buffer for the active profile */
+    bool                     ProfilePending;  /* Table changed while shooting; applied on stop */
+
     /*
     ** Operational data (not reported in housekeeping)...
     */
@@ -0,0 +1,912 @@
+/************************************************************************
+ * NASA Docket No. GSC-18,719-1, and identified as “core Flight System: Bootes”
+ *
+ * Copyright (c) 2020 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License. You may obtain
+ * a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ************************************************************************/
+
+/**
+ * \file
+ *   This file contains the source code for the Cam App AES-256 block cipher.
+ */
+
+/*
+** Include Files:
+*/
+#include "cam_app_aes.h"
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <string.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define CAM_APP_AES_HAVE_AESNI
+#include <cpuid.h>
+#include <wmmintrin.h>
+#endif
+
+#if defined(__aarch64__)
+#define CAM_APP_AES_HAVE_ARM64
+#include <arm_neon.h>
+#include <sys/auxv.h>
+#endif
+
+#ifdef CAM_APP_AES_WITH_SECURITY_LIB
+#include "security.h"
+#endif
+
+/*
+** Backend forced at build time, "auto" to pick the fastest the CPU supports
+*/
+#ifndef CAM_APP_AES_BACKEND
+#define CAM_APP_AES_BACKEND "auto"
+#endif
+
+/*
+** Independent blocks kept in flight by the hardware backends to hide
+** instruction latency
+*/
+#define CAM_APP_AES_LANES 4
+
+/*
+** Round tables, words in big-endian column order.  Te/Td fold SubBytes
+** (or its inverse) with MixColumns (or its inverse) for each byte lane.
+*/
+static uint8_t  CAM_APP_AesSbox[256];
+static uint8_t  CAM_APP_AesInvSbox[256];
+static uint32_t CAM_APP_AesTe[4][256];
+static uint32_t CAM_APP_AesTd[4][256];
+
+typedef void (*CAM_APP_AesBlocksFunc_t)(const CAM_APP_AesSchedule_t *Schedule, const uint8_t *In, uint8_t *Out,
+                                        size_t Blocks);
+
+typedef struct
+{
+    const char             *Name;
+    bool                    (*Supported)(void); /* NULL when it runs everywhere */
+    CAM_APP_AesBlocksFunc_t Encrypt;
+    CAM_APP_AesBlocksFunc_t Decrypt;
+} CAM_APP_AesBackend_t;
+
+static const CAM_APP_AesBackend_t *CAM_APP_AesActive;
+static pthread_once_t              CAM_APP_AesInitOnce = PTHREAD_ONCE_INIT;
+
+#define CAM_APP_AES_LOAD32(p) \
+    (((uint32_t)(p)[0] << 24) | ((uint32_t)(p)[1] << 16) | ((uint32_t)(p)[2] << 8) | (uint32_t)(p)[3])
+
+#define CAM_APP_AES_STORE32(p, v)      \
+    do                                 \
+    {                                  \
+        (p)[0] = (uint8_t)((v) >> 24); \
+        (p)[1] = (uint8_t)((v) >> 16); \
+        (p)[2] = (uint8_t)((v) >> 8);  \
+        (p)[3] = (uint8_t)(v);         \
+    } while (0)
+
+#define CAM_APP_AES_ROR8(v) (((v) >> 8) | ((v) << 24))
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Multiply in GF(2^8) modulo the AES polynomial                   */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+static uint8_t CAM_APP_AesMul(uint8_t a, uint8_t b)
+{
+    uint8_t Product = 0;
+
+    while (b != 0)
+    {
+        if (b & 1)
+        {
+            Product ^= a;
+        }
+        a = (uint8_t)((a << 1) ^ ((a & 0x80) ? 0x1b : 0));
+        b >>= 1;
+    }
+
+    return Product;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Build the S-boxes and round tables                              */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+static void CAM_APP_AesBuildTables(void)
+{
+    uint8_t  p = 1;
+    uint8_t  q = 1;
+    uint8_t  s;
+    uint8_t  x;
+    uint32_t Te;
+    uint32_t Td;
+    int      i;
+    int      Lane;
+
+    /* Walk the multiplicative group with generator 3, tracking its inverse 1/3 */
+    do
+    {
+        p = (uint8_t)(p ^ (p << 1) ^ ((p & 0x80) ? 0x1b : 0));
+
+        q ^= (uint8_t)(q << 1);
+        q ^= (uint8_t)(q << 2);
+        q ^= (uint8_t)(q << 4);
+        if (q & 0x80)
+        {
+            q ^= 0x09;
+        }
+
+        x = (uint8_t)(q ^ (uint8_t)((q << 1) | (q >> 7)) ^ (uint8_t)((q << 2) | (q >> 6)) ^
+                      (uint8_t)((q << 3) | (q >> 5)) ^ (uint8_t)((q << 4) | (q >> 4)));
+        CAM_APP_AesSbox[p] = x ^ 0x63;
+    } while (p != 1);
+
+    CAM_APP_AesSbox[0] = 0x63;
+
+    for (i = 0; i < 256; i++)
+    {
+        CAM_APP_AesInvSbox[CAM_APP_AesSbox[i]] = (uint8_t)i;
+    }
+
+    for (i = 0; i < 256; i++)
+    {
+        s  = CAM_APP_AesSbox[i];
+        Te = ((uint32_t)CAM_APP_AesMul(s, 2) << 24) | ((uint32_t)s << 16) | ((uint32_t)s << 8) |
+             (uint32_t)CAM_APP_AesMul(s, 3);
+
+        s  = CAM_APP_AesInvSbox[i];
+        Td = ((uint32_t)CAM_APP_AesMul(s, 14) << 24) | ((uint32_t)CAM_APP_AesMul(s, 9) << 16) |
+             ((uint32_t)CAM_APP_AesMul(s, 13) << 8) | (uint32_t)CAM_APP_AesMul(s, 11);
+
+        for (Lane = 0; Lane < 4; Lane++)
+        {
+            CAM_APP_AesTe[Lane][i] = Te;
+            CAM_APP_AesTd[Lane][i] = Td;
+            Te                     = CAM_APP_AES_ROR8(Te);
+            Td                     = CAM_APP_AES_ROR8(Td);
+        }
+    }
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Apply the S-box to each byte of a word                          */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+static uint32_t CAM_APP_AesSubWord(uint32_t w)
+{
+    return ((uint32_t)CAM_APP_AesSbox[w >> 24] << 24) | ((uint32_t)CAM_APP_AesSbox[(w >> 16) & 0xff] << 16) |
+           ((uint32_t)CAM_APP_AesSbox[(w >> 8) & 0xff] << 8) | (uint32_t)CAM_APP_AesSbox[w & 0xff];
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Portable backend: encrypt with the round tables                 */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+static void CAM_APP_AesPortableEncrypt(const CAM_APP_AesSchedule_t *Schedule, const uint8_t *In, uint8_t *Out,
+                                       size_t Blocks)
+{
+    const uint8_t *rk;
+    uint32_t       s0, s1, s2, s3;
+    uint32_t       t0, t1, t2, t3;
+    int            Round;
+
+    for (; Blocks > 0; Blocks--, In += CAM_APP_AES_BLOCK_SIZE, Out += CAM_APP_AES_BLOCK_SIZE)
+    {
+        rk = Schedule->Enc[0];
+
+        s0 = CAM_APP_AES_LOAD32(In) ^ CAM_APP_AES_LOAD32(rk);
+        s1 = CAM_APP_AES_LOAD32(In + 4) ^ CAM_APP_AES_LOAD32(rk + 4);
+        s2 = CAM_APP_AES_LOAD32(In + 8) ^ CAM_APP_AES_LOAD32(rk + 8);
+        s3 = CAM_APP_AES_LOAD32(In + 12) ^ CAM_APP_AES_LOAD32(rk + 12);
+
+        for (Round = 1; Round < CAM_APP_AES_ROUNDS; Round++)
+        {
+            rk = Schedule->Enc[Round];
+            t0 = CAM_APP_AesTe[0][s0 >> 24] ^ CAM_APP_AesTe[1][(s1 >> 16) & 0xff] ^
+                 CAM_APP_AesTe[2][(s2 >> 8) & 0xff] ^ CAM_APP_AesTe[3][s3 & 0xff] ^ CAM_APP_AES_LOAD32(rk);
+            t1 = CAM_APP_AesTe[0][s1 >> 24] ^ CAM_APP_AesTe[1][(s2 >> 16) & 0xff] ^
+                 CAM_APP_AesTe[2][(s3 >> 8) & 0xff] ^ CAM_APP_AesTe[3][s0 & 0xff] ^ CAM_APP_AES_LOAD32(rk + 4);
+            t2 = CAM_APP_AesTe[0][s2 >> 24] ^ CAM_APP_AesTe[1][(s3 >> 16) & 0xff] ^
+                 CAM_APP_AesTe[2][(s0 >> 8) & 0xff] ^ CAM_APP_AesTe[3][s1 & 0xff] ^ CAM_APP_AES_LOAD32(rk + 8);
+            t3 = CAM_APP_AesTe[0][s3 >> 24] ^ CAM_APP_AesTe[1][(s0 >> 16) & 0xff] ^
+                 CAM_APP_AesTe[2][(s1 >> 8) & 0xff] ^ CAM_APP_AesTe[3][s2 & 0xff] ^ CAM_APP_AES_LOAD32(rk + 12);
+            s0 = t0;
+            s1 = t1;
+            s2 = t2;
+            s3 = t3;
+        }
+
+        /* Last round has no MixColumns */
+        rk = Schedule->Enc[CAM_APP_AES_ROUNDS];
+        t0 = ((uint32_t)CAM_APP_AesSbox[s0 >> 24] << 24) ^ ((uint32_t)CAM_APP_AesSbox[(s1 >> 16) & 0xff] << 16) ^
+             ((uint32_t)CAM_APP_AesSbox[(s2 >> 8) & 0xff] << 8) ^ (uint32_t)CAM_APP_AesSbox[s3 & 0xff] ^
+             CAM_APP_AES_LOAD32(rk);
+        t1 = ((uint32_t)CAM_APP_AesSbox[s1 >> 24] << 24) ^ ((uint32_t)CAM_APP_AesSbox[(s2 >> 16) & 0xff] << 16) ^
+             ((uint32_t)CAM_APP_AesSbox[(s3 >> 8) & 0xff] << 8) ^ (uint32_t)CAM_APP_AesSbox[s0 & 0xff] ^
+             CAM_APP_AES_LOAD32(rk + 4);
+        t2 = ((uint32_t)CAM_APP_AesSbox[s2 >> 24] << 24) ^ ((uint32_t)CAM_APP_AesSbox[(s3 >> 16) & 0xff] << 16) ^
+             ((uint32_t)CAM_APP_AesSbox[(s0 >> 8) & 0xff] << 8) ^ (uint32_t)CAM_APP_AesSbox[s1 & 0xff] ^
+             CAM_APP_AES_LOAD32(rk + 8);
+        t3 = ((uint32_t)CAM_APP_AesSbox[s3 >> 24] << 24) ^ ((uint32_t)CAM_APP_AesSbox[(s0 >> 16) & 0xff] << 16) ^
+             ((uint32_t)CAM_APP_AesSbox[(s1 >> 8) & 0xff] << 8) ^ (uint32_t)CAM_APP_AesSbox[s2 & 0xff] ^
+             CAM_APP_AES_LOAD32(rk + 12);
+
+        CAM_APP_AES_STORE32(Out, t0);
+        CAM_APP_AES_STORE32(Out + 4, t1);
+        CAM_APP_AES_STORE32(Out + 8, t2);
+        CAM_APP_AES_STORE32(Out + 12, t3);
+    }
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Portable backend: decrypt with the round tables                 */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+static void CAM_APP_AesPortableDecrypt(const CAM_APP_AesSchedule_t *Schedule, const uint8_t *In, uint8_t *Out,
+                                       size_t Blocks)
+{
+    const uint8_t *rk;
+    uint32_t       s0, s1, s2, s3;
+    uint32_t       t0, t1, t2, t3;
+    int            Round;
+
+    for (; Blocks > 0; Blocks--, In += CAM_APP_AES_BLOCK_SIZE, Out += CAM_APP_AES_BLOCK_SIZE)
+    {
+        rk = Schedule->Dec[0];
+
+        s0 = CAM_APP_AES_LOAD32(In) ^ CAM_APP_AES_LOAD32(rk);
+        s1 = CAM_APP_AES_LOAD32(In + 4) ^ CAM_APP_AES_LOAD32(rk + 4);
+        s2 = CAM_APP_AES_LOAD32(In + 8) ^ CAM_APP_AES_LOAD32(rk + 8);
+        s3 = CAM_APP_AES_LOAD32(In + 12) ^ CAM_APP_AES_LOAD32(rk + 12);
+
+        for (Round = 1; Round < CAM_APP_AES_ROUNDS; Round++)
+        {
+            rk = Schedule->Dec[Round];
+            t0 = CAM_APP_AesTd[0][s0 >> 24] ^ CAM_APP_AesTd[1][(s3 >> 16) & 0xff] ^
+                 CAM_APP_AesTd[2][(s2 >> 8) & 0xff] ^ CAM_APP_AesTd[3][s1 & 0xff] ^ CAM_APP_AES_LOAD32(rk);
+            t1 = CAM_APP_AesTd[0][s1 >> 24] ^ CAM_APP_AesTd[1][(s0 >> 16) & 0xff] ^
+                 CAM_APP_AesTd[2][(s3 >> 8) & 0xff] ^ CAM_APP_AesTd[3][s2 & 0xff] ^ CAM_APP_AES_LOAD32(rk + 4);
+            t2 = CAM_APP_AesTd[0][s2 >> 24] ^ CAM_APP_AesTd[1][(s1 >> 16) & 0xff] ^
+                 CAM_APP_AesTd[2][(s0 >> 8) & 0xff] ^ CAM_APP_AesTd[3][s3 & 0xff] ^ CAM_APP_AES_LOAD32(rk + 8);
+            t3 = CAM_APP_AesTd[0][s3 >> 24] ^ CAM_APP_AesTd[1][(s2 >> 16) & 0xff] ^
+                 CAM_APP_AesTd[2][(s1 >> 8) & 0xff] ^ CAM_APP_AesTd[3][s0 & 0xff] ^ CAM_APP_AES_LOAD32(rk + 12);
+            s0 = t0;
+            s1 = t1;
+            s2 = t2;
+            s3 = t3;
+        }
+
+        rk = Schedule->Dec[CAM_APP_AES_ROUNDS];
+        t0 = ((uint32_t)CAM_APP_AesInvSbox[s0 >> 24] << 24) ^ ((uint32_t)CAM_APP_AesInvSbox[(s3 >> 16) & 0xff] << 16) ^
+             ((uint32_t)CAM_APP_AesInvSbox[(s2 >> 8) & 0xff] << 8) ^ (uint32_t)CAM_APP_AesInvSbox[s1 & 0xff] ^
+             CAM_APP_AES_LOAD32(rk);
+        t1 = ((uint32_t)CAM_APP_AesInvSbox[s1 >> 24] << 24) ^ ((uint32_t)CAM_APP_AesInvSbox[(s0 >> 16) & 0xff] << 16) ^
+             ((uint32_t)CAM_APP_AesInvSbox[(s3 >> 8) & 0xff] << 8) ^ (uint32_t)CAM_APP_AesInvSbox[s2 & 0xff] ^
+             CAM_APP_AES_LOAD32(rk + 4);
+        t2 = ((uint32_t)CAM_APP_AesInvSbox[s2 >> 24] << 24) ^ ((uint32_t)CAM_APP_AesInvSbox[(s1 >> 16) & 0xff] << 16) ^
+             ((uint32_t)CAM_APP_AesInvSbox[(s0 >> 8) & 0xff] << 8) ^ (uint32_t)CAM_APP_AesInvSbox[s3 & 0xff] ^
+             CAM_APP_AES_LOAD32(rk + 8);
+        t3 = ((uint32_t)CAM_APP_AesInvSbox[s3 >> 24] << 24) ^ ((uint32_t)CAM_APP_AesInvSbox[(s2 >> 16) & 0xff] << 16) ^
+             ((uint32_t)CAM_APP_AesInvSbox[(s1 >> 8) & 0xff] << 8) ^ (uint32_t)CAM_APP_AesInvSbox[s0 & 0xff] ^
+             CAM_APP_AES_LOAD32(rk + 12);
+
+        CAM_APP_AES_STORE32(Out, t0);
+        CAM_APP_AES_STORE32(Out + 4, t1);
+        CAM_APP_AES_STORE32(Out + 8, t2);
+        CAM_APP_AES_STORE32(Out + 12, t3);
+    }
+}
+
+#ifdef CAM_APP_AES_HAVE_AESNI
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* AES-NI backend: check CPUID for the instructions                */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+static bool CAM_APP_AesNiSupported(void)
+{
+    unsigned int a, b, c, d;
+
+    return __get_cpuid(1, &a, &b, &c, &d) && (c & bit_AES) != 0 && (d & bit_SSE2) != 0;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* AES-NI backend: encrypt, several blocks in flight at a time     */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+__attribute__((target("aes,sse2"))) static void CAM_APP_AesNiEncrypt(const CAM_APP_AesSchedule_t *Schedule,
+                                                                     const uint8_t *In, uint8_t *Out, size_t Blocks)
+{
+    __m128i rk[CAM_APP_AES_ROUNDS + 1];
+    __m128i b[CAM_APP_AES_LANES];
+    size_t  Lanes;
+    size_t  i;
+    int     Round;
+
+    for (Round = 0; Round <= CAM_APP_AES_ROUNDS; Round++)
+    {
+        rk[Round] = _mm_loadu_si128((const __m128i *)Schedule->Enc[Round]);
+    }
+
+    while (Blocks > 0)
+    {
+        Lanes = (Blocks < CAM_APP_AES_LANES) ? Blocks : CAM_APP_AES_LANES;
+
+        for (i = 0; i < Lanes; i++)
+        {
+            b[i] = _mm_xor_si128(_mm_loadu_si128((const __m128i *)(In + i * CAM_APP_AES_BLOCK_SIZE)), rk[0]);
+        }
+        for (Round = 1; Round < CAM_APP_AES_ROUNDS; Round++)
+        {
+            for (i = 0; i < Lanes; i++)
+            {
+                b[i] = _mm_aesenc_si128(b[i], rk[Round]);
+            }
+        }
+        for (i = 0; i < Lanes; i++)
+        {
+            _mm_storeu_si128((__m128i *)(Out + i * CAM_APP_AES_BLOCK_SIZE),
+                             _mm_aesenclast_si128(b[i], rk[CAM_APP_AES_ROUNDS]));
+        }
+
+        In += Lanes * CAM_APP_AES_BLOCK_SIZE;
+        Out += Lanes * CAM_APP_AES_BLOCK_SIZE;
+        Blocks -= Lanes;
+    }
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* AES-NI backend: decrypt, several blocks in flight at a time     */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+__attribute__((target("aes,sse2"))) static void CAM_APP_AesNiDecrypt(const CAM_APP_AesSchedule_t *Schedule,
+                                                                     const uint8_t *In, uint8_t *Out, size_t Blocks)
+{
+    __m128i rk[CAM_APP_AES_ROUNDS + 1];
+    __m128i b[CAM_APP_AES_LANES];
+    size_t  Lanes;
+    size_t  i;
+    int     Round;
+
+    for (Round = 0; Round <= CAM_APP_AES_ROUNDS; Round++)
+    {
+        rk[Round] = _mm_loadu_si128((const __m128i *)Schedule->Dec[Round]);
+    }
+
+    while (Blocks > 0)
+    {
+        Lanes = (Blocks < CAM_APP_AES_LANES) ? Blocks : CAM_APP_AES_LANES;
+
+        for (i = 0; i < Lanes; i++)
+        {
+            b[i] = _mm_xor_si128(_mm_loadu_si128((const __m128i *)(In + i * CAM_APP_AES_BLOCK_SIZE)), rk[0]);
+        }
+        for (Round = 1; Round < CAM_APP_AES_ROUNDS; Round++)
+        {
+            for (i = 0; i < Lanes; i++)
+            {
+                b[i] = _mm_aesdec_si128(b[i], rk[Round]);
+            }
+        }
+        for (i = 0; i < Lanes; i++)
+        {
+            _mm_storeu_si128((__m128i *)(Out + i * CAM_APP_AES_BLOCK_SIZE),
+                             _mm_aesdeclast_si128(b[i], rk[CAM_APP_AES_ROUNDS]));
+        }
+
+        In += Lanes * CAM_APP_AES_BLOCK_SIZE;
+        Out += Lanes * CAM_APP_AES_BLOCK_SIZE;
+        Blocks -= Lanes;
+    }
+}
+
+#endif /* CAM_APP_AES_HAVE_AESNI */
+
+#ifdef CAM_APP_AES_HAVE_ARM64
+
+#ifndef HWCAP_ASIMD
+#define HWCAP_ASIMD (1 << 1)
+#endif
+#ifndef HWCAP_AES
+#define HWCAP_AES (1 << 3)
+#endif
+
+#if defined(__clang__)
+#define CAM_APP_AES_TARGET_CE __attribute__((target("aes")))
+#else
+#define CAM_APP_AES_TARGET_CE __attribute__((target("+crypto")))
+#endif
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* ARMv8 backend: check the hwcaps for the AES instructions        */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+static bool CAM_APP_AesCeSupported(void)
+{
+    return (getauxval(AT_HWCAP) & HWCAP_AES) != 0;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* ARMv8 backend: encrypt, several blocks in flight at a time      */
+/*                                                                 */
+/* AESE folds the round key in before SubBytes and ShiftRows, so   */
+/* the last two round keys are applied by AESE and a plain XOR.    */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+CAM_APP_AES_TARGET_CE static void CAM_APP_AesCeEncrypt(const CAM_APP_AesSchedule_t *Schedule, const uint8_t *In,
+                                                       uint8_t *Out, size_t Blocks)
+{
+    uint8x16_t rk[CAM_APP_AES_ROUNDS + 1];
+    uint8x16_t b[CAM_APP_AES_LANES];
+    size_t     Lanes;
+    size_t     i;
+    int        Round;
+
+    for (Round = 0; Round <= CAM_APP_AES_ROUNDS; Round++)
+    {
+        rk[Round] = vld1q_u8(Schedule->Enc[Round]);
+    }
+
+    while (Blocks > 0)
+    {
+        Lanes = (Blocks < CAM_APP_AES_LANES) ? Blocks : CAM_APP_AES_LANES;
+
+        for (i = 0; i < Lanes; i++)
+        {
+            b[i] = vld1q_u8(In + i * CAM_APP_AES_BLOCK_SIZE);
+        }
+        for (Round = 0; Round < CAM_APP_AES_ROUNDS - 1; Round++)
+        {
+            for (i = 0; i < Lanes; i++)
+            {
+                b[i] = vaesmcq_u8(vaeseq_u8(b[i], rk[Round]));
+            }
+        }
+        for (i = 0; i < Lanes; i++)
+        {
+            b[i] = veorq_u8(vaeseq_u8(b[i], rk[CAM_APP_AES_ROUNDS - 1]), rk[CAM_APP_AES_ROUNDS]);
+            vst1q_u8(Out + i * CAM_APP_AES_BLOCK_SIZE, b[i]);
+        }
+
+        In += Lanes * CAM_APP_AES_BLOCK_SIZE;
+        Out += Lanes * CAM_APP_AES_BLOCK_SIZE;
+        Blocks -= Lanes;
+    }
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* ARMv8 backend: decrypt, several blocks in flight at a time      */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+CAM_APP_AES_TARGET_CE static void CAM_APP_AesCeDecrypt(const CAM_APP_AesSchedule_t *Schedule, const uint8_t *In,
+                                                       uint8_t *Out, size_t Blocks)
+{
+    uint8x16_t rk[CAM_APP_AES_ROUNDS + 1];
+    uint8x16_t b[CAM_APP_AES_LANES];
+    size_t     Lanes;
+    size_t     i;
+    int        Round;
+
+    for (Round = 0; Round <= CAM_APP_AES_ROUNDS; Round++)
+    {
+        rk[Round] = vld1q_u8(Schedule->Dec[Round]);
+    }
+
+    while (Blocks > 0)
+    {
+        Lanes = (Blocks < CAM_APP_AES_LANES) ? Blocks : CAM_APP_AES_LANES;
+
+        for (i = 0; i < Lanes; i++)
+        {
+            b[i] = vld1q_u8(In + i * CAM_APP_AES_BLOCK_SIZE);
+        }
+        for (Round = 0; Round < CAM_APP_AES_ROUNDS - 1; Round++)
+        {
+            for (i = 0; i < Lanes; i++)
+            {
+                b[i] = vaesimcq_u8(vaesdq_u8(b[i], rk[Round]));
+            }
+        }
+        for (i = 0; i < Lanes; i++)
+        {
+            b[i] = veorq_u8(vaesdq_u8(b[i], rk[CAM_APP_AES_ROUNDS - 1]), rk[CAM_APP_AES_ROUNDS]);
+            vst1q_u8(Out + i * CAM_APP_AES_BLOCK_SIZE, b[i]);
+        }
+
+        In += Lanes * CAM_APP_AES_BLOCK_SIZE;
+        Out += Lanes * CAM_APP_AES_BLOCK_SIZE;
+        Blocks -= Lanes;
+    }
+}
+
+/*
+** Byte permutations for ShiftRows and its inverse on a column-major state
+*/
+static const uint8_t CAM_APP_AesShiftRows[16]    = {0, 5, 10, 15, 4, 9, 14, 3, 8, 13, 2, 7, 12, 1, 6, 11};
+static const uint8_t CAM_APP_AesInvShiftRows[16] = {0, 13, 10, 7, 4, 1, 14, 11, 8, 5, 2, 15, 12, 9, 6, 3};
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* NEON backend: check the hwcaps for Advanced SIMD                */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+static bool CAM_APP_AesNeonSupported(void)
+{
+    return (getauxval(AT_HWCAP) & HWCAP_ASIMD) != 0;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* NEON backend: load a 256-byte S-box into four table registers   */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+static void CAM_APP_AesNeonLoadBox(uint8x16x4_t Box[4], const uint8_t *Table)
+{
+    int i;
+    int j;
+
+    for (i = 0; i < 4; i++)
+    {
+        for (j = 0; j < 4; j++)
+        {
+            Box[i].val[j] = vld1q_u8(Table + 64 * i + 16 * j);
+        }
+    }
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* NEON backend: substitute every byte through a 256-byte table    */
+/*                                                                 */
+/* TBL covers 64 entries; out-of-range lanes of each TBX keep the  */
+/* result of the quarter that did match.                           */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+static inline uint8x16_t CAM_APP_AesNeonSub(const uint8x16x4_t Box[4], uint8x16_t x)
+{
+    uint8x16_t r;
+
+    r = vqtbl4q_u8(Box[0], x);
+    r = vqtbx4q_u8(r, Box[1], vsubq_u8(x, vdupq_n_u8(0x40)));
+    r = vqtbx4q_u8(r, Box[2], vsubq_u8(x, vdupq_n_u8(0x80)));
+    r = vqtbx4q_u8(r, Box[3], vsubq_u8(x, vdupq_n_u8(0xc0)));
+
+    return r;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* NEON backend: multiply every byte by x in GF(2^8)               */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+static inline uint8x16_t CAM_APP_AesNeonXtime(uint8x16_t x)
+{
+    uint8x16_t Carry = vreinterpretq_u8_s8(vshrq_n_s8(vreinterpretq_s8_u8(x), 7));
+
+    return veorq_u8(vshlq_n_u8(x, 1), vandq_u8(Carry, vdupq_n_u8(0x1b)));
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* NEON backend: MixColumns                                        */
+/*                                                                 */
+/* Rotating each column word by one and two bytes lines up         */
+/* a[r+1] and a[r+2] with a[r]:                                    */
+/*   out = 2(a ^ a>>>8) ^ a>>>8 ^ (a ^ a>>>8)>>>16                 */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+static inline uint8x16_t CAM_APP_AesNeonMix(uint8x16_t a)
+{
+    uint32x4_t w  = vreinterpretq_u32_u8(a);
+    uint8x16_t r1 = vreinterpretq_u8_u32(vorrq_u32(vshrq_n_u32(w, 8), vshlq_n_u32(w, 24)));
+    uint8x16_t t  = veorq_u8(a, r1);
+
+    return veorq_u8(veorq_u8(CAM_APP_AesNeonXtime(t), r1), vreinterpretq_u8_u16(vrev32q_u16(vreinterpretq_u16_u8(t))));
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* NEON backend: InvMixColumns                                     */
+/*                                                                 */
+/* The inverse matrix factors as MixColumns times {05 00 04 00},   */
+/* so premultiply each column and reuse MixColumns.                */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+static inline uint8x16_t CAM_APP_AesNeonInvMix(uint8x16_t a)
+{
+    uint8x16_t v = CAM_APP_AesNeonXtime(CAM_APP_AesNeonXtime(a));
+
+    v = veorq_u8(v, vreinterpretq_u8_u16(vrev32q_u16(vreinterpretq_u16_u8(v))));
+
+    return CAM_APP_AesNeonMix(veorq_u8(a, v));
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* NEON backend: encrypt one block at a time                       */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+static void CAM_APP_AesNeonEncrypt(const CAM_APP_AesSchedule_t *Schedule, const uint8_t *In, uint8_t *Out,
+                                   size_t Blocks)
+{
+    uint8x16x4_t Box[4];
+    uint8x16_t   Shift = vld1q_u8(CAM_APP_AesShiftRows);
+    uint8x16_t   b;
+    int          Round;
+
+    CAM_APP_AesNeonLoadBox(Box, CAM_APP_AesSbox);
+
+    for (; Blocks > 0; Blocks--, In += CAM_APP_AES_BLOCK_SIZE, Out += CAM_APP_AES_BLOCK_SIZE)
+    {
+        b = veorq_u8(vld1q_u8(In), vld1q_u8(Schedule->Enc[0]));
+
+        for (Round = 1; Round < CAM_APP_AES_ROUNDS; Round++)
+        {
+            b = CAM_APP_AesNeonSub(Box, vqtbl1q_u8(b, Shift));
+            b = veorq_u8(CAM_APP_AesNeonMix(b), vld1q_u8(Schedule->Enc[Round]));
+        }
+
+        b = CAM_APP_AesNeonSub(Box, vqtbl1q_u8(b, Shift));
+        vst1q_u8(Out, veorq_u8(b, vld1q_u8(Schedule->Enc[CAM_APP_AES_ROUNDS])));
+    }
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* NEON backend: decrypt one block at a time                       */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+static void CAM_APP_AesNeonDecrypt(const CAM_APP_AesSchedule_t *Schedule, const uint8_t *In, uint8_t *Out,
+                                   size_t Blocks)
+{
+    uint8x16x4_t Box[4];
+    uint8x16_t   Shift = vld1q_u8(CAM_APP_AesInvShiftRows);
+    uint8x16_t   b;
+    int          Round;
+
+    CAM_APP_AesNeonLoadBox(Box, CAM_APP_AesInvSbox);
+
+    for (; Blocks > 0; Blocks--, In += CAM_APP_AES_BLOCK_SIZE, Out += CAM_APP_AES_BLOCK_SIZE)
+    {
+        b = veorq_u8(vld1q_u8(In), vld1q_u8(Schedule->Dec[0]));
+
+        for (Round = 1; Round < CAM_APP_AES_ROUNDS; Round++)
+        {
+            b = CAM_APP_AesNeonSub(Box, vqtbl1q_u8(b, Shift));
+            b = veorq_u8(CAM_APP_AesNeonInvMix(b), vld1q_u8(Schedule->Dec[Round]));
+        }
+
+        b = CAM_APP_AesNeonSub(Box, vqtbl1q_u8(b, Shift));
+        vst1q_u8(Out, veorq_u8(b, vld1q_u8(Schedule->Dec[CAM_APP_AES_ROUNDS])));
+    }
+}
+
+#endif /* CAM_APP_AES_HAVE_ARM64 */
+
+#ifdef CAM_APP_AES_WITH_SECURITY_LIB
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Security_lib backend: re-expands the key on every call          */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+static void CAM_APP_AesLegacyEncrypt(const CAM_APP_AesSchedule_t *Schedule, const uint8_t *In, uint8_t *Out,
+                                     size_t Blocks)
+{
+    byte RoundKeys[(Nr + 1) * Nb * 4];
+
+    memmove(Out, In, Blocks * CAM_APP_AES_BLOCK_SIZE);
+    encrypt_data(Out, Blocks * CAM_APP_AES_BLOCK_SIZE, Schedule->Key, RoundKeys);
+    memset(RoundKeys, 0, sizeof(RoundKeys));
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Security_lib backend: re-expands the key on every call          */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+static void CAM_APP_AesLegacyDecrypt(const CAM_APP_AesSchedule_t *Schedule, const uint8_t *In, uint8_t *Out,
+                                     size_t Blocks)
+{
+    byte RoundKeys[(Nr + 1) * Nb * 4];
+
+    memmove(Out, In, Blocks * CAM_APP_AES_BLOCK_SIZE);
+    decrypt_data(Out, Blocks * CAM_APP_AES_BLOCK_SIZE, Schedule->Key, RoundKeys);
+    memset(RoundKeys, 0, sizeof(RoundKeys));
+}
+
+#endif /* CAM_APP_AES_WITH_SECURITY_LIB */
+
+/*
+** Backends in order of preference; the first supported one is used
+** unless another is forced.  Portable always runs, so any listed after
+** it are only used when forced.
+*/
+static const CAM_APP_AesBackend_t CAM_APP_AesBackends[] = {
+#ifdef CAM_APP_AES_HAVE_AESNI
+    {"aesni", CAM_APP_AesNiSupported, CAM_APP_AesNiEncrypt, CAM_APP_AesNiDecrypt},
+#endif
+#ifdef CAM_APP_AES_HAVE_ARM64
+    {"armv8-ce", CAM_APP_AesCeSupported, CAM_APP_AesCeEncrypt, CAM_APP_AesCeDecrypt},
+    {"neon", CAM_APP_AesNeonSupported, CAM_APP_AesNeonEncrypt, CAM_APP_AesNeonDecrypt},
+#endif
+    {"portable", NULL, CAM_APP_AesPortableEncrypt, CAM_APP_AesPortableDecrypt},
+#ifdef CAM_APP_AES_WITH_SECURITY_LIB
+    {"security_lib", NULL, CAM_APP_AesLegacyEncrypt, CAM_APP_AesLegacyDecrypt},
+#endif
+};
+
+#define CAM_APP_AES_BACKEND_COUNT (sizeof(CAM_APP_AesBackends) / sizeof(CAM_APP_AesBackends[0]))
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Build the tables and pick the backend, once per process         */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+static void CAM_APP_AesInit(void)
+{
+    const CAM_APP_AesBackend_t *Backend;
+    size_t                      i;
+
+    CAM_APP_AesBuildTables();
+
+    /* A forced backend the CPU cannot run falls back to the automatic choice */
+    for (i = 0; i < CAM_APP_AES_BACKEND_COUNT && CAM_APP_AesActive == NULL; i++)
+    {
+        Backend = &CAM_APP_AesBackends[i];
+        if (strcmp(Backend->Name, CAM_APP_AES_BACKEND) == 0 && (Backend->Supported == NULL || Backend->Supported()))
+        {
+            CAM_APP_AesActive = Backend;
+        }
+    }
+
+    for (i = 0; i < CAM_APP_AES_BACKEND_COUNT && CAM_APP_AesActive == NULL; i++)
+    {
+        Backend = &CAM_APP_AesBackends[i];
+        if (Backend->Supported == NULL || Backend->Supported())
+        {
+            CAM_APP_AesActive = Backend;
+        }
+    }
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Name of the backend in use                                      */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+const char *CAM_APP_AesBackendName(void)
+{
+    pthread_once(&CAM_APP_AesInitOnce, CAM_APP_AesInit);
+
+    return CAM_APP_AesActive->Name;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Switch to the backend called Name                               */
+/*                                                                 */
+/* Returns false, keeping the backend in use, if there is no such  */
+/* backend or the CPU cannot run it.  Schedules expanded before    */
+/* the switch stay valid, but no blocks may be in flight.          */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+bool CAM_APP_AesSelectBackend(const char *Name)
+{
+    const CAM_APP_AesBackend_t *Backend;
+    size_t                      i;
+
+    pthread_once(&CAM_APP_AesInitOnce, CAM_APP_AesInit);
+
+    for (i = 0; i < CAM_APP_AES_BACKEND_COUNT; i++)
+    {
+        Backend = &CAM_APP_AesBackends[i];
+        if (strcmp(Backend->Name, Name) == 0 && (Backend->Supported == NULL || Backend->Supported()))
+        {
+            CAM_APP_AesActive = Backend;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Expand a 256-bit key into forward and inverse round keys        */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+void CAM_APP_AesExpandKey(CAM_APP_AesSchedule_t *Schedule, const uint8_t *Key)
+{
+    const int KeyWords = CAM_APP_AES_KEY_SIZE / 4;
+    uint32_t  Words[CAM_APP_AES_ROUND_WORDS];
+    uint32_t  Temp;
+    uint8_t   Rcon = 1;
+    int       Round;
+    int       i;
+
+    pthread_once(&CAM_APP_AesInitOnce, CAM_APP_AesInit);
+
+    for (i = 0; i < KeyWords; i++)
+    {
+        Words[i] = CAM_APP_AES_LOAD32(Key + 4 * i);
+    }
+
+    for (i = KeyWords; i < CAM_APP_AES_ROUND_WORDS; i++)
+    {
+        Temp = Words[i - 1];
+        if (i % KeyWords == 0)
+        {
+            Temp = CAM_APP_AesSubWord((Temp << 8) | (Temp >> 24)) ^ ((uint32_t)Rcon << 24);
+            Rcon = CAM_APP_AesMul(Rcon, 2);
+        }
+        else if (i % KeyWords == 4)
+        {
+            Temp = CAM_APP_AesSubWord(Temp);
+        }
+        Words[i] = Words[i - KeyWords] ^ Temp;
+    }
+
+    /* Equivalent inverse cipher: reversed order, InvMixColumns on the inner rounds */
+    for (Round = 0; Round <= CAM_APP_AES_ROUNDS; Round++)
+    {
+        for (i = 0; i < 4; i++)
+        {
+            Temp = Words[4 * Round + i];
+            CAM_APP_AES_STORE32(Schedule->Enc[Round] + 4 * i, Temp);
+
+            Temp = Words[4 * (CAM_APP_AES_ROUNDS - Round) + i];
+            if (Round > 0 && Round < CAM_APP_AES_ROUNDS)
+            {
+                Temp = CAM_APP_AesTd[0][CAM_APP_AesSbox[Temp >> 24]] ^
+                       CAM_APP_AesTd[1][CAM_APP_AesSbox[(Temp >> 16) & 0xff]] ^
+                       CAM_APP_AesTd[2][CAM_APP_AesSbox[(Temp >> 8) & 0xff]] ^
+                       CAM_APP_AesTd[3][CAM_APP_AesSbox[Temp & 0xff]];
+            }
+            CAM_APP_AES_STORE32(Schedule->Dec[Round] + 4 * i, Temp);
+        }
+    }
+
+    memcpy(Schedule->Key, Key, sizeof(Schedule->Key));
+    memset(Words, 0, sizeof(Words));
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Encrypt whole blocks; In and Out may be the same buffer         */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+void CAM_APP_AesEncryptBlocks(const CAM_APP_AesSchedule_t *Schedule, const uint8_t *In, uint8_t *Out, size_t Blocks)
+{
+    CAM_APP_AesActive->Encrypt(Schedule, In, Out, Blocks);
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Decrypt whole blocks; In and Out may be the same buffer         */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+void CAM_APP_AesDecryptBlocks(const CAM_APP_AesSchedule_t *Schedule, const uint8_t *In, uint8_t *Out, size_t Blocks)
+{
+    CAM_APP_AesActive->Decrypt(Schedule, In, Out, Blocks);
+}
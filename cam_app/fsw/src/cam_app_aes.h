@@ -0,0 +1,77 @@
+/************************************************************************
+ * NASA Docket No. GSC-18,719-1, and identified as “core Flight System: Bootes”
+ *
+ * Copyright (c) 2020 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License. You may obtain
+ * a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ************************************************************************/
+
+/**
+ * @file
+ *   This file contains the prototypes for the Cam App AES-256 block cipher
+ *
+ *   The key is expanded once into a schedule holding both the forward
+ *   round keys and the inverse round keys of the equivalent inverse
+ *   cipher; blocks are then processed from the schedule alone.  The
+ *   round lookup tables are shared by every schedule and built on first
+ *   use.  Blocks are plain AES-256 as specified in FIPS-197, checked
+ *   against its known-answer vectors and those of SP 800-38A.
+ *
+ *   Blocks are processed by one of several backends, chosen once at
+ *   startup from what the CPU supports:
+ *
+ *     aesni        x86 AES-NI instructions
+ *     armv8-ce     AArch64 Cryptography Extensions
+ *     neon         AArch64 Advanced SIMD table lookups, for cores without
+ *                  the Cryptography Extensions (e.g. Raspberry Pi 4)
+ *     portable     table-driven C
+ *     security_lib Security_lib's encrypt_data/decrypt_data, only when
+ *                  forced and built with CAM_APP_AES_WITH_SECURITY_LIB
+ *
+ *   Building with CAM_APP_AES_BACKEND defined to one of these names
+ *   forces that backend when the CPU supports it, and
+ *   CAM_APP_AesSelectBackend switches to one at run time so each can be
+ *   checked against the same vectors.  Every backend produces identical
+ *   output.
+ */
+
+#ifndef CAM_APP_AES_H
+#define CAM_APP_AES_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define CAM_APP_AES_BLOCK_SIZE  16 /**< \brief Cipher block size in bytes */
+#define CAM_APP_AES_KEY_SIZE    32 /**< \brief AES-256 key size in bytes */
+#define CAM_APP_AES_ROUNDS      14 /**< \brief Rounds for a 256-bit key */
+#define CAM_APP_AES_ROUND_WORDS (4 * (CAM_APP_AES_ROUNDS + 1))
+
+/*
+** Round keys are kept in cipher byte order so every backend can load them as is
+*/
+typedef struct
+{
+    uint8_t Enc[CAM_APP_AES_ROUNDS + 1][CAM_APP_AES_BLOCK_SIZE]; /**< \brief Forward round keys */
+    uint8_t Dec[CAM_APP_AES_ROUNDS + 1][CAM_APP_AES_BLOCK_SIZE]; /**< \brief Inverse round keys, after InvMixColumns */
+    uint8_t Key[CAM_APP_AES_KEY_SIZE];                           /**< \brief Raw key, for the Security_lib backend */
+} CAM_APP_AesSchedule_t;
+
+const char *CAM_APP_AesBackendName(void);
+bool        CAM_APP_AesSelectBackend(const char *Name);
+
+void CAM_APP_AesExpandKey(CAM_APP_AesSchedule_t *Schedule, const uint8_t *Key);
+void CAM_APP_AesEncryptBlocks(const CAM_APP_AesSchedule_t *Schedule, const uint8_t *In, uint8_t *Out, size_t Blocks);
+void CAM_APP_AesDecryptBlocks(const CAM_APP_AesSchedule_t *Schedule, const uint8_t *In, uint8_t *Out, size_t Blocks);
+
+#endif /* CAM_APP_AES_H */
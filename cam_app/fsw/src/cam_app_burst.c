@@ -0,0 +1,173 @@
+/************************************************************************
+ * NASA Docket No. GSC-18,719-1, and identified as “core Flight System: Bootes”
+ *
+ * Copyright (c) 2020 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License. You may obtain
+ * a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ************************************************************************/
+
+/**
+ * \file
+ *   This file contains the source code for the Cam App burst arena.
+ */
+
+/*
+** Include Files:
+*/
+#include "cam_app_burst.h"
+#include "cam_app_eventids.h"
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct
+{
+    uint8 *Arena;
+    size_t Used;
+    uint32 Count;
+
+    pthread_mutex_t Lock;
+    pthread_cond_t  Returned;
+    uint32          Lent; /* Frames lent out and not yet returned, guarded by Lock */
+
+    CAM_APP_BurstFrame_t Frames[CAM_APP_BURST_MAX_FRAMES];
+} CAM_APP_Burst_t;
+
+static CAM_APP_Burst_t CAM_APP_Burst = {
+    .Lock     = PTHREAD_MUTEX_INITIALIZER,
+    .Returned = PTHREAD_COND_INITIALIZER,
+};
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Allocate the arena once so a burst never waits on the allocator */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+CFE_Status_t CAM_APP_BurstInit(void)
+{
+    if (CAM_APP_Burst.Arena == NULL)
+    {
+        CAM_APP_Burst.Arena = malloc(CAM_APP_BURST_ARENA_SIZE);
+        if (CAM_APP_Burst.Arena == NULL)
+        {
+            CFE_EVS_SendEvent(CAM_APP_SHOT_BURST_ERR_EID, CFE_EVS_EventType_ERROR,
+                              "CAM_APP: Failed to allocate %lu byte burst arena",
+                              (unsigned long)CAM_APP_BURST_ARENA_SIZE);
+            return CFE_STATUS_EXTERNAL_RESOURCE_FAIL;
+        }
+    }
+
+    CAM_APP_BurstReset();
+
+    return CFE_SUCCESS;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Forget the frames of the previous burst                         */
+/*                                                                 */
+/* Waits until the pipeline has returned every frame lent from it; */
+/* the stages always pass a frame on or recycle it, so this ends.  */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+void CAM_APP_BurstReset(void)
+{
+    pthread_mutex_lock(&CAM_APP_Burst.Lock);
+    while (CAM_APP_Burst.Lent > 0)
+    {
+        pthread_cond_wait(&CAM_APP_Burst.Returned, &CAM_APP_Burst.Lock);
+    }
+    pthread_mutex_unlock(&CAM_APP_Burst.Lock);
+
+    CAM_APP_Burst.Used  = 0;
+    CAM_APP_Burst.Count = 0;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Copy a captured frame into the arena                            */
+/*                                                                 */
+/* Returns false when the frame table or the arena is full.        */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+bool CAM_APP_BurstAppend(const CAM_APP_CaptureFrame_t *Frame, const char *Timestamp, uint64 CaptureTimeUs)
+{
+    CAM_APP_BurstFrame_t *Entry;
+
+    if (CAM_APP_Burst.Arena == NULL || CAM_APP_Burst.Count >= CAM_APP_BURST_MAX_FRAMES ||
+        Frame->Size > CAM_APP_BURST_ARENA_SIZE - CAM_APP_Burst.Used)
+    {
+        return false;
+    }
+
+    Entry = &CAM_APP_Burst.Frames[CAM_APP_Burst.Count];
+
+    memcpy(CAM_APP_Burst.Arena + CAM_APP_Burst.Used, Frame->Data, Frame->Size);
+    Entry->Data          = CAM_APP_Burst.Arena + CAM_APP_Burst.Used;
+    Entry->Size          = Frame->Size;
+    Entry->CaptureTimeUs = CaptureTimeUs;
+    strncpy(Entry->Timestamp, Timestamp, sizeof(Entry->Timestamp) - 1);
+    Entry->Timestamp[sizeof(Entry->Timestamp) - 1] = '\0';
+
+    CAM_APP_Burst.Used += Frame->Size;
+    CAM_APP_Burst.Count++;
+
+    return true;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Number of frames held from the current burst                    */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+uint32 CAM_APP_BurstCount(void)
+{
+    return CAM_APP_Burst.Count;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Lend a held frame by capture order; its bytes stay valid until  */
+/* CAM_APP_BurstReturn is called for it                            */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+const CAM_APP_BurstFrame_t *CAM_APP_BurstLend(uint32 Index)
+{
+    if (Index >= CAM_APP_Burst.Count)
+    {
+        return NULL;
+    }
+
+    pthread_mutex_lock(&CAM_APP_Burst.Lock);
+    CAM_APP_Burst.Lent++;
+    pthread_mutex_unlock(&CAM_APP_Burst.Lock);
+
+    return &CAM_APP_Burst.Frames[Index];
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Give back a lent frame; may be called from any stage            */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+void CAM_APP_BurstReturn(void)
+{
+    pthread_mutex_lock(&CAM_APP_Burst.Lock);
+    CAM_APP_Burst.Lent--;
+    if (CAM_APP_Burst.Lent == 0)
+    {
+        pthread_cond_broadcast(&CAM_APP_Burst.Returned);
+    }
+    pthread_mutex_unlock(&CAM_APP_Burst.Lock);
+}
@@ -0,0 +1,59 @@
+/************************************************************************
+ * NASA Docket No. GSC-18,719-1, and identified as “core Flight System: Bootes”
+ *
+ * Copyright (c) 2020 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License. You may obtain
+ * a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ************************************************************************/
+
+/**
+ * @file
+ *   This file contains the prototypes for the Cam App burst arena
+ *
+ *   A burst captures frames back to back, faster than encryption and
+ *   storage can keep up, so the frames are first packed into one arena
+ *   allocated at init and only fed downstream once the burst is over.
+ *   The arena is filled by the capture stage alone.  Frames are lent to
+ *   the pipeline in place, and the next burst waits until every one of
+ *   them has been returned.
+ */
+
+#ifndef CAM_APP_BURST_H
+#define CAM_APP_BURST_H
+
+/*
+** Required header files.
+*/
+#include "cam_app.h"
+#include "cam_app_capture.h"
+
+/*
+** A frame held in the burst arena
+*/
+typedef struct
+{
+    const uint8 *Data;          /**< \brief Frame bytes inside the arena */
+    size_t       Size;          /**< \brief Number of valid bytes at Data */
+    uint64       CaptureTimeUs; /**< \brief Capture wall time, microseconds since the Unix epoch */
+    char         Timestamp[24]; /**< \brief Capture wall time, YYYYMMDD_HH:MM:SS.mmm */
+} CAM_APP_BurstFrame_t;
+
+CFE_Status_t                CAM_APP_BurstInit(void);
+void                        CAM_APP_BurstReset(void);
+bool                        CAM_APP_BurstAppend(const CAM_APP_CaptureFrame_t *Frame, const char *Timestamp,
+                                                uint64 CaptureTimeUs);
+uint32                      CAM_APP_BurstCount(void);
+const CAM_APP_BurstFrame_t *CAM_APP_BurstLend(uint32 Index);
+void                        CAM_APP_BurstReturn(void);
+
+#endif /* CAM_APP_BURST_H */
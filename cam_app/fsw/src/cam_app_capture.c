@@ -0,0 +1,221 @@
+/************************************************************************
+ * NASA Docket No. GSC-18,719-1, and identified as “core Flight System: Bootes”
+ *
+ * Copyright (c) 2020 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License. You may obtain
+ * a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ************************************************************************/
+
+/**
+ * \file
+ *   This file contains the source code for the Cam App capture backend selection.
+ */
+
+/*
+** Include Files:
+*/
+#include "cam_app.h"
+#include "cam_app_capture.h"
+#include "cam_app_eventids.h"
+
+#include <stdatomic.h>
+
+/*
+** Known backends, looked up by name
+*/
+static const CAM_APP_CaptureBackend_t *const CAM_APP_CaptureBackends[] = {
+    &CAM_APP_CaptureV4L2,
+    &CAM_APP_CaptureStream,
+    &CAM_APP_CaptureShell,
+};
+
+/*
+** Backend of the running capture session, NULL when closed
+*/
+static const CAM_APP_CaptureBackend_t *CAM_APP_CaptureActive;
+
+/*
+** Frames dequeued and not yet requeued; requeues may come from any stage
+*/
+static atomic_uint CAM_APP_CaptureHeld;
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Open and start one backend                                      */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+static CFE_Status_t CAM_APP_CaptureTryBackend(const CAM_APP_CaptureBackend_t *Backend)
+{
+    CFE_Status_t Status;
+
+    Status = Backend->Open();
+    if (Status == CFE_SUCCESS)
+    {
+        Status = Backend->Start();
+        if (Status != CFE_SUCCESS)
+        {
+            Backend->Close();
+        }
+    }
+
+    if (Status == CFE_SUCCESS)
+    {
+        CAM_APP_CaptureActive = Backend;
+        atomic_store(&CAM_APP_CaptureHeld, 0);
+    }
+    else
+    {
+        CFE_EVS_SendEvent(CAM_APP_CAPTURE_ERR_EID, CFE_EVS_EventType_ERROR,
+                          "CAM_APP: Capture backend '%s' failed to start, RC = 0x%08lX", Backend->Name,
+                          (unsigned long)Status);
+    }
+
+    return Status;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Open the named backend, falling back to the shell backend       */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+CFE_Status_t CAM_APP_CaptureOpen(const char *BackendName)
+{
+    CFE_Status_t                    Status  = CFE_STATUS_EXTERNAL_RESOURCE_FAIL;
+    const CAM_APP_CaptureBackend_t *Backend = NULL;
+    size_t                          i;
+
+    if (CAM_APP_CaptureActive != NULL)
+    {
+        return CFE_STATUS_INCORRECT_STATE;
+    }
+
+    for (i = 0; i < sizeof(CAM_APP_CaptureBackends) / sizeof(CAM_APP_CaptureBackends[0]); i++)
+    {
+        if (strcmp(CAM_APP_CaptureBackends[i]->Name, BackendName) == 0)
+        {
+            Backend = CAM_APP_CaptureBackends[i];
+            break;
+        }
+    }
+
+    if (Backend == NULL)
+    {
+        CFE_EVS_SendEvent(CAM_APP_CAPTURE_ERR_EID, CFE_EVS_EventType_ERROR, "CAM_APP: Unknown capture backend '%s'",
+                          BackendName);
+    }
+    else
+    {
+        Status = CAM_APP_CaptureTryBackend(Backend);
+    }
+
+    if (Status != CFE_SUCCESS && Backend != &CAM_APP_CaptureShell)
+    {
+        Status = CAM_APP_CaptureTryBackend(&CAM_APP_CaptureShell);
+    }
+
+    return Status;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Take the next frame from the active backend                     */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+CFE_Status_t CAM_APP_CaptureDequeue(CAM_APP_CaptureFrame_t *Frame)
+{
+    CFE_Status_t Status;
+
+    if (CAM_APP_CaptureActive == NULL)
+    {
+        return CFE_STATUS_INCORRECT_STATE;
+    }
+
+    Status = CAM_APP_CaptureActive->Dequeue(Frame);
+    if (Status == CFE_SUCCESS)
+    {
+        atomic_fetch_add(&CAM_APP_CaptureHeld, 1);
+    }
+
+    return Status;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Return a frame to the active backend                            */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+CFE_Status_t CAM_APP_CaptureRequeue(const CAM_APP_CaptureFrame_t *Frame)
+{
+    if (CAM_APP_CaptureActive == NULL)
+    {
+        return CFE_STATUS_INCORRECT_STATE;
+    }
+
+    atomic_fetch_sub(&CAM_APP_CaptureHeld, 1);
+
+    return CAM_APP_CaptureActive->Requeue(Frame);
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Report whether the frame just dequeued may be kept while more   */
+/* are taken                                                       */
+/*                                                                 */
+/* Only the capture stage dequeues, so the count can only fall     */
+/* between this check and its next dequeue.                        */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+bool CAM_APP_CaptureMayHold(void)
+{
+    if (CAM_APP_CaptureActive == NULL)
+    {
+        return false;
+    }
+
+    return atomic_load(&CAM_APP_CaptureHeld) <= CAM_APP_CaptureActive->MaxHeld();
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Stop and close the active backend                               */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+void CAM_APP_CaptureClose(void)
+{
+    if (CAM_APP_CaptureActive != NULL)
+    {
+        CAM_APP_CaptureActive->Stop();
+        CAM_APP_CaptureActive->Close();
+        CAM_APP_CaptureActive = NULL;
+    }
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Report whether a capture session is active                      */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+bool CAM_APP_CaptureIsOpen(void)
+{
+    return CAM_APP_CaptureActive != NULL;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Name of the active backend, for events                          */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+const char *CAM_APP_CaptureBackendName(void)
+{
+    return (CAM_APP_CaptureActive != NULL) ? CAM_APP_CaptureActive->Name : "none";
+}
@@ -0,0 +1,77 @@
+/************************************************************************
+ * NASA Docket No. GSC-18,719-1, and identified as “core Flight System: Bootes”
+ *
+ * Copyright (c) 2020 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License. You may obtain
+ * a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ************************************************************************/
+
+/**
+ * @file
+ *   This file contains the capture backend interface for the Cam App
+ *
+ *   A backend is opened once, started, and then hands out frames with
+ *   Dequeue until it is stopped.  Every dequeued frame must be given back
+ *   with Requeue before the backend may reuse its memory.  Up to MaxHeld
+ *   frames may stay out while more are dequeued, so a consumer can read
+ *   them in place on another thread; any more must be requeued before the
+ *   next dequeue.  Requeue may be called from any thread.
+ */
+
+#ifndef CAM_APP_CAPTURE_H
+#define CAM_APP_CAPTURE_H
+
+/*
+** Required header files.
+*/
+#include "cam_app.h"
+
+/*
+** A captured frame, owned by the backend until it is requeued
+*/
+typedef struct
+{
+    const uint8 *Data;  /**< \brief Frame bytes, valid until requeue */
+    size_t       Size;  /**< \brief Number of valid bytes at Data */
+    uint32       Index; /**< \brief Backend buffer index, passed back on requeue */
+} CAM_APP_CaptureFrame_t;
+
+/*
+** Capture backend operations
+*/
+typedef struct
+{
+    const char *Name;
+
+    CFE_Status_t (*Open)(void);
+    CFE_Status_t (*Start)(void);
+    CFE_Status_t (*Dequeue)(CAM_APP_CaptureFrame_t *Frame);
+    CFE_Status_t (*Requeue)(const CAM_APP_CaptureFrame_t *Frame);
+    CFE_Status_t (*Stop)(void);
+    void (*Close)(void);
+    uint32 (*MaxHeld)(void); /* Frames that may stay dequeued while the next is taken */
+} CAM_APP_CaptureBackend_t;
+
+extern const CAM_APP_CaptureBackend_t CAM_APP_CaptureV4L2;
+extern const CAM_APP_CaptureBackend_t CAM_APP_CaptureStream;
+extern const CAM_APP_CaptureBackend_t CAM_APP_CaptureShell;
+
+CFE_Status_t CAM_APP_CaptureOpen(const char *BackendName);
+CFE_Status_t CAM_APP_CaptureDequeue(CAM_APP_CaptureFrame_t *Frame);
+CFE_Status_t CAM_APP_CaptureRequeue(const CAM_APP_CaptureFrame_t *Frame);
+bool         CAM_APP_CaptureMayHold(void);
+void         CAM_APP_CaptureClose(void);
+bool         CAM_APP_CaptureIsOpen(void);
+const char  *CAM_APP_CaptureBackendName(void);
+
+#endif /* CAM_APP_CAPTURE_H */
@@ -0,0 +1,186 @@
+/************************************************************************
+ * NASA Docket No. GSC-18,719-1, and identified as “core Flight System: Bootes”
+ *
+ * Copyright (c) 2020 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License. You may obtain
+ * a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ************************************************************************/
+
+/**
+ * \file
+ *   This file contains the source code for the Cam App "shell" capture backend.
+ *
+ *   This is the original capture path: every dequeue launches the still
+ *   capture command, which writes a JPEG file that is then mapped and
+ *   handed out as the frame until it is requeued.  It needs no camera
+ *   access of its own and is used as the fallback when the selected
+ *   backend cannot be opened.
+ *
+ *   The file is unlinked once mapped, so the next shot writes a new one
+ *   and a few shots can stay mapped while the pipeline reads them.
+ */
+
+/*
+** Include Files:
+*/
+#include "cam_app.h"
+#include "cam_app_capture.h"
+#include "cam_app_eventids.h"
+
+#include "common_fnc.h"
+
+#include <stdatomic.h>
+#include <unistd.h>
+
+/*
+** Shots that may be mapped at once
+*/
+#define CAM_APP_SHELL_SHOTS 4
+
+static mapped_file_t CAM_APP_ShellFiles[CAM_APP_SHELL_SHOTS]; /* Shots mapped until they are requeued */
+static atomic_bool   CAM_APP_ShellInUse[CAM_APP_SHELL_SHOTS]; /* Set while the shot at the same index is out */
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Check the profile can be shot this way                          */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+static CFE_Status_t CAM_APP_ShellOpen(void)
+{
+    if (CAM_APP_Data.Profile.Format != CAM_APP_CAPTURE_FORMAT_MJPEG)
+    {
+        CFE_EVS_SendEvent(CAM_APP_CAPTURE_ERR_EID, CFE_EVS_EventType_ERROR,
+                          "CAM_APP: Shell capture only produces JPEG");
+        return CFE_STATUS_EXTERNAL_RESOURCE_FAIL;
+    }
+
+    return CFE_SUCCESS;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Nothing to start; the camera is launched per frame              */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+static CFE_Status_t CAM_APP_ShellStart(void)
+{
+    return CFE_SUCCESS;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Run the still capture command and map its output file           */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+static CFE_Status_t CAM_APP_ShellDequeue(CAM_APP_CaptureFrame_t *Frame)
+{
+    char   Command[256];
+    uint32 i;
+
+    /* Requeues may come from other stages, so a free entry is looked up first */
+    i = 0;
+    while (i < CAM_APP_SHELL_SHOTS && atomic_load(&CAM_APP_ShellInUse[i]))
+    {
+        i++;
+    }
+
+    if (i == CAM_APP_SHELL_SHOTS)
+    {
+        return CFE_STATUS_INCORRECT_STATE;
+    }
+
+    snprintf(Command, sizeof(Command), CAM_APP_CAPTURE_SHELL_CMD, CAM_APP_CAPTURE_SHELL_FILE,
+             CAM_APP_Data.Profile.WarmupMs, CAM_APP_Data.Profile.Width, CAM_APP_Data.Profile.Height,
+             CAM_APP_Data.Profile.Quality);
+
+    if (system(Command) != 0)
+    {
+        return CFE_STATUS_EXTERNAL_RESOURCE_FAIL;
+    }
+
+    /* Empty files cannot be mapped and fail here too */
+    if (!map_file(&CAM_APP_ShellFiles[i], CAM_APP_CAPTURE_SHELL_FILE))
+    {
+        return CFE_STATUS_EXTERNAL_RESOURCE_FAIL;
+    }
+
+    /* The mapping outlives the name, so the next shot cannot overwrite it */
+    unlink(CAM_APP_CAPTURE_SHELL_FILE);
+    atomic_store(&CAM_APP_ShellInUse[i], true);
+
+    Frame->Data  = CAM_APP_ShellFiles[i].data;
+    Frame->Size  = CAM_APP_ShellFiles[i].size;
+    Frame->Index = i;
+
+    return CFE_SUCCESS;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Unmap the shot, freeing its entry for another                   */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+static CFE_Status_t CAM_APP_ShellRequeue(const CAM_APP_CaptureFrame_t *Frame)
+{
+    unmap_file(&CAM_APP_ShellFiles[Frame->Index]);
+    atomic_store(&CAM_APP_ShellInUse[Frame->Index], false);
+
+    return CFE_SUCCESS;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Nothing to stop                                                 */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+static CFE_Status_t CAM_APP_ShellStop(void)
+{
+    return CFE_SUCCESS;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Drop shots that were never requeued                             */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+static void CAM_APP_ShellClose(void)
+{
+    uint32 i;
+
+    for (i = 0; i < CAM_APP_SHELL_SHOTS; i++)
+    {
+        unmap_file(&CAM_APP_ShellFiles[i]);
+        atomic_store(&CAM_APP_ShellInUse[i], false);
+    }
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* All but one entry may be held, leaving room for the next shot   */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+static uint32 CAM_APP_ShellMaxHeld(void)
+{
+    return CAM_APP_SHELL_SHOTS - 1;
+}
+
+const CAM_APP_CaptureBackend_t CAM_APP_CaptureShell = {
+    .Name    = "shell",
+    .Open    = CAM_APP_ShellOpen,
+    .Start   = CAM_APP_ShellStart,
+    .Dequeue = CAM_APP_ShellDequeue,
+    .Requeue = CAM_APP_ShellRequeue,
+    .Stop    = CAM_APP_ShellStop,
+    .Close   = CAM_APP_ShellClose,
+    .MaxHeld = CAM_APP_ShellMaxHeld,
+};
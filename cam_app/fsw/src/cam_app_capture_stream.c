@@ -0,0 +1,416 @@
+/************************************************************************
+ * NASA Docket No. GSC-18,719-1, and identified as “core Flight System: Bootes”
+ *
+ * Copyright (c) 2020 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License. You may obtain
+ * a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ************************************************************************/
+
+/**
+ * \file
+ *   This file contains the source code for the Cam App "stream" capture backend.
+ *
+ *   The camera is started once as a streaming child process that writes
+ *   MJPEG to a pipe.  Each dequeue only splits the next frame out of the
+ *   pipe, instead of launching a new camera process per shot.
+ *
+ *   The pipe is drained on every dequeue, so its frames are no older than
+ *   the previous dequeue.  When that was more than two frame periods ago
+ *   they are all thrown away and the next frame to arrive is taken.  Any
+ *   frames still queued inside the camera process itself may come first;
+ *   those cannot be told apart from new ones.
+ */
+
+/*
+** Include Files:
+*/
+#include "cam_app.h"
+#include "cam_app_capture.h"
+#include "cam_app_eventids.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+typedef struct
+{
+    pid_t  Pid;
+    int    Fd;
+    uint8 *Buffer;     /* Stream reassembly buffer, room for two frames of the active profile */
+    size_t BufferSize; /* Bytes allocated at Buffer */
+    size_t Fill;       /* Number of valid bytes in Buffer */
+    size_t FrameSize;  /* Bytes of the frame handed out by dequeue, discarded on requeue */
+    uint64 DrainedNs;  /* Monotonic time the pipe was last read empty */
+} CAM_APP_StreamSession_t;
+
+static CAM_APP_StreamSession_t CAM_APP_StreamSession = {.Pid = -1, .Fd = -1};
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Locate the first complete JPEG (SOI .. EOI) in the buffer       */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+static bool CAM_APP_StreamFindFrame(const uint8 *Buf, size_t Len, size_t *Start, size_t *End)
+{
+    size_t i;
+    bool   InFrame = false;
+
+    for (i = 0; i + 1 < Len; i++)
+    {
+        if (Buf[i] != 0xFF)
+        {
+            continue;
+        }
+
+        if (!InFrame && Buf[i + 1] == 0xD8)
+        {
+            *Start  = i;
+            InFrame = true;
+            i++;
+        }
+        else if (InFrame && Buf[i + 1] == 0xD9)
+        {
+            *End = i + 2;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Monotonic time in nanoseconds                                   */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+static uint64 CAM_APP_StreamNowNs(void)
+{
+    struct timespec Now;
+
+    clock_gettime(CLOCK_MONOTONIC, &Now);
+
+    return (uint64)Now.tv_sec * 1000000000ULL + (uint64)Now.tv_nsec;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Drop the first Count bytes of the reassembly buffer             */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+static void CAM_APP_StreamDiscard(size_t Count)
+{
+    CAM_APP_StreamSession_t *Session = &CAM_APP_StreamSession;
+
+    if (Count >= Session->Fill)
+    {
+        Session->Fill = 0;
+    }
+    else
+    {
+        memmove(Session->Buffer, Session->Buffer + Count, Session->Fill - Count);
+        Session->Fill -= Count;
+    }
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Read whatever the stream has ready without blocking             */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+static CFE_Status_t CAM_APP_StreamDrain(void)
+{
+    CAM_APP_StreamSession_t *Session = &CAM_APP_StreamSession;
+    ssize_t                  Count;
+    size_t                   Start;
+    size_t                   End;
+
+    while (1)
+    {
+        if (Session->Fill == Session->BufferSize)
+        {
+            /* Full: make room by dropping the oldest frame, or everything if no frame fits */
+            if (CAM_APP_StreamFindFrame(Session->Buffer, Session->Fill, &Start, &End))
+            {
+                CAM_APP_StreamDiscard(End);
+            }
+            else
+            {
+                Session->Fill = 0;
+            }
+        }
+
+        Count = read(Session->Fd, Session->Buffer + Session->Fill, Session->BufferSize - Session->Fill);
+        if (Count > 0)
+        {
+            Session->Fill += Count;
+        }
+        else if (Count < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        else if (Count < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+        {
+            Session->DrainedNs = CAM_APP_StreamNowNs();
+            return CFE_SUCCESS;
+        }
+        else
+        {
+            /* End of stream or read error: the camera process is gone */
+            return CFE_STATUS_EXTERNAL_RESOURCE_FAIL;
+        }
+    }
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Allocate the reassembly buffer                                  */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+static CFE_Status_t CAM_APP_StreamOpen(void)
+{
+    CAM_APP_StreamSession_t *Session = &CAM_APP_StreamSession;
+
+    if (CAM_APP_Data.Profile.Format != CAM_APP_CAPTURE_FORMAT_MJPEG)
+    {
+        CFE_EVS_SendEvent(CAM_APP_CAPTURE_ERR_EID, CFE_EVS_EventType_ERROR,
+                          "CAM_APP: Stream capture only produces MJPEG");
+        return CFE_STATUS_EXTERNAL_RESOURCE_FAIL;
+    }
+
+    if (Session->Buffer == NULL)
+    {
+        Session->BufferSize = 2 * (size_t)CAM_APP_Data.FrameBufferSize;
+        Session->Buffer     = malloc(Session->BufferSize);
+        if (Session->Buffer == NULL)
+        {
+            CFE_EVS_SendEvent(CAM_APP_CAPTURE_ERR_EID, CFE_EVS_EventType_ERROR,
+                              "CAM_APP: Failed to allocate capture buffer");
+            return CFE_STATUS_EXTERNAL_RESOURCE_FAIL;
+        }
+    }
+
+    return CFE_SUCCESS;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Start the streaming camera process                              */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+static CFE_Status_t CAM_APP_StreamStart(void)
+{
+    CAM_APP_StreamSession_t *Session = &CAM_APP_StreamSession;
+    char                     Command[256];
+    int                      PipeFds[2];
+    pid_t                    Pid;
+
+    if (Session->Pid > 0)
+    {
+        return CFE_STATUS_INCORRECT_STATE;
+    }
+
+    snprintf(Command, sizeof(Command), CAM_APP_CAPTURE_STREAM_CMD, CAM_APP_Data.Profile.Width,
+             CAM_APP_Data.Profile.Height, CAM_APP_Data.Profile.FrameRate, CAM_APP_Data.Profile.Quality);
+
+    if (pipe(PipeFds) != 0)
+    {
+        CFE_EVS_SendEvent(CAM_APP_CAPTURE_ERR_EID, CFE_EVS_EventType_ERROR,
+                          "CAM_APP: Failed to create capture pipe, errno = %d", errno);
+        return CFE_STATUS_EXTERNAL_RESOURCE_FAIL;
+    }
+
+    Pid = fork();
+    if (Pid == 0)
+    {
+        /* Child: stream frames to the write end of the pipe */
+        dup2(PipeFds[1], STDOUT_FILENO);
+        close(PipeFds[0]);
+        close(PipeFds[1]);
+        execl("/bin/sh", "sh", "-c", Command, (char *)NULL);
+        _exit(127);
+    }
+
+    close(PipeFds[1]);
+
+    if (Pid < 0)
+    {
+        close(PipeFds[0]);
+        CFE_EVS_SendEvent(CAM_APP_CAPTURE_ERR_EID, CFE_EVS_EventType_ERROR,
+                          "CAM_APP: Failed to start camera stream, errno = %d", errno);
+        return CFE_STATUS_EXTERNAL_RESOURCE_FAIL;
+    }
+
+    fcntl(PipeFds[0], F_SETFL, fcntl(PipeFds[0], F_GETFL) | O_NONBLOCK);
+    fcntl(PipeFds[0], F_SETFD, FD_CLOEXEC);
+
+    Session->Pid       = Pid;
+    Session->Fd        = PipeFds[0];
+    Session->Fill      = 0;
+    Session->FrameSize = 0;
+    Session->DrainedNs = CAM_APP_StreamNowNs();
+
+    return CFE_SUCCESS;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Return the most recent complete frame from the stream           */
+/*                                                                 */
+/* The frame points into the reassembly buffer and stays valid     */
+/* until it is requeued.  A backlog that may have sat in the pipe  */
+/* since before the last shot is discarded in favour of the next   */
+/* frame.                                                          */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+static CFE_Status_t CAM_APP_StreamDequeue(CAM_APP_CaptureFrame_t *Frame)
+{
+    CAM_APP_StreamSession_t *Session = &CAM_APP_StreamSession;
+    CFE_Status_t             Status;
+    struct pollfd            Pfd;
+    size_t                   Start;
+    size_t                   End;
+    size_t                   NextStart;
+    size_t                   NextEnd;
+    bool                     Fresh;
+    int                      Ready;
+
+    if (Session->Fd < 0 || Session->FrameSize != 0)
+    {
+        /* Not streaming, or the previous frame has not been requeued */
+        return CFE_STATUS_INCORRECT_STATE;
+    }
+
+    Pfd.fd     = Session->Fd;
+    Pfd.events = POLLIN;
+    Fresh      = CAM_APP_StreamNowNs() - Session->DrainedNs <= 2000000000ULL / CAM_APP_Data.Profile.FrameRate;
+
+    while (1)
+    {
+        Status = CAM_APP_StreamDrain();
+        if (Status != CFE_SUCCESS)
+        {
+            return Status;
+        }
+
+        if (!Fresh)
+        {
+            /* The rest of a stale frame may still follow; with no start marker it is skipped */
+            Session->Fill = 0;
+            Fresh         = true;
+        }
+        else if (CAM_APP_StreamFindFrame(Session->Buffer, Session->Fill, &Start, &End))
+        {
+            /* Skip stale frames so the shot reflects the current scene */
+            while (CAM_APP_StreamFindFrame(Session->Buffer + End, Session->Fill - End, &NextStart, &NextEnd))
+            {
+                CAM_APP_StreamDiscard(End);
+                CAM_APP_StreamFindFrame(Session->Buffer, Session->Fill, &Start, &End);
+            }
+
+            CAM_APP_StreamDiscard(Start);
+            Session->FrameSize = End - Start;
+
+            Frame->Data  = Session->Buffer;
+            Frame->Size  = Session->FrameSize;
+            Frame->Index = 0;
+            return CFE_SUCCESS;
+        }
+
+        Ready = poll(&Pfd, 1, CAM_APP_CAPTURE_TIMEOUT_MSEC);
+        if (Ready == 0 || (Ready < 0 && errno != EINTR))
+        {
+            /* No frame within the timeout: the camera has stalled */
+            return CFE_STATUS_EXTERNAL_RESOURCE_FAIL;
+        }
+    }
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Give the dequeued frame back to the stream                      */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+static CFE_Status_t CAM_APP_StreamRequeue(const CAM_APP_CaptureFrame_t *Frame)
+{
+    CAM_APP_StreamSession_t *Session = &CAM_APP_StreamSession;
+
+    CAM_APP_StreamDiscard(Session->FrameSize);
+    Session->FrameSize = 0;
+
+    return CFE_SUCCESS;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Stop the streaming camera process                               */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+static CFE_Status_t CAM_APP_StreamStop(void)
+{
+    CAM_APP_StreamSession_t *Session = &CAM_APP_StreamSession;
+
+    if (Session->Fd >= 0)
+    {
+        close(Session->Fd);
+        Session->Fd = -1;
+    }
+
+    if (Session->Pid > 0)
+    {
+        kill(Session->Pid, SIGTERM);
+        waitpid(Session->Pid, NULL, 0);
+        Session->Pid = -1;
+    }
+
+    Session->Fill      = 0;
+    Session->FrameSize = 0;
+
+    return CFE_SUCCESS;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Release the reassembly buffer                                   */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+static void CAM_APP_StreamClose(void)
+{
+    free(CAM_APP_StreamSession.Buffer);
+    CAM_APP_StreamSession.Buffer = NULL;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* The next frame is reassembled over the last, so none is held    */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+static uint32 CAM_APP_StreamMaxHeld(void)
+{
+    return 0;
+}
+
+const CAM_APP_CaptureBackend_t CAM_APP_CaptureStream = {
+    .Name    = "stream",
+    .Open    = CAM_APP_StreamOpen,
+    .Start   = CAM_APP_StreamStart,
+    .Dequeue = CAM_APP_StreamDequeue,
+    .Requeue = CAM_APP_StreamRequeue,
+    .Stop    = CAM_APP_StreamStop,
+    .Close   = CAM_APP_StreamClose,
+    .MaxHeld = CAM_APP_StreamMaxHeld,
+};
+
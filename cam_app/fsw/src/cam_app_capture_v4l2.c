@@ -0,0 +1,453 @@
+/************************************************************************
+ * NASA Docket No. GSC-18,719-1, and identified as “core Flight System: Bootes”
+ *
+ * Copyright (c) 2020 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License. You may obtain
+ * a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ************************************************************************/
+
+/**
+ * \file
+ *   This file contains the source code for the Cam App "v4l2" capture backend.
+ *
+ *   Frames are captured into kernel buffers that are mmap'd once at open.
+ *   A dequeued frame points straight into the mapped buffer, so no copy is
+ *   made in user space; the buffer goes back to the driver on requeue.
+ *   All but two buffers may be held at once, so the driver always has one
+ *   to fill while the newest filled one waits to be dequeued.
+ */
+
+/*
+** Include Files:
+*/
+#include "cam_app.h"
+#include "cam_app_capture.h"
+#include "cam_app_eventids.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <time.h>
+#include <unistd.h>
+#include <linux/videodev2.h>
+
+typedef struct
+{
+    void  *Start;
+    size_t Length;
+} CAM_APP_V4L2Buffer_t;
+
+typedef struct
+{
+    int                  Fd;
+    uint32               BufferCount;
+    uint64               FramePeriodNs; /* Frame interval the driver settled on */
+    CAM_APP_V4L2Buffer_t Buffers[CAM_APP_CAPTURE_V4L2_BUFFERS];
+} CAM_APP_V4L2Session_t;
+
+static CAM_APP_V4L2Session_t CAM_APP_V4L2Session = {.Fd = -1};
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Map a capture profile format to its V4L2 pixel format           */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+static uint32 CAM_APP_V4L2PixelFormat(uint8 Format)
+{
+    return (Format == CAM_APP_CAPTURE_FORMAT_YUYV) ? V4L2_PIX_FMT_YUYV : V4L2_PIX_FMT_MJPEG;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* ioctl wrapper that restarts on signals                          */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+static int CAM_APP_V4L2Ioctl(unsigned long Request, void *Arg)
+{
+    int Result;
+
+    do
+    {
+        Result = ioctl(CAM_APP_V4L2Session.Fd, Request, Arg);
+    } while (Result < 0 && errno == EINTR);
+
+    return Result;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Release the mapped buffers and the device                       */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+static void CAM_APP_V4L2Close(void)
+{
+    CAM_APP_V4L2Session_t     *Session = &CAM_APP_V4L2Session;
+    struct v4l2_requestbuffers Req;
+    uint32                     i;
+
+    for (i = 0; i < Session->BufferCount; i++)
+    {
+        munmap(Session->Buffers[i].Start, Session->Buffers[i].Length);
+    }
+    Session->BufferCount = 0;
+
+    if (Session->Fd >= 0)
+    {
+        memset(&Req, 0, sizeof(Req));
+        Req.type   = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+        Req.memory = V4L2_MEMORY_MMAP;
+        CAM_APP_V4L2Ioctl(VIDIOC_REQBUFS, &Req);
+
+        close(Session->Fd);
+        Session->Fd = -1;
+    }
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Open the device, set the format and map the streaming buffers   */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+static CFE_Status_t CAM_APP_V4L2Open(void)
+{
+    CAM_APP_V4L2Session_t     *Session = &CAM_APP_V4L2Session;
+    struct v4l2_capability     Cap;
+    struct v4l2_format         Fmt;
+    struct v4l2_streamparm     Parm;
+    struct v4l2_requestbuffers Req;
+    struct v4l2_buffer         Buf;
+    struct v4l2_control        Ctrl;
+    uint32                     PixelFormat = CAM_APP_V4L2PixelFormat(CAM_APP_Data.Profile.Format);
+    uint32                     i;
+
+    Session->Fd = open(CAM_APP_CAPTURE_V4L2_DEVICE, O_RDWR | O_NONBLOCK | O_CLOEXEC);
+    if (Session->Fd < 0)
+    {
+        CFE_EVS_SendEvent(CAM_APP_CAPTURE_ERR_EID, CFE_EVS_EventType_ERROR, "CAM_APP: Cannot open %s, errno = %d",
+                          CAM_APP_CAPTURE_V4L2_DEVICE, errno);
+        return CFE_STATUS_EXTERNAL_RESOURCE_FAIL;
+    }
+
+    memset(&Cap, 0, sizeof(Cap));
+    if (CAM_APP_V4L2Ioctl(VIDIOC_QUERYCAP, &Cap) < 0 || (Cap.capabilities & V4L2_CAP_VIDEO_CAPTURE) == 0 ||
+        (Cap.capabilities & V4L2_CAP_STREAMING) == 0)
+    {
+        CFE_EVS_SendEvent(CAM_APP_CAPTURE_ERR_EID, CFE_EVS_EventType_ERROR,
+                          "CAM_APP: %s is not a streaming capture device", CAM_APP_CAPTURE_V4L2_DEVICE);
+        CAM_APP_V4L2Close();
+        return CFE_STATUS_EXTERNAL_RESOURCE_FAIL;
+    }
+
+    memset(&Fmt, 0, sizeof(Fmt));
+    Fmt.type                = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+    Fmt.fmt.pix.width       = CAM_APP_Data.Profile.Width;
+    Fmt.fmt.pix.height      = CAM_APP_Data.Profile.Height;
+    Fmt.fmt.pix.pixelformat = PixelFormat;
+    Fmt.fmt.pix.field       = V4L2_FIELD_NONE;
+    if (CAM_APP_V4L2Ioctl(VIDIOC_S_FMT, &Fmt) < 0 || Fmt.fmt.pix.pixelformat != PixelFormat)
+    {
+        CFE_EVS_SendEvent(CAM_APP_CAPTURE_ERR_EID, CFE_EVS_EventType_ERROR,
+                          "CAM_APP: %s does not support the configured pixel format", CAM_APP_CAPTURE_V4L2_DEVICE);
+        CAM_APP_V4L2Close();
+        return CFE_STATUS_EXTERNAL_RESOURCE_FAIL;
+    }
+
+    /* Frame rate is advisory; not every driver supports it */
+    memset(&Parm, 0, sizeof(Parm));
+    Parm.type                                  = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+    Parm.parm.capture.timeperframe.numerator   = 1;
+    Parm.parm.capture.timeperframe.denominator = CAM_APP_Data.Profile.FrameRate;
+    if (CAM_APP_V4L2Ioctl(VIDIOC_S_PARM, &Parm) == 0 && Parm.parm.capture.timeperframe.denominator != 0)
+    {
+        Session->FramePeriodNs = 1000000000ULL * Parm.parm.capture.timeperframe.numerator /
+                                 Parm.parm.capture.timeperframe.denominator;
+    }
+    else
+    {
+        Session->FramePeriodNs = 1000000000ULL / CAM_APP_Data.Profile.FrameRate;
+    }
+
+    /* So is JPEG quality, which only encoding devices expose */
+    memset(&Ctrl, 0, sizeof(Ctrl));
+    Ctrl.id    = V4L2_CID_JPEG_COMPRESSION_QUALITY;
+    Ctrl.value = CAM_APP_Data.Profile.Quality;
+    CAM_APP_V4L2Ioctl(VIDIOC_S_CTRL, &Ctrl);
+
+    memset(&Req, 0, sizeof(Req));
+    Req.count  = CAM_APP_CAPTURE_V4L2_BUFFERS;
+    Req.type   = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+    Req.memory = V4L2_MEMORY_MMAP;
+    if (CAM_APP_V4L2Ioctl(VIDIOC_REQBUFS, &Req) < 0 || Req.count < 2)
+    {
+        CFE_EVS_SendEvent(CAM_APP_CAPTURE_ERR_EID, CFE_EVS_EventType_ERROR,
+                          "CAM_APP: %s cannot allocate mmap buffers", CAM_APP_CAPTURE_V4L2_DEVICE);
+        CAM_APP_V4L2Close();
+        return CFE_STATUS_EXTERNAL_RESOURCE_FAIL;
+    }
+
+    if (Req.count > CAM_APP_CAPTURE_V4L2_BUFFERS)
+    {
+        Req.count = CAM_APP_CAPTURE_V4L2_BUFFERS;
+    }
+
+    for (i = 0; i < Req.count; i++)
+    {
+        memset(&Buf, 0, sizeof(Buf));
+        Buf.type   = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+        Buf.memory = V4L2_MEMORY_MMAP;
+        Buf.index  = i;
+        if (CAM_APP_V4L2Ioctl(VIDIOC_QUERYBUF, &Buf) < 0)
+        {
+            break;
+        }
+
+        Session->Buffers[i].Length = Buf.length;
+        Session->Buffers[i].Start =
+            mmap(NULL, Buf.length, PROT_READ | PROT_WRITE, MAP_SHARED, Session->Fd, Buf.m.offset);
+        if (Session->Buffers[i].Start == MAP_FAILED)
+        {
+            break;
+        }
+
+        Session->BufferCount++;
+    }
+
+    if (Session->BufferCount != Req.count)
+    {
+        CFE_EVS_SendEvent(CAM_APP_CAPTURE_ERR_EID, CFE_EVS_EventType_ERROR,
+                          "CAM_APP: Failed to map buffer %lu of %s, errno = %d", (unsigned long)Session->BufferCount,
+                          CAM_APP_CAPTURE_V4L2_DEVICE, errno);
+        CAM_APP_V4L2Close();
+        return CFE_STATUS_EXTERNAL_RESOURCE_FAIL;
+    }
+
+    return CFE_SUCCESS;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Hand one buffer back to the driver                              */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+static CFE_Status_t CAM_APP_V4L2QueueBuffer(uint32 Index)
+{
+    struct v4l2_buffer Buf;
+
+    memset(&Buf, 0, sizeof(Buf));
+    Buf.type   = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+    Buf.memory = V4L2_MEMORY_MMAP;
+    Buf.index  = Index;
+
+    if (CAM_APP_V4L2Ioctl(VIDIOC_QBUF, &Buf) < 0)
+    {
+        return CFE_STATUS_EXTERNAL_RESOURCE_FAIL;
+    }
+
+    return CFE_SUCCESS;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Queue every buffer and turn streaming on                        */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+static CFE_Status_t CAM_APP_V4L2Start(void)
+{
+    enum v4l2_buf_type Type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+    uint32             i;
+
+    for (i = 0; i < CAM_APP_V4L2Session.BufferCount; i++)
+    {
+        if (CAM_APP_V4L2QueueBuffer(i) != CFE_SUCCESS)
+        {
+            return CFE_STATUS_EXTERNAL_RESOURCE_FAIL;
+        }
+    }
+
+    if (CAM_APP_V4L2Ioctl(VIDIOC_STREAMON, &Type) < 0)
+    {
+        CFE_EVS_SendEvent(CAM_APP_CAPTURE_ERR_EID, CFE_EVS_EventType_ERROR,
+                          "CAM_APP: %s failed to start streaming, errno = %d", CAM_APP_CAPTURE_V4L2_DEVICE, errno);
+        return CFE_STATUS_EXTERNAL_RESOURCE_FAIL;
+    }
+
+    return CFE_SUCCESS;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Check a filled buffer was captured within the last two frame    */
+/* periods                                                         */
+/*                                                                 */
+/* Buffers without a monotonic timestamp cannot be aged and are    */
+/* never taken as fresh.                                           */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+static bool CAM_APP_V4L2IsFresh(const struct v4l2_buffer *Buf)
+{
+    struct timespec Now;
+    uint64          NowNs;
+    uint64          TakenNs;
+
+    if ((Buf->flags & V4L2_BUF_FLAG_TIMESTAMP_MASK) != V4L2_BUF_FLAG_TIMESTAMP_MONOTONIC)
+    {
+        return false;
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &Now);
+    NowNs   = (uint64)Now.tv_sec * 1000000000ULL + (uint64)Now.tv_nsec;
+    TakenNs = (uint64)Buf->timestamp.tv_sec * 1000000000ULL + (uint64)Buf->timestamp.tv_usec * 1000ULL;
+
+    return NowNs < TakenNs || NowNs - TakenNs <= 2 * CAM_APP_V4L2Session.FramePeriodNs;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Dequeue the newest filled buffer                                */
+/*                                                                 */
+/* Older filled buffers are requeued right away.  When the shot    */
+/* period is longer than the driver's queue lasts, even the newest */
+/* may have waited there since before the last shot; it is then    */
+/* requeued too and the next frame the driver fills is taken       */
+/* instead.  Either way the shot reflects the current scene.       */
+/* Buffers the driver flags as corrupted are requeued and skipped. */
+/* Every buffer dequeued here is either returned or requeued, even */
+/* on failure, so none drops out of the driver's queue.            */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+static CFE_Status_t CAM_APP_V4L2Dequeue(CAM_APP_CaptureFrame_t *Frame)
+{
+    struct v4l2_buffer Buf;
+    struct pollfd      Pfd;
+    bool               Have   = false;
+    bool               Fresh  = false;
+    bool               Waited = false;
+    uint32             Index;
+    uint32             BytesUsed;
+    int                Ready;
+
+    Pfd.fd     = CAM_APP_V4L2Session.Fd;
+    Pfd.events = POLLIN;
+
+    while (1)
+    {
+        memset(&Buf, 0, sizeof(Buf));
+        Buf.type   = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+        Buf.memory = V4L2_MEMORY_MMAP;
+
+        if (CAM_APP_V4L2Ioctl(VIDIOC_DQBUF, &Buf) == 0)
+        {
+            if ((Buf.flags & V4L2_BUF_FLAG_ERROR) != 0)
+            {
+                CAM_APP_V4L2QueueBuffer(Buf.index);
+                continue;
+            }
+
+            if (Have)
+            {
+                CAM_APP_V4L2QueueBuffer(Index);
+            }
+
+            /* Anything filled after the wait began was captured since the call */
+            Have      = true;
+            Fresh     = Waited || CAM_APP_V4L2IsFresh(&Buf);
+            Index     = Buf.index;
+            BytesUsed = Buf.bytesused;
+            continue;
+        }
+
+        if (errno != EAGAIN)
+        {
+            if (Have)
+            {
+                CAM_APP_V4L2QueueBuffer(Index);
+            }
+            return CFE_STATUS_EXTERNAL_RESOURCE_FAIL;
+        }
+
+        if (Have && Fresh)
+        {
+            break;
+        }
+
+        if (Have)
+        {
+            CAM_APP_V4L2QueueBuffer(Index);
+            Have = false;
+        }
+
+        Ready  = poll(&Pfd, 1, CAM_APP_CAPTURE_TIMEOUT_MSEC);
+        Waited = true;
+        if (Ready == 0 || (Ready < 0 && errno != EINTR))
+        {
+            /* No frame within the timeout: the camera has stalled */
+            return CFE_STATUS_EXTERNAL_RESOURCE_FAIL;
+        }
+    }
+
+    Frame->Data  = CAM_APP_V4L2Session.Buffers[Index].Start;
+    Frame->Size  = BytesUsed;
+    Frame->Index = Index;
+
+    return CFE_SUCCESS;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Give the frame's buffer back to the driver                      */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+static CFE_Status_t CAM_APP_V4L2Requeue(const CAM_APP_CaptureFrame_t *Frame)
+{
+    return CAM_APP_V4L2QueueBuffer(Frame->Index);
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Turn streaming off; the driver reclaims all buffers             */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+static CFE_Status_t CAM_APP_V4L2Stop(void)
+{
+    enum v4l2_buf_type Type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+
+    if (CAM_APP_V4L2Ioctl(VIDIOC_STREAMOFF, &Type) < 0)
+    {
+        return CFE_STATUS_EXTERNAL_RESOURCE_FAIL;
+    }
+
+    return CFE_SUCCESS;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Buffers that may be held while the driver keeps streaming       */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+static uint32 CAM_APP_V4L2MaxHeld(void)
+{
+    return CAM_APP_V4L2Session.BufferCount > 2 ? CAM_APP_V4L2Session.BufferCount - 2 : 0;
+}
+
+const CAM_APP_CaptureBackend_t CAM_APP_CaptureV4L2 = {
+    .Name    = "v4l2",
+    .Open    = CAM_APP_V4L2Open,
+    .Start   = CAM_APP_V4L2Start,
+    .Dequeue = CAM_APP_V4L2Dequeue,
+    .Requeue = CAM_APP_V4L2Requeue,
+    .Stop    = CAM_APP_V4L2Stop,
+    .Close   = CAM_APP_V4L2Close,
+    .MaxHeld = CAM_APP_V4L2MaxHeld,
+};
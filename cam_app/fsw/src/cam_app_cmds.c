@@ -32,16 +32,14 @@
 #include "cam_app_tbl.h"
 #include "cam_app_utils.h"
 #include "cam_app_msg.h"
-
-/* The cam_lib module provides the CAM_Function() prototype */
-#include "time.h"
-#include "unistd.h"
-#include "pthread.h"
-#include <stdbool.h>
-
-/* Encypt Library */
-#include "common_fnc.h"
-#include "security.h"
+#include "cam_app_capture.h"
+#include "cam_app_crypto.h"
+#include "cam_app_pipeline.h"
+#include "cam_app_writer.h"
+#include "cam_app_segment.h"
+#include "cam_app_retention.h"
+#include "cam_app_downlink.h"
+#include "cam_app_histogram.h"
 
 
 /* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
@@ -62,6 +60,49 @@ CFE_Status_t CAM_APP_SendHkCmd(const CAM_APP_SendHkCmd_t *Msg)
     CAM_APP_Data.HkTlm.Payload.CommandErrorCounter = CAM_APP_Data.ErrCounter;
     CAM_APP_Data.HkTlm.Payload.CommandCounter      = CAM_APP_Data.CmdCounter;
 
+    /*
+    ** Get capture scheduling counters...
+    */
+    CAM_APP_Data.HkTlm.Payload.MissedDeadlines = CAM_APP_PipelineMissedDeadlines();
+    CAM_APP_PipelineFrameCounts(&CAM_APP_Data.HkTlm.Payload.FramesCaptured, &CAM_APP_Data.HkTlm.Payload.FramesEncrypted,
+                                &CAM_APP_Data.HkTlm.Payload.FramesStored, &CAM_APP_Data.HkTlm.Payload.FramesFailed,
+                                &CAM_APP_Data.HkTlm.Payload.FramesDropped);
+    CAM_APP_PipelineLatencies(&CAM_APP_Data.HkTlm.Payload.CaptureLastUs, &CAM_APP_Data.HkTlm.Payload.CaptureAvgUs,
+                              &CAM_APP_Data.HkTlm.Payload.EncryptLastUs, &CAM_APP_Data.HkTlm.Payload.EncryptAvgUs,
+                              &CAM_APP_Data.HkTlm.Payload.EncryptKbPerSec);
+    CAM_APP_PipelineQueueDepths(&CAM_APP_Data.HkTlm.Payload.CryptoQueueDepth,
+                                &CAM_APP_Data.HkTlm.Payload.StorageQueueDepth);
+    CAM_APP_PipelineVerifyCounts(&CAM_APP_Data.HkTlm.Payload.FramesVerified,
+                                 &CAM_APP_Data.HkTlm.Payload.VerifyMismatches,
+                                 &CAM_APP_Data.HkTlm.Payload.VerifySkipped);
+
+    /*
+    ** Get storage writer statistics...
+    */
+    CAM_APP_WriterStats(&CAM_APP_Data.HkTlm.Payload.WriteQueueDepth, &CAM_APP_Data.HkTlm.Payload.WriteQueuePeak,
+                        &CAM_APP_Data.HkTlm.Payload.WriteLatencyAvgUs, &CAM_APP_Data.HkTlm.Payload.WriteLatencyMaxUs,
+                        &CAM_APP_Data.HkTlm.Payload.WriteErrors, &CAM_APP_Data.HkTlm.Payload.WrittenKb);
+
+    /*
+    ** Get storage retention statistics...
+    */
+    CAM_APP_RetentionStats(&CAM_APP_Data.HkTlm.Payload.FreeSpaceKb, &CAM_APP_Data.HkTlm.Payload.RetainedKb,
+                           &CAM_APP_Data.HkTlm.Payload.FilesEvicted, &CAM_APP_Data.HkTlm.Payload.EvictedKb);
+
+    /*
+    ** Get durability commit times...
+    */
+    CAM_APP_WriterSyncStats(&CAM_APP_Data.HkTlm.Payload.SyncFileAvgUs, &CAM_APP_Data.HkTlm.Payload.SyncFileMaxUs,
+                            &CAM_APP_Data.HkTlm.Payload.SyncGroupAvgUs, &CAM_APP_Data.HkTlm.Payload.SyncGroupMaxUs,
+                            &CAM_APP_Data.HkTlm.Payload.SyncGroupFiles);
+
+    /*
+    ** Get image telemetry statistics...
+    */
+    CAM_APP_DownlinkStats(&CAM_APP_Data.HkTlm.Payload.ImageChunksSent, &CAM_APP_Data.HkTlm.Payload.ImageChunkErrors,
+                          &CAM_APP_Data.HkTlm.Payload.DownlinkBacklog, &CAM_APP_Data.HkTlm.Payload.DownlinkThrottles,
+                          &CAM_APP_Data.HkTlm.Payload.DownlinkDropped);
+
     /*
     ** Send housekeeping telemetry packet...
     */
@@ -76,6 +117,44 @@ CFE_Status_t CAM_APP_SendHkCmd(const CAM_APP_SendHkCmd_t *Msg)
         CFE_TBL_Manage(CAM_APP_Data.TblHandles[i]);
     }
 
+    CAM_APP_CaptureTableUpdate();
+
+    return CFE_SUCCESS;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* Send the latency percentiles of each pipeline stage                        */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+CFE_Status_t CAM_APP_SendLatencyCmd(const CAM_APP_SendLatencyCmd_t *Msg)
+{
+    CAM_APP_LatencyTlm_Payload_t *Payload = &CAM_APP_Data.LatencyTlm.Payload;
+
+    CAM_APP_HistogramSummary(CAM_APP_LATENCY_FRAME, &Payload->Frame);
+    CAM_APP_HistogramSummary(CAM_APP_LATENCY_CAPTURE, &Payload->Capture);
+    CAM_APP_HistogramSummary(CAM_APP_LATENCY_ENCRYPT, &Payload->Encrypt);
+    CAM_APP_HistogramSummary(CAM_APP_LATENCY_WRITE, &Payload->Write);
+    CAM_APP_HistogramSummary(CAM_APP_LATENCY_COMMIT, &Payload->Commit);
+
+    CFE_SB_TimeStampMsg(CFE_MSG_PTR(CAM_APP_Data.LatencyTlm.TelemetryHeader));
+    CFE_SB_TransmitMsg(CFE_MSG_PTR(CAM_APP_Data.LatencyTlm.TelemetryHeader), true);
+
+    CAM_APP_Data.CmdCounter++;
+
+    return CFE_SUCCESS;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* Send queued image telemetry within the downlink budget                     */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+CFE_Status_t CAM_APP_WakeupCmd(const CAM_APP_WakeupCmd_t *Msg)
+{
+    // 스케줄러 주기 신호이므로 명령 카운터는 올리지 않음
+    CAM_APP_DownlinkWakeup();
+
     return CFE_SUCCESS;
 }
 
@@ -105,6 +184,11 @@ CFE_Status_t CAM_APP_ResetCountersCmd(const CAM_APP_ResetCountersCmd_t *Msg)
 {
     CAM_APP_Data.CmdCounter = 0;
     CAM_APP_Data.ErrCounter = 0;
+    CAM_APP_PipelineResetCounters();
+    CAM_APP_WriterResetStats();
+    CAM_APP_RetentionResetStats();
+    CAM_APP_DownlinkResetStats();
+    CAM_APP_HistogramReset();
 
     CFE_EVS_SendEvent(CAM_APP_RESET_INF_EID, CFE_EVS_EventType_INFORMATION, "CAM: RESET command");
 
@@ -119,12 +203,13 @@ CFE_Status_t CAM_APP_ResetCountersCmd(const CAM_APP_ResetCountersCmd_t *Msg)
 /* * * * * * * * * * * * * * * * * * * * * * * *  * * * * * * *  * *  * * * * */
 CFE_Status_t CAM_APP_ProcessCmd(const CAM_APP_ProcessCmd_t *Msg)
 {
-    CFE_Status_t               status;
-    void *                     TblAddr;
-    CAM_APP_ExampleTable_t *TblPtr;
-    const char *               TableName = "CAM_APP.ExampleTable";
+    CFE_Status_t                    status;
+    void *                          TblAddr;
+    CAM_APP_CaptureTable_t *        TblPtr;
+    const CAM_APP_CaptureProfile_t *Profile;
+    const char *                    TableName = "CAM_APP.CaptureTable";
 
-    /* Cam Use of Example Table */
+    /* Cam Use of Capture Table */
 
     status = CFE_TBL_GetAddress(&TblAddr, CAM_APP_Data.TblHandles[0]);
 
@@ -134,8 +219,13 @@ CFE_Status_t CAM_APP_ProcessCmd(const CAM_APP_ProcessCmd_t *Msg)
         return status;
     }
 
-    TblPtr = TblAddr;
-    CFE_ES_WriteToSysLog("Cam App: Example Table Value 1: %d  Value 2: %d", TblPtr->Int1, TblPtr->Int2);
+    TblPtr  = TblAddr;
+    Profile = &TblPtr->Profiles[TblPtr->ActiveProfile];
+    CFE_ES_WriteToSysLog("Cam App: Capture Table profile %u '%s': %ux%u @ %u fps, format %u, quality %u, "
+                         "period %lu ms, storage %u, stages 0x%02x, verify 1/%u%s",
+                         TblPtr->ActiveProfile, Profile->Name, Profile->Width, Profile->Height, Profile->FrameRate,
+                         Profile->Format, Profile->Quality, (unsigned long)Profile->PeriodMs, Profile->StorageMode,
+                         Profile->Stages, Profile->VerifyInterval, CAM_APP_Data.ProfilePending ? " (pending)" : "");
 
     CAM_APP_GetCrc(TableName);
 
@@ -165,46 +255,64 @@ CFE_Status_t CAM_APP_DisplayParamCmd(const CAM_APP_DisplayParamCmd_t *Msg)
 
 /* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
 /*                                                                            */
-/* A simple example command that Setting Shot Period                          */
+/* Set the time between shot deadlines, in milliseconds                       */
 /*                                                                            */
 /* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
 
-uint16 Period = 10;
-
 CFE_Status_t CAM_APP_ShotPeriodCmd(const CAM_APP_ShotPeriodCmd_t *Msg)
 {
+    if (Msg->Payload.PeriodMs < CAM_APP_MIN_SHOT_PERIOD_MS)
+    {
+        CAM_APP_Data.ErrCounter++;
+        CFE_EVS_SendEvent(CAM_APP_SHOT_PERIOD_ERR_EID, CFE_EVS_EventType_ERROR,
+                          "CAM_APP: Shot Period %lu(ms) is below the %lu(ms) minimum",
+                          (unsigned long)Msg->Payload.PeriodMs, (unsigned long)CAM_APP_MIN_SHOT_PERIOD_MS);
+        return CFE_STATUS_RANGE_ERROR;
+    }
+
+    /* 다음 촬영 마감 시각부터 새 주기 적용 */
+    atomic_store(&CAM_APP_Data.ShotPeriodMs, Msg->Payload.PeriodMs);
+    CAM_APP_Data.CmdCounter++;
+
     CFE_EVS_SendEvent(CAM_APP_SHOT_PERIOD_INF_EID, CFE_EVS_EventType_INFORMATION,
-                      "CAM_APP: Shot Period is set to %d(sec)", (int)Msg->Payload.Period);
-    
-    Period = (int)Msg->Payload.Period;
-    return Period;
+                      "CAM_APP: Shot Period is set to %lu(ms)", (unsigned long)Msg->Payload.PeriodMs);
 
     return CFE_SUCCESS; 
 }
 
-byte Global_Security_Key[32] = {0x30 ,0x30 ,0x30 ,0x30 ,0x30 ,0x30 ,0x30 ,0x30 ,0x30 ,0x30 ,0x30 ,0x30 ,0x30 ,0x30 ,0x30 ,0x30 ,0x30 ,0x30 ,0x30 ,0x30 ,0x30 ,0x30 ,0x30 ,0x30 ,0x30 ,0x30 ,0x30 ,0x30 ,0x30 ,0x30 ,0x30 ,0x30 };  // 전역 변수로 선언하여 키를 저장
-
 CFE_Status_t CAM_APP_SecurityKeyCmd(const CAM_APP_SecurityKeyCmd_t *Msg)
 {
     // 수신한 키를 이벤트 로그에 출력
-    char received_key_string[96] = {0};
+    char received_key_string[32 * 3 + 1] = {0};
     for (int i = 0; i < 32; i++)
     {
-        sprintf(&received_key_string[i * 3], "%02x ", Msg->Payload.Key[i]);
+        sprintf(&received_key_string[i * 3], "%02x ", (uint8)Msg->Payload.Key[i]);
     }
 
-    // 수신한 키를 전역 변수에 저장
-    memcpy(Global_Security_Key, Msg->Payload.Key, sizeof(Global_Security_Key));
+    // 키 스케줄을 한 번만 확장해 두고, 프레임마다 재확장하지 않음
+    CAM_APP_CryptoKey_t *Key = CAM_APP_CryptoKeyCreate((const uint8 *)Msg->Payload.Key);
+    if (Key == NULL)
+    {
+        CAM_APP_Data.ErrCounter++;
+        CFE_EVS_SendEvent(CAM_APP_SECURITY_KEY_INF_EID, CFE_EVS_EventType_ERROR,
+                          "CAM_APP: Failed to allocate key context, previous key kept");
+        return CFE_STATUS_EXTERNAL_RESOURCE_FAIL;
+    }
+
+    // 수신한 키를 전역 변수에 저장하고 활성 키 교체
+    // (처리 중인 프레임은 이전 키로 끝까지 암호화되므로 촬영을 멈출 필요 없음)
+    memcpy(CAM_APP_Data.SecurityKey, Msg->Payload.Key, sizeof(CAM_APP_Data.SecurityKey));
+    CAM_APP_CryptoKeyInstall(Key);
 
     // 저장된 키를 이벤트 로그에 출력
-    char stored_key_string[96] = {0};
+    char stored_key_string[32 * 3 + 1] = {0};
     for (int i = 0; i < 32; i++)
     {
-        sprintf(&stored_key_string[i * 3], "%02x ", Global_Security_Key[i]);
+        sprintf(&stored_key_string[i * 3], "%02x ", CAM_APP_Data.SecurityKey[i]);
     }
 
     // 수신된 키와 저장된 키를 비교
-    if (memcmp(Msg->Payload.Key, Global_Security_Key, sizeof(Global_Security_Key)) == 0)
+    if (memcmp(Msg->Payload.Key, CAM_APP_Data.SecurityKey, sizeof(CAM_APP_Data.SecurityKey)) == 0)
     {
         CFE_EVS_SendEvent(CAM_APP_SECURITY_KEY_INF_EID, CFE_EVS_EventType_INFORMATION,
                           "CAM_APP: Security Key has been successfully stored and verified.");
@@ -216,10 +324,10 @@ CFE_Status_t CAM_APP_SecurityKeyCmd(const CAM_APP_SecurityKeyCmd_t *Msg)
     }
 
     // 최종적으로 저장된 키 값을 출력
-    char final_key_string[96] = {0};
+    char final_key_string[32 * 3 + 1] = {0};
     for (int i = 0; i < 32; i++)
     {
-        sprintf(&final_key_string[i * 3], "%02x ", Global_Security_Key[i]);
+        sprintf(&final_key_string[i * 3], "%02x ", CAM_APP_Data.SecurityKey[i]);
     }
     CFE_EVS_SendEvent(CAM_APP_SECURITY_KEY_INF_EID, CFE_EVS_EventType_INFORMATION,
                       "CAM_APP: Final Key: [%s]", final_key_string);
@@ -229,172 +337,287 @@ CFE_Status_t CAM_APP_SecurityKeyCmd(const CAM_APP_SecurityKeyCmd_t *Msg)
 
 /* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
 /*                                                                            */
-/* A Cam_app Start, Stop Process to using thread                              */
+/* Select where captured frames live between capture and encryption           */
 /*                                                                            */
 /* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+CFE_Status_t CAM_APP_SetStorageModeCmd(const CAM_APP_SetStorageModeCmd_t *Msg)
+{
+    static const char *const ModeNames[] = {"FILE", "MEMORY", "SEGMENT"};
+
+    if (Msg->Payload.Mode != CAM_APP_STORAGE_MODE_FILE && Msg->Payload.Mode != CAM_APP_STORAGE_MODE_MEMORY &&
+        Msg->Payload.Mode != CAM_APP_STORAGE_MODE_SEGMENT)
+    {
+        CAM_APP_Data.ErrCounter++;
+        CFE_EVS_SendEvent(CAM_APP_STORAGE_MODE_ERR_EID, CFE_EVS_EventType_ERROR,
+                          "CAM_APP: Invalid storage mode %u", (unsigned int)Msg->Payload.Mode);
+        return CFE_STATUS_RANGE_ERROR;
+    }
 
+    atomic_store(&CAM_APP_Data.StorageMode, Msg->Payload.Mode);
+    CAM_APP_Data.CmdCounter++;
 
-int Stop_Command;
-int Start_Security_Command;
-pthread_t thread;
+    CFE_EVS_SendEvent(CAM_APP_STORAGE_MODE_INF_EID, CFE_EVS_EventType_INFORMATION, "CAM_APP: Storage mode set to %s",
+                      ModeNames[Msg->Payload.Mode]);
 
-#define BLOCK_SIZE 16
+    return CFE_SUCCESS;
+}
 
-void *startloop(void *arg)
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* Select how many stored files are read back and checked                     */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+CFE_Status_t CAM_APP_SetVerifyCmd(const CAM_APP_SetVerifyCmd_t *Msg)
 {
-    while (1)
+    /* 촬영 중에도 바로 적용, 다음에 저장되는 파일부터 */
+    atomic_store(&CAM_APP_Data.VerifyInterval, Msg->Payload.Interval);
+    CAM_APP_Data.CmdCounter++;
+
+    if (Msg->Payload.Interval == 0)
     {
-        if (Stop_Command == 1)
-        {
-            break;
-        }
-        else
-        {
-            time_t t = time(NULL);
-            struct tm *now = localtime(&t);
-
-            char timestamp[20];
-            strftime(timestamp, sizeof(timestamp), "%Y%m%d_%H:%M:%S", now);
-
-            char original_filename[100];
-            sprintf(original_filename, "/home/cansat/Photo/Original_Photo/photo_%s.jpeg", timestamp);
-
-            char command[200];
-            sprintf(command, "libcamera-still -o %s -t 1000 --width 320 --height 240", original_filename);
-
-            printf("Executing command: %s\n", command);
-
-            system(command);
-
-            if (Start_Security_Command == 1)
-            {
-                // 이미지 데이터 읽기
-                byte* data = NULL;
-                size_t size = 0;
-                if (!read_image_data(&data, &size, original_filename))
-                {
-                    printf("Failed to read image data\n");
-                    continue;
-                }
-
-                // 패딩 추가
-                pad_data(&data, &size);
-                printf("Padding added to data\n");
-                CFE_EVS_SendEvent(CAM_APP_SECURITY_PROCESSING_INF_EID, CFE_EVS_EventType_INFORMATION,
-                                  "CAM_APP: Padding added to data");
-
-                // 암호화 키
-                byte round_keys[(Nr+1) * Nb];
-
-                // 암호화 진행
-                encrypt_data(data, size, Global_Security_Key, round_keys);
-                printf("Data encryption completed\n");
-                CFE_EVS_SendEvent(CAM_APP_SECURITY_PROCESSING_INF_EID, CFE_EVS_EventType_INFORMATION,
-                                  "CAM_APP: Data encryption completed");
-
-                // 암호화된 데이터를 16진수 문자열로 변환하여 별도의 파일에 저장
-                char encrypted_filename[100];
-                sprintf(encrypted_filename, "/home/cansat/Photo/Encrypt_Photo/encrypted_photo_%s.enc", timestamp);
-
-                FILE *encrypted_file = fopen(encrypted_filename, "w");
-                if (encrypted_file != NULL) 
-                {
-                    for (size_t i = 0; i < size; i++) 
-                    {
-                        fprintf(encrypted_file, "%02x", data[i]);
-                    }
-                    fclose(encrypted_file);
-                    printf("Encrypted data saved: %s\n", encrypted_filename);
-                    CFE_EVS_SendEvent(CAM_APP_SECURITY_PROCESSING_INF_EID, CFE_EVS_EventType_INFORMATION,
-                                      "CAM_APP: Encrypted data saved: %s", encrypted_filename);
-                } 
-                else 
-                {
-                    printf("Failed to open encrypted file: %s\n", encrypted_filename);
-                    CFE_EVS_SendEvent(CAM_APP_SECURITY_PROCESSING_INF_EID, CFE_EVS_EventType_ERROR,
-                                      "CAM_APP: Failed to open encrypted file: %s", encrypted_filename);
-                    free(data);
-                    continue;
-                }
-
-                
-                // 복호화
-                byte* encrypted_data = NULL;
-                size_t encrypted_size = 0;
-                read_encrypted_data(&encrypted_data, &encrypted_size, encrypted_filename);
-                if (encrypted_data != NULL)
-                {
-                    printf("Encrypted data read successfully: %s\n", encrypted_filename);                   
-                }
-                else
-                {
-                    printf("Failed to read encrypted data: %s\n", encrypted_filename);
-                    free(data);
-                    continue;
-                }
-
-                // 복호화 진행
-                decrypt_data(encrypted_data, encrypted_size, Global_Security_Key, round_keys);
-                printf("Data decryption completed\n");                
-
-                // 패딩 제거
-                unpad_data(&encrypted_data, &encrypted_size);
-                printf("Padding removed from data\n");
-
-                // 복호화된 데이터를 파일로 저장
-                char decrypted_filename[100];
-                sprintf(decrypted_filename, "/home/cansat/Photo/Decrypt_Photo/decrypted_photo_%s.jpeg", timestamp);
-                write_image_data(encrypted_data, encrypted_size, decrypted_filename);
-                printf("Decrypted data saved: %s\n", decrypted_filename);
-                
-
-                // 메모리 해제
-                free(data);
-                //free(encrypted_data);
-            }
-
-            sleep(Period);
-        }
+        CFE_EVS_SendEvent(CAM_APP_VERIFY_INF_EID, CFE_EVS_EventType_INFORMATION, "CAM_APP: Verification off");
+    }
+    else
+    {
+        CFE_EVS_SendEvent(CAM_APP_VERIFY_INF_EID, CFE_EVS_EventType_INFORMATION,
+                          "CAM_APP: Verifying every %u encrypted file(s)", Msg->Payload.Interval);
+    }
+
+    return CFE_SUCCESS;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* Copy one frame out of the segment log into a file of its own               */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+CFE_Status_t CAM_APP_ExtractFrameCmd(const CAM_APP_ExtractFrameCmd_t *Msg)
+{
+    char         Name[CAM_APP_SEGMENT_NAME_LEN + 64];
+    CFE_Status_t status;
+
+    /* 기록 중인 세그먼트도 읽기만 하므로 촬영 중에도 가능, 결과는 이벤트로 보고 */
+    status = CAM_APP_SegmentExtract(CAM_APP_Data.PhotoDir, Msg->Payload.Segment, Msg->Payload.Sequence, Name,
+                                    sizeof(Name));
+    if (status == CFE_SUCCESS)
+    {
+        CAM_APP_Data.CmdCounter++;
+    }
+    else
+    {
+        CAM_APP_Data.ErrCounter++;
+    }
+
+    return status;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* Select when stored files are synced to the card                            */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+CFE_Status_t CAM_APP_SetDurabilityCmd(const CAM_APP_SetDurabilityCmd_t *Msg)
+{
+    if (Msg->Payload.Policy > CAM_APP_DURABILITY_GROUP ||
+        (Msg->Payload.Policy == CAM_APP_DURABILITY_GROUP &&
+         (Msg->Payload.GroupFiles == 0 || Msg->Payload.GroupFiles > CAM_APP_WRITER_MAX_PENDING ||
+          Msg->Payload.GroupMs == 0)))
+    {
+        CAM_APP_Data.ErrCounter++;
+        CFE_EVS_SendEvent(CAM_APP_DURABILITY_ERR_EID, CFE_EVS_EventType_ERROR,
+                          "CAM_APP: Invalid durability policy %u, group of %u file(s) or %lu ms",
+                          (unsigned int)Msg->Payload.Policy, (unsigned int)Msg->Payload.GroupFiles,
+                          (unsigned long)Msg->Payload.GroupMs);
+        return CFE_STATUS_RANGE_ERROR;
+    }
+
+    /* 쓰기 스레드는 촬영 시작 시 정책을 받으므로 다음 촬영부터 적용 */
+    atomic_store(&CAM_APP_Data.Durability, Msg->Payload.Policy);
+    if (Msg->Payload.Policy == CAM_APP_DURABILITY_GROUP)
+    {
+        CAM_APP_Data.GroupFiles = Msg->Payload.GroupFiles;
+        CAM_APP_Data.GroupMs    = Msg->Payload.GroupMs;
     }
-    pthread_exit(NULL); 
+    CAM_APP_Data.CmdCounter++;
+
+    if (Msg->Payload.Policy == CAM_APP_DURABILITY_GROUP)
+    {
+        CFE_EVS_SendEvent(CAM_APP_DURABILITY_INF_EID, CFE_EVS_EventType_INFORMATION,
+                          "CAM_APP: Durability set to group, %u file(s) or %lu ms, from the next shot start",
+                          (unsigned int)CAM_APP_Data.GroupFiles, (unsigned long)CAM_APP_Data.GroupMs);
+    }
+    else
+    {
+        CFE_EVS_SendEvent(CAM_APP_DURABILITY_INF_EID, CFE_EVS_EventType_INFORMATION,
+                          "CAM_APP: Durability set to %s from the next shot start",
+                          CAM_APP_WriterDurabilityName(Msg->Payload.Policy));
+    }
+
+    return CFE_SUCCESS;
 }
 
-void stoploop(void)
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* Set the image telemetry budget                                             */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+CFE_Status_t CAM_APP_SetDownlinkCmd(const CAM_APP_SetDownlinkCmd_t *Msg)
 {
-    Stop_Command = 1;
+    CFE_Status_t status;
+
+    status = CAM_APP_DownlinkSetRate(Msg->Payload.RateBytesPerSec, Msg->Payload.BurstBytes);
+    if (status != CFE_SUCCESS)
+    {
+        CAM_APP_Data.ErrCounter++;
+        CFE_EVS_SendEvent(CAM_APP_DOWNLINK_ERR_EID, CFE_EVS_EventType_ERROR,
+                          "CAM_APP: Invalid downlink burst %lu bytes, must hold a %lu byte packet",
+                          (unsigned long)Msg->Payload.BurstBytes, (unsigned long)sizeof(CAM_APP_ImageTlm_t));
+        return status;
+    }
+
+    CAM_APP_Data.CmdCounter++;
+    CFE_EVS_SendEvent(CAM_APP_DOWNLINK_INF_EID, CFE_EVS_EventType_INFORMATION,
+                      "CAM_APP: Downlink set to %lu bytes/s, burst %lu bytes",
+                      (unsigned long)Msg->Payload.RateBytesPerSec, (unsigned long)Msg->Payload.BurstBytes);
+
+    return CFE_SUCCESS;
 }
 
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* Open the camera and start the capture pipeline                             */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+static CFE_Status_t CAM_APP_ShotOpen(bool Periodic)
+{
+    CFE_Status_t status;
 
+    /* 카메라는 촬영 시작 시 한 번만 열고 정지할 때까지 스트리밍 유지 */
+    status = CAM_APP_CaptureOpen(CAM_APP_CAPTURE_BACKEND);
+    if (status != CFE_SUCCESS)
+    {
+        CFE_EVS_SendEvent(CAM_APP_CAPTURE_ERR_EID, CFE_EVS_EventType_ERROR,
+                          "CAM: Failed to open camera stream, RC = 0x%08lX", (unsigned long)status);
+        return status;
+    }
 
+    status = CAM_APP_PipelineStart(Periodic);
+    if (status != CFE_SUCCESS)
+    {
+        CFE_EVS_SendEvent(CAM_APP_PIPELINE_ERR_EID, CFE_EVS_EventType_ERROR,
+                          "CAM: Failed to start capture pipeline, RC = 0x%08lX", (unsigned long)status);
+        CAM_APP_CaptureClose();
+    }
 
+    return status;
+}
 
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* A Cam_app Start, Stop Process to using the capture pipeline                */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
 CFE_Status_t CAM_APP_ShotStartCmd(const CAM_APP_ShotStartCmd_t *Msg)
 {    
-    Stop_Command = 0;
+    CFE_Status_t status;
 
-    if(pthread_create(&thread, NULL, startloop, NULL))
+    if (CAM_APP_PipelineIsPeriodic())
+    {
+        CFE_EVS_SendEvent(CAM_APP_CAPTURE_ERR_EID, CFE_EVS_EventType_ERROR, "CAM: Image Shot already running");
+        return CFE_STATUS_INCORRECT_STATE;
+    }
+
+    /* 버스트용으로 이미 열려 있으면 주기 촬영만 켠다 */
+    if (CAM_APP_PipelineIsRunning())
+    {
+        CAM_APP_PipelineSetPeriodic(true);
+    }
+    else
     {
-        perror("pthread_Create");
-        exit(EXIT_FAILURE);
+        status = CAM_APP_ShotOpen(true);
+        if (status != CFE_SUCCESS)
+        {
+            return status;
+        }
     }
     
-    CFE_EVS_SendEvent(CAM_APP_SHOT_START_INF_EID, CFE_EVS_EventType_INFORMATION, "CAM: Image Shot Start");
+    CFE_EVS_SendEvent(CAM_APP_SHOT_START_INF_EID, CFE_EVS_EventType_INFORMATION, "CAM: Image Shot Start (%s capture)",
+                      CAM_APP_CaptureBackendName());
     return CFE_SUCCESS; 
 
 }
 
 CFE_Status_t CAM_APP_ShotStopCmd(const CAM_APP_ShotStopCmd_t *Msg)
 {
-    stoploop();
-    pthread_join(thread, NULL);
+    if (!CAM_APP_PipelineIsRunning())
+    {
+        return CFE_STATUS_INCORRECT_STATE;
+    }
+
+    /* 대기 중인 프레임을 모두 저장한 뒤 카메라 종료 */
+    CAM_APP_PipelineStop();
+    CAM_APP_CaptureClose();
+
+    /* 촬영 중에 바뀐 캡처 테이블은 지금 적용 */
+    if (CAM_APP_Data.ProfilePending)
+    {
+        CAM_APP_CaptureTableUpdate();
+    }
     CFE_EVS_SendEvent(CAM_APP_SHOT_STOP_INF_EID, CFE_EVS_EventType_INFORMATION, "CAM: Send Stop_Command");
     
     return CFE_SUCCESS;
 }
 
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* Capture a burst of frames back to back, then encrypt and store them        */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+CFE_Status_t CAM_APP_ShotBurstCmd(const CAM_APP_ShotBurstCmd_t *Msg)
+{
+    CFE_Status_t status;
+    uint16       FrameCount = Msg->Payload.FrameCount;
+    uint32       IntervalMs = Msg->Payload.IntervalMs;
+
+    if (FrameCount == 0 || FrameCount > CAM_APP_BURST_MAX_FRAMES || IntervalMs > CAM_APP_BURST_MAX_INTERVAL_MS)
+    {
+        CAM_APP_Data.ErrCounter++;
+        CFE_EVS_SendEvent(CAM_APP_SHOT_BURST_ERR_EID, CFE_EVS_EventType_ERROR,
+                          "CAM: Invalid burst of %u frames at %lu ms, limits %u frames and %lu ms", FrameCount,
+                          (unsigned long)IntervalMs, CAM_APP_BURST_MAX_FRAMES,
+                          (unsigned long)CAM_APP_BURST_MAX_INTERVAL_MS);
+        return CFE_STATUS_RANGE_ERROR;
+    }
+
+    /* 촬영 중이 아니면 주기 촬영 없이 카메라만 연다 (SHOT_STOP 으로 닫음) */
+    if (!CAM_APP_PipelineIsRunning())
+    {
+        status = CAM_APP_ShotOpen(false);
+        if (status != CFE_SUCCESS)
+        {
+            CAM_APP_Data.ErrCounter++;
+            return status;
+        }
+    }
+
+    status = CAM_APP_PipelineRequestBurst(FrameCount, IntervalMs);
+    if (status != CFE_SUCCESS)
+    {
+        CAM_APP_Data.ErrCounter++;
+        CFE_EVS_SendEvent(CAM_APP_SHOT_BURST_ERR_EID, CFE_EVS_EventType_ERROR, "CAM: Burst already in progress");
+        return status;
+    }
+
+    CAM_APP_Data.CmdCounter++;
+    CFE_EVS_SendEvent(CAM_APP_SHOT_BURST_INF_EID, CFE_EVS_EventType_INFORMATION,
+                      "CAM: Image Burst Start, %u frames at %lu ms", FrameCount, (unsigned long)IntervalMs);
+
+    return CFE_SUCCESS;
+}
+
 CFE_Status_t CAM_APP_SecurityStartCmd(const CAM_APP_SecurityStartCmd_t *Msg)
 {
-    Start_Security_Command = 1;
+    atomic_store(&CAM_APP_Data.SecurityEnabled, true);
     CFE_EVS_SendEvent(CAM_APP_SECURITY_START_INF_EID, CFE_EVS_EventType_INFORMATION, "CAM: Security_Start_Command");
 
     return CFE_SUCCESS;
@@ -402,9 +625,8 @@ CFE_Status_t CAM_APP_SecurityStartCmd(const CAM_APP_SecurityStartCmd_t *Msg)
 
 CFE_Status_t CAM_APP_SecurityStopCmd(const CAM_APP_SecurityStopCmd_t *Msg)
 {
-    Start_Security_Command = 0;
+    atomic_store(&CAM_APP_Data.SecurityEnabled, false);
     CFE_EVS_SendEvent(CAM_APP_SECURITY_STOP_INF_EID, CFE_EVS_EventType_INFORMATION, "CAM: Security_Stop_Command");
 
     return CFE_SUCCESS;
 }
-
@@ -41,5 +41,13 @@ CFE_Status_t CAM_APP_ShotStopCmd(const CAM_APP_ShotStopCmd_t *Msg);
 CFE_Status_t CAM_APP_SecurityStartCmd(const CAM_APP_SecurityStartCmd_t *Msg);
 CFE_Status_t CAM_APP_SecurityStopCmd(const CAM_APP_SecurityStopCmd_t *Msg);
 CFE_Status_t CAM_APP_SecurityKeyCmd(const CAM_APP_SecurityKeyCmd_t *Msg);
+CFE_Status_t CAM_APP_SetStorageModeCmd(const CAM_APP_SetStorageModeCmd_t *Msg);
+CFE_Status_t CAM_APP_ShotBurstCmd(const CAM_APP_ShotBurstCmd_t *Msg);
+CFE_Status_t CAM_APP_SetVerifyCmd(const CAM_APP_SetVerifyCmd_t *Msg);
+CFE_Status_t CAM_APP_ExtractFrameCmd(const CAM_APP_ExtractFrameCmd_t *Msg);
+CFE_Status_t CAM_APP_SetDurabilityCmd(const CAM_APP_SetDurabilityCmd_t *Msg);
+CFE_Status_t CAM_APP_SetDownlinkCmd(const CAM_APP_SetDownlinkCmd_t *Msg);
+CFE_Status_t CAM_APP_SendLatencyCmd(const CAM_APP_SendLatencyCmd_t *Msg);
+CFE_Status_t CAM_APP_WakeupCmd(const CAM_APP_WakeupCmd_t *Msg);
 
 #endif /* CAM_APP_CMDS_H */
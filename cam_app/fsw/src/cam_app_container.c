@@ -0,0 +1,329 @@
+/************************************************************************
+ * NASA Docket No. GSC-18,719-1, and identified as “core Flight System: Bootes”
+ *
+ * Copyright (c) 2020 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License. You may obtain
+ * a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ************************************************************************/
+
+/**
+ * \file
+ *   This file contains the source code for the Cam App encrypted file container.
+ */
+
+/*
+** Include Files:
+*/
+#include "cam_app_container.h"
+#include "cam_app_crypto_pool.h"
+
+#include <stdbool.h>
+#include <string.h>
+
+#define CAM_APP_CONTAINER_MAGIC      "CAMF"
+#define CAM_APP_CONTAINER_MAC_OFFSET 48 /* Header bytes covered by the MAC come before it */
+
+/*
+** One file being sealed or opened
+*/
+typedef struct
+{
+    const CAM_APP_CryptoKey_t *Key;
+    const uint8_t             *Iv;
+    const uint8_t             *In;
+    uint8_t                   *Out;
+    uint8_t                   *Tags; /* One MAC per segment when sealing, the latest when opening */
+    bool                       Sealing;
+} CAM_APP_ContainerJob_t;
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Store a Size byte big-endian field                              */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+static void CAM_APP_ContainerPut(uint8_t *Out, uint64_t Value, size_t Size)
+{
+    while (Size-- > 0)
+    {
+        Out[Size] = (uint8_t)Value;
+        Value >>= 8;
+    }
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Load a Size byte big-endian field                               */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+static uint64_t CAM_APP_ContainerGet(const uint8_t *In, size_t Size)
+{
+    uint64_t Value = 0;
+    size_t   i;
+
+    for (i = 0; i < Size; i++)
+    {
+        Value = (Value << 8) | In[i];
+    }
+
+    return Value;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Describe a status for event and log messages                    */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+const char *CAM_APP_ContainerStatusText(CAM_APP_ContainerStatus_t Status)
+{
+    switch (Status)
+    {
+        case CAM_APP_CONTAINER_OK:
+            return "ok";
+        case CAM_APP_CONTAINER_BAD_HEADER:
+            return "unrecognised header";
+        case CAM_APP_CONTAINER_BAD_SIZE:
+            return "length does not match header";
+        case CAM_APP_CONTAINER_BAD_MAC:
+            return "MAC mismatch";
+        case CAM_APP_CONTAINER_TOO_LARGE:
+            return "too many segments";
+        default:
+            return "unknown status";
+    }
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Lay out the header that goes in front of the ciphertext         */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+static void CAM_APP_ContainerEncodeHeader(const CAM_APP_ContainerHeader_t *Header, uint8_t *File)
+{
+    memcpy(File, CAM_APP_CONTAINER_MAGIC, 4);
+    File[4] = CAM_APP_CONTAINER_VERSION;
+    File[5] = CAM_APP_CONTAINER_CIPHER_AES256_CTR_CMAC;
+    CAM_APP_ContainerPut(File + 6, CAM_APP_CONTAINER_HEADER_SIZE, 2);
+    CAM_APP_ContainerPut(File + 8, Header->SegmentSize, 4);
+    CAM_APP_ContainerPut(File + 12, Header->Sequence, 4);
+    CAM_APP_ContainerPut(File + 16, Header->PlainSize, 8);
+    CAM_APP_ContainerPut(File + 24, Header->CaptureTimeUs, 8);
+    memcpy(File + 32, Header->Iv, CAM_APP_CRYPTO_IV_SIZE);
+    memcpy(File + CAM_APP_CONTAINER_MAC_OFFSET, Header->Mac, CAM_APP_CRYPTO_MAC_SIZE);
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Read the header of a Size byte file                             */
+/*                                                                 */
+/* Only the layout is checked; the MAC is checked by opening the   */
+/* file.                                                           */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+CAM_APP_ContainerStatus_t CAM_APP_ContainerDecodeHeader(CAM_APP_ContainerHeader_t *Header, const uint8_t *File,
+                                                        size_t Size)
+{
+    if (Size < CAM_APP_CONTAINER_HEADER_SIZE || memcmp(File, CAM_APP_CONTAINER_MAGIC, 4) != 0 ||
+        File[4] != CAM_APP_CONTAINER_VERSION || File[5] != CAM_APP_CONTAINER_CIPHER_AES256_CTR_CMAC ||
+        CAM_APP_ContainerGet(File + 6, 2) != CAM_APP_CONTAINER_HEADER_SIZE)
+    {
+        return CAM_APP_CONTAINER_BAD_HEADER;
+    }
+
+    Header->SegmentSize   = (uint32_t)CAM_APP_ContainerGet(File + 8, 4);
+    Header->Sequence      = (uint32_t)CAM_APP_ContainerGet(File + 12, 4);
+    Header->PlainSize     = CAM_APP_ContainerGet(File + 16, 8);
+    Header->CaptureTimeUs = CAM_APP_ContainerGet(File + 24, 8);
+    memcpy(Header->Iv, File + 32, CAM_APP_CRYPTO_IV_SIZE);
+    memcpy(Header->Mac, File + CAM_APP_CONTAINER_MAC_OFFSET, CAM_APP_CRYPTO_MAC_SIZE);
+
+    if (Header->SegmentSize == 0 || Header->SegmentSize % CAM_APP_CRYPTO_BLOCK_SIZE != 0)
+    {
+        return CAM_APP_CONTAINER_BAD_HEADER;
+    }
+
+    if (Size - CAM_APP_CONTAINER_HEADER_SIZE != Header->PlainSize)
+    {
+        return CAM_APP_CONTAINER_BAD_SIZE;
+    }
+
+    return CAM_APP_CONTAINER_OK;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Encrypt and MAC one segment, or MAC and decrypt it              */
+/*                                                                 */
+/* The MAC is always taken over the ciphertext, so a segment being */
+/* opened in place is checked before it is decrypted.  Sealing     */
+/* leaves each segment's tag at its place in Tags; opening goes    */
+/* one segment at a time and leaves the tag at the start.          */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+static void CAM_APP_ContainerSegment(void *Context, size_t Segment, size_t Offset, size_t Len)
+{
+    CAM_APP_ContainerJob_t *Job = Context;
+    CAM_APP_CryptoMac_t     Mac;
+    uint8_t                 Index[8];
+
+    if (Job->Sealing)
+    {
+        CAM_APP_CryptoCtr(Job->Key, Job->Iv, Offset, Job->In + Offset, Job->Out + Offset, Len);
+    }
+
+    CAM_APP_ContainerPut(Index, Segment, sizeof(Index));
+    CAM_APP_CryptoMacInit(&Mac, Job->Key);
+    CAM_APP_CryptoMacUpdate(&Mac, Index, sizeof(Index));
+    CAM_APP_CryptoMacUpdate(&Mac, Job->Sealing ? Job->Out + Offset : Job->In + Offset, Len);
+    CAM_APP_CryptoMacFinal(&Mac, Job->Sealing ? Job->Tags + Segment * CAM_APP_CRYPTO_MAC_SIZE : Job->Tags);
+
+    if (!Job->Sealing)
+    {
+        CAM_APP_CryptoCtr(Job->Key, Job->Iv, Offset, Job->In + Offset, Job->Out + Offset, Len);
+    }
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* MAC the covered header bytes and the segment tags               */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+static void CAM_APP_ContainerMac(const CAM_APP_CryptoKey_t *Key, const uint8_t *File, const uint8_t *Tags,
+                                 size_t Segments, uint8_t *Tag)
+{
+    CAM_APP_CryptoMac_t Mac;
+
+    CAM_APP_CryptoMacInit(&Mac, Key);
+    CAM_APP_CryptoMacUpdate(&Mac, File, CAM_APP_CONTAINER_MAC_OFFSET);
+    CAM_APP_CryptoMacUpdate(&Mac, Tags, Segments * CAM_APP_CRYPTO_MAC_SIZE);
+    CAM_APP_CryptoMacFinal(&Mac, Tag);
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Encrypt a frame into a file header and ciphertext               */
+/*                                                                 */
+/* The caller fills in the header's sequence, length and capture   */
+/* time, and the segment size, which is rounded down to a whole    */
+/* number of blocks.  The IV and MAC are filled in here.  The      */
+/* header image takes HEADER_SIZE bytes and the ciphertext         */
+/* PlainSize bytes; the file is the one followed by the other, so  */
+/* they can be written out without first being put together.       */
+/* Cipher must not overlap Plain.  Segments are shared with the    */
+/* crypto worker pool, and their tags are kept in the caller's     */
+/* TagsSize byte buffer until the file MAC is taken over them.     */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+CAM_APP_ContainerStatus_t CAM_APP_ContainerSeal(const CAM_APP_CryptoKey_t *Key, CAM_APP_ContainerHeader_t *Header,
+                                                const uint8_t *Plain, uint8_t *HeaderImage, uint8_t *Cipher,
+                                                uint8_t *Tags, size_t TagsSize)
+{
+    CAM_APP_ContainerJob_t Job;
+    size_t                 Segments;
+
+    Header->SegmentSize -= Header->SegmentSize % CAM_APP_CRYPTO_BLOCK_SIZE;
+    if (Header->SegmentSize == 0)
+    {
+        Header->SegmentSize = CAM_APP_CRYPTO_BLOCK_SIZE;
+    }
+
+    if (CAM_APP_CONTAINER_TAGS_SIZE(Header->PlainSize, Header->SegmentSize) > TagsSize)
+    {
+        return CAM_APP_CONTAINER_TOO_LARGE;
+    }
+
+    Segments = (Header->PlainSize + Header->SegmentSize - 1) / Header->SegmentSize;
+
+    CAM_APP_CryptoMakeIv(Header->Iv);
+    memset(Header->Mac, 0, sizeof(Header->Mac));
+
+    Job.Key     = Key;
+    Job.Iv      = Header->Iv;
+    Job.Tags    = Tags;
+    Job.In      = Plain;
+    Job.Out     = Cipher;
+    Job.Sealing = true;
+    CAM_APP_CryptoPoolRun(CAM_APP_ContainerSegment, &Job, Header->PlainSize, Header->SegmentSize);
+
+    CAM_APP_ContainerEncodeHeader(Header, HeaderImage);
+    CAM_APP_ContainerMac(Key, HeaderImage, Job.Tags, Segments, Header->Mac);
+    memcpy(HeaderImage + CAM_APP_CONTAINER_MAC_OFFSET, Header->Mac, CAM_APP_CRYPTO_MAC_SIZE);
+
+    return CAM_APP_CONTAINER_OK;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Check and decrypt a Size byte file image in place               */
+/*                                                                 */
+/* On success the frame is left at File + HEADER_SIZE.  After a    */
+/* MAC failure those bytes are decrypted but must not be trusted.  */
+/* This runs on the calling thread only, leaving the pool free for */
+/* frames being sealed, and takes each segment's tag into the file */
+/* MAC as it goes, so a file of any length needs no tag buffer.    */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+CAM_APP_ContainerStatus_t CAM_APP_ContainerOpen(const CAM_APP_CryptoKey_t *Key, CAM_APP_ContainerHeader_t *Header,
+                                                uint8_t *File, size_t Size)
+{
+    CAM_APP_ContainerStatus_t Status;
+    CAM_APP_ContainerJob_t    Job;
+    CAM_APP_CryptoMac_t       Mac;
+    uint8_t                   SegmentTag[CAM_APP_CRYPTO_MAC_SIZE];
+    uint8_t                   Tag[CAM_APP_CRYPTO_MAC_SIZE];
+    uint8_t                   Diff = 0;
+    size_t                    Segments;
+    size_t                    Segment;
+    size_t                    Offset;
+    size_t                    Len;
+    size_t                    i;
+
+    Status = CAM_APP_ContainerDecodeHeader(Header, File, Size);
+    if (Status != CAM_APP_CONTAINER_OK)
+    {
+        return Status;
+    }
+
+    Segments = (Header->PlainSize + Header->SegmentSize - 1) / Header->SegmentSize;
+
+    CAM_APP_CryptoMacInit(&Mac, Key);
+    CAM_APP_CryptoMacUpdate(&Mac, File, CAM_APP_CONTAINER_MAC_OFFSET);
+
+    Job.Key     = Key;
+    Job.Iv      = Header->Iv;
+    Job.Tags    = SegmentTag;
+    Job.In      = File + CAM_APP_CONTAINER_HEADER_SIZE;
+    Job.Out     = File + CAM_APP_CONTAINER_HEADER_SIZE;
+    Job.Sealing = false;
+    for (Segment = 0; Segment < Segments; Segment++)
+    {
+        Offset = Segment * Header->SegmentSize;
+        Len    = Header->PlainSize - Offset;
+        if (Len > Header->SegmentSize)
+        {
+            Len = Header->SegmentSize;
+        }
+
+        CAM_APP_ContainerSegment(&Job, Segment, Offset, Len);
+        CAM_APP_CryptoMacUpdate(&Mac, SegmentTag, sizeof(SegmentTag));
+    }
+
+    CAM_APP_CryptoMacFinal(&Mac, Tag);
+
+    /* Compare every byte so the time taken says nothing about where a forged MAC goes wrong */
+    for (i = 0; i < CAM_APP_CRYPTO_MAC_SIZE; i++)
+    {
+        Diff |= Tag[i] ^ Header->Mac[i];
+    }
+
+    return Diff == 0 ? CAM_APP_CONTAINER_OK : CAM_APP_CONTAINER_BAD_MAC;
+}
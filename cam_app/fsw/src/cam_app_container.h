@@ -0,0 +1,102 @@
+/************************************************************************
+ * NASA Docket No. GSC-18,719-1, and identified as “core Flight System: Bootes”
+ *
+ * Copyright (c) 2020 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License. You may obtain
+ * a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ************************************************************************/
+
+/**
+ * @file
+ *   This file contains the prototypes for the Cam App encrypted file container
+ *
+ *   An encrypted frame is stored as a fixed size binary header followed
+ *   by the raw ciphertext, so the file is only as long as the frame plus
+ *   the header.  The header is laid out as below, multi-byte fields
+ *   big-endian:
+ *
+ *     Offset  Size  Field
+ *          0     4  Magic, "CAMF"
+ *          4     1  Version, currently 1
+ *          5     1  Cipher, 1 = AES-256-CTR with AES-CMAC
+ *          6     2  Header size in bytes
+ *          8     4  Segment size in bytes
+ *         12     4  Capture sequence number since shooting started
+ *         16     8  Frame length in bytes
+ *         24     8  Capture time, microseconds since the Unix epoch
+ *         32    16  IV (see cam_app_crypto.h)
+ *         48    16  MAC
+ *
+ *   The MAC covers the whole file.  The ciphertext is split into
+ *   segments of the given size, and each segment gets its own CMAC over
+ *   its 64-bit index followed by its bytes; the MAC in the header is the
+ *   CMAC of the first 48 header bytes followed by every segment's tag in
+ *   order.  Segments can therefore be sealed and checked on several
+ *   threads, and no byte of the file can be changed, dropped or moved
+ *   without the MAC failing.
+ *
+ *   This module does not depend on cFE so that ground tools can share it.
+ */
+
+#ifndef CAM_APP_CONTAINER_H
+#define CAM_APP_CONTAINER_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "cam_app_crypto.h"
+
+#define CAM_APP_CONTAINER_HEADER_SIZE 64 /**< \brief Bytes in front of the ciphertext */
+#define CAM_APP_CONTAINER_VERSION     1  /**< \brief Layout version written into new files */
+
+#define CAM_APP_CONTAINER_CIPHER_AES256_CTR_CMAC 1 /**< \brief AES-256-CTR, authenticated with AES-CMAC */
+
+/*
+** Bytes of segment tags sealing a PlainSize byte frame takes, for a
+** segment size that is a whole number of blocks
+*/
+#define CAM_APP_CONTAINER_TAGS_SIZE(PlainSize, SegmentSize) \
+    ((((PlainSize) + (SegmentSize)-1) / (SegmentSize)) * CAM_APP_CRYPTO_MAC_SIZE)
+
+typedef enum
+{
+    CAM_APP_CONTAINER_OK,
+    CAM_APP_CONTAINER_BAD_HEADER, /**< \brief Not a container, or a version or cipher this build cannot read */
+    CAM_APP_CONTAINER_BAD_SIZE,   /**< \brief File length does not match the header */
+    CAM_APP_CONTAINER_BAD_MAC,    /**< \brief File was altered or sealed under another key */
+    CAM_APP_CONTAINER_TOO_LARGE   /**< \brief Frame has more segments than the tag buffer holds */
+} CAM_APP_ContainerStatus_t;
+
+/*
+** Header fields of one file
+*/
+typedef struct
+{
+    uint32_t SegmentSize;                  /**< \brief Ciphertext bytes per MAC segment */
+    uint32_t Sequence;                     /**< \brief Capture sequence number */
+    uint64_t PlainSize;                    /**< \brief Frame length in bytes */
+    uint64_t CaptureTimeUs;                /**< \brief Capture time, microseconds since the Unix epoch */
+    uint8_t  Iv[CAM_APP_CRYPTO_IV_SIZE];   /**< \brief IV the frame is encrypted from */
+    uint8_t  Mac[CAM_APP_CRYPTO_MAC_SIZE]; /**< \brief MAC over the header and ciphertext */
+} CAM_APP_ContainerHeader_t;
+
+const char               *CAM_APP_ContainerStatusText(CAM_APP_ContainerStatus_t Status);
+CAM_APP_ContainerStatus_t CAM_APP_ContainerDecodeHeader(CAM_APP_ContainerHeader_t *Header, const uint8_t *File,
+                                                        size_t Size);
+CAM_APP_ContainerStatus_t CAM_APP_ContainerSeal(const CAM_APP_CryptoKey_t *Key, CAM_APP_ContainerHeader_t *Header,
+                                                const uint8_t *Plain, uint8_t *HeaderImage, uint8_t *Cipher,
+                                                uint8_t *Tags, size_t TagsSize);
+CAM_APP_ContainerStatus_t CAM_APP_ContainerOpen(const CAM_APP_CryptoKey_t *Key, CAM_APP_ContainerHeader_t *Header,
+                                                uint8_t *File, size_t Size);
+
+#endif /* CAM_APP_CONTAINER_H */
@@ -0,0 +1,107 @@
+/************************************************************************
+ * NASA Docket No. GSC-18,719-1, and identified as “core Flight System: Bootes”
+ *
+ * Copyright (c) 2020 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License. You may obtain
+ * a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ************************************************************************/
+
+/**
+ * \file
+ *   This file contains the source code for the Cam App CRC-32.
+ */
+
+/*
+** Include Files:
+*/
+#include "cam_app_crc.h"
+
+#include <pthread.h>
+
+#define CAM_APP_CRC_POLY 0xEDB88320u
+
+/*
+** Table[0] is the usual byte-at-a-time table; Table[k][b] is the CRC of
+** byte b followed by k zero bytes, which lets eight bytes be folded in at once
+*/
+static uint32_t       CAM_APP_CrcTable[8][256];
+static pthread_once_t CAM_APP_CrcOnce = PTHREAD_ONCE_INIT;
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Build the lookup tables                                         */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+static void CAM_APP_CrcInit(void)
+{
+    uint32_t Crc;
+    uint32_t i;
+    uint32_t k;
+
+    for (i = 0; i < 256; i++)
+    {
+        Crc = i;
+        for (k = 0; k < 8; k++)
+        {
+            Crc = (Crc >> 1) ^ (CAM_APP_CRC_POLY & (0u - (Crc & 1u)));
+        }
+        CAM_APP_CrcTable[0][i] = Crc;
+    }
+
+    for (i = 0; i < 256; i++)
+    {
+        for (k = 1; k < 8; k++)
+        {
+            Crc                    = CAM_APP_CrcTable[k - 1][i];
+            CAM_APP_CrcTable[k][i] = (Crc >> 8) ^ CAM_APP_CrcTable[0][Crc & 0xFF];
+        }
+    }
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Extend Crc over Len bytes at Data                               */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+uint32_t CAM_APP_Crc32(uint32_t Crc, const void *Data, size_t Len)
+{
+    const uint8_t *In = Data;
+    uint32_t       Lo;
+    uint32_t       Hi;
+
+    pthread_once(&CAM_APP_CrcOnce, CAM_APP_CrcInit);
+
+    Crc = ~Crc;
+
+    /* Loaded a byte at a time so the result does not depend on alignment or byte order */
+    while (Len >= 8)
+    {
+        Lo = Crc ^ ((uint32_t)In[0] | (uint32_t)In[1] << 8 | (uint32_t)In[2] << 16 | (uint32_t)In[3] << 24);
+        Hi = (uint32_t)In[4] | (uint32_t)In[5] << 8 | (uint32_t)In[6] << 16 | (uint32_t)In[7] << 24;
+
+        Crc = CAM_APP_CrcTable[7][Lo & 0xFF] ^ CAM_APP_CrcTable[6][(Lo >> 8) & 0xFF] ^
+              CAM_APP_CrcTable[5][(Lo >> 16) & 0xFF] ^ CAM_APP_CrcTable[4][Lo >> 24] ^
+              CAM_APP_CrcTable[3][Hi & 0xFF] ^ CAM_APP_CrcTable[2][(Hi >> 8) & 0xFF] ^
+              CAM_APP_CrcTable[1][(Hi >> 16) & 0xFF] ^ CAM_APP_CrcTable[0][Hi >> 24];
+
+        In += 8;
+        Len -= 8;
+    }
+
+    while (Len-- > 0)
+    {
+        Crc = (Crc >> 8) ^ CAM_APP_CrcTable[0][(Crc ^ *In++) & 0xFF];
+    }
+
+    return ~Crc;
+}
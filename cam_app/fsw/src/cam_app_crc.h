@@ -0,0 +1,42 @@
+/************************************************************************
+ * NASA Docket No. GSC-18,719-1, and identified as “core Flight System: Bootes”
+ *
+ * Copyright (c) 2020 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License. You may obtain
+ * a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ************************************************************************/
+
+/**
+ * @file
+ *   This file contains the prototypes for the Cam App CRC-32
+ *
+ *   The checksum is the common reflected CRC-32 (polynomial 0xEDB88320)
+ *   used by zlib and PNG, so ground tools can check it with any standard
+ *   implementation.  It is computed eight bytes at a time from tables
+ *   built on first use.
+ *
+ *   A buffer can be checksummed in pieces by passing the result for the
+ *   earlier pieces as Crc; start from 0.
+ *
+ *   This module does not depend on cFE so that ground tools can share it.
+ */
+
+#ifndef CAM_APP_CRC_H
+#define CAM_APP_CRC_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+uint32_t CAM_APP_Crc32(uint32_t Crc, const void *Data, size_t Len);
+
+#endif /* CAM_APP_CRC_H */
@@ -0,0 +1,346 @@
+/************************************************************************
+ * NASA Docket No. GSC-18,719-1, and identified as “core Flight System: Bootes”
+ *
+ * Copyright (c) 2020 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License. You may obtain
+ * a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ************************************************************************/
+
+/**
+ * \file
+ *   This file contains the source code for the Cam App frame cipher.
+ */
+
+/*
+** Include Files:
+*/
+#include "cam_app_crypto.h"
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/random.h>
+#include <time.h>
+
+/*
+** Counter blocks run through the cipher per call, enough to keep the
+** hardware backends' lanes full while staying on the stack
+*/
+#define CAM_APP_CRYPTO_CTR_BATCH 16
+
+/*
+** Label the MAC key is derived under; the last byte of each derivation
+** block counts the key's two halves
+*/
+#define CAM_APP_CRYPTO_MAC_LABEL "CAM_APP MAC KEY"
+
+struct CAM_APP_CryptoKey
+{
+    CAM_APP_AesSchedule_t Schedule;
+    CAM_APP_AesSchedule_t MacSchedule;
+    uint8_t               MacSubkey1[CAM_APP_CRYPTO_BLOCK_SIZE]; /* CMAC K1, for a final whole block */
+    uint8_t               MacSubkey2[CAM_APP_CRYPTO_BLOCK_SIZE]; /* CMAC K2, for a padded final block */
+    atomic_uint           Refs;
+};
+
+/*
+** The key new frames are encrypted under.  The lock only covers taking a
+** reference, so swapping keys never waits on a frame being processed.
+*/
+static CAM_APP_CryptoKey_t *CAM_APP_CryptoActiveKey;
+static pthread_mutex_t      CAM_APP_CryptoActiveLock = PTHREAD_MUTEX_INITIALIZER;
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Multiply a block by x in GF(2^128), as CMAC subkeys are made    */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+static void CAM_APP_CryptoDouble(uint8_t *Out, const uint8_t *In)
+{
+    uint8_t Carry = In[0] >> 7;
+    int     i;
+
+    for (i = 0; i < CAM_APP_CRYPTO_BLOCK_SIZE - 1; i++)
+    {
+        Out[i] = (uint8_t)((In[i] << 1) | (In[i + 1] >> 7));
+    }
+    Out[CAM_APP_CRYPTO_BLOCK_SIZE - 1] = (uint8_t)((In[CAM_APP_CRYPTO_BLOCK_SIZE - 1] << 1) ^ (Carry * 0x87));
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Expand a key into a new handle holding one reference            */
+/*                                                                 */
+/* Frames are encrypted under the key itself and authenticated     */
+/* under a second key derived from it, so the two uses never share */
+/* a key.  Returns NULL if the handle cannot be allocated.         */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+CAM_APP_CryptoKey_t *CAM_APP_CryptoKeyCreate(const uint8_t *Key)
+{
+    CAM_APP_CryptoKey_t *Handle = malloc(sizeof(*Handle));
+    uint8_t              MacKey[CAM_APP_CRYPTO_KEY_SIZE];
+    uint8_t              Zero[CAM_APP_CRYPTO_BLOCK_SIZE] = {0};
+    uint8_t              L[CAM_APP_CRYPTO_BLOCK_SIZE];
+
+    if (Handle != NULL)
+    {
+        CAM_APP_AesExpandKey(&Handle->Schedule, Key);
+
+        memcpy(MacKey, CAM_APP_CRYPTO_MAC_LABEL "\x01", CAM_APP_CRYPTO_BLOCK_SIZE);
+        memcpy(MacKey + CAM_APP_CRYPTO_BLOCK_SIZE, CAM_APP_CRYPTO_MAC_LABEL "\x02", CAM_APP_CRYPTO_BLOCK_SIZE);
+        CAM_APP_AesEncryptBlocks(&Handle->Schedule, MacKey, MacKey, 2);
+        CAM_APP_AesExpandKey(&Handle->MacSchedule, MacKey);
+
+        CAM_APP_AesEncryptBlocks(&Handle->MacSchedule, Zero, L, 1);
+        CAM_APP_CryptoDouble(Handle->MacSubkey1, L);
+        CAM_APP_CryptoDouble(Handle->MacSubkey2, Handle->MacSubkey1);
+
+        memset(MacKey, 0, sizeof(MacKey));
+        memset(L, 0, sizeof(L));
+        atomic_init(&Handle->Refs, 1);
+    }
+
+    return Handle;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Take another reference to a key                                 */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+void CAM_APP_CryptoKeyRetain(CAM_APP_CryptoKey_t *Key)
+{
+    atomic_fetch_add(&Key->Refs, 1);
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Drop a reference, wiping and freeing the key with the last one  */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+void CAM_APP_CryptoKeyRelease(CAM_APP_CryptoKey_t *Key)
+{
+    if (Key != NULL && atomic_fetch_sub(&Key->Refs, 1) == 1)
+    {
+        memset(Key, 0, sizeof(*Key));
+        free(Key);
+    }
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Make Key the active key, taking over the caller's reference     */
+/*                                                                 */
+/* Frames already holding the previous key finish under it; that   */
+/* key is freed once the last of them releases it.                 */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+void CAM_APP_CryptoKeyInstall(CAM_APP_CryptoKey_t *Key)
+{
+    CAM_APP_CryptoKey_t *Previous;
+
+    pthread_mutex_lock(&CAM_APP_CryptoActiveLock);
+    Previous                = CAM_APP_CryptoActiveKey;
+    CAM_APP_CryptoActiveKey = Key;
+    pthread_mutex_unlock(&CAM_APP_CryptoActiveLock);
+
+    CAM_APP_CryptoKeyRelease(Previous);
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Take a reference to the active key, NULL if none is installed   */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+CAM_APP_CryptoKey_t *CAM_APP_CryptoKeyAcquire(void)
+{
+    CAM_APP_CryptoKey_t *Key;
+
+    pthread_mutex_lock(&CAM_APP_CryptoActiveLock);
+    Key = CAM_APP_CryptoActiveKey;
+    if (Key != NULL)
+    {
+        CAM_APP_CryptoKeyRetain(Key);
+    }
+    pthread_mutex_unlock(&CAM_APP_CryptoActiveLock);
+
+    return Key;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Fill in a fresh IV for one file                                 */
+/*                                                                 */
+/* The nonce comes from the kernel's random pool; if that is not   */
+/* ready yet (early boot) the wall clock and a running count still */
+/* keep it unique per file.  The block counter starts at zero.     */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+void CAM_APP_CryptoMakeIv(uint8_t *Iv)
+{
+    static atomic_uint Fallback;
+    struct timespec    Now;
+    uint64_t           Nanoseconds;
+    uint32_t           Count;
+
+    if (getrandom(Iv, CAM_APP_CRYPTO_NONCE_SIZE, GRND_NONBLOCK) != CAM_APP_CRYPTO_NONCE_SIZE)
+    {
+        clock_gettime(CLOCK_REALTIME, &Now);
+        Nanoseconds = (uint64_t)Now.tv_sec * 1000000000u + (uint64_t)Now.tv_nsec;
+        Count       = atomic_fetch_add(&Fallback, 1);
+
+        memcpy(Iv, &Nanoseconds, sizeof(Nanoseconds));
+        memcpy(Iv + sizeof(Nanoseconds), &Count, CAM_APP_CRYPTO_NONCE_SIZE - sizeof(Nanoseconds));
+    }
+
+    memset(Iv + CAM_APP_CRYPTO_NONCE_SIZE, 0, CAM_APP_CRYPTO_IV_SIZE - CAM_APP_CRYPTO_NONCE_SIZE);
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Encrypt or decrypt Len bytes starting Offset bytes into a file  */
+/*                                                                 */
+/* Offset must be a multiple of the block size so that segments of */
+/* one frame can be processed independently.  In and Out may be    */
+/* the same buffer.                                                */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+void CAM_APP_CryptoCtr(const CAM_APP_CryptoKey_t *Key, const uint8_t *Iv, size_t Offset, const uint8_t *In,
+                       uint8_t *Out, size_t Len)
+{
+    uint8_t  Stream[CAM_APP_CRYPTO_CTR_BATCH * CAM_APP_CRYPTO_BLOCK_SIZE];
+    uint8_t *Block;
+    uint32_t Counter;
+    size_t   Blocks;
+    size_t   Bytes;
+    size_t   i;
+
+    Counter = ((uint32_t)Iv[12] << 24) | ((uint32_t)Iv[13] << 16) | ((uint32_t)Iv[14] << 8) | (uint32_t)Iv[15];
+    Counter += (uint32_t)(Offset / CAM_APP_CRYPTO_BLOCK_SIZE);
+
+    while (Len > 0)
+    {
+        Blocks = (Len + CAM_APP_CRYPTO_BLOCK_SIZE - 1) / CAM_APP_CRYPTO_BLOCK_SIZE;
+        if (Blocks > CAM_APP_CRYPTO_CTR_BATCH)
+        {
+            Blocks = CAM_APP_CRYPTO_CTR_BATCH;
+        }
+
+        for (i = 0; i < Blocks; i++, Counter++)
+        {
+            Block = Stream + i * CAM_APP_CRYPTO_BLOCK_SIZE;
+            memcpy(Block, Iv, CAM_APP_CRYPTO_NONCE_SIZE);
+            Block[12] = (uint8_t)(Counter >> 24);
+            Block[13] = (uint8_t)(Counter >> 16);
+            Block[14] = (uint8_t)(Counter >> 8);
+            Block[15] = (uint8_t)Counter;
+        }
+
+        CAM_APP_AesEncryptBlocks(&Key->Schedule, Stream, Stream, Blocks);
+
+        Bytes = Blocks * CAM_APP_CRYPTO_BLOCK_SIZE;
+        if (Bytes > Len)
+        {
+            Bytes = Len;
+        }
+        for (i = 0; i < Bytes; i++)
+        {
+            Out[i] = In[i] ^ Stream[i];
+        }
+
+        In += Bytes;
+        Out += Bytes;
+        Len -= Bytes;
+    }
+
+    memset(Stream, 0, sizeof(Stream));
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Start an AES-CMAC under the key's MAC key                       */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+void CAM_APP_CryptoMacInit(CAM_APP_CryptoMac_t *Mac, const CAM_APP_CryptoKey_t *Key)
+{
+    Mac->Key        = Key;
+    Mac->PendingLen = 0;
+    memset(Mac->State, 0, sizeof(Mac->State));
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Add Len bytes to a MAC                                          */
+/*                                                                 */
+/* The last block seen is held back until more data arrives, since */
+/* the final block is treated differently.                         */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+void CAM_APP_CryptoMacUpdate(CAM_APP_CryptoMac_t *Mac, const uint8_t *Data, size_t Len)
+{
+    size_t Take;
+    size_t i;
+
+    while (Len > 0)
+    {
+        if (Mac->PendingLen == CAM_APP_CRYPTO_BLOCK_SIZE)
+        {
+            for (i = 0; i < CAM_APP_CRYPTO_BLOCK_SIZE; i++)
+            {
+                Mac->State[i] ^= Mac->Pending[i];
+            }
+            CAM_APP_AesEncryptBlocks(&Mac->Key->MacSchedule, Mac->State, Mac->State, 1);
+            Mac->PendingLen = 0;
+        }
+
+        Take = CAM_APP_CRYPTO_BLOCK_SIZE - Mac->PendingLen;
+        if (Take > Len)
+        {
+            Take = Len;
+        }
+        memcpy(Mac->Pending + Mac->PendingLen, Data, Take);
+
+        Mac->PendingLen += Take;
+        Data += Take;
+        Len -= Take;
+    }
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Finish a MAC and write its tag                                  */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+void CAM_APP_CryptoMacFinal(CAM_APP_CryptoMac_t *Mac, uint8_t *Tag)
+{
+    const uint8_t *Subkey = Mac->Key->MacSubkey1;
+    size_t         i;
+
+    /* A partial (or empty) final block is padded with 10...0 and takes the second subkey */
+    if (Mac->PendingLen < CAM_APP_CRYPTO_BLOCK_SIZE)
+    {
+        Mac->Pending[Mac->PendingLen] = 0x80;
+        memset(Mac->Pending + Mac->PendingLen + 1, 0, CAM_APP_CRYPTO_BLOCK_SIZE - Mac->PendingLen - 1);
+        Subkey = Mac->Key->MacSubkey2;
+    }
+
+    for (i = 0; i < CAM_APP_CRYPTO_BLOCK_SIZE; i++)
+    {
+        Mac->State[i] ^= Mac->Pending[i] ^ Subkey[i];
+    }
+    CAM_APP_AesEncryptBlocks(&Mac->Key->MacSchedule, Mac->State, Tag, 1);
+
+    memset(Mac, 0, sizeof(*Mac));
+}
@@ -0,0 +1,90 @@
+/************************************************************************
+ * NASA Docket No. GSC-18,719-1, and identified as “core Flight System: Bootes”
+ *
+ * Copyright (c) 2020 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License. You may obtain
+ * a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ************************************************************************/
+
+/**
+ * @file
+ *   This file contains the prototypes for the Cam App frame cipher
+ *
+ *   Frames are encrypted with AES-256 in counter (CTR) mode.  Each file
+ *   gets its own IV, a 96-bit random nonce followed by a 32-bit block
+ *   counter starting at zero, stored in the file header.  The
+ *   keystream depends only on the key, the IV and the block position, so
+ *   a frame can be cut into segments and encrypted on several threads,
+ *   and the ciphertext is exactly as long as the frame with no padding.
+ *   For frames under 64 GiB the output is the same as AES-256-CTR in
+ *   other tools (e.g. openssl enc -aes-256-ctr).
+ *
+ *   The cipher runs under a key handle rather than raw key bytes.  A
+ *   handle carries the expanded schedule, so the key is expanded once when
+ *   it is loaded instead of once per frame, and is reference counted so a
+ *   new key can be installed while frames are still in flight under the
+ *   old one.
+ *
+ *   Frames are authenticated with AES-CMAC (RFC 4493) under a second
+ *   AES-256 key the handle derives from the frame key when it is created,
+ *   by encrypting two fixed label blocks under the frame key.
+ *
+ *   This module does not depend on cFE so that ground tools can share it.
+ */
+
+#ifndef CAM_APP_CRYPTO_H
+#define CAM_APP_CRYPTO_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "cam_app_aes.h"
+
+#define CAM_APP_CRYPTO_BLOCK_SIZE CAM_APP_AES_BLOCK_SIZE /**< \brief Cipher block size in bytes */
+#define CAM_APP_CRYPTO_KEY_SIZE   CAM_APP_AES_KEY_SIZE   /**< \brief AES-256 key size in bytes */
+#define CAM_APP_CRYPTO_NONCE_SIZE 12                     /**< \brief Random part of the IV */
+#define CAM_APP_CRYPTO_IV_SIZE    CAM_APP_AES_BLOCK_SIZE /**< \brief Nonce plus initial block counter */
+#define CAM_APP_CRYPTO_MAC_SIZE   CAM_APP_AES_BLOCK_SIZE /**< \brief AES-CMAC tag size in bytes */
+
+/*
+** Expanded key shared by every frame that uses it
+*/
+typedef struct CAM_APP_CryptoKey CAM_APP_CryptoKey_t;
+
+/*
+** A MAC being computed over data supplied in pieces
+*/
+typedef struct
+{
+    const CAM_APP_CryptoKey_t *Key;
+    uint8_t                    State[CAM_APP_CRYPTO_BLOCK_SIZE];
+    uint8_t                    Pending[CAM_APP_CRYPTO_BLOCK_SIZE]; /* Last block, not yet chained in */
+    size_t                     PendingLen;
+} CAM_APP_CryptoMac_t;
+
+CAM_APP_CryptoKey_t *CAM_APP_CryptoKeyCreate(const uint8_t *Key);
+void                 CAM_APP_CryptoKeyRetain(CAM_APP_CryptoKey_t *Key);
+void                 CAM_APP_CryptoKeyRelease(CAM_APP_CryptoKey_t *Key);
+void                 CAM_APP_CryptoKeyInstall(CAM_APP_CryptoKey_t *Key);
+CAM_APP_CryptoKey_t *CAM_APP_CryptoKeyAcquire(void);
+
+void CAM_APP_CryptoMakeIv(uint8_t *Iv);
+void CAM_APP_CryptoCtr(const CAM_APP_CryptoKey_t *Key, const uint8_t *Iv, size_t Offset, const uint8_t *In,
+                       uint8_t *Out, size_t Len);
+
+void CAM_APP_CryptoMacInit(CAM_APP_CryptoMac_t *Mac, const CAM_APP_CryptoKey_t *Key);
+void CAM_APP_CryptoMacUpdate(CAM_APP_CryptoMac_t *Mac, const uint8_t *Data, size_t Len);
+void CAM_APP_CryptoMacFinal(CAM_APP_CryptoMac_t *Mac, uint8_t *Tag);
+
+#endif /* CAM_APP_CRYPTO_H */
@@ -0,0 +1,241 @@
+/************************************************************************
+ * NASA Docket No. GSC-18,719-1, and identified as “core Flight System: Bootes”
+ *
+ * Copyright (c) 2020 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License. You may obtain
+ * a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ************************************************************************/
+
+/**
+ * \file
+ *   This file contains the source code for the Cam App crypto worker pool.
+ */
+
+/*
+** Include Files:
+*/
+#include "cam_app_crypto_pool.h"
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+
+/*
+** One frame's worth of work, on the submitting thread's stack
+*/
+typedef struct
+{
+    CAM_APP_CryptoPoolFunc_t Func;
+    void                    *Context;
+    size_t                   Len;
+    size_t                   SegmentSize;
+    size_t                   Segments;
+    atomic_size_t            NextSegment;
+} CAM_APP_CryptoPoolJob_t;
+
+typedef struct
+{
+    pthread_mutex_t Submit; /* Held by the thread whose frame is in the pool */
+    pthread_mutex_t Lock;
+    pthread_cond_t  Posted;
+    pthread_cond_t  Idle;
+
+    pthread_t    Threads[CAM_APP_CRYPTO_POOL_MAX_WORKERS];
+    unsigned int Workers;
+    bool         Shutdown;
+
+    CAM_APP_CryptoPoolJob_t *Job;        /* NULL once every segment has been claimed */
+    unsigned long            Generation; /* Bumped for every frame posted */
+    unsigned int             Busy;       /* Helpers still working on Job */
+} CAM_APP_CryptoPool_t;
+
+static CAM_APP_CryptoPool_t CAM_APP_CryptoPool = {
+    .Submit = PTHREAD_MUTEX_INITIALIZER,
+    .Lock   = PTHREAD_MUTEX_INITIALIZER,
+    .Posted = PTHREAD_COND_INITIALIZER,
+    .Idle   = PTHREAD_COND_INITIALIZER,
+};
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Claim and process segments until the frame has none left        */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+static void CAM_APP_CryptoPoolDrain(CAM_APP_CryptoPoolJob_t *Job)
+{
+    size_t Segment;
+    size_t Offset;
+    size_t Len;
+
+    while ((Segment = atomic_fetch_add(&Job->NextSegment, 1)) < Job->Segments)
+    {
+        Offset = Segment * Job->SegmentSize;
+        Len    = Job->Len - Offset;
+        if (Len > Job->SegmentSize)
+        {
+            Len = Job->SegmentSize;
+        }
+
+        Job->Func(Job->Context, Segment, Offset, Len);
+    }
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Helper thread: join each posted frame until shut down           */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+static void *CAM_APP_CryptoPoolWorker(void *Arg)
+{
+    CAM_APP_CryptoPool_t    *Pool = &CAM_APP_CryptoPool;
+    CAM_APP_CryptoPoolJob_t *Job;
+    unsigned long            Seen;
+
+    pthread_mutex_lock(&Pool->Lock);
+    Seen = Pool->Generation;
+
+    for (;;)
+    {
+        while (!Pool->Shutdown && (Pool->Job == NULL || Pool->Generation == Seen))
+        {
+            pthread_cond_wait(&Pool->Posted, &Pool->Lock);
+        }
+
+        if (Pool->Shutdown)
+        {
+            break;
+        }
+
+        Job  = Pool->Job;
+        Seen = Pool->Generation;
+        Pool->Busy++;
+        pthread_mutex_unlock(&Pool->Lock);
+
+        CAM_APP_CryptoPoolDrain(Job);
+
+        pthread_mutex_lock(&Pool->Lock);
+        if (--Pool->Busy == 0)
+        {
+            pthread_cond_signal(&Pool->Idle);
+        }
+    }
+
+    pthread_mutex_unlock(&Pool->Lock);
+
+    return NULL;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Start up to Workers helper threads                              */
+/*                                                                 */
+/* Returns the number actually started; the pool still works, more */
+/* slowly, with fewer or none.                                     */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+unsigned int CAM_APP_CryptoPoolStart(unsigned int Workers)
+{
+    CAM_APP_CryptoPool_t *Pool = &CAM_APP_CryptoPool;
+
+    if (Workers > CAM_APP_CRYPTO_POOL_MAX_WORKERS)
+    {
+        Workers = CAM_APP_CRYPTO_POOL_MAX_WORKERS;
+    }
+
+    pthread_mutex_lock(&Pool->Submit);
+
+    while (Pool->Workers < Workers &&
+           pthread_create(&Pool->Threads[Pool->Workers], NULL, CAM_APP_CryptoPoolWorker, NULL) == 0)
+    {
+        Pool->Workers++;
+    }
+    Workers = Pool->Workers;
+
+    pthread_mutex_unlock(&Pool->Submit);
+
+    return Workers;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Stop and join the helper threads                                */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+void CAM_APP_CryptoPoolStop(void)
+{
+    CAM_APP_CryptoPool_t *Pool = &CAM_APP_CryptoPool;
+    unsigned int          i;
+
+    pthread_mutex_lock(&Pool->Submit);
+
+    pthread_mutex_lock(&Pool->Lock);
+    Pool->Shutdown = true;
+    pthread_cond_broadcast(&Pool->Posted);
+    pthread_mutex_unlock(&Pool->Lock);
+
+    for (i = 0; i < Pool->Workers; i++)
+    {
+        pthread_join(Pool->Threads[i], NULL);
+    }
+
+    Pool->Workers  = 0;
+    Pool->Shutdown = false;
+
+    pthread_mutex_unlock(&Pool->Submit);
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Run Func over every segment of a Len byte frame, sharing the    */
+/* segments with the pool                                          */
+/*                                                                 */
+/* Returns once Func has finished on every segment.  SegmentSize   */
+/* must not be zero.                                               */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+void CAM_APP_CryptoPoolRun(CAM_APP_CryptoPoolFunc_t Func, void *Context, size_t Len, size_t SegmentSize)
+{
+    CAM_APP_CryptoPool_t   *Pool = &CAM_APP_CryptoPool;
+    CAM_APP_CryptoPoolJob_t Job;
+
+    Job.Func        = Func;
+    Job.Context     = Context;
+    Job.Len         = Len;
+    Job.SegmentSize = SegmentSize;
+    Job.Segments    = (Len + SegmentSize - 1) / SegmentSize;
+    atomic_init(&Job.NextSegment, 0);
+
+    pthread_mutex_lock(&Pool->Submit);
+
+    if (Job.Segments > 1 && Pool->Workers > 0)
+    {
+        pthread_mutex_lock(&Pool->Lock);
+        Pool->Job = &Job;
+        Pool->Generation++;
+        pthread_cond_broadcast(&Pool->Posted);
+        pthread_mutex_unlock(&Pool->Lock);
+    }
+
+    CAM_APP_CryptoPoolDrain(&Job);
+
+    /* Every segment is claimed; wait for the helpers still finishing theirs */
+    pthread_mutex_lock(&Pool->Lock);
+    Pool->Job = NULL;
+    while (Pool->Busy > 0)
+    {
+        pthread_cond_wait(&Pool->Idle, &Pool->Lock);
+    }
+    pthread_mutex_unlock(&Pool->Lock);
+
+    pthread_mutex_unlock(&Pool->Submit);
+}
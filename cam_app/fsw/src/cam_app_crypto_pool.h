@@ -0,0 +1,52 @@
+/************************************************************************
+ * NASA Docket No. GSC-18,719-1, and identified as “core Flight System: Bootes”
+ *
+ * Copyright (c) 2020 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License. You may obtain
+ * a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ************************************************************************/
+
+/**
+ * @file
+ *   This file contains the prototypes for the Cam App crypto worker pool
+ *
+ *   A frame handed to the pool is cut into segments that the calling
+ *   thread and the pool's helper threads claim one at a time until none
+ *   are left, so a large frame is encrypted on every core.  What is done
+ *   to each segment is up to the caller, and segments may finish in any
+ *   order.  One frame is processed at a time; a second caller waits for
+ *   the first to finish.
+ *   Frames of a single segment, or with no helpers running, are
+ *   processed on the calling thread alone.
+ *
+ *   The pool does not depend on cFE so that ground tools can share it.
+ */
+
+#ifndef CAM_APP_CRYPTO_POOL_H
+#define CAM_APP_CRYPTO_POOL_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define CAM_APP_CRYPTO_POOL_MAX_WORKERS 16 /**< \brief Upper bound on helper threads */
+
+/*
+** Work on one segment: Len bytes starting Offset bytes into the frame
+*/
+typedef void (*CAM_APP_CryptoPoolFunc_t)(void *Context, size_t Segment, size_t Offset, size_t Len);
+
+unsigned int CAM_APP_CryptoPoolStart(unsigned int Workers);
+void         CAM_APP_CryptoPoolStop(void);
+void         CAM_APP_CryptoPoolRun(CAM_APP_CryptoPoolFunc_t Func, void *Context, size_t Len, size_t SegmentSize);
+
+#endif /* CAM_APP_CRYPTO_POOL_H */
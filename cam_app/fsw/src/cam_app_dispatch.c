@@ -152,6 +152,55 @@ void CAM_APP_ProcessGroundCommand(const CFE_SB_Buffer_t *SBBufPtr)
             }
             break;
 
+        case CAM_APP_SET_STORAGE_MODE_CC:
+            if (CAM_APP_VerifyCmdLength(&SBBufPtr->Msg, sizeof(CAM_APP_SetStorageModeCmd_t)))
+            {
+                CAM_APP_SetStorageModeCmd((const CAM_APP_SetStorageModeCmd_t *)SBBufPtr);
+            }
+            break;
+
+        case CAM_APP_SHOT_BURST_CC:
+            if (CAM_APP_VerifyCmdLength(&SBBufPtr->Msg, sizeof(CAM_APP_ShotBurstCmd_t)))
+            {
+                CAM_APP_ShotBurstCmd((const CAM_APP_ShotBurstCmd_t *)SBBufPtr);
+            }
+            break;
+
+        case CAM_APP_SET_VERIFY_CC:
+            if (CAM_APP_VerifyCmdLength(&SBBufPtr->Msg, sizeof(CAM_APP_SetVerifyCmd_t)))
+            {
+                CAM_APP_SetVerifyCmd((const CAM_APP_SetVerifyCmd_t *)SBBufPtr);
+            }
+            break;
+
+        case CAM_APP_EXTRACT_FRAME_CC:
+            if (CAM_APP_VerifyCmdLength(&SBBufPtr->Msg, sizeof(CAM_APP_ExtractFrameCmd_t)))
+            {
+                CAM_APP_ExtractFrameCmd((const CAM_APP_ExtractFrameCmd_t *)SBBufPtr);
+            }
+            break;
+
+        case CAM_APP_SET_DURABILITY_CC:
+            if (CAM_APP_VerifyCmdLength(&SBBufPtr->Msg, sizeof(CAM_APP_SetDurabilityCmd_t)))
+            {
+                CAM_APP_SetDurabilityCmd((const CAM_APP_SetDurabilityCmd_t *)SBBufPtr);
+            }
+            break;
+
+        case CAM_APP_SET_DOWNLINK_CC:
+            if (CAM_APP_VerifyCmdLength(&SBBufPtr->Msg, sizeof(CAM_APP_SetDownlinkCmd_t)))
+            {
+                CAM_APP_SetDownlinkCmd((const CAM_APP_SetDownlinkCmd_t *)SBBufPtr);
+            }
+            break;
+
+        case CAM_APP_SEND_LATENCY_CC:
+            if (CAM_APP_VerifyCmdLength(&SBBufPtr->Msg, sizeof(CAM_APP_SendLatencyCmd_t)))
+            {
+                CAM_APP_SendLatencyCmd((const CAM_APP_SendLatencyCmd_t *)SBBufPtr);
+            }
+            break;
+
 
         /* default case already found during FC vs length test */
         default:
@@ -185,6 +234,10 @@ void CAM_APP_TaskPipe(const CFE_SB_Buffer_t *SBBufPtr)
             CAM_APP_SendHkCmd((const CAM_APP_SendHkCmd_t *)SBBufPtr);
             break;
 
+        case CAM_APP_WAKEUP_MID:
+            CAM_APP_WakeupCmd((const CAM_APP_WakeupCmd_t *)SBBufPtr);
+            break;
+
         default:
             CFE_EVS_SendEvent(CAM_APP_MID_ERR_EID, CFE_EVS_EventType_ERROR,
                               "CAM: invalid command packet,MID = 0x%x", (unsigned int)CFE_SB_MsgIdToValue(MsgId));
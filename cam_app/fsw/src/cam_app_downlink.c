@@ -0,0 +1,452 @@
+/************************************************************************
+ * NASA Docket No. GSC-18,719-1, and identified as “core Flight System: Bootes”
+ *
+ * Copyright (c) 2020 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License. You may obtain
+ * a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ************************************************************************/
+
+/**
+ * \file
+ *   This file contains the source code for the Cam App image downlink.
+ */
+
+/*
+** Include Files:
+*/
+#include "cam_app_downlink.h"
+#include "cam_app_eventids.h"
+#include "cam_app_hex.h"
+
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+/* The chunk size leaves room for a 16 byte telemetry header; a mission with a larger one must shrink it */
+CompileTimeAssert(sizeof(CAM_APP_ImageTlm_t) <= CFE_MISSION_SB_MAX_SB_MSG_SIZE, CamAppImageTlmTooLarge);
+CompileTimeAssert(CAM_APP_DOWNLINK_BURST >= sizeof(CAM_APP_ImageTlm_t), CamAppDownlinkBurstTooSmall);
+
+/* Bytes of a packet ahead of its data */
+#define CAM_APP_DOWNLINK_OVERHEAD (sizeof(CAM_APP_ImageTlm_t) - CAM_APP_IMAGE_CHUNK_SIZE)
+
+#define CAM_APP_DOWNLINK_NAME_LEN (CAM_APP_PHOTO_DIR_LEN + 64)
+
+#define CAM_APP_DOWNLINK_NS_PER_SEC 1000000000ULL
+
+/*
+** A stored frame waiting to be sent
+*/
+typedef struct
+{
+    char   Name[CAM_APP_DOWNLINK_NAME_LEN];
+    uint64 Offset; /* Where the container starts in the file */
+    uint32 Length; /* Container length, bytes */
+    uint32 Sequence;
+    bool   Hex; /* Stored as hex text, two characters per byte */
+} CAM_APP_DownlinkEntry_t;
+
+/*
+** Outcome of trying to send one packet
+*/
+typedef enum
+{
+    CAM_APP_DOWNLINK_SENT,
+    CAM_APP_DOWNLINK_RETRY, /* The bus did not take it; try again on a later wakeup */
+    CAM_APP_DOWNLINK_DROP   /* The frame can no longer be read */
+} CAM_APP_DownlinkResult_t;
+
+typedef struct
+{
+    pthread_mutex_t         Lock; /* Guards the queues */
+    CAM_APP_DownlinkEntry_t Queue[CAM_APP_DOWNLINK_PRIORITIES][CAM_APP_DOWNLINK_QUEUE_DEPTH];
+    uint32                  Head[CAM_APP_DOWNLINK_PRIORITIES];
+    uint32                  Count[CAM_APP_DOWNLINK_PRIORITIES];
+
+    /* The frame being sent; main task only */
+    CAM_APP_DownlinkEntry_t Current;
+    bool                    Sending;
+    int                     Fd;
+    uint32                  Sent; /* Bytes of Current already published */
+
+    /* Budget, set by command and read on each wakeup */
+    atomic_uint RateBytesPerSec;
+    atomic_uint BurstBytes;
+
+    /* Token bucket, in byte-nanoseconds so that short wakeup periods lose nothing to rounding; main task only */
+    uint64 Tokens;
+    uint64 LastRefillNs;
+
+    char HexText[2 * CAM_APP_IMAGE_CHUNK_SIZE]; /* One packet's worth of a hex file */
+
+    atomic_ullong QueuedBytes; /* Container bytes queued and not yet sent, the current frame's included */
+    atomic_uint   ChunksSent;
+    atomic_uint   ChunkErrors;
+    atomic_uint   Throttles;
+    atomic_uint   FramesDropped;
+} CAM_APP_Downlink_t;
+
+static CAM_APP_Downlink_t CAM_APP_Downlink = {
+    .Lock            = PTHREAD_MUTEX_INITIALIZER,
+    .Fd              = -1,
+    .RateBytesPerSec = CAM_APP_DOWNLINK_RATE,
+    .BurstBytes      = CAM_APP_DOWNLINK_BURST,
+};
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Monotonic time in nanoseconds                                   */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+static uint64 CAM_APP_DownlinkNowNs(void)
+{
+    struct timespec Now;
+
+    clock_gettime(CLOCK_MONOTONIC, &Now);
+
+    return (uint64)Now.tv_sec * CAM_APP_DOWNLINK_NS_PER_SEC + (uint64)Now.tv_nsec;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Queue a stored frame for downlink                               */
+/*                                                                 */
+/* Length bytes of container start at Offset in the file Name,     */
+/* or twice as many characters if it was stored as hex text.  The  */
+/* frame is dropped if its priority's queue is full.               */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+void CAM_APP_DownlinkQueue(uint32 Priority, uint32 Sequence, const char *Name, uint64 Offset, uint32 Length,
+                           bool Hex)
+{
+    CAM_APP_Downlink_t      *Downlink = &CAM_APP_Downlink;
+    CAM_APP_DownlinkEntry_t *Entry;
+
+    if (Priority >= CAM_APP_DOWNLINK_PRIORITIES || Length == 0)
+    {
+        return;
+    }
+
+    pthread_mutex_lock(&Downlink->Lock);
+
+    if (Downlink->Count[Priority] == CAM_APP_DOWNLINK_QUEUE_DEPTH)
+    {
+        pthread_mutex_unlock(&Downlink->Lock);
+
+        atomic_fetch_add(&Downlink->FramesDropped, 1);
+        CFE_EVS_SendEvent(CAM_APP_DOWNLINK_ERR_EID, CFE_EVS_EventType_DEBUG,
+                          "CAM_APP: Downlink queue full, frame %lu not sent", (unsigned long)Sequence);
+        return;
+    }
+
+    Entry = &Downlink->Queue[Priority][(Downlink->Head[Priority] + Downlink->Count[Priority]) %
+                                        CAM_APP_DOWNLINK_QUEUE_DEPTH];
+    strncpy(Entry->Name, Name, sizeof(Entry->Name) - 1);
+    Entry->Name[sizeof(Entry->Name) - 1] = '\0';
+    Entry->Offset                        = Offset;
+    Entry->Length                        = Length;
+    Entry->Sequence                      = Sequence;
+    Entry->Hex                           = Hex;
+    Downlink->Count[Priority]++;
+
+    atomic_fetch_add(&Downlink->QueuedBytes, Length);
+
+    pthread_mutex_unlock(&Downlink->Lock);
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Stop sending the current frame                                  */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+static void CAM_APP_DownlinkFinish(void)
+{
+    CAM_APP_Downlink_t *Downlink = &CAM_APP_Downlink;
+
+    atomic_fetch_sub(&Downlink->QueuedBytes, Downlink->Current.Length - Downlink->Sent);
+
+    close(Downlink->Fd);
+    Downlink->Fd      = -1;
+    Downlink->Sending = false;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Make the highest priority frame waiting the current one         */
+/*                                                                 */
+/* Frames whose file is gone, evicted by retention for one, are    */
+/* dropped.  Returns false when nothing is waiting.                */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+static bool CAM_APP_DownlinkNext(void)
+{
+    CAM_APP_Downlink_t *Downlink = &CAM_APP_Downlink;
+    uint32              Priority;
+
+    while (true)
+    {
+        pthread_mutex_lock(&Downlink->Lock);
+
+        Priority = 0;
+        while (Priority < CAM_APP_DOWNLINK_PRIORITIES && Downlink->Count[Priority] == 0)
+        {
+            Priority++;
+        }
+
+        if (Priority == CAM_APP_DOWNLINK_PRIORITIES)
+        {
+            pthread_mutex_unlock(&Downlink->Lock);
+            return false;
+        }
+
+        Downlink->Current        = Downlink->Queue[Priority][Downlink->Head[Priority]];
+        Downlink->Head[Priority] = (Downlink->Head[Priority] + 1) % CAM_APP_DOWNLINK_QUEUE_DEPTH;
+        Downlink->Count[Priority]--;
+
+        pthread_mutex_unlock(&Downlink->Lock);
+
+        Downlink->Sent = 0;
+        Downlink->Fd   = open(Downlink->Current.Name, O_RDONLY | O_CLOEXEC);
+        if (Downlink->Fd >= 0)
+        {
+            Downlink->Sending = true;
+            return true;
+        }
+
+        atomic_fetch_sub(&Downlink->QueuedBytes, Downlink->Current.Length);
+        atomic_fetch_add(&Downlink->FramesDropped, 1);
+        CFE_EVS_SendEvent(CAM_APP_DOWNLINK_ERR_EID, CFE_EVS_EventType_DEBUG,
+                          "CAM_APP: Frame %lu gone before downlink: %s", (unsigned long)Downlink->Current.Sequence,
+                          Downlink->Current.Name);
+    }
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Read the next Chunk bytes of the current frame into a bus       */
+/* buffer and send it                                              */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+static CAM_APP_DownlinkResult_t CAM_APP_DownlinkSendChunk(size_t Chunk)
+{
+    CAM_APP_Downlink_t *Downlink = &CAM_APP_Downlink;
+    CAM_APP_ImageTlm_t *Packet;
+    CFE_SB_Buffer_t    *Buffer;
+    CFE_Status_t        status;
+    bool                Read;
+
+    Buffer = CFE_SB_AllocateMessageBuffer(CAM_APP_DOWNLINK_OVERHEAD + Chunk);
+    if (Buffer == NULL)
+    {
+        atomic_fetch_add(&Downlink->ChunkErrors, 1);
+        return CAM_APP_DOWNLINK_RETRY;
+    }
+
+    Packet = (CAM_APP_ImageTlm_t *)Buffer;
+
+    /* The frame's only copy, from the card straight into the bus buffer; hex text needs decoding on the way */
+    if (Downlink->Current.Hex)
+    {
+        Read = pread(Downlink->Fd, Downlink->HexText, 2 * Chunk,
+                     (off_t)(Downlink->Current.Offset + 2 * (uint64)Downlink->Sent)) == (ssize_t)(2 * Chunk) &&
+               CAM_APP_HexDecode(Downlink->HexText, 2 * Chunk, Packet->Payload.Data);
+    }
+    else
+    {
+        Read = pread(Downlink->Fd, Packet->Payload.Data, Chunk,
+                     (off_t)(Downlink->Current.Offset + Downlink->Sent)) == (ssize_t)Chunk;
+    }
+
+    if (!Read)
+    {
+        CFE_SB_ReleaseMessageBuffer(Buffer);
+        return CAM_APP_DOWNLINK_DROP;
+    }
+
+    CFE_MSG_Init(CFE_MSG_PTR(Packet->TelemetryHeader), CFE_SB_ValueToMsgId(CAM_APP_IMAGE_TLM_MID),
+                 CAM_APP_DOWNLINK_OVERHEAD + Chunk);
+
+    Packet->Payload.Sequence    = Downlink->Current.Sequence;
+    Packet->Payload.Offset      = Downlink->Sent;
+    Packet->Payload.TotalLength = Downlink->Current.Length;
+    Packet->Payload.DataLength  = (uint32)Chunk;
+
+    CFE_SB_TimeStampMsg(CFE_MSG_PTR(Packet->TelemetryHeader));
+
+    /* The bus owns the buffer once it is sent, and the sender still does if it was not */
+    status = CFE_SB_TransmitBuffer(Buffer, true);
+    if (status != CFE_SUCCESS)
+    {
+        CFE_SB_ReleaseMessageBuffer(Buffer);
+        atomic_fetch_add(&Downlink->ChunkErrors, 1);
+        CFE_EVS_SendEvent(CAM_APP_DOWNLINK_ERR_EID, CFE_EVS_EventType_DEBUG,
+                          "CAM_APP: Failed to send frame %lu at offset %lu, RC = 0x%08lX",
+                          (unsigned long)Downlink->Current.Sequence, (unsigned long)Downlink->Sent,
+                          (unsigned long)status);
+        return CAM_APP_DOWNLINK_RETRY;
+    }
+
+    atomic_fetch_add(&Downlink->ChunksSent, 1);
+
+    return CAM_APP_DOWNLINK_SENT;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Top up the budget and spend it on queued frames                 */
+/*                                                                 */
+/* Called on each scheduler wakeup.  A frame, once started, is     */
+/* sent to the end before a higher priority one that arrived       */
+/* meanwhile, so the ground gets each frame's packets together.    */
+/* A wakeup that leaves packets waiting for budget counts as a     */
+/* throttle.                                                       */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+void CAM_APP_DownlinkWakeup(void)
+{
+    CAM_APP_Downlink_t      *Downlink = &CAM_APP_Downlink;
+    uint32                   Rate     = atomic_load(&Downlink->RateBytesPerSec);
+    uint64                   Capacity = (uint64)atomic_load(&Downlink->BurstBytes) * CAM_APP_DOWNLINK_NS_PER_SEC;
+    uint64                   Now      = CAM_APP_DownlinkNowNs();
+    uint64                   Elapsed  = Now - Downlink->LastRefillNs;
+    uint64                   Cost;
+    size_t                   Chunk;
+    CAM_APP_DownlinkResult_t Result;
+
+    /* The first wakeup finds the bucket full; checking the time to fill first keeps the product in range */
+    if (Rate != 0 && (Downlink->LastRefillNs == 0 || Elapsed >= Capacity / Rate))
+    {
+        Downlink->Tokens = Capacity;
+    }
+    else
+    {
+        Downlink->Tokens += Elapsed * Rate;
+        if (Downlink->Tokens > Capacity)
+        {
+            Downlink->Tokens = Capacity;
+        }
+    }
+    Downlink->LastRefillNs = Now;
+
+    while (Downlink->Sending || CAM_APP_DownlinkNext())
+    {
+        Chunk = Downlink->Current.Length - Downlink->Sent;
+        if (Chunk > CAM_APP_IMAGE_CHUNK_SIZE)
+        {
+            Chunk = CAM_APP_IMAGE_CHUNK_SIZE;
+        }
+
+        /* Whole packets are charged, headers included, as that is what the link carries */
+        Cost = (uint64)(CAM_APP_DOWNLINK_OVERHEAD + Chunk) * CAM_APP_DOWNLINK_NS_PER_SEC;
+        if (Downlink->Tokens < Cost)
+        {
+            atomic_fetch_add(&Downlink->Throttles, 1);
+            return;
+        }
+
+        CFE_ES_PerfLogEntry(CAM_APP_DOWNLINK_PERF_ID);
+        Result = CAM_APP_DownlinkSendChunk(Chunk);
+        CFE_ES_PerfLogExit(CAM_APP_DOWNLINK_PERF_ID);
+
+        switch (Result)
+        {
+            case CAM_APP_DOWNLINK_RETRY:
+                return;
+
+            case CAM_APP_DOWNLINK_DROP:
+                atomic_fetch_add(&Downlink->FramesDropped, 1);
+                CFE_EVS_SendEvent(CAM_APP_DOWNLINK_ERR_EID, CFE_EVS_EventType_DEBUG,
+                                  "CAM_APP: Failed to read frame %lu at offset %lu: %s",
+                                  (unsigned long)Downlink->Current.Sequence, (unsigned long)Downlink->Sent,
+                                  Downlink->Current.Name);
+                CAM_APP_DownlinkFinish();
+                break;
+
+            default:
+                Downlink->Tokens -= Cost;
+                Downlink->Sent += (uint32)Chunk;
+                atomic_fetch_sub(&Downlink->QueuedBytes, Chunk);
+                if (Downlink->Sent == Downlink->Current.Length)
+                {
+                    CAM_APP_DownlinkFinish();
+                }
+                break;
+        }
+    }
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Set the budget: bytes per second and the most that may go out   */
+/* at once after a quiet spell                                     */
+/*                                                                 */
+/* A rate of 0 holds frames in the queue.  The burst must fit a    */
+/* full packet.                                                    */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+CFE_Status_t CAM_APP_DownlinkSetRate(uint32 RateBytesPerSec, uint32 BurstBytes)
+{
+    CAM_APP_Downlink_t *Downlink = &CAM_APP_Downlink;
+    uint64              Capacity = (uint64)BurstBytes * CAM_APP_DOWNLINK_NS_PER_SEC;
+
+    if (BurstBytes < sizeof(CAM_APP_ImageTlm_t))
+    {
+        return CFE_STATUS_RANGE_ERROR;
+    }
+
+    atomic_store(&Downlink->RateBytesPerSec, RateBytesPerSec);
+    atomic_store(&Downlink->BurstBytes, BurstBytes);
+    if (RateBytesPerSec == 0)
+    {
+        Downlink->Tokens = 0;
+    }
+    else if (Downlink->Tokens > Capacity)
+    {
+        Downlink->Tokens = Capacity;
+    }
+
+    return CFE_SUCCESS;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Report packets sent and packets that could not be, bytes        */
+/* waiting, wakeups that ran out of budget and frames given up on  */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+void CAM_APP_DownlinkStats(uint32 *ChunksSent, uint32 *ChunkErrors, uint32 *QueuedBytes, uint32 *Throttles,
+                           uint32 *FramesDropped)
+{
+    unsigned long long Queued = atomic_load(&CAM_APP_Downlink.QueuedBytes);
+
+    *ChunksSent    = atomic_load(&CAM_APP_Downlink.ChunksSent);
+    *ChunkErrors   = atomic_load(&CAM_APP_Downlink.ChunkErrors);
+    *QueuedBytes   = Queued > UINT32_MAX ? UINT32_MAX : (uint32)Queued;
+    *Throttles     = atomic_load(&CAM_APP_Downlink.Throttles);
+    *FramesDropped = atomic_load(&CAM_APP_Downlink.FramesDropped);
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Clear the statistics reported in housekeeping                   */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+void CAM_APP_DownlinkResetStats(void)
+{
+    atomic_store(&CAM_APP_Downlink.ChunksSent, 0);
+    atomic_store(&CAM_APP_Downlink.ChunkErrors, 0);
+    atomic_store(&CAM_APP_Downlink.Throttles, 0);
+    atomic_store(&CAM_APP_Downlink.FramesDropped, 0);
+}
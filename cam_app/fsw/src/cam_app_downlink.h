@@ -0,0 +1,61 @@
+/************************************************************************
+ * NASA Docket No. GSC-18,719-1, and identified as “core Flight System: Bootes”
+ *
+ * Copyright (c) 2020 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License. You may obtain
+ * a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ************************************************************************/
+
+/**
+ * @file
+ *   This file contains the prototypes for the Cam App image downlink
+ *
+ *   The downlink publishes stored encrypted frames on the software bus as
+ *   runs of image telemetry packets, within a budget of bytes per second.
+ *   Frames wait in a queue per priority as the name and place of their
+ *   container on the card, so a backlog takes neither frame slots nor bus
+ *   memory.  On each scheduler wakeup the budget is topped up, up to the
+ *   burst allowance, and spent on packets from the highest priority frame
+ *   waiting.  Each packet is read from the card straight into a buffer
+ *   taken from the bus and handed over with it, so the frame is copied
+ *   once, into the bus, and subscribers such as TO_LAB get the same
+ *   buffer without copying it again.
+ *
+ *   Frames may be queued from any thread.  Wakeups and rate changes come
+ *   from the main task only.
+ */
+
+#ifndef CAM_APP_DOWNLINK_H
+#define CAM_APP_DOWNLINK_H
+
+/*
+** Required header files.
+*/
+#include "cam_app.h"
+
+/*
+** Frame priorities, highest first
+*/
+#define CAM_APP_DOWNLINK_PRIORITY_BURST    0 /**< \brief Frames of a commanded burst */
+#define CAM_APP_DOWNLINK_PRIORITY_PERIODIC 1 /**< \brief Frames of periodic shooting */
+#define CAM_APP_DOWNLINK_PRIORITIES        2
+
+void         CAM_APP_DownlinkQueue(uint32 Priority, uint32 Sequence, const char *Name, uint64 Offset, uint32 Length,
+                                   bool Hex);
+void         CAM_APP_DownlinkWakeup(void);
+CFE_Status_t CAM_APP_DownlinkSetRate(uint32 RateBytesPerSec, uint32 BurstBytes);
+void         CAM_APP_DownlinkStats(uint32 *ChunksSent, uint32 *ChunkErrors, uint32 *QueuedBytes, uint32 *Throttles,
+                                   uint32 *FramesDropped);
+void         CAM_APP_DownlinkResetStats(void);
+
+#endif /* CAM_APP_DOWNLINK_H */
@@ -33,6 +33,16 @@
 
 #include "cam_app_eds_dispatcher.h"
 #include "cam_app_eds_dictionary.h"
+#include "cam_app_eds_typedefs.h"
+
+/*
+ * The ground decodes housekeeping from the EDS, so the C payload must keep the same layout
+ */
+CompileTimeAssert(sizeof(CAM_APP_HkTlm_Payload_t) == sizeof(EdsDataType_CAM_APP_HkTlm_Payload_t),
+                  CamAppHkTlmPayloadSizeMismatch);
+CompileTimeAssert(offsetof(CAM_APP_HkTlm_Payload_t, MissedDeadlines) ==
+                      offsetof(EdsDataType_CAM_APP_HkTlm_Payload_t, MissedDeadlines),
+                  CamAppHkTlmPayloadLayoutMismatch);
 
 /*
  * Define a lookup table for CAM app command codes
@@ -42,12 +52,20 @@ static const EdsDispatchTable_CAM_APP_Application_CFE_SB_Telecommand_t CAM_TC_DI
             .ResetCountersCmd_indication = CAM_APP_ResetCountersCmd,
             .ProcessCmd_indication       = CAM_APP_ProcessCmd,
             .DisplayParamCmd_indication  = CAM_APP_DisplayParamCmd,
-            .ShotPeriod_indication       = CAM_APP_ShotPeriodCmd,
+            .ShotPeriodCmd_indication    = CAM_APP_ShotPeriodCmd,
             .ShotStart_indication        = CAM_APP_ShotStartCmd,
             .ShotStop_indication         = CAM_APP_ShotStopCmd,
             .SecurityStart_indication    = CAM_APP_SecurityStartCmd,
-            .SecurityStop_indication     = CAM_APP_SecurityStopCmd}
-    .SEND_HK = {.indication = CAM_APP_SendHkCmd}};
+            .SecurityStop_indication     = CAM_APP_SecurityStopCmd,
+            .SetStorageModeCmd_indication = CAM_APP_SetStorageModeCmd,
+            .ShotBurstCmd_indication      = CAM_APP_ShotBurstCmd,
+            .SetVerifyCmd_indication      = CAM_APP_SetVerifyCmd,
+            .ExtractFrameCmd_indication   = CAM_APP_ExtractFrameCmd,
+            .SetDurabilityCmd_indication  = CAM_APP_SetDurabilityCmd,
+            .SetDownlinkCmd_indication    = CAM_APP_SetDownlinkCmd,
+            .SendLatencyCmd_indication    = CAM_APP_SendLatencyCmd},
+    .SEND_HK = {.indication = CAM_APP_SendHkCmd},
+    .WAKEUP  = {.indication = CAM_APP_WakeupCmd}};
 
 /* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
 /*                                                                            */
@@ -0,0 +1,549 @@
+/************************************************************************
+ * NASA Docket No. GSC-18,719-1, and identified as “core Flight System: Bootes”
+ *
+ * Copyright (c) 2020 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License. You may obtain
+ * a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ************************************************************************/
+
+/**
+ * \file
+ *   This file contains the source code for the Cam App hex codec.
+ */
+
+/*
+** Include Files:
+*/
+#include "cam_app_hex.h"
+
+#include <pthread.h>
+#include <string.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define CAM_APP_HEX_HAVE_X86
+#include <cpuid.h>
+#include <immintrin.h>
+#endif
+
+#if defined(__aarch64__)
+#define CAM_APP_HEX_HAVE_NEON
+#include <arm_neon.h>
+#include <sys/auxv.h>
+#endif
+
+/*
+** Encode In[0..Len) into 2 * Len characters at Out
+*/
+typedef void (*CAM_APP_HexEncodeFunc_t)(const uint8_t *In, size_t Len, char *Out);
+
+/*
+** Decode Len characters into Len / 2 bytes, false on a non-hex character
+*/
+typedef bool (*CAM_APP_HexDecodeFunc_t)(const char *In, size_t Len, uint8_t *Out);
+
+typedef struct
+{
+    const char             *Name;
+    bool                    (*Supported)(void); /* NULL when it runs everywhere */
+    CAM_APP_HexEncodeFunc_t Encode;
+    CAM_APP_HexDecodeFunc_t Decode;
+} CAM_APP_HexBackend_t;
+
+static const CAM_APP_HexBackend_t *CAM_APP_HexActive;
+static pthread_once_t              CAM_APP_HexInitOnce = PTHREAD_ONCE_INIT;
+
+static const char CAM_APP_HexDigits[16] = "0123456789abcdef";
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Value of one hex digit, -1 if the character is not one          */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+static int CAM_APP_HexNibble(char c)
+{
+    if (c >= '0' && c <= '9')
+    {
+        return c - '0';
+    }
+    if (c >= 'a' && c <= 'f')
+    {
+        return c - 'a' + 10;
+    }
+    if (c >= 'A' && c <= 'F')
+    {
+        return c - 'A' + 10;
+    }
+
+    return -1;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Scalar backend: encode, also used for the vector backends' tail */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+static void CAM_APP_HexScalarEncode(const uint8_t *In, size_t Len, char *Out)
+{
+    size_t i;
+
+    for (i = 0; i < Len; i++)
+    {
+        Out[2 * i]     = CAM_APP_HexDigits[In[i] >> 4];
+        Out[2 * i + 1] = CAM_APP_HexDigits[In[i] & 0x0f];
+    }
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Scalar backend: decode, also used for the vector backends' tail */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+static bool CAM_APP_HexScalarDecode(const char *In, size_t Len, uint8_t *Out)
+{
+    int    High;
+    int    Low;
+    size_t i;
+
+    for (i = 0; i < Len / 2; i++)
+    {
+        High = CAM_APP_HexNibble(In[2 * i]);
+        Low  = CAM_APP_HexNibble(In[2 * i + 1]);
+        if (High < 0 || Low < 0)
+        {
+            return false;
+        }
+
+        Out[i] = (uint8_t)((High << 4) | Low);
+    }
+
+    return true;
+}
+
+#ifdef CAM_APP_HEX_HAVE_X86
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* SSE2 backend: check CPUID for the instructions                  */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+static bool CAM_APP_HexSse2Supported(void)
+{
+    unsigned int a, b, c, d;
+
+    return __get_cpuid(1, &a, &b, &c, &d) && (d & bit_SSE2) != 0;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* SSE2 backend: turn 16 nibbles into their digits                 */
+/*                                                                 */
+/* Without a byte shuffle the digit is computed: '0' + n, plus the */
+/* gap up to 'a' for n above 9.                                    */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+__attribute__((target("sse2"))) static inline __m128i CAM_APP_HexSse2Digits(__m128i Nibbles)
+{
+    __m128i Letters = _mm_cmpgt_epi8(Nibbles, _mm_set1_epi8(9));
+
+    return _mm_add_epi8(_mm_add_epi8(Nibbles, _mm_set1_epi8('0')),
+                        _mm_and_si128(Letters, _mm_set1_epi8('a' - '0' - 10)));
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* SSE2 backend: encode 16 bytes at a time                         */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+__attribute__((target("sse2"))) static void CAM_APP_HexSse2Encode(const uint8_t *In, size_t Len, char *Out)
+{
+    const __m128i Mask = _mm_set1_epi8(0x0f);
+    __m128i       Bytes;
+    __m128i       High;
+    __m128i       Low;
+
+    for (; Len >= 16; Len -= 16, In += 16, Out += 32)
+    {
+        Bytes = _mm_loadu_si128((const __m128i *)In);
+        High  = CAM_APP_HexSse2Digits(_mm_and_si128(_mm_srli_epi16(Bytes, 4), Mask));
+        Low   = CAM_APP_HexSse2Digits(_mm_and_si128(Bytes, Mask));
+
+        _mm_storeu_si128((__m128i *)Out, _mm_unpacklo_epi8(High, Low));
+        _mm_storeu_si128((__m128i *)(Out + 16), _mm_unpackhi_epi8(High, Low));
+    }
+
+    CAM_APP_HexScalarEncode(In, Len, Out);
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* SSE2 backend: turn 16 characters into nibbles                   */
+/*                                                                 */
+/* Lanes holding anything but a hex digit are set in Invalid.      */
+/* Range checks use x - lo <= hi - lo, unsigned, with a saturating */
+/* subtract since SSE2 has no unsigned byte compare.               */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+__attribute__((target("sse2"))) static inline __m128i CAM_APP_HexSse2Nibbles(__m128i Chars, __m128i *Invalid)
+{
+    const __m128i Zero   = _mm_setzero_si128();
+    __m128i       Digit  = _mm_sub_epi8(Chars, _mm_set1_epi8('0'));
+    __m128i       Letter = _mm_sub_epi8(_mm_or_si128(Chars, _mm_set1_epi8(0x20)), _mm_set1_epi8('a'));
+    __m128i       IsDigit;
+    __m128i       IsLetter;
+
+    IsDigit  = _mm_cmpeq_epi8(_mm_subs_epu8(Digit, _mm_set1_epi8(9)), Zero);
+    IsLetter = _mm_cmpeq_epi8(_mm_subs_epu8(Letter, _mm_set1_epi8(5)), Zero);
+
+    *Invalid = _mm_or_si128(*Invalid, _mm_cmpeq_epi8(_mm_or_si128(IsDigit, IsLetter), Zero));
+
+    return _mm_or_si128(_mm_and_si128(IsDigit, Digit),
+                        _mm_andnot_si128(IsDigit, _mm_add_epi8(Letter, _mm_set1_epi8(10))));
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* SSE2 backend: decode 32 characters at a time                    */
+/*                                                                 */
+/* Both input vectors are loaded before the output is stored, so   */
+/* Out may be the same buffer as In.                               */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+__attribute__((target("sse2"))) static bool CAM_APP_HexSse2Decode(const char *In, size_t Len, uint8_t *Out)
+{
+    const __m128i LowByte = _mm_set1_epi16(0x00ff);
+    __m128i       Invalid = _mm_setzero_si128();
+    __m128i       First;
+    __m128i       Second;
+
+    for (; Len >= 32; Len -= 32, In += 32, Out += 16)
+    {
+        First  = CAM_APP_HexSse2Nibbles(_mm_loadu_si128((const __m128i *)In), &Invalid);
+        Second = CAM_APP_HexSse2Nibbles(_mm_loadu_si128((const __m128i *)(In + 16)), &Invalid);
+
+        /* Each 16-bit lane holds a high nibble in its low byte and a low nibble in its high byte */
+        First  = _mm_or_si128(_mm_slli_epi16(_mm_and_si128(First, LowByte), 4), _mm_srli_epi16(First, 8));
+        Second = _mm_or_si128(_mm_slli_epi16(_mm_and_si128(Second, LowByte), 4), _mm_srli_epi16(Second, 8));
+
+        _mm_storeu_si128((__m128i *)Out, _mm_packus_epi16(First, Second));
+    }
+
+    return _mm_movemask_epi8(Invalid) == 0 && CAM_APP_HexScalarDecode(In, Len, Out);
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* AVX2 backend: check CPUID for the instructions and that the OS  */
+/* saves the 256-bit registers                                     */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+static bool CAM_APP_HexAvx2Supported(void)
+{
+    unsigned int a, b, c, d;
+    unsigned int XcrLow;
+    unsigned int XcrHigh;
+
+    if (!__get_cpuid(1, &a, &b, &c, &d) || (c & bit_OSXSAVE) == 0)
+    {
+        return false;
+    }
+
+    __asm__ volatile("xgetbv" : "=a"(XcrLow), "=d"(XcrHigh) : "c"(0));
+    if ((XcrLow & 0x6) != 0x6)
+    {
+        return false;
+    }
+
+    return __get_cpuid_count(7, 0, &a, &b, &c, &d) && (b & bit_AVX2) != 0;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* AVX2 backend: encode 32 bytes at a time                         */
+/*                                                                 */
+/* Interleaving works within 128-bit lanes, so the two halves are  */
+/* put back in order with a cross-lane permute.                    */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+__attribute__((target("avx2"))) static void CAM_APP_HexAvx2Encode(const uint8_t *In, size_t Len, char *Out)
+{
+    const __m256i Mask   = _mm256_set1_epi8(0x0f);
+    const __m256i Digits = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i *)CAM_APP_HexDigits));
+    __m256i       Bytes;
+    __m256i       High;
+    __m256i       Low;
+    __m256i       First;
+    __m256i       Second;
+
+    for (; Len >= 32; Len -= 32, In += 32, Out += 64)
+    {
+        Bytes = _mm256_loadu_si256((const __m256i *)In);
+        High  = _mm256_shuffle_epi8(Digits, _mm256_and_si256(_mm256_srli_epi16(Bytes, 4), Mask));
+        Low   = _mm256_shuffle_epi8(Digits, _mm256_and_si256(Bytes, Mask));
+
+        First  = _mm256_unpacklo_epi8(High, Low);
+        Second = _mm256_unpackhi_epi8(High, Low);
+
+        _mm256_storeu_si256((__m256i *)Out, _mm256_permute2x128_si256(First, Second, 0x20));
+        _mm256_storeu_si256((__m256i *)(Out + 32), _mm256_permute2x128_si256(First, Second, 0x31));
+    }
+
+    CAM_APP_HexSse2Encode(In, Len, Out);
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* AVX2 backend: turn 32 characters into nibbles                   */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+__attribute__((target("avx2"))) static inline __m256i CAM_APP_HexAvx2Nibbles(__m256i Chars, __m256i *Invalid)
+{
+    __m256i Digit  = _mm256_sub_epi8(Chars, _mm256_set1_epi8('0'));
+    __m256i Letter = _mm256_sub_epi8(_mm256_or_si256(Chars, _mm256_set1_epi8(0x20)), _mm256_set1_epi8('a'));
+    __m256i IsDigit;
+    __m256i IsLetter;
+
+    IsDigit  = _mm256_cmpeq_epi8(_mm256_min_epu8(Digit, _mm256_set1_epi8(9)), Digit);
+    IsLetter = _mm256_cmpeq_epi8(_mm256_min_epu8(Letter, _mm256_set1_epi8(5)), Letter);
+
+    *Invalid = _mm256_or_si256(*Invalid, _mm256_andnot_si256(_mm256_or_si256(IsDigit, IsLetter),
+                                                             _mm256_set1_epi8(-1)));
+
+    return _mm256_blendv_epi8(_mm256_add_epi8(Letter, _mm256_set1_epi8(10)), Digit, IsDigit);
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* AVX2 backend: decode 64 characters at a time                    */
+/*                                                                 */
+/* A multiply-add joins each pair of nibbles into a 16-bit lane;   */
+/* packing is within 128-bit lanes, so a permute restores order.   */
+/* Out may be the same buffer as In.                               */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+__attribute__((target("avx2"))) static bool CAM_APP_HexAvx2Decode(const char *In, size_t Len, uint8_t *Out)
+{
+    const __m256i Weights = _mm256_set1_epi16(0x0110);
+    __m256i       Invalid = _mm256_setzero_si256();
+    __m256i       First;
+    __m256i       Second;
+
+    for (; Len >= 64; Len -= 64, In += 64, Out += 32)
+    {
+        First  = CAM_APP_HexAvx2Nibbles(_mm256_loadu_si256((const __m256i *)In), &Invalid);
+        Second = CAM_APP_HexAvx2Nibbles(_mm256_loadu_si256((const __m256i *)(In + 32)), &Invalid);
+
+        First  = _mm256_maddubs_epi16(First, Weights);
+        Second = _mm256_maddubs_epi16(Second, Weights);
+
+        _mm256_storeu_si256((__m256i *)Out, _mm256_permute4x64_epi64(_mm256_packus_epi16(First, Second), 0xd8));
+    }
+
+    return _mm256_testz_si256(Invalid, Invalid) && CAM_APP_HexSse2Decode(In, Len, Out);
+}
+
+#endif /* CAM_APP_HEX_HAVE_X86 */
+
+#ifdef CAM_APP_HEX_HAVE_NEON
+
+#ifndef HWCAP_ASIMD
+#define HWCAP_ASIMD (1 << 1)
+#endif
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* NEON backend: check the kernel's HWCAP for Advanced SIMD        */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+static bool CAM_APP_HexNeonSupported(void)
+{
+    return (getauxval(AT_HWCAP) & HWCAP_ASIMD) != 0;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* NEON backend: encode 16 bytes at a time                         */
+/*                                                                 */
+/* The interleaving store writes high and low digits alternately.  */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+static void CAM_APP_HexNeonEncode(const uint8_t *In, size_t Len, char *Out)
+{
+    const uint8x16_t Digits = vld1q_u8((const uint8_t *)CAM_APP_HexDigits);
+    uint8x16_t       Bytes;
+    uint8x16x2_t     Chars;
+
+    for (; Len >= 16; Len -= 16, In += 16, Out += 32)
+    {
+        Bytes        = vld1q_u8(In);
+        Chars.val[0] = vqtbl1q_u8(Digits, vshrq_n_u8(Bytes, 4));
+        Chars.val[1] = vqtbl1q_u8(Digits, vandq_u8(Bytes, vdupq_n_u8(0x0f)));
+
+        vst2q_u8((uint8_t *)Out, Chars);
+    }
+
+    CAM_APP_HexScalarEncode(In, Len, Out);
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* NEON backend: turn 16 characters into nibbles                   */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+static inline uint8x16_t CAM_APP_HexNeonNibbles(uint8x16_t Chars, uint8x16_t *Invalid)
+{
+    uint8x16_t Digit  = vsubq_u8(Chars, vdupq_n_u8('0'));
+    uint8x16_t Letter = vsubq_u8(vorrq_u8(Chars, vdupq_n_u8(0x20)), vdupq_n_u8('a'));
+    uint8x16_t IsDigit;
+    uint8x16_t IsLetter;
+
+    IsDigit  = vcleq_u8(Digit, vdupq_n_u8(9));
+    IsLetter = vcleq_u8(Letter, vdupq_n_u8(5));
+
+    *Invalid = vorrq_u8(*Invalid, vmvnq_u8(vorrq_u8(IsDigit, IsLetter)));
+
+    return vbslq_u8(IsDigit, Digit, vaddq_u8(Letter, vdupq_n_u8(10)));
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* NEON backend: decode 32 characters at a time                    */
+/*                                                                 */
+/* The de-interleaving load splits high and low digits apart.  Out */
+/* may be the same buffer as In.                                   */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+static bool CAM_APP_HexNeonDecode(const char *In, size_t Len, uint8_t *Out)
+{
+    uint8x16_t   Invalid = vdupq_n_u8(0);
+    uint8x16x2_t Chars;
+    uint8x16_t   High;
+    uint8x16_t   Low;
+
+    for (; Len >= 32; Len -= 32, In += 32, Out += 16)
+    {
+        Chars = vld2q_u8((const uint8_t *)In);
+        High  = CAM_APP_HexNeonNibbles(Chars.val[0], &Invalid);
+        Low   = CAM_APP_HexNeonNibbles(Chars.val[1], &Invalid);
+
+        vst1q_u8(Out, vorrq_u8(vshlq_n_u8(High, 4), Low));
+    }
+
+    return vmaxvq_u8(Invalid) == 0 && CAM_APP_HexScalarDecode(In, Len, Out);
+}
+
+#endif /* CAM_APP_HEX_HAVE_NEON */
+
+/*
+** Backends in order of preference; the first supported one is used
+*/
+static const CAM_APP_HexBackend_t CAM_APP_HexBackends[] = {
+#ifdef CAM_APP_HEX_HAVE_X86
+    {"avx2", CAM_APP_HexAvx2Supported, CAM_APP_HexAvx2Encode, CAM_APP_HexAvx2Decode},
+    {"sse2", CAM_APP_HexSse2Supported, CAM_APP_HexSse2Encode, CAM_APP_HexSse2Decode},
+#endif
+#ifdef CAM_APP_HEX_HAVE_NEON
+    {"neon", CAM_APP_HexNeonSupported, CAM_APP_HexNeonEncode, CAM_APP_HexNeonDecode},
+#endif
+    {"scalar", NULL, CAM_APP_HexScalarEncode, CAM_APP_HexScalarDecode},
+};
+
+#define CAM_APP_HEX_BACKEND_COUNT (sizeof(CAM_APP_HexBackends) / sizeof(CAM_APP_HexBackends[0]))
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Pick the backend, once per process                              */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+static void CAM_APP_HexInit(void)
+{
+    const CAM_APP_HexBackend_t *Backend;
+    size_t                      i;
+
+    for (i = 0; i < CAM_APP_HEX_BACKEND_COUNT && CAM_APP_HexActive == NULL; i++)
+    {
+        Backend = &CAM_APP_HexBackends[i];
+        if (Backend->Supported == NULL || Backend->Supported())
+        {
+            CAM_APP_HexActive = Backend;
+        }
+    }
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Name of the backend in use                                      */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+const char *CAM_APP_HexBackendName(void)
+{
+    pthread_once(&CAM_APP_HexInitOnce, CAM_APP_HexInit);
+
+    return CAM_APP_HexActive->Name;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Switch to the backend called Name                               */
+/*                                                                 */
+/* Returns false, keeping the backend in use, if there is no such  */
+/* backend or the CPU cannot run it.  No other call may be in      */
+/* progress.                                                       */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+bool CAM_APP_HexSelectBackend(const char *Name)
+{
+    const CAM_APP_HexBackend_t *Backend;
+    size_t                      i;
+
+    pthread_once(&CAM_APP_HexInitOnce, CAM_APP_HexInit);
+
+    for (i = 0; i < CAM_APP_HEX_BACKEND_COUNT; i++)
+    {
+        Backend = &CAM_APP_HexBackends[i];
+        if (strcmp(Backend->Name, Name) == 0 && (Backend->Supported == NULL || Backend->Supported()))
+        {
+            CAM_APP_HexActive = Backend;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Write Len bytes as 2 * Len lowercase hex digits, no terminator  */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+void CAM_APP_HexEncode(const uint8_t *In, size_t Len, char *Out)
+{
+    pthread_once(&CAM_APP_HexInitOnce, CAM_APP_HexInit);
+
+    CAM_APP_HexActive->Encode(In, Len, Out);
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Decode Len hex digits into Len / 2 bytes                        */
+/*                                                                 */
+/* Returns false if Len is odd or any character is not a hex       */
+/* digit; Out is then incomplete.  Out may be the same buffer as   */
+/* In, decoding in place.                                          */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+bool CAM_APP_HexDecode(const char *In, size_t Len, uint8_t *Out)
+{
+    pthread_once(&CAM_APP_HexInitOnce, CAM_APP_HexInit);
+
+    return Len % 2 == 0 && CAM_APP_HexActive->Decode(In, Len, Out);
+}
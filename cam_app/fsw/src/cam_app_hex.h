@@ -0,0 +1,53 @@
+/************************************************************************
+ * NASA Docket No. GSC-18,719-1, and identified as “core Flight System: Bootes”
+ *
+ * Copyright (c) 2020 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License. You may obtain
+ * a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ************************************************************************/
+
+/**
+ * @file
+ *   This file contains the prototypes for the Cam App hex codec
+ *
+ *   Encrypted files can still be written as hex text for ground tools
+ *   that expect it.  Encoding and decoding run over whole buffers with
+ *   one of several backends, chosen once at startup from what the CPU
+ *   supports:
+ *
+ *     avx2    x86 AVX2, 32 bytes at a time
+ *     sse2    x86 SSE2, 16 bytes at a time
+ *     neon    AArch64 Advanced SIMD, 16 bytes at a time
+ *     scalar  portable C
+ *
+ *   CAM_APP_HexSelectBackend switches to another at run time so each
+ *   can be checked against the same inputs.  Every backend produces
+ *   identical output.  Text is written in lowercase; either case is
+ *   accepted when decoding.
+ *
+ *   This module does not depend on cFE so that ground tools can share it.
+ */
+
+#ifndef CAM_APP_HEX_H
+#define CAM_APP_HEX_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+const char *CAM_APP_HexBackendName(void);
+bool        CAM_APP_HexSelectBackend(const char *Name);
+void        CAM_APP_HexEncode(const uint8_t *In, size_t Len, char *Out);
+bool        CAM_APP_HexDecode(const char *In, size_t Len, uint8_t *Out);
+
+#endif /* CAM_APP_HEX_H */
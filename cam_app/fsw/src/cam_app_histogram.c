@@ -0,0 +1,174 @@
+/************************************************************************
+ * NASA Docket No. GSC-18,719-1, and identified as “core Flight System: Bootes”
+ *
+ * Copyright (c) 2020 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License. You may obtain
+ * a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ************************************************************************/
+
+/**
+ * \file
+ *   This file contains the source code for the Cam App latency histograms.
+ */
+
+/*
+** Include Files:
+*/
+#include "cam_app_histogram.h"
+
+#include <stdatomic.h>
+
+/* Each power of two above the exact range is split into 2^SUB_BITS buckets */
+#define CAM_APP_HISTOGRAM_SUB_BITS 3
+#define CAM_APP_HISTOGRAM_SUB      (1u << CAM_APP_HISTOGRAM_SUB_BITS)
+
+/* Exact buckets for 0 to 2 * SUB - 1, then SUB per power of two up to 2^31 */
+#define CAM_APP_HISTOGRAM_BUCKETS ((32 - CAM_APP_HISTOGRAM_SUB_BITS + 1) * CAM_APP_HISTOGRAM_SUB)
+
+typedef struct
+{
+    atomic_uint Buckets[CAM_APP_HISTOGRAM_BUCKETS];
+    atomic_uint MaxUs;
+} CAM_APP_Histogram_t;
+
+static CAM_APP_Histogram_t CAM_APP_Histograms[CAM_APP_LATENCY_STAGES];
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Bucket holding a latency                                        */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+static uint32 CAM_APP_HistogramBucket(uint32 Us)
+{
+    uint32 Exponent;
+
+    if (Us < 2 * CAM_APP_HISTOGRAM_SUB)
+    {
+        return Us;
+    }
+
+    /* The leading bit picks the power of two, the next SUB_BITS bits the bucket within it */
+    Exponent = 31 - (uint32)__builtin_clz(Us);
+
+    return (Exponent - CAM_APP_HISTOGRAM_SUB_BITS + 1) * CAM_APP_HISTOGRAM_SUB +
+           ((Us >> (Exponent - CAM_APP_HISTOGRAM_SUB_BITS)) & (CAM_APP_HISTOGRAM_SUB - 1));
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Largest latency a bucket holds                                  */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+static uint32 CAM_APP_HistogramUpper(uint32 Bucket)
+{
+    uint32 Shift;
+
+    if (Bucket < 2 * CAM_APP_HISTOGRAM_SUB)
+    {
+        return Bucket;
+    }
+
+    Shift = Bucket / CAM_APP_HISTOGRAM_SUB - 1;
+
+    return (uint32)((((uint64)(Bucket % CAM_APP_HISTOGRAM_SUB + CAM_APP_HISTOGRAM_SUB) + 1) << Shift) - 1);
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Record one latency of a stage; callable from any thread         */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+void CAM_APP_HistogramRecord(uint32 Stage, uint64 LatencyUs)
+{
+    CAM_APP_Histogram_t *Histogram = &CAM_APP_Histograms[Stage];
+    uint32               Us        = LatencyUs > UINT32_MAX ? UINT32_MAX : (uint32)LatencyUs;
+    unsigned int         Seen      = atomic_load_explicit(&Histogram->MaxUs, memory_order_relaxed);
+
+    atomic_fetch_add_explicit(&Histogram->Buckets[CAM_APP_HistogramBucket(Us)], 1, memory_order_relaxed);
+
+    while (Us > Seen && !atomic_compare_exchange_weak_explicit(&Histogram->MaxUs, &Seen, Us, memory_order_relaxed,
+                                                               memory_order_relaxed))
+    {
+    }
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Report a stage's count, median, 90th and 99th percentiles and   */
+/* maximum                                                         */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+void CAM_APP_HistogramSummary(uint32 Stage, CAM_APP_LatencyStats_t *Stats)
+{
+    static const uint32  Percent[3] = {50, 90, 99};
+    CAM_APP_Histogram_t *Histogram  = &CAM_APP_Histograms[Stage];
+    uint32               Counts[CAM_APP_HISTOGRAM_BUCKETS];
+    uint32              *Results[3] = {&Stats->P50Us, &Stats->P90Us, &Stats->P99Us};
+    uint64               Total      = 0;
+    uint64               Seen       = 0;
+    uint64               Rank;
+    uint32               Bucket     = 0;
+    uint32               i;
+
+    /* Work from one snapshot so that the percentiles agree with each other and with the count */
+    for (i = 0; i < CAM_APP_HISTOGRAM_BUCKETS; i++)
+    {
+        Counts[i] = atomic_load_explicit(&Histogram->Buckets[i], memory_order_relaxed);
+        Total += Counts[i];
+    }
+
+    Stats->Count = Total > UINT32_MAX ? UINT32_MAX : (uint32)Total;
+    Stats->MaxUs = atomic_load_explicit(&Histogram->MaxUs, memory_order_relaxed);
+
+    for (i = 0; i < 3; i++)
+    {
+        *Results[i] = 0;
+        if (Total == 0)
+        {
+            continue;
+        }
+
+        /* The smallest value with at least this share of the samples at or below it */
+        Rank = (Total * Percent[i] + 99) / 100;
+        while (Seen < Rank)
+        {
+            Seen += Counts[Bucket++];
+        }
+
+        *Results[i] = CAM_APP_HistogramUpper(Bucket - 1);
+        if (*Results[i] > Stats->MaxUs)
+        {
+            *Results[i] = Stats->MaxUs;
+        }
+    }
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Clear every histogram                                           */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+void CAM_APP_HistogramReset(void)
+{
+    uint32 Stage;
+    uint32 i;
+
+    for (Stage = 0; Stage < CAM_APP_LATENCY_STAGES; Stage++)
+    {
+        for (i = 0; i < CAM_APP_HISTOGRAM_BUCKETS; i++)
+        {
+            atomic_store(&CAM_APP_Histograms[Stage].Buckets[i], 0);
+        }
+        atomic_store(&CAM_APP_Histograms[Stage].MaxUs, 0);
+    }
+}
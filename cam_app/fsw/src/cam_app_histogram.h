@@ -0,0 +1,57 @@
+/************************************************************************
+ * NASA Docket No. GSC-18,719-1, and identified as “core Flight System: Bootes”
+ *
+ * Copyright (c) 2020 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License. You may obtain
+ * a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ************************************************************************/
+
+/**
+ * @file
+ *   This file contains the prototypes for the Cam App latency histograms
+ *
+ *   Each pipeline stage, and each frame from capture to stored, records
+ *   its latency in microseconds into a histogram of fixed size.  Buckets
+ *   are exact below 16 us and above that split each power of two into
+ *   eight, so any reported value is within 12.5% of the true one, from
+ *   microseconds to the whole uint32 range.  Recording is one atomic
+ *   increment plus, for a new maximum, a compare-and-swap, so any thread
+ *   may record without taking a lock.
+ *
+ *   Percentiles are read from a snapshot of the buckets as the upper edge
+ *   of the bucket they fall in, never above the largest value recorded.
+ */
+
+#ifndef CAM_APP_HISTOGRAM_H
+#define CAM_APP_HISTOGRAM_H
+
+/*
+** Required header files.
+*/
+#include "cam_app.h"
+
+/*
+** Latencies kept
+*/
+#define CAM_APP_LATENCY_FRAME   0 /**< \brief Capture to all of a frame's files stored */
+#define CAM_APP_LATENCY_CAPTURE 1 /**< \brief Camera to frame slot */
+#define CAM_APP_LATENCY_ENCRYPT 2 /**< \brief Sealing a frame */
+#define CAM_APP_LATENCY_WRITE   3 /**< \brief A file from submission to the writer to written */
+#define CAM_APP_LATENCY_COMMIT  4 /**< \brief A durability sync of a file or group */
+#define CAM_APP_LATENCY_STAGES  5
+
+void CAM_APP_HistogramRecord(uint32 Stage, uint64 LatencyUs);
+void CAM_APP_HistogramSummary(uint32 Stage, CAM_APP_LatencyStats_t *Stats);
+void CAM_APP_HistogramReset(void);
+
+#endif /* CAM_APP_HISTOGRAM_H */
@@ -0,0 +1,1455 @@
+/************************************************************************
+ * NASA Docket No. GSC-18,719-1, and identified as “core Flight System: Bootes”
+ *
+ * Copyright (c) 2020 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License. You may obtain
+ * a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ************************************************************************/
+
+/**
+ * \file
+ *   This file contains the source code for the Cam App capture pipeline.
+ */
+
+/*
+** Include Files:
+*/
+#include "cam_app.h"
+#include "cam_app_burst.h"
+#include "cam_app_capture.h"
+#include "cam_app_container.h"
+#include "cam_app_crc.h"
+#include "cam_app_crypto.h"
+#include "cam_app_crypto_pool.h"
+#include "cam_app_downlink.h"
+#include "cam_app_eventids.h"
+#include "cam_app_histogram.h"
+#include "cam_app_pipeline.h"
+#include "cam_app_queue.h"
+#include "cam_app_retention.h"
+#include "cam_app_sched.h"
+#include "cam_app_segment.h"
+#include "cam_app_writer.h"
+
+#include "common_fnc.h"
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <time.h>
+
+#define CAM_APP_PIPELINE_NAME_LEN (CAM_APP_PHOTO_DIR_LEN + 64)
+
+#define CAM_APP_PIPELINE_BLOCK_WHEN_FULL (CAM_APP_PIPELINE_QUEUE_POLICY == CAM_APP_PIPELINE_QUEUE_POLICY_BLOCK)
+
+#define CAM_APP_PIPELINE_ENCRYPTED_HEX (CAM_APP_ENCRYPTED_FORMAT == CAM_APP_ENCRYPTED_FORMAT_HEX)
+
+/* Segment tags of the largest frame a profile may produce */
+#define CAM_APP_PIPELINE_SEAL_TAGS_SIZE \
+    CAM_APP_CONTAINER_TAGS_SIZE(CAM_APP_CAPTURE_MAX_FRAME_SIZE, CAM_APP_CRYPTO_SEGMENT_SIZE)
+
+#if CAM_APP_PIPELINE_ENCRYPTED_HEX
+#define CAM_APP_PIPELINE_READ_ENCRYPTED read_encrypted_hex
+#else
+#define CAM_APP_PIPELINE_READ_ENCRYPTED read_encrypted_data
+#endif
+
+/*
+** A pending burst request packs the frame count above the interval
+*/
+#define CAM_APP_PIPELINE_BURST_REQUEST(Count, IntervalMs) (((unsigned long long)(Count) << 32) | (IntervalMs))
+#define CAM_APP_PIPELINE_BURST_COUNT(Request)             ((uint16)((Request) >> 32))
+#define CAM_APP_PIPELINE_BURST_INTERVAL(Request)          ((uint32)(Request))
+
+/*
+** A stored file waiting to be read back and checked
+*/
+typedef struct
+{
+    char                 Name[CAM_APP_PIPELINE_NAME_LEN];
+    CAM_APP_CryptoKey_t *Key;      /* Key the file was encrypted under */
+    uint32               Sequence;
+    uint32               Digest;   /* CRC-32 of the frame as captured */
+    uint64               Offset;   /* Where the container starts in a segment */
+    uint32               Length;   /* Container length in a segment, 0 for a file of its own */
+} CAM_APP_VerifyJob_t;
+
+/*
+** The files of one slot while the writer has them
+*/
+typedef struct
+{
+    CAM_APP_FrameSlot_t   *Slot;
+    CAM_APP_WriteRequest_t Original;
+    CAM_APP_WriteRequest_t Encrypted;
+    char                   OriginalName[CAM_APP_PIPELINE_NAME_LEN];
+    char                   EncryptedName[CAM_APP_PIPELINE_NAME_LEN];
+    char                  *Text;    /* Hex image of the encrypted file, sized with the slot; HEX format only */
+    atomic_uint            Pending; /* Files not yet reported back by the writer */
+    atomic_bool            Failed;  /* A file of the frame could not be written */
+    CAM_APP_Segment_t     *Segment; /* Segment holding the frame's record, SEGMENT mode only */
+    uint64                 RecordOffset;
+    uint8                  Record[CAM_APP_SEGMENT_RECORD_SIZE];
+} CAM_APP_StoreJob_t;
+
+/*
+** Time spent by a stage on each frame, for housekeeping
+*/
+typedef struct
+{
+    atomic_uint   LastUs;
+    atomic_ullong TotalUs;
+    atomic_ullong Samples;
+} CAM_APP_PipelineLatency_t;
+
+typedef struct
+{
+    atomic_bool Running;
+    atomic_bool Stopping;
+    atomic_bool Periodic;
+
+    atomic_ullong BurstRequest; /* 0 when no burst is pending */
+
+    CAM_APP_Sched_t Sched;
+
+    pthread_t CaptureThread;
+    pthread_t CryptoThread;
+    pthread_t StorageThread;
+    pthread_t VerifyThread;
+
+    CAM_APP_Queue_t FreeQueue;
+    CAM_APP_Queue_t CryptoQueue;
+    CAM_APP_Queue_t StorageQueue;
+    CAM_APP_Queue_t VerifyFreeQueue;
+    CAM_APP_Queue_t VerifyQueue;
+
+    void *FreeRing[CAM_APP_PIPELINE_SLOTS];
+    void *CryptoRing[CAM_APP_PIPELINE_CRYPTO_QUEUE_DEPTH];
+    void *StorageRing[CAM_APP_PIPELINE_STORAGE_QUEUE_DEPTH];
+    void *VerifyFreeRing[CAM_APP_PIPELINE_VERIFY_QUEUE_DEPTH];
+    void *VerifyRing[CAM_APP_PIPELINE_VERIFY_QUEUE_DEPTH];
+
+    CAM_APP_VerifyJob_t VerifyJobs[CAM_APP_PIPELINE_VERIFY_QUEUE_DEPTH];
+
+    CAM_APP_FrameSlot_t Slots[CAM_APP_PIPELINE_SLOTS];
+    CAM_APP_StoreJob_t  StoreJobs[CAM_APP_PIPELINE_SLOTS]; /* One per slot, at the same index */
+    uint32              FrameSize;                         /* Bytes each slot Buffer holds, 0 until configured */
+
+    uint32 NextSequence;
+
+    /* Kept across runs for housekeeping, cleared by CAM_APP_PipelineResetCounters */
+    atomic_uint FramesCaptured;
+    atomic_uint FramesEncrypted;
+    atomic_uint FramesStored;
+    atomic_uint FramesFailed;
+    atomic_uint FramesDropped;
+    atomic_uint FramesVerified;
+    atomic_uint VerifyMismatches;
+    atomic_uint VerifySkipped;
+
+    CAM_APP_PipelineLatency_t CaptureLatency; /* Camera to slot, per frame */
+    CAM_APP_PipelineLatency_t EncryptLatency; /* Sealing one frame */
+    atomic_ullong             EncryptedBytes;
+
+    uint8 SealTags[CAM_APP_PIPELINE_SEAL_TAGS_SIZE]; /* Segment tags of the frame being sealed; crypto stage only */
+
+    /* The frame counts when shooting last started, so the stop event covers the run alone; main task only */
+    uint32 StartCaptured;
+    uint32 StartEncrypted;
+    uint32 StartStored;
+    uint32 StartFailed;
+    uint32 StartDropped;
+} CAM_APP_Pipeline_t;
+
+static CAM_APP_Pipeline_t CAM_APP_Pipeline;
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Give a lent frame back to its owner; Plain must not be read     */
+/* after this                                                      */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+static void CAM_APP_PipelineGiveBack(CAM_APP_FrameSlot_t *Slot)
+{
+    if (Slot->Lender == CAM_APP_PIPELINE_LENDER_CAPTURE)
+    {
+        CAM_APP_CaptureRequeue(&Slot->Frame);
+    }
+    else if (Slot->Lender == CAM_APP_PIPELINE_LENDER_BURST)
+    {
+        CAM_APP_BurstReturn();
+    }
+
+    Slot->Lender = CAM_APP_PIPELINE_LENDER_NONE;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Return a slot to the free queue, dropping its key reference and */
+/* any frame it still has on loan                                  */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+static void CAM_APP_PipelineRecycle(CAM_APP_FrameSlot_t *Slot)
+{
+    CAM_APP_PipelineGiveBack(Slot);
+
+    CAM_APP_CryptoKeyRelease(Slot->Key);
+    Slot->Key = NULL;
+
+    CAM_APP_QueuePush(&CAM_APP_Pipeline.FreeQueue, Slot, false);
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Count a frame the storage stage is done with and recycle its    */
+/* slot                                                            */
+/*                                                                 */
+/* Only a frame whose files were all written counts as stored and  */
+/* has its end-to-end latency recorded.                            */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+static void CAM_APP_PipelineRetire(CAM_APP_FrameSlot_t *Slot, bool Stored)
+{
+    struct timespec Now;
+    uint64          NowUs;
+
+    if (Stored)
+    {
+        /* Measured on the wall clock the capture time was taken from; a clock step back counts as 0 */
+        clock_gettime(CLOCK_REALTIME, &Now);
+        NowUs = (uint64)Now.tv_sec * 1000000u + (uint64)(Now.tv_nsec / 1000);
+        CAM_APP_HistogramRecord(CAM_APP_LATENCY_FRAME,
+                                NowUs > Slot->CaptureTimeUs ? NowUs - Slot->CaptureTimeUs : 0);
+
+        atomic_fetch_add(&CAM_APP_Pipeline.FramesStored, 1);
+    }
+    else
+    {
+        atomic_fetch_add(&CAM_APP_Pipeline.FramesFailed, 1);
+    }
+
+    CAM_APP_PipelineRecycle(Slot);
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Hand a slot to the next stage, or recycle it if the policy      */
+/* says to drop frames when that stage is backed up                */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+static void CAM_APP_PipelineForward(CAM_APP_Queue_t *Next, CAM_APP_FrameSlot_t *Slot)
+{
+    if (!CAM_APP_QueuePush(Next, Slot, CAM_APP_PIPELINE_BLOCK_WHEN_FULL || Slot->Lossless))
+    {
+        atomic_fetch_add(&CAM_APP_Pipeline.FramesDropped, 1);
+        CFE_EVS_SendEvent(CAM_APP_PIPELINE_DROP_ERR_EID, CFE_EVS_EventType_DEBUG,
+                          "CAM_APP: Dropped frame %lu, downstream queue full", (unsigned long)Slot->Sequence);
+        CAM_APP_PipelineRecycle(Slot);
+    }
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Format the current wall time for file names                     */
+/*                                                                 */
+/* Returns the same time in microseconds since the Unix epoch for  */
+/* the file header.                                                */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+static uint64 CAM_APP_PipelineStamp(char *Timestamp, size_t Size)
+{
+    struct timespec Now;
+    struct tm       NowTm;
+    size_t          Len;
+
+    /* Millisecond suffix keeps names unique at sub-second periods */
+    clock_gettime(CLOCK_REALTIME, &Now);
+    localtime_r(&Now.tv_sec, &NowTm);
+    Len = strftime(Timestamp, Size, "%Y%m%d_%H:%M:%S", &NowTm);
+    snprintf(Timestamp + Len, Size - Len, ".%03ld", Now.tv_nsec / 1000000L);
+
+    return (uint64)Now.tv_sec * 1000000u + (uint64)(Now.tv_nsec / 1000);
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Monotonic time in microseconds, for stage latencies             */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+static uint64 CAM_APP_PipelineNowUs(void)
+{
+    struct timespec Now;
+
+    clock_gettime(CLOCK_MONOTONIC, &Now);
+
+    return (uint64)Now.tv_sec * 1000000u + (uint64)(Now.tv_nsec / 1000);
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Record a stage's time on one frame, begun at StartUs, here and  */
+/* in the stage's histogram                                        */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+static void CAM_APP_PipelineLatencyAdd(CAM_APP_PipelineLatency_t *Latency, uint32 Stage, uint64 StartUs)
+{
+    uint64 ElapsedUs = CAM_APP_PipelineNowUs() - StartUs;
+
+    CAM_APP_HistogramRecord(Stage, ElapsedUs);
+
+    atomic_store(&Latency->LastUs, ElapsedUs > UINT32_MAX ? UINT32_MAX : (uint32)ElapsedUs);
+    atomic_fetch_add(&Latency->TotalUs, ElapsedUs);
+    atomic_fetch_add(&Latency->Samples, 1);
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Report a stage's last and mean time per frame                   */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+static void CAM_APP_PipelineLatencyGet(CAM_APP_PipelineLatency_t *Latency, uint32 *LastUs, uint32 *AvgUs)
+{
+    unsigned long long Samples = atomic_load(&Latency->Samples);
+
+    *LastUs = atomic_load(&Latency->LastUs);
+    *AvgUs  = Samples == 0 ? 0 : (uint32)(atomic_load(&Latency->TotalUs) / Samples);
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Clear a stage's times                                           */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+static void CAM_APP_PipelineLatencyReset(CAM_APP_PipelineLatency_t *Latency)
+{
+    atomic_store(&Latency->LastUs, 0);
+    atomic_store(&Latency->TotalUs, 0);
+    atomic_store(&Latency->Samples, 0);
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Take one frame from the camera into a free slot and pass it on  */
+/*                                                                 */
+/* Returns false once the pipeline is stopping.                    */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+static bool CAM_APP_PipelineShoot(void)
+{
+    CAM_APP_CaptureFrame_t Frame;
+    CAM_APP_FrameSlot_t   *Slot;
+    void                  *Item;
+    uint64                 StartUs;
+
+    if (!CAM_APP_QueuePop(&CAM_APP_Pipeline.FreeQueue, &Item, true))
+    {
+        return false;
+    }
+    Slot = Item;
+
+    CFE_ES_PerfLogEntry(CAM_APP_CAPTURE_PERF_ID);
+    StartUs = CAM_APP_PipelineNowUs();
+    if (CAM_APP_CaptureDequeue(&Frame) != CFE_SUCCESS)
+    {
+        CFE_ES_PerfLogExit(CAM_APP_CAPTURE_PERF_ID);
+        CFE_EVS_SendEvent(CAM_APP_CAPTURE_ERR_EID, CFE_EVS_EventType_ERROR,
+                          "CAM_APP: Failed to dequeue frame from %s capture", CAM_APP_CaptureBackendName());
+        CAM_APP_QueuePush(&CAM_APP_Pipeline.FreeQueue, Slot, false);
+        return true;
+    }
+
+    if (Frame.Size > CAM_APP_Pipeline.FrameSize)
+    {
+        CAM_APP_CaptureRequeue(&Frame);
+        CFE_ES_PerfLogExit(CAM_APP_CAPTURE_PERF_ID);
+        CFE_EVS_SendEvent(CAM_APP_CAPTURE_ERR_EID, CFE_EVS_EventType_ERROR,
+                          "CAM_APP: Frame of %lu bytes exceeds slot size", (unsigned long)Frame.Size);
+        CAM_APP_QueuePush(&CAM_APP_Pipeline.FreeQueue, Slot, false);
+        return true;
+    }
+
+    /* Read the frame in place when the camera can spare the buffer until the frame is sealed */
+    if (CAM_APP_CaptureMayHold())
+    {
+        Slot->Plain  = Frame.Data;
+        Slot->Frame  = Frame;
+        Slot->Lender = CAM_APP_PIPELINE_LENDER_CAPTURE;
+    }
+    else
+    {
+        memcpy(Slot->Buffer, Frame.Data, Frame.Size);
+        CAM_APP_CaptureRequeue(&Frame);
+        Slot->Plain = Slot->Buffer;
+    }
+    CAM_APP_PipelineLatencyAdd(&CAM_APP_Pipeline.CaptureLatency, CAM_APP_LATENCY_CAPTURE, StartUs);
+    CFE_ES_PerfLogExit(CAM_APP_CAPTURE_PERF_ID);
+
+    Slot->CaptureTimeUs = CAM_APP_PipelineStamp(Slot->Timestamp, sizeof(Slot->Timestamp));
+    Slot->PlainSize     = Frame.Size;
+    Slot->CipherSize    = 0;
+    Slot->StorageMode   = atomic_load(&CAM_APP_Data.StorageMode);
+    Slot->Verify        = false;
+    Slot->Sequence      = CAM_APP_Pipeline.NextSequence++;
+    Slot->Lossless      = false;
+    atomic_fetch_add(&CAM_APP_Pipeline.FramesCaptured, 1);
+
+    CAM_APP_PipelineForward(&CAM_APP_Pipeline.CryptoQueue, Slot);
+
+    return true;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Grab a burst of frames into the arena, then feed them through   */
+/* crypto and storage once the camera is no longer needed          */
+/*                                                                 */
+/* Returns false once the pipeline is stopping.                    */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+static bool CAM_APP_PipelineBurst(uint16 FrameCount, uint32 IntervalMs)
+{
+    CAM_APP_CaptureFrame_t      Frame;
+    const CAM_APP_BurstFrame_t *Held;
+    CAM_APP_FrameSlot_t        *Slot;
+    void                       *Item;
+    struct timespec             Start;
+    struct timespec             Next;
+    struct timespec             End;
+    char                        Timestamp[sizeof(Slot->Timestamp)];
+    uint64                      CaptureTimeUs;
+    uint64                      StartUs;
+    uint32                      i;
+
+    CAM_APP_BurstReset();
+
+    clock_gettime(CLOCK_MONOTONIC, &Start);
+    Next = Start;
+
+    for (i = 0; i < FrameCount && !atomic_load(&CAM_APP_Pipeline.Stopping); i++)
+    {
+        if (i > 0 && IntervalMs > 0)
+        {
+            Next.tv_sec += IntervalMs / 1000;
+            Next.tv_nsec += (long)(IntervalMs % 1000) * 1000000L;
+            if (Next.tv_nsec >= 1000000000L)
+            {
+                Next.tv_sec++;
+                Next.tv_nsec -= 1000000000L;
+            }
+
+            /* Stopping cancels the scheduler, which ends this wait too */
+            if (!CAM_APP_SchedSleepUntil(&CAM_APP_Pipeline.Sched, &Next))
+            {
+                break;
+            }
+        }
+
+        CFE_ES_PerfLogEntry(CAM_APP_CAPTURE_PERF_ID);
+        StartUs = CAM_APP_PipelineNowUs();
+        if (CAM_APP_CaptureDequeue(&Frame) != CFE_SUCCESS)
+        {
+            CFE_ES_PerfLogExit(CAM_APP_CAPTURE_PERF_ID);
+            CFE_EVS_SendEvent(CAM_APP_CAPTURE_ERR_EID, CFE_EVS_EventType_ERROR,
+                              "CAM_APP: Burst stopped at frame %lu, %s capture failed", (unsigned long)i,
+                              CAM_APP_CaptureBackendName());
+            break;
+        }
+
+        CaptureTimeUs = CAM_APP_PipelineStamp(Timestamp, sizeof(Timestamp));
+
+        if (Frame.Size > CAM_APP_Pipeline.FrameSize || !CAM_APP_BurstAppend(&Frame, Timestamp, CaptureTimeUs))
+        {
+            CAM_APP_CaptureRequeue(&Frame);
+            CFE_ES_PerfLogExit(CAM_APP_CAPTURE_PERF_ID);
+            CFE_EVS_SendEvent(CAM_APP_SHOT_BURST_ERR_EID, CFE_EVS_EventType_ERROR,
+                              "CAM_APP: Burst stopped at frame %lu, arena full", (unsigned long)i);
+            break;
+        }
+
+        CAM_APP_CaptureRequeue(&Frame);
+        CAM_APP_PipelineLatencyAdd(&CAM_APP_Pipeline.CaptureLatency, CAM_APP_LATENCY_CAPTURE, StartUs);
+        CFE_ES_PerfLogExit(CAM_APP_CAPTURE_PERF_ID);
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &End);
+
+    CFE_EVS_SendEvent(CAM_APP_SHOT_BURST_INF_EID, CFE_EVS_EventType_INFORMATION,
+                      "CAM_APP: Burst captured %lu of %u frames in %ld ms", (unsigned long)CAM_APP_BurstCount(),
+                      FrameCount,
+                      (long)((End.tv_sec - Start.tv_sec) * 1000L + (End.tv_nsec - Start.tv_nsec) / 1000000L));
+
+    /* Burst frames wait for free slots and queue room rather than being dropped */
+    for (i = 0; i < CAM_APP_BurstCount(); i++)
+    {
+        if (!CAM_APP_QueuePop(&CAM_APP_Pipeline.FreeQueue, &Item, true))
+        {
+            return false;
+        }
+        Slot = Item;
+        Held = CAM_APP_BurstLend(i);
+
+        memcpy(Slot->Timestamp, Held->Timestamp, sizeof(Slot->Timestamp));
+        Slot->Plain         = Held->Data;
+        Slot->Lender        = CAM_APP_PIPELINE_LENDER_BURST;
+        Slot->CaptureTimeUs = Held->CaptureTimeUs;
+        Slot->PlainSize     = Held->Size;
+        Slot->CipherSize    = 0;
+        Slot->StorageMode   = atomic_load(&CAM_APP_Data.StorageMode);
+        Slot->Verify        = false;
+        Slot->Sequence      = CAM_APP_Pipeline.NextSequence++;
+        Slot->Lossless      = true;
+        atomic_fetch_add(&CAM_APP_Pipeline.FramesCaptured, 1);
+
+        CAM_APP_PipelineForward(&CAM_APP_Pipeline.CryptoQueue, Slot);
+    }
+
+    return !atomic_load(&CAM_APP_Pipeline.Stopping);
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Capture stage: shoot on schedule and run requested bursts       */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+static void *CAM_APP_CaptureStage(void *Arg)
+{
+    unsigned long long Request;
+    uint32             PeriodMs;
+    bool               Periodic;
+    bool               Kicked;
+    bool               Running = true;
+
+    while (Running)
+    {
+        Periodic = atomic_load(&CAM_APP_Pipeline.Periodic);
+
+        /* A period of 0 makes an idle pipeline sleep until it is kicked */
+        PeriodMs = Periodic ? atomic_load(&CAM_APP_Data.ShotPeriodMs) : 0;
+
+        if (!CAM_APP_SchedWait(&CAM_APP_Pipeline.Sched, PeriodMs, &Kicked))
+        {
+            break;
+        }
+
+        Request = atomic_load(&CAM_APP_Pipeline.BurstRequest);
+        if (Request != 0)
+        {
+            Running = CAM_APP_PipelineBurst(CAM_APP_PIPELINE_BURST_COUNT(Request),
+                                            CAM_APP_PIPELINE_BURST_INTERVAL(Request));
+            atomic_store(&CAM_APP_Pipeline.BurstRequest, 0);
+        }
+        else if (Periodic && !Kicked)
+        {
+            Running = CAM_APP_PipelineShoot();
+        }
+    }
+
+    CAM_APP_QueueClose(&CAM_APP_Pipeline.CryptoQueue);
+
+    return NULL;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Crypto stage: encrypt the captured frame                        */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+static void *CAM_APP_CryptoStage(void *Arg)
+{
+    CAM_APP_ContainerHeader_t Header;
+    CAM_APP_ContainerStatus_t Sealed;
+    CAM_APP_FrameSlot_t      *Slot;
+    void                     *Item;
+    uint64                    StartUs;
+    uint16                    VerifyInterval;
+
+    while (CAM_APP_QueuePop(&CAM_APP_Pipeline.CryptoQueue, &Item, true))
+    {
+        Slot = Item;
+
+        /* The frame keeps the key it was encrypted under even if a new one is loaded meanwhile */
+        if (atomic_load(&CAM_APP_Data.SecurityEnabled))
+        {
+            Slot->Key = CAM_APP_CryptoKeyAcquire();
+        }
+
+        if (Slot->Key != NULL)
+        {
+            Header.SegmentSize   = CAM_APP_CRYPTO_SEGMENT_SIZE;
+            Header.Sequence      = Slot->Sequence;
+            Header.PlainSize     = Slot->PlainSize;
+            Header.CaptureTimeUs = Slot->CaptureTimeUs;
+
+            CFE_ES_PerfLogEntry(CAM_APP_ENCRYPT_PERF_ID);
+            StartUs = CAM_APP_PipelineNowUs();
+            Sealed  = CAM_APP_ContainerSeal(Slot->Key, &Header, Slot->Plain, Slot->Header, Slot->Cipher,
+                                            CAM_APP_Pipeline.SealTags, sizeof(CAM_APP_Pipeline.SealTags));
+            CFE_ES_PerfLogExit(CAM_APP_ENCRYPT_PERF_ID);
+
+            if (Sealed == CAM_APP_CONTAINER_OK)
+            {
+                CAM_APP_PipelineLatencyAdd(&CAM_APP_Pipeline.EncryptLatency, CAM_APP_LATENCY_ENCRYPT, StartUs);
+                atomic_fetch_add(&CAM_APP_Pipeline.EncryptedBytes, Slot->PlainSize);
+                Slot->CipherSize = Slot->PlainSize;
+                atomic_fetch_add(&CAM_APP_Pipeline.FramesEncrypted, 1);
+
+                /* The check of the stored file compares against this, so it needs no plaintext later */
+                VerifyInterval = atomic_load(&CAM_APP_Data.VerifyInterval);
+                Slot->Verify   = VerifyInterval != 0 && Slot->Sequence % VerifyInterval == 0;
+                if (Slot->Verify)
+                {
+                    Slot->Digest = CAM_APP_Crc32(0, Slot->Plain, Slot->PlainSize);
+                }
+
+                /* Unless the plaintext is stored too, a lent frame can go back before the files are written */
+                if (Slot->StorageMode != CAM_APP_STORAGE_MODE_FILE)
+                {
+                    CAM_APP_PipelineGiveBack(Slot);
+                }
+            }
+            else
+            {
+                CFE_EVS_SendEvent(CAM_APP_SECURITY_PROCESSING_INF_EID, CFE_EVS_EventType_ERROR,
+                                  "CAM_APP: Failed to encrypt frame %lu, %s", (unsigned long)Slot->Sequence,
+                                  CAM_APP_ContainerStatusText(Sealed));
+            }
+        }
+
+        CAM_APP_PipelineForward(&CAM_APP_Pipeline.StorageQueue, Slot);
+    }
+
+    CAM_APP_QueueClose(&CAM_APP_Pipeline.StorageQueue);
+
+    return NULL;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Queue a stored file for checking by the verify stage            */
+/*                                                                 */
+/* Called by the writer once the file is in.  The digest was taken */
+/* when the frame was sealed, so the slot can be recycled straight */
+/* away.  The writer never waits for the verifier; the check is    */
+/* skipped if it has fallen behind.                                */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+static void CAM_APP_StorageQueueVerify(const CAM_APP_FrameSlot_t *Slot, const char *EncryptedName, uint64 Offset,
+                                       uint32 Length)
+{
+    CAM_APP_VerifyJob_t *Job;
+    void                *Item;
+
+    if (!CAM_APP_QueuePop(&CAM_APP_Pipeline.VerifyFreeQueue, &Item, false))
+    {
+        atomic_fetch_add(&CAM_APP_Pipeline.VerifySkipped, 1);
+        return;
+    }
+    Job = Item;
+
+    snprintf(Job->Name, sizeof(Job->Name), "%s", EncryptedName);
+    CAM_APP_CryptoKeyRetain(Slot->Key);
+    Job->Key      = Slot->Key;
+    Job->Sequence = Slot->Sequence;
+    Job->Digest   = Slot->Digest;
+    Job->Offset   = Offset;
+    Job->Length   = Length;
+
+    /* There are as many ring entries as jobs, so this cannot fail */
+    CAM_APP_QueuePush(&CAM_APP_Pipeline.VerifyQueue, Job, false);
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Read back an encrypted file and check it decrypts to the frame  */
+/* that was captured                                               */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+static void CAM_APP_VerifyFile(const CAM_APP_VerifyJob_t *Job)
+{
+    CAM_APP_ContainerHeader_t Header;
+    CAM_APP_ContainerStatus_t Status;
+    mapped_file_t             File;
+    const char               *Reason = NULL;
+
+    /* Segment records are always binary, whatever the file format */
+    if (Job->Length != 0 ? !map_file_range(&File, Job->Name, (off_t)Job->Offset, Job->Length)
+                         : !CAM_APP_PIPELINE_READ_ENCRYPTED(&File, Job->Name))
+    {
+        Reason = "unreadable";
+    }
+    else
+    {
+        /* The mapping is private, so this decrypts in place behind the header without touching the file */
+        Status = CAM_APP_ContainerOpen(Job->Key, &Header, File.data, File.size);
+        if (Status != CAM_APP_CONTAINER_OK)
+        {
+            Reason = CAM_APP_ContainerStatusText(Status);
+        }
+        else if (Header.Sequence != Job->Sequence ||
+                 CAM_APP_Crc32(0, File.data + CAM_APP_CONTAINER_HEADER_SIZE, Header.PlainSize) != Job->Digest)
+        {
+            Reason = "digest mismatch";
+        }
+
+        unmap_file(&File);
+    }
+
+    if (Reason != NULL)
+    {
+        atomic_fetch_add(&CAM_APP_Pipeline.VerifyMismatches, 1);
+        CFE_EVS_SendEvent(CAM_APP_VERIFY_ERR_EID, CFE_EVS_EventType_ERROR,
+                          "CAM_APP: Frame %lu failed verification (%s): %s", (unsigned long)Job->Sequence, Reason,
+                          Job->Name);
+        return;
+    }
+
+    atomic_fetch_add(&CAM_APP_Pipeline.FramesVerified, 1);
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Verify stage: check queued files when nothing else needs the    */
+/* CPU                                                             */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+static void *CAM_APP_VerifyStage(void *Arg)
+{
+    CAM_APP_VerifyJob_t *Job;
+    void                *Item;
+
+#ifdef SCHED_IDLE
+    struct sched_param Param = {0};
+
+    /* Best effort: without it the checks still run, just at normal priority */
+    pthread_setschedparam(pthread_self(), SCHED_IDLE, &Param);
+#endif
+
+    while (CAM_APP_QueuePop(&CAM_APP_Pipeline.VerifyQueue, &Item, true))
+    {
+        Job = Item;
+
+        CFE_ES_PerfLogEntry(CAM_APP_VERIFY_PERF_ID);
+        CAM_APP_VerifyFile(Job);
+        CFE_ES_PerfLogExit(CAM_APP_VERIFY_PERF_ID);
+
+        CAM_APP_CryptoKeyRelease(Job->Key);
+        Job->Key = NULL;
+        CAM_APP_QueuePush(&CAM_APP_Pipeline.VerifyFreeQueue, Job, false);
+    }
+
+    return NULL;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Called by the writer as each file is finished                   */
+/*                                                                 */
+/* Once every file of the frame is in, the slot is recycled.  In   */
+/* SEGMENT mode a request is a record rather than a file.          */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+static void CAM_APP_StorageDone(CAM_APP_WriteRequest_t *Request)
+{
+    CAM_APP_StoreJob_t  *Job    = Request->Context;
+    CAM_APP_FrameSlot_t *Slot   = Job->Slot;
+    uint64               Offset = 0;
+    uint32               Length = 0;
+    uint64               Size   = 0;
+    uint32               i;
+
+    /* Records are accounted for with their segment once it is closed */
+    if (Request->Status == 0 && Request->Fd < 0)
+    {
+        for (i = 0; i < Request->PartCount; i++)
+        {
+            Size += Request->Parts[i].iov_len;
+        }
+        CAM_APP_RetentionAdd(Request == &Job->Original ? CAM_APP_RETENTION_TIER_ORIGINAL
+                                                       : CAM_APP_RETENTION_TIER_ENCRYPTED,
+                             Request->Name, Size);
+    }
+
+    if (Request->Status != 0)
+    {
+        atomic_store(&Job->Failed, true);
+    }
+
+    if (Request == &Job->Original)
+    {
+        if (Request->Status != 0)
+        {
+            CFE_EVS_SendEvent(CAM_APP_PIPELINE_ERR_EID, CFE_EVS_EventType_ERROR,
+                              "CAM_APP: Failed to write image file (%s): %s", strerror(Request->Status),
+                              Request->Name);
+        }
+    }
+    else if (Request->Status != 0)
+    {
+        CFE_EVS_SendEvent(CAM_APP_SECURITY_PROCESSING_INF_EID, CFE_EVS_EventType_ERROR,
+                          "CAM_APP: Failed to write encrypted file (%s): %s", strerror(Request->Status),
+                          Request->Name);
+    }
+    else
+    {
+        CFE_EVS_SendEvent(CAM_APP_SECURITY_PROCESSING_INF_EID, CFE_EVS_EventType_DEBUG,
+                          "CAM_APP: Encrypted data saved: %s", Request->Name);
+
+        if (Job->Segment != NULL)
+        {
+            Offset = Job->RecordOffset + CAM_APP_SEGMENT_RECORD_SIZE;
+            Length = (uint32)(sizeof(Slot->Header) + Slot->CipherSize);
+        }
+
+        if (Slot->Verify)
+        {
+            CAM_APP_StorageQueueVerify(Slot, Request->Name, Offset, Length);
+        }
+
+        /* Only where the container is on the card is queued; it is read back when its turn comes */
+        if (CAM_APP_DOWNLINK_ENABLE)
+        {
+            CAM_APP_DownlinkQueue(Slot->Lossless ? CAM_APP_DOWNLINK_PRIORITY_BURST : CAM_APP_DOWNLINK_PRIORITY_PERIODIC,
+                                  Slot->Sequence, Request->Name, Offset,
+                                  (uint32)(sizeof(Slot->Header) + Slot->CipherSize),
+                                  CAM_APP_PIPELINE_ENCRYPTED_HEX && Job->Segment == NULL);
+        }
+    }
+
+    if (atomic_fetch_sub(&Job->Pending, 1) == 1)
+    {
+        if (Job->Segment != NULL)
+        {
+            CAM_APP_SegmentRelease(Job->Segment);
+            Job->Segment = NULL;
+        }
+
+        CAM_APP_PipelineRetire(Slot, !atomic_load(&Job->Failed));
+    }
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Start a request to write the file Name, or with Fd at or above  */
+/* 0 into that open file at Offset                                 */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+static void CAM_APP_StoragePrepare(CAM_APP_StoreJob_t *Job, CAM_APP_WriteRequest_t *Request, const char *Name,
+                                   int Fd, uint64 Offset)
+{
+    Request->Name      = Name;
+    Request->Fd        = Fd;
+    Request->Offset    = Offset;
+    Request->PartCount = 0;
+    Request->Context   = Job;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Append a buffer to a request                                    */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+static void CAM_APP_StorageAddPart(CAM_APP_WriteRequest_t *Request, const void *Base, size_t Size)
+{
+    Request->Parts[Request->PartCount].iov_base = (void *)Base;
+    Request->Parts[Request->PartCount].iov_len  = Size;
+    Request->PartCount++;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Append the frame to the segment log as one record               */
+/*                                                                 */
+/* The ciphertext is kept if there is any, otherwise the frame as  */
+/* captured.  Returns NULL if no segment could be opened.          */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+static CAM_APP_WriteRequest_t *CAM_APP_StorageAppend(CAM_APP_StoreJob_t *Job, const CAM_APP_FrameSlot_t *Slot)
+{
+    CAM_APP_SegmentRecord_t Record;
+    CAM_APP_WriteRequest_t *Request;
+
+    Record.Sequence      = Slot->Sequence;
+    Record.CaptureTimeUs = Slot->CaptureTimeUs;
+
+    if (Slot->CipherSize != 0)
+    {
+        Record.Kind   = CAM_APP_SEGMENT_KIND_CONTAINER;
+        Record.Length = (uint32)(sizeof(Slot->Header) + Slot->CipherSize);
+        Record.Crc    = CAM_APP_Crc32(CAM_APP_Crc32(0, Slot->Header, sizeof(Slot->Header)), Slot->Cipher,
+                                      Slot->CipherSize);
+    }
+    else
+    {
+        Record.Kind   = CAM_APP_SEGMENT_KIND_PLAIN;
+        Record.Length = (uint32)Slot->PlainSize;
+        Record.Crc    = CAM_APP_Crc32(0, Slot->Plain, Slot->PlainSize);
+    }
+
+    Job->Segment = CAM_APP_SegmentReserve(CAM_APP_Data.PhotoDir, CAM_APP_SEGMENT_RECORD_SIZE + Record.Length,
+                                          &Job->RecordOffset);
+    if (Job->Segment == NULL)
+    {
+        return NULL;
+    }
+
+    CAM_APP_SegmentEncodeRecord(&Record, Job->Record);
+
+    Request = Record.Kind == CAM_APP_SEGMENT_KIND_CONTAINER ? &Job->Encrypted : &Job->Original;
+    CAM_APP_StoragePrepare(Job, Request, Job->Segment->Name, Job->Segment->Fd, Job->RecordOffset);
+    CAM_APP_StorageAddPart(Request, Job->Record, sizeof(Job->Record));
+    if (Record.Kind == CAM_APP_SEGMENT_KIND_CONTAINER)
+    {
+        CAM_APP_StorageAddPart(Request, Slot->Header, sizeof(Slot->Header));
+        CAM_APP_StorageAddPart(Request, Slot->Cipher, Slot->CipherSize);
+    }
+    else
+    {
+        CAM_APP_StorageAddPart(Request, Slot->Plain, Slot->PlainSize);
+    }
+
+    return Request;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Storage stage: hand the frame's files to the writer according   */
+/* to the storage mode                                             */
+/*                                                                 */
+/* The stage does not wait for the files to be written; the slot   */
+/* stays out of the free queue until the writer reports them.      */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+static void *CAM_APP_StorageStage(void *Arg)
+{
+    CAM_APP_FrameSlot_t    *Slot;
+    CAM_APP_StoreJob_t     *Job;
+    CAM_APP_WriteRequest_t *Batch[2];
+    uint32                  Count;
+    void                   *Item;
+
+    while (CAM_APP_QueuePop(&CAM_APP_Pipeline.StorageQueue, &Item, true))
+    {
+        CFE_ES_PerfLogEntry(CAM_APP_STORE_PERF_ID);
+
+        Slot  = Item;
+        Job   = &CAM_APP_Pipeline.StoreJobs[Slot - CAM_APP_Pipeline.Slots];
+        Count = 0;
+
+        if (Slot->StorageMode == CAM_APP_STORAGE_MODE_SEGMENT)
+        {
+            Batch[0] = CAM_APP_StorageAppend(Job, Slot);
+            Count    = Batch[0] != NULL ? 1 : 0;
+        }
+
+        /* In MEMORY mode the plaintext is only written when there is no ciphertext to keep instead */
+        if (Slot->StorageMode != CAM_APP_STORAGE_MODE_SEGMENT &&
+            (Slot->StorageMode == CAM_APP_STORAGE_MODE_FILE || Slot->CipherSize == 0))
+        {
+            snprintf(Job->OriginalName, sizeof(Job->OriginalName), "%s/Original_Photo/photo_%s.jpeg",
+                     CAM_APP_Data.PhotoDir, Slot->Timestamp);
+            CAM_APP_StoragePrepare(Job, &Job->Original, Job->OriginalName, -1, 0);
+            CAM_APP_StorageAddPart(&Job->Original, Slot->Plain, Slot->PlainSize);
+            Batch[Count++] = &Job->Original;
+        }
+
+        if (Slot->StorageMode != CAM_APP_STORAGE_MODE_SEGMENT && Slot->CipherSize != 0)
+        {
+            snprintf(Job->EncryptedName, sizeof(Job->EncryptedName), "%s/Encrypt_Photo/encrypted_photo_%s.enc",
+                     CAM_APP_Data.PhotoDir, Slot->Timestamp);
+
+            CAM_APP_StoragePrepare(Job, &Job->Encrypted, Job->EncryptedName, -1, 0);
+#if CAM_APP_PIPELINE_ENCRYPTED_HEX
+            CAM_APP_StorageAddPart(&Job->Encrypted, Job->Text,
+                                   encode_encrypted_hex(Slot->Header, sizeof(Slot->Header), Slot->Cipher,
+                                                        Slot->CipherSize, Job->Text));
+#else
+            CAM_APP_StorageAddPart(&Job->Encrypted, Slot->Header, sizeof(Slot->Header));
+            CAM_APP_StorageAddPart(&Job->Encrypted, Slot->Cipher, Slot->CipherSize);
+#endif
+            Batch[Count++] = &Job->Encrypted;
+        }
+
+        /* Only a frame with no segment to go in gets here with nothing to write */
+        if (Count == 0)
+        {
+            CAM_APP_PipelineRetire(Slot, false);
+        }
+        else
+        {
+            Job->Slot = Slot;
+            atomic_store(&Job->Failed, false);
+            atomic_store(&Job->Pending, Count);
+            CAM_APP_WriterSubmit(Batch, Count);
+        }
+
+        CFE_ES_PerfLogExit(CAM_APP_STORE_PERF_ID);
+    }
+
+    /* Let the writer finish, and so queue its last checks, before the verifier is told there are no more */
+    CAM_APP_WriterStop();
+    CAM_APP_SegmentClose();
+    CAM_APP_QueueClose(&CAM_APP_Pipeline.VerifyQueue);
+
+    return NULL;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Set up the scheduler and queues for a run                       */
+/*                                                                 */
+/* Returns 0, or -1 with whatever was set up freed again.          */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+static int32 CAM_APP_PipelineInitSync(void)
+{
+    CAM_APP_Pipeline_t *Pipe     = &CAM_APP_Pipeline;
+    CAM_APP_Queue_t    *Queues[] = {&Pipe->FreeQueue, &Pipe->CryptoQueue, &Pipe->StorageQueue, &Pipe->VerifyFreeQueue,
+                                    &Pipe->VerifyQueue};
+    void              **Rings[]  = {Pipe->FreeRing, Pipe->CryptoRing, Pipe->StorageRing, Pipe->VerifyFreeRing,
+                                    Pipe->VerifyRing};
+    const uint32        Depths[] = {CAM_APP_PIPELINE_SLOTS, CAM_APP_PIPELINE_CRYPTO_QUEUE_DEPTH,
+                                    CAM_APP_PIPELINE_STORAGE_QUEUE_DEPTH, CAM_APP_PIPELINE_VERIFY_QUEUE_DEPTH,
+                                    CAM_APP_PIPELINE_VERIFY_QUEUE_DEPTH};
+    uint32              i;
+
+    if (CAM_APP_SchedInit(&Pipe->Sched) != 0)
+    {
+        return -1;
+    }
+
+    for (i = 0; i < sizeof(Queues) / sizeof(Queues[0]); i++)
+    {
+        if (CAM_APP_QueueInit(Queues[i], Rings[i], Depths[i]) != 0)
+        {
+            while (i-- > 0)
+            {
+                CAM_APP_QueueDestroy(Queues[i]);
+            }
+            CAM_APP_SchedDestroy(&Pipe->Sched);
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Stop the crypto helpers and the writer and free the scheduler   */
+/* and queues; slot buffers outlive a run                          */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+static void CAM_APP_PipelineRelease(void)
+{
+    /* Normally already stopped by the storage stage on its way out */
+    CAM_APP_WriterStop();
+    CAM_APP_CryptoPoolStop();
+    CAM_APP_SchedDestroy(&CAM_APP_Pipeline.Sched);
+    CAM_APP_QueueDestroy(&CAM_APP_Pipeline.VerifyQueue);
+    CAM_APP_QueueDestroy(&CAM_APP_Pipeline.VerifyFreeQueue);
+    CAM_APP_QueueDestroy(&CAM_APP_Pipeline.StorageQueue);
+    CAM_APP_QueueDestroy(&CAM_APP_Pipeline.CryptoQueue);
+    CAM_APP_QueueDestroy(&CAM_APP_Pipeline.FreeQueue);
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Size the slot buffers for frames of up to FrameSize bytes       */
+/*                                                                 */
+/* In HEX format each slot also gets room for the hex image of its */
+/* encrypted file, so storing a frame allocates nothing.  Called   */
+/* when a capture profile is loaded, never while running.          */
+/* The new buffers are allocated before the old ones are freed so  */
+/* a failure leaves the previous profile's pool intact.            */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+CFE_Status_t CAM_APP_PipelineConfigure(uint32 FrameSize)
+{
+    CAM_APP_Pipeline_t *Pipe = &CAM_APP_Pipeline;
+    uint8              *Buffer[CAM_APP_PIPELINE_SLOTS];
+    uint8              *Cipher[CAM_APP_PIPELINE_SLOTS];
+    char               *Text[CAM_APP_PIPELINE_SLOTS];
+    bool                Allocated = true;
+    uint32              i;
+
+    if (atomic_load(&Pipe->Running))
+    {
+        return CFE_STATUS_INCORRECT_STATE;
+    }
+
+    if (FrameSize == Pipe->FrameSize)
+    {
+        return CFE_SUCCESS;
+    }
+
+    for (i = 0; i < CAM_APP_PIPELINE_SLOTS; i++)
+    {
+        Buffer[i] = malloc(FrameSize);
+        Cipher[i] = malloc(FrameSize);
+        Text[i]   = CAM_APP_PIPELINE_ENCRYPTED_HEX ? malloc(2 * (CAM_APP_CONTAINER_HEADER_SIZE + (size_t)FrameSize))
+                                                   : NULL;
+        Allocated = Allocated && Buffer[i] != NULL && Cipher[i] != NULL &&
+                    (Text[i] != NULL || !CAM_APP_PIPELINE_ENCRYPTED_HEX);
+    }
+
+    for (i = 0; i < CAM_APP_PIPELINE_SLOTS; i++)
+    {
+        /* Keep whichever set of buffers is complete and free the other */
+        if (Allocated)
+        {
+            free(Pipe->Slots[i].Buffer);
+            free(Pipe->Slots[i].Cipher);
+            free(Pipe->StoreJobs[i].Text);
+            Pipe->Slots[i].Buffer   = Buffer[i];
+            Pipe->Slots[i].Cipher   = Cipher[i];
+            Pipe->StoreJobs[i].Text = Text[i];
+        }
+        else
+        {
+            free(Buffer[i]);
+            free(Cipher[i]);
+            free(Text[i]);
+        }
+    }
+
+    if (!Allocated)
+    {
+        return CFE_STATUS_EXTERNAL_RESOURCE_FAIL;
+    }
+
+    Pipe->FrameSize = FrameSize;
+
+    return CFE_SUCCESS;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Fill the free queues and start the stage threads                */
+/*                                                                 */
+/* The capture session must already be open.  When Periodic is     */
+/* false nothing is shot until periodic shooting is enabled or a   */
+/* burst is requested.                                             */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+CFE_Status_t CAM_APP_PipelineStart(bool Periodic)
+{
+    CAM_APP_Pipeline_t *Pipe       = &CAM_APP_Pipeline;
+    uint8               Durability = atomic_load(&CAM_APP_Data.Durability);
+    uint32              Workers;
+    uint32              i;
+
+    if (atomic_load(&Pipe->Running) || Pipe->FrameSize == 0)
+    {
+        return CFE_STATUS_INCORRECT_STATE;
+    }
+
+    if (CAM_APP_PipelineInitSync() != 0)
+    {
+        return CFE_STATUS_EXTERNAL_RESOURCE_FAIL;
+    }
+
+    /* Fewer helpers only slows encryption down, so this is not fatal */
+    Workers = CAM_APP_CryptoPoolStart(CAM_APP_CRYPTO_POOL_WORKERS);
+    if (Workers < CAM_APP_CRYPTO_POOL_WORKERS)
+    {
+        CFE_EVS_SendEvent(CAM_APP_PIPELINE_ERR_EID, CFE_EVS_EventType_ERROR,
+                          "CAM_APP: Started %lu of %lu crypto helper threads", (unsigned long)Workers,
+                          (unsigned long)CAM_APP_CRYPTO_POOL_WORKERS);
+    }
+
+    CAM_APP_RetentionStart(CAM_APP_Data.PhotoDir);
+
+    if (CAM_APP_WriterStart(CAM_APP_StorageDone, Durability, CAM_APP_Data.GroupFiles, CAM_APP_Data.GroupMs) != 0)
+    {
+        CAM_APP_PipelineRelease();
+        return CFE_STATUS_EXTERNAL_RESOURCE_FAIL;
+    }
+    CAM_APP_Data.HkTlm.Payload.DurabilityPolicy = Durability;
+
+    CFE_EVS_SendEvent(CAM_APP_PIPELINE_INF_EID, CFE_EVS_EventType_DEBUG,
+                      "CAM_APP: Writing files with %s, %s durability", CAM_APP_WriterBackendName(),
+                      CAM_APP_WriterDurabilityName(Durability));
+
+    for (i = 0; i < CAM_APP_PIPELINE_SLOTS; i++)
+    {
+        CAM_APP_QueuePush(&Pipe->FreeQueue, &Pipe->Slots[i], false);
+    }
+
+    for (i = 0; i < CAM_APP_PIPELINE_VERIFY_QUEUE_DEPTH; i++)
+    {
+        CAM_APP_QueuePush(&Pipe->VerifyFreeQueue, &Pipe->VerifyJobs[i], false);
+    }
+
+    Pipe->NextSequence = 0;
+    atomic_store(&Pipe->Stopping, false);
+    atomic_store(&Pipe->Periodic, Periodic);
+    atomic_store(&Pipe->BurstRequest, 0);
+    Pipe->StartCaptured  = atomic_load(&Pipe->FramesCaptured);
+    Pipe->StartEncrypted = atomic_load(&Pipe->FramesEncrypted);
+    Pipe->StartStored    = atomic_load(&Pipe->FramesStored);
+    Pipe->StartFailed    = atomic_load(&Pipe->FramesFailed);
+    Pipe->StartDropped   = atomic_load(&Pipe->FramesDropped);
+    CAM_APP_SchedStart(&Pipe->Sched);
+
+    if (pthread_create(&Pipe->VerifyThread, NULL, CAM_APP_VerifyStage, NULL) != 0)
+    {
+        CAM_APP_PipelineRelease();
+        return CFE_STATUS_EXTERNAL_RESOURCE_FAIL;
+    }
+
+    if (pthread_create(&Pipe->StorageThread, NULL, CAM_APP_StorageStage, NULL) != 0)
+    {
+        CAM_APP_QueueClose(&Pipe->VerifyQueue);
+        pthread_join(Pipe->VerifyThread, NULL);
+        CAM_APP_PipelineRelease();
+        return CFE_STATUS_EXTERNAL_RESOURCE_FAIL;
+    }
+
+    if (pthread_create(&Pipe->CryptoThread, NULL, CAM_APP_CryptoStage, NULL) != 0)
+    {
+        CAM_APP_QueueClose(&Pipe->StorageQueue);
+        pthread_join(Pipe->StorageThread, NULL);
+        pthread_join(Pipe->VerifyThread, NULL);
+        CAM_APP_PipelineRelease();
+        return CFE_STATUS_EXTERNAL_RESOURCE_FAIL;
+    }
+
+    if (pthread_create(&Pipe->CaptureThread, NULL, CAM_APP_CaptureStage, NULL) != 0)
+    {
+        CAM_APP_QueueClose(&Pipe->CryptoQueue);
+        pthread_join(Pipe->CryptoThread, NULL);
+        pthread_join(Pipe->StorageThread, NULL);
+        pthread_join(Pipe->VerifyThread, NULL);
+        CAM_APP_PipelineRelease();
+        return CFE_STATUS_EXTERNAL_RESOURCE_FAIL;
+    }
+
+    atomic_store(&Pipe->Running, true);
+
+    return CFE_SUCCESS;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Stop capturing and wait for queued frames to be stored and      */
+/* checked                                                         */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+void CAM_APP_PipelineStop(void)
+{
+    CAM_APP_Pipeline_t *Pipe = &CAM_APP_Pipeline;
+
+    if (!atomic_load(&Pipe->Running))
+    {
+        return;
+    }
+
+    /* Each stage closes the next stage's queue on exit, from capture down to verify */
+    atomic_store(&Pipe->Stopping, true);
+    CAM_APP_SchedCancel(&Pipe->Sched);
+    CAM_APP_QueueClose(&Pipe->FreeQueue);
+
+    pthread_join(Pipe->CaptureThread, NULL);
+    pthread_join(Pipe->CryptoThread, NULL);
+    pthread_join(Pipe->StorageThread, NULL);
+    pthread_join(Pipe->VerifyThread, NULL);
+
+    CAM_APP_PipelineRelease();
+    atomic_store(&Pipe->Running, false);
+
+    CFE_EVS_SendEvent(CAM_APP_PIPELINE_INF_EID, CFE_EVS_EventType_INFORMATION,
+                      "CAM_APP: Pipeline stopped, captured %u, encrypted %u, stored %u, failed %u, dropped %u, "
+                      "missed %u",
+                      atomic_load(&Pipe->FramesCaptured) - Pipe->StartCaptured,
+                      atomic_load(&Pipe->FramesEncrypted) - Pipe->StartEncrypted,
+                      atomic_load(&Pipe->FramesStored) - Pipe->StartStored,
+                      atomic_load(&Pipe->FramesFailed) - Pipe->StartFailed,
+                      atomic_load(&Pipe->FramesDropped) - Pipe->StartDropped,
+                      atomic_load(&Pipe->Sched.MissedDeadlines));
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Report whether the pipeline threads are running                 */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+bool CAM_APP_PipelineIsRunning(void)
+{
+    return atomic_load(&CAM_APP_Pipeline.Running);
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Turn periodic shooting on or off without stopping the pipeline  */
+/*                                                                 */
+/* Turning it on restarts the schedule so the first shot is taken  */
+/* at once.                                                        */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+void CAM_APP_PipelineSetPeriodic(bool Periodic)
+{
+    if (!atomic_load(&CAM_APP_Pipeline.Running))
+    {
+        return;
+    }
+
+    atomic_store(&CAM_APP_Pipeline.Periodic, Periodic);
+
+    if (Periodic)
+    {
+        CAM_APP_SchedStart(&CAM_APP_Pipeline.Sched);
+    }
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Report whether periodic shooting is enabled                     */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+bool CAM_APP_PipelineIsPeriodic(void)
+{
+    return atomic_load(&CAM_APP_Pipeline.Running) && atomic_load(&CAM_APP_Pipeline.Periodic);
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Ask the capture stage to run a burst at its next opportunity    */
+/*                                                                 */
+/* Only one burst may be pending or in progress at a time.         */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+CFE_Status_t CAM_APP_PipelineRequestBurst(uint16 FrameCount, uint32 IntervalMs)
+{
+    unsigned long long Idle = 0;
+
+    if (!atomic_load(&CAM_APP_Pipeline.Running) || FrameCount == 0)
+    {
+        return CFE_STATUS_INCORRECT_STATE;
+    }
+
+    if (!atomic_compare_exchange_strong(&CAM_APP_Pipeline.BurstRequest, &Idle,
+                                        CAM_APP_PIPELINE_BURST_REQUEST(FrameCount, IntervalMs)))
+    {
+        return CFE_STATUS_INCORRECT_STATE;
+    }
+
+    CAM_APP_SchedKick(&CAM_APP_Pipeline.Sched);
+
+    return CFE_SUCCESS;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Number of shot deadlines missed since shooting last started     */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+uint32 CAM_APP_PipelineMissedDeadlines(void)
+{
+    return atomic_load(&CAM_APP_Pipeline.Sched.MissedDeadlines);
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Report the verification counters                                */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+void CAM_APP_PipelineVerifyCounts(uint32 *Verified, uint32 *Mismatches, uint32 *Skipped)
+{
+    *Verified   = atomic_load(&CAM_APP_Pipeline.FramesVerified);
+    *Mismatches = atomic_load(&CAM_APP_Pipeline.VerifyMismatches);
+    *Skipped    = atomic_load(&CAM_APP_Pipeline.VerifySkipped);
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Report the frames that reached each stage, those that could not */
+/* be stored and those dropped                                     */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+void CAM_APP_PipelineFrameCounts(uint32 *Captured, uint32 *Encrypted, uint32 *Stored, uint32 *Failed,
+                                 uint32 *Dropped)
+{
+    *Captured  = atomic_load(&CAM_APP_Pipeline.FramesCaptured);
+    *Encrypted = atomic_load(&CAM_APP_Pipeline.FramesEncrypted);
+    *Stored    = atomic_load(&CAM_APP_Pipeline.FramesStored);
+    *Failed    = atomic_load(&CAM_APP_Pipeline.FramesFailed);
+    *Dropped   = atomic_load(&CAM_APP_Pipeline.FramesDropped);
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Report the last and mean capture and encryption times, and the  */
+/* encryption rate in KiB per second spent encrypting              */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+void CAM_APP_PipelineLatencies(uint32 *CaptureLastUs, uint32 *CaptureAvgUs, uint32 *EncryptLastUs,
+                               uint32 *EncryptAvgUs, uint32 *EncryptKbPerSec)
+{
+    unsigned long long TotalUs = atomic_load(&CAM_APP_Pipeline.EncryptLatency.TotalUs);
+
+    CAM_APP_PipelineLatencyGet(&CAM_APP_Pipeline.CaptureLatency, CaptureLastUs, CaptureAvgUs);
+    CAM_APP_PipelineLatencyGet(&CAM_APP_Pipeline.EncryptLatency, EncryptLastUs, EncryptAvgUs);
+
+    *EncryptKbPerSec =
+        TotalUs == 0 ? 0 : (uint32)(atomic_load(&CAM_APP_Pipeline.EncryptedBytes) * 1000000u / TotalUs / 1024u);
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Report the frames waiting for the crypto and storage stages     */
+/*                                                                 */
+/* Called from the main task, which is also the only one to start  */
+/* and stop the pipeline, so the queues cannot go away meanwhile.  */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+void CAM_APP_PipelineQueueDepths(uint32 *Crypto, uint32 *Storage)
+{
+    if (!atomic_load(&CAM_APP_Pipeline.Running))
+    {
+        *Crypto  = 0;
+        *Storage = 0;
+        return;
+    }
+
+    *Crypto  = CAM_APP_QueueCount(&CAM_APP_Pipeline.CryptoQueue);
+    *Storage = CAM_APP_QueueCount(&CAM_APP_Pipeline.StorageQueue);
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Clear the counters reported in housekeeping                     */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+void CAM_APP_PipelineResetCounters(void)
+{
+    CAM_APP_Pipeline_t *Pipe = &CAM_APP_Pipeline;
+
+    atomic_store(&Pipe->FramesCaptured, 0);
+    atomic_store(&Pipe->FramesEncrypted, 0);
+    atomic_store(&Pipe->FramesStored, 0);
+    atomic_store(&Pipe->FramesFailed, 0);
+    atomic_store(&Pipe->FramesDropped, 0);
+    atomic_store(&Pipe->FramesVerified, 0);
+    atomic_store(&Pipe->VerifyMismatches, 0);
+    atomic_store(&Pipe->VerifySkipped, 0);
+    CAM_APP_PipelineLatencyReset(&Pipe->CaptureLatency);
+    CAM_APP_PipelineLatencyReset(&Pipe->EncryptLatency);
+    atomic_store(&Pipe->EncryptedBytes, 0);
+
+    /* A run in progress is then reported from here */
+    Pipe->StartCaptured  = 0;
+    Pipe->StartEncrypted = 0;
+    Pipe->StartStored    = 0;
+    Pipe->StartFailed    = 0;
+    Pipe->StartDropped   = 0;
+}
@@ -0,0 +1,110 @@
+/************************************************************************
+ * NASA Docket No. GSC-18,719-1, and identified as “core Flight System: Bootes”
+ *
+ * Copyright (c) 2020 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License. You may obtain
+ * a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ************************************************************************/
+
+/**
+ * @file
+ *   This file contains the prototypes for the Cam App capture pipeline
+ *
+ *   Frames flow through three stages, each on its own thread:
+ *
+ *     capture --> [crypto queue] --> crypto --> [storage queue] --> storage
+ *
+ *   so that capturing frame N+1 overlaps encrypting frame N and writing
+ *   frame N-1.  Storage only hands the files to the background writer in
+ *   cam_app_writer.h, so a slow card holds up the slot being written but
+ *   not the stage.  A fourth, idle-priority thread reads back a sample of the
+ *   stored files and checks that they decrypt to the captured frames.
+ *   Frames live in a fixed pool of slots whose buffers are sized for the
+ *   active capture profile when the table is loaded.  Where the camera
+ *   allows it, a slot reads the frame in place in the camera's buffer or
+ *   the burst arena instead of copying it, and gives it back as soon as
+ *   nothing downstream needs the plaintext: once it is sealed if only
+ *   ciphertext is stored, otherwise once the frame is stored.
+ *
+ *   The capture stage shoots on the periodic schedule and, on request,
+ *   runs a burst: frames are grabbed back to back into the burst arena
+ *   and then fed through the other stages without being dropped.  A
+ *   pipeline started for a burst alone stays idle afterwards until it is
+ *   stopped or periodic shooting is enabled.
+ */
+
+#ifndef CAM_APP_PIPELINE_H
+#define CAM_APP_PIPELINE_H
+
+/*
+** Required header files.
+*/
+#include "cam_app.h"
+#include "cam_app_capture.h"
+#include "cam_app_container.h"
+#include "cam_app_crypto.h"
+
+/*
+** One slot per queue entry plus one in the hands of each stage
+*/
+#define CAM_APP_PIPELINE_SLOTS (CAM_APP_PIPELINE_CRYPTO_QUEUE_DEPTH + CAM_APP_PIPELINE_STORAGE_QUEUE_DEPTH + 3)
+
+/*
+** Owner of the memory a slot's plaintext is in
+*/
+#define CAM_APP_PIPELINE_LENDER_NONE    0 /* The slot's own Buffer */
+#define CAM_APP_PIPELINE_LENDER_CAPTURE 1 /* A capture backend buffer, given back with a requeue */
+#define CAM_APP_PIPELINE_LENDER_BURST   2 /* A burst arena frame, given back with CAM_APP_BurstReturn */
+
+/*
+** A frame travelling through the pipeline
+*/
+typedef struct
+{
+    const uint8           *Plain;      /**< \brief Captured frame bytes, in Buffer or lent to the slot */
+    uint8                 *Buffer;     /**< \brief The slot's own frame buffer, for frames that are copied */
+    uint8                 *Cipher;     /**< \brief Encrypted frame */
+    size_t                 PlainSize;  /**< \brief Valid bytes at Plain */
+    size_t                 CipherSize; /**< \brief Valid bytes at Cipher, 0 when not encrypted */
+    uint8                  Lender;     /**< \brief Owner of the memory at Plain, CAM_APP_PIPELINE_LENDER_* */
+    CAM_APP_CaptureFrame_t Frame;      /**< \brief Camera frame at Plain while the camera lends it */
+
+    uint8                StorageMode; /**< \brief Storage mode when the frame was captured */
+    bool                 Verify;      /**< \brief Read the encrypted file back once it is stored */
+    uint32               Digest;      /**< \brief CRC-32 of the plaintext, taken at sealing when Verify */
+    CAM_APP_CryptoKey_t *Key;         /**< \brief Key held for the frame while it is encrypted and stored */
+    uint32               Sequence;    /**< \brief Capture sequence number since shooting started */
+    bool                 Lossless;    /**< \brief Wait for room downstream instead of dropping (burst frames) */
+
+    uint64 CaptureTimeUs;                         /**< \brief Capture wall time, microseconds since the Unix epoch */
+    char   Timestamp[24];                         /**< \brief Capture wall time, YYYYMMDD_HH:MM:SS.mmm */
+    uint8  Header[CAM_APP_CONTAINER_HEADER_SIZE]; /**< \brief File header written in front of Cipher */
+} CAM_APP_FrameSlot_t;
+
+CFE_Status_t CAM_APP_PipelineConfigure(uint32 FrameSize);
+CFE_Status_t CAM_APP_PipelineStart(bool Periodic);
+void         CAM_APP_PipelineStop(void);
+bool         CAM_APP_PipelineIsRunning(void);
+void         CAM_APP_PipelineSetPeriodic(bool Periodic);
+bool         CAM_APP_PipelineIsPeriodic(void);
+CFE_Status_t CAM_APP_PipelineRequestBurst(uint16 FrameCount, uint32 IntervalMs);
+uint32       CAM_APP_PipelineMissedDeadlines(void);
+void         CAM_APP_PipelineVerifyCounts(uint32 *Verified, uint32 *Mismatches, uint32 *Skipped);
+void         CAM_APP_PipelineFrameCounts(uint32 *Captured, uint32 *Encrypted, uint32 *Stored, uint32 *Failed,
+                                         uint32 *Dropped);
+void         CAM_APP_PipelineLatencies(uint32 *CaptureLastUs, uint32 *CaptureAvgUs, uint32 *EncryptLastUs,
+                                       uint32 *EncryptAvgUs, uint32 *EncryptKbPerSec);
+void         CAM_APP_PipelineQueueDepths(uint32 *Crypto, uint32 *Storage);
+void         CAM_APP_PipelineResetCounters(void);
+
+#endif /* CAM_APP_PIPELINE_H */
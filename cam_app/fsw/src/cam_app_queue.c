@@ -0,0 +1,231 @@
+/************************************************************************
+ * NASA Docket No. GSC-18,719-1, and identified as “core Flight System: Bootes”
+ *
+ * Copyright (c) 2020 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License. You may obtain
+ * a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ************************************************************************/
+
+/**
+ * \file
+ *   This file contains the source code for the Cam App bounded queue.
+ */
+
+/*
+** Include Files:
+*/
+#include "cam_app_queue.h"
+
+#include <errno.h>
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Set up an empty queue over caller-provided ring storage         */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+int32 CAM_APP_QueueInit(CAM_APP_Queue_t *Queue, void **Ring, uint32 Depth)
+{
+    pthread_condattr_t Attr;
+    int                Status;
+
+    Queue->Ring      = Ring;
+    Queue->Depth     = Depth;
+    Queue->Head      = 0;
+    Queue->Count     = 0;
+    Queue->HighWater = 0;
+    Queue->Closed    = false;
+
+    if (pthread_mutex_init(&Queue->Lock, NULL) != 0)
+    {
+        return -1;
+    }
+
+    /* Timed pops take monotonic deadlines, so that setting the clock does not stretch or cut a wait */
+    if (pthread_condattr_init(&Attr) != 0)
+    {
+        pthread_mutex_destroy(&Queue->Lock);
+        return -1;
+    }
+    pthread_condattr_setclock(&Attr, CLOCK_MONOTONIC);
+
+    Status = pthread_cond_init(&Queue->NotEmpty, &Attr);
+    if (Status == 0)
+    {
+        Status = pthread_cond_init(&Queue->NotFull, &Attr);
+        if (Status != 0)
+        {
+            pthread_cond_destroy(&Queue->NotEmpty);
+        }
+    }
+    pthread_condattr_destroy(&Attr);
+
+    if (Status != 0)
+    {
+        pthread_mutex_destroy(&Queue->Lock);
+        return -1;
+    }
+
+    return 0;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Release the queue's synchronization objects                     */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+void CAM_APP_QueueDestroy(CAM_APP_Queue_t *Queue)
+{
+    pthread_cond_destroy(&Queue->NotFull);
+    pthread_cond_destroy(&Queue->NotEmpty);
+    pthread_mutex_destroy(&Queue->Lock);
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Append an item                                                  */
+/*                                                                 */
+/* When the queue is full, either wait for room (Block) or fail    */
+/* immediately so the caller can drop the item.  Always fails once */
+/* the queue is closed.                                            */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+bool CAM_APP_QueuePush(CAM_APP_Queue_t *Queue, void *Item, bool Block)
+{
+    bool Pushed = false;
+
+    pthread_mutex_lock(&Queue->Lock);
+
+    while (Block && !Queue->Closed && Queue->Count == Queue->Depth)
+    {
+        pthread_cond_wait(&Queue->NotFull, &Queue->Lock);
+    }
+
+    if (!Queue->Closed && Queue->Count < Queue->Depth)
+    {
+        Queue->Ring[(Queue->Head + Queue->Count) % Queue->Depth] = Item;
+        Queue->Count++;
+        if (Queue->Count > Queue->HighWater)
+        {
+            Queue->HighWater = Queue->Count;
+        }
+
+        pthread_cond_signal(&Queue->NotEmpty);
+        Pushed = true;
+    }
+
+    pthread_mutex_unlock(&Queue->Lock);
+
+    return Pushed;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Remove the oldest item                                          */
+/*                                                                 */
+/* A blocking pop waits until an item arrives.  Fails when the     */
+/* queue is empty and either non-blocking or closed, so consumers  */
+/* drain everything queued before a close.                         */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+bool CAM_APP_QueuePop(CAM_APP_Queue_t *Queue, void **Item, bool Block)
+{
+    bool Popped = false;
+
+    pthread_mutex_lock(&Queue->Lock);
+
+    while (Block && !Queue->Closed && Queue->Count == 0)
+    {
+        pthread_cond_wait(&Queue->NotEmpty, &Queue->Lock);
+    }
+
+    if (Queue->Count > 0)
+    {
+        *Item       = Queue->Ring[Queue->Head];
+        Queue->Head = (Queue->Head + 1) % Queue->Depth;
+        Queue->Count--;
+
+        pthread_cond_signal(&Queue->NotFull);
+        Popped = true;
+    }
+
+    pthread_mutex_unlock(&Queue->Lock);
+
+    return Popped;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Remove the oldest item, waiting no later than Deadline          */
+/*                                                                 */
+/* Deadline is on CLOCK_MONOTONIC.  Fails once it has passed, or   */
+/* straight away when the queue is empty and closed.               */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+bool CAM_APP_QueuePopUntil(CAM_APP_Queue_t *Queue, void **Item, const struct timespec *Deadline)
+{
+    bool Popped = false;
+
+    pthread_mutex_lock(&Queue->Lock);
+
+    while (!Queue->Closed && Queue->Count == 0)
+    {
+        if (pthread_cond_timedwait(&Queue->NotEmpty, &Queue->Lock, Deadline) == ETIMEDOUT)
+        {
+            break;
+        }
+    }
+
+    if (Queue->Count > 0)
+    {
+        *Item       = Queue->Ring[Queue->Head];
+        Queue->Head = (Queue->Head + 1) % Queue->Depth;
+        Queue->Count--;
+
+        pthread_cond_signal(&Queue->NotFull);
+        Popped = true;
+    }
+
+    pthread_mutex_unlock(&Queue->Lock);
+
+    return Popped;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Refuse further pushes and wake every waiter                     */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+void CAM_APP_QueueClose(CAM_APP_Queue_t *Queue)
+{
+    pthread_mutex_lock(&Queue->Lock);
+    Queue->Closed = true;
+    pthread_cond_broadcast(&Queue->NotEmpty);
+    pthread_cond_broadcast(&Queue->NotFull);
+    pthread_mutex_unlock(&Queue->Lock);
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Number of items currently queued                                */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+uint32 CAM_APP_QueueCount(CAM_APP_Queue_t *Queue)
+{
+    uint32 Count;
+
+    pthread_mutex_lock(&Queue->Lock);
+    Count = Queue->Count;
+    pthread_mutex_unlock(&Queue->Lock);
+
+    return Count;
+}
@@ -0,0 +1,62 @@
+/************************************************************************
+ * NASA Docket No. GSC-18,719-1, and identified as “core Flight System: Bootes”
+ *
+ * Copyright (c) 2020 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License. You may obtain
+ * a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ************************************************************************/
+
+/**
+ * @file
+ *   This file contains the bounded queue used between Cam App pipeline stages
+ */
+
+#ifndef CAM_APP_QUEUE_H
+#define CAM_APP_QUEUE_H
+
+/*
+** Required header files.
+*/
+#include "common_types.h"
+
+#include <pthread.h>
+#include <time.h>
+
+/*
+** Fixed-depth FIFO of pointers, safe for any number of producers and consumers
+**
+** The ring storage is supplied by the caller so that every queue is sized
+** at compile time from the platform configuration.
+*/
+typedef struct
+{
+    void          **Ring;
+    uint32          Depth;
+    uint32          Head;  /* Index of the oldest item */
+    uint32          Count; /* Number of items held */
+    uint32          HighWater;
+    bool            Closed;
+    pthread_mutex_t Lock;
+    pthread_cond_t  NotEmpty;
+    pthread_cond_t  NotFull;
+} CAM_APP_Queue_t;
+
+int32  CAM_APP_QueueInit(CAM_APP_Queue_t *Queue, void **Ring, uint32 Depth);
+void   CAM_APP_QueueDestroy(CAM_APP_Queue_t *Queue);
+bool   CAM_APP_QueuePush(CAM_APP_Queue_t *Queue, void *Item, bool Block);
+bool   CAM_APP_QueuePop(CAM_APP_Queue_t *Queue, void **Item, bool Block);
+bool   CAM_APP_QueuePopUntil(CAM_APP_Queue_t *Queue, void **Item, const struct timespec *Deadline);
+void   CAM_APP_QueueClose(CAM_APP_Queue_t *Queue);
+uint32 CAM_APP_QueueCount(CAM_APP_Queue_t *Queue);
+
+#endif /* CAM_APP_QUEUE_H */
@@ -0,0 +1,403 @@
+/************************************************************************
+ * NASA Docket No. GSC-18,719-1, and identified as “core Flight System: Bootes”
+ *
+ * Copyright (c) 2020 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License. You may obtain
+ * a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ************************************************************************/
+
+/**
+ * \file
+ *   This file contains the source code for the Cam App retention manager.
+ */
+
+/*
+** Include Files:
+*/
+#include "cam_app_eventids.h"
+#include "cam_app_retention.h"
+
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <sys/statvfs.h>
+#include <time.h>
+#include <unistd.h>
+
+#if CAM_APP_RETENTION_LOW_WATERMARK >= CAM_APP_RETENTION_HIGH_WATERMARK && CAM_APP_RETENTION_HIGH_WATERMARK != 0
+#error CAM_APP_RETENTION_LOW_WATERMARK must be below CAM_APP_RETENTION_HIGH_WATERMARK
+#endif
+
+#define CAM_APP_RETENTION_NAME_LEN  48 /* Longest file name kept in the index */
+#define CAM_APP_RETENTION_MIN_DEPTH 64
+
+/*
+** One stored file
+*/
+typedef struct
+{
+    uint64 Age;  /* Nanoseconds since the Unix epoch when it was stored */
+    uint64 Size; /* Bytes */
+    char   Name[CAM_APP_RETENTION_NAME_LEN];
+} CAM_APP_RetentionEntry_t;
+
+/*
+** The files of one tier, oldest first, in a ring that grows as needed
+*/
+typedef struct
+{
+    const char               *Dir;
+    CAM_APP_RetentionEntry_t *Entries;
+    uint32                    Depth;
+    uint32                    Head;  /* Index of the oldest file */
+    uint32                    Count; /* Number of files held */
+    uint64                    Bytes;
+} CAM_APP_RetentionTier_t;
+
+typedef struct
+{
+    pthread_mutex_t         Lock;
+    bool                    Indexed;
+    char                    PhotoDir[CAM_APP_PHOTO_DIR_LEN];
+    CAM_APP_RetentionTier_t Tiers[CAM_APP_RETENTION_TIERS];
+    uint64                  Retained; /* Bytes held across all tiers */
+    uint32                  FilesEvicted;
+    uint64                  BytesEvicted;
+} CAM_APP_Retention_t;
+
+static CAM_APP_Retention_t CAM_APP_Retention = {
+    .Lock  = PTHREAD_MUTEX_INITIALIZER,
+    .Tiers = {{.Dir = "Original_Photo"}, {.Dir = "Encrypt_Photo"}, {.Dir = "Segments"}}};
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Current wall time in nanoseconds                                */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+static uint64 CAM_APP_RetentionNow(void)
+{
+    struct timespec Now;
+
+    clock_gettime(CLOCK_REALTIME, &Now);
+
+    return (uint64)Now.tv_sec * 1000000000u + (uint64)Now.tv_nsec;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Append a file to a tier, growing its ring if it is full         */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+static bool CAM_APP_RetentionPush(CAM_APP_RetentionTier_t *Tier, const char *Name, uint64 Size, uint64 Age)
+{
+    CAM_APP_RetentionEntry_t *Entries;
+    CAM_APP_RetentionEntry_t *Entry;
+    uint32                    Depth;
+    uint32                    i;
+
+    if (Tier->Count == Tier->Depth)
+    {
+        Depth   = Tier->Depth != 0 ? Tier->Depth * 2 : CAM_APP_RETENTION_MIN_DEPTH;
+        Entries = malloc(Depth * sizeof(*Entries));
+        if (Entries == NULL)
+        {
+            return false;
+        }
+
+        /* Unwrap into the new ring so the oldest file is at the front again */
+        for (i = 0; i < Tier->Count; i++)
+        {
+            Entries[i] = Tier->Entries[(Tier->Head + i) % Tier->Depth];
+        }
+
+        free(Tier->Entries);
+        Tier->Entries = Entries;
+        Tier->Depth   = Depth;
+        Tier->Head    = 0;
+    }
+
+    Entry       = &Tier->Entries[(Tier->Head + Tier->Count) % Tier->Depth];
+    Entry->Age  = Age;
+    Entry->Size = Size;
+    snprintf(Entry->Name, sizeof(Entry->Name), "%s", Name);
+
+    Tier->Count++;
+    Tier->Bytes += Size;
+    CAM_APP_Retention.Retained += Size;
+
+    return true;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Order index entries oldest first                                */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+static int CAM_APP_RetentionCompare(const void *Left, const void *Right)
+{
+    const CAM_APP_RetentionEntry_t *A = Left;
+    const CAM_APP_RetentionEntry_t *B = Right;
+
+    if (A->Age != B->Age)
+    {
+        return A->Age < B->Age ? -1 : 1;
+    }
+
+    return strcmp(A->Name, B->Name);
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Index the files already in one tier's directory                 */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+static void CAM_APP_RetentionScan(CAM_APP_RetentionTier_t *Tier)
+{
+    char           Dir[CAM_APP_PHOTO_DIR_LEN + 32];
+    DIR           *Stream;
+    struct dirent *Entry;
+    struct stat    St;
+
+    snprintf(Dir, sizeof(Dir), "%s/%s", CAM_APP_Retention.PhotoDir, Tier->Dir);
+
+    Stream = opendir(Dir);
+    if (Stream == NULL)
+    {
+        return;
+    }
+
+    while ((Entry = readdir(Stream)) != NULL)
+    {
+        if (strlen(Entry->d_name) >= CAM_APP_RETENTION_NAME_LEN ||
+            fstatat(dirfd(Stream), Entry->d_name, &St, AT_SYMLINK_NOFOLLOW) != 0 || !S_ISREG(St.st_mode))
+        {
+            continue;
+        }
+
+        if (!CAM_APP_RetentionPush(Tier, Entry->d_name, (uint64)St.st_size,
+                                   (uint64)St.st_mtim.tv_sec * 1000000000u + (uint64)St.st_mtim.tv_nsec))
+        {
+            break;
+        }
+    }
+
+    closedir(Stream);
+
+    /* Nothing has been popped yet, so the ring starts at the front */
+    qsort(Tier->Entries, Tier->Count, sizeof(*Tier->Entries), CAM_APP_RetentionCompare);
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Pick the tier whose oldest file goes next, NULL if none         */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+static CAM_APP_RetentionTier_t *CAM_APP_RetentionVictim(void)
+{
+    CAM_APP_RetentionTier_t *Victim = NULL;
+    CAM_APP_RetentionTier_t *Tier;
+    uint32                   i;
+
+    for (i = 0; i < CAM_APP_RETENTION_TIERS; i++)
+    {
+        Tier = &CAM_APP_Retention.Tiers[i];
+        if (Tier->Count == 0)
+        {
+            continue;
+        }
+
+#if CAM_APP_RETENTION_EVICT_POLICY == CAM_APP_RETENTION_EVICT_PRIORITY
+        return Tier;
+#else
+        if (Victim == NULL || Tier->Entries[Tier->Head].Age < Victim->Entries[Victim->Head].Age)
+        {
+            Victim = Tier;
+        }
+#endif
+    }
+
+    return Victim;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Delete files until the index is back under the low watermark    */
+/*                                                                 */
+/* Called with the lock held.  Files that turn out to be gone      */
+/* already only leave the index.                                   */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+static void CAM_APP_RetentionEvict(void)
+{
+    CAM_APP_RetentionTier_t  *Tier;
+    CAM_APP_RetentionEntry_t *Entry;
+    char                      Name[CAM_APP_PHOTO_DIR_LEN + 32 + CAM_APP_RETENTION_NAME_LEN];
+    uint32                    Files = 0;
+    uint64                    Bytes = 0;
+
+    while (CAM_APP_Retention.Retained > CAM_APP_RETENTION_LOW_WATERMARK && (Tier = CAM_APP_RetentionVictim()) != NULL)
+    {
+        Entry      = &Tier->Entries[Tier->Head];
+        Tier->Head = (Tier->Head + 1) % Tier->Depth;
+        Tier->Count--;
+        Tier->Bytes -= Entry->Size;
+        CAM_APP_Retention.Retained -= Entry->Size;
+
+        snprintf(Name, sizeof(Name), "%s/%s/%s", CAM_APP_Retention.PhotoDir, Tier->Dir, Entry->Name);
+        if (unlink(Name) == 0)
+        {
+            Files++;
+            Bytes += Entry->Size;
+        }
+        else if (errno != ENOENT)
+        {
+            CFE_EVS_SendEvent(CAM_APP_RETENTION_ERR_EID, CFE_EVS_EventType_ERROR,
+                              "CAM_APP: Failed to evict %s: %s", Name, strerror(errno));
+        }
+    }
+
+    CAM_APP_Retention.FilesEvicted += Files;
+    CAM_APP_Retention.BytesEvicted += Bytes;
+
+    CFE_EVS_SendEvent(CAM_APP_RETENTION_INF_EID, CFE_EVS_EventType_DEBUG,
+                      "CAM_APP: Evicted %lu file(s), %llu bytes, %llu bytes retained", (unsigned long)Files,
+                      (unsigned long long)Bytes, (unsigned long long)CAM_APP_Retention.Retained);
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Get ready to store files under PhotoDir                         */
+/*                                                                 */
+/* The directories are only read the first time a photo directory  */
+/* is used, or after it has changed.  Evicts straight away if what */
+/* is already there is over budget.                                */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+CFE_Status_t CAM_APP_RetentionStart(const char *PhotoDir)
+{
+    CAM_APP_RetentionTier_t *Tier;
+    uint32                   Files = 0;
+    uint32                   i;
+
+    pthread_mutex_lock(&CAM_APP_Retention.Lock);
+
+    if (CAM_APP_Retention.Indexed && strcmp(CAM_APP_Retention.PhotoDir, PhotoDir) == 0)
+    {
+        pthread_mutex_unlock(&CAM_APP_Retention.Lock);
+        return CFE_SUCCESS;
+    }
+
+    snprintf(CAM_APP_Retention.PhotoDir, sizeof(CAM_APP_Retention.PhotoDir), "%s", PhotoDir);
+    CAM_APP_Retention.Retained = 0;
+
+    for (i = 0; i < CAM_APP_RETENTION_TIERS; i++)
+    {
+        Tier        = &CAM_APP_Retention.Tiers[i];
+        Tier->Head  = 0;
+        Tier->Count = 0;
+        Tier->Bytes = 0;
+
+        CAM_APP_RetentionScan(Tier);
+        Files += Tier->Count;
+    }
+
+    CAM_APP_Retention.Indexed = true;
+
+    CFE_EVS_SendEvent(CAM_APP_RETENTION_INF_EID, CFE_EVS_EventType_INFORMATION,
+                      "CAM_APP: Retaining %lu file(s), %llu bytes under %s", (unsigned long)Files,
+                      (unsigned long long)CAM_APP_Retention.Retained, PhotoDir);
+
+    if (CAM_APP_RETENTION_HIGH_WATERMARK != 0 && CAM_APP_Retention.Retained > CAM_APP_RETENTION_HIGH_WATERMARK)
+    {
+        CAM_APP_RetentionEvict();
+    }
+
+    pthread_mutex_unlock(&CAM_APP_Retention.Lock);
+
+    return CFE_SUCCESS;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Record a file just stored in Tier, and evict if that takes the  */
+/* index over the high watermark                                   */
+/*                                                                 */
+/* Name may be a full path; only the last part is kept.            */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+void CAM_APP_RetentionAdd(uint32 Tier, const char *Name, uint64 Size)
+{
+    const char *Base = strrchr(Name, '/');
+
+    Base = Base != NULL ? Base + 1 : Name;
+
+    pthread_mutex_lock(&CAM_APP_Retention.Lock);
+
+    if (CAM_APP_Retention.Indexed && Tier < CAM_APP_RETENTION_TIERS && strlen(Base) < CAM_APP_RETENTION_NAME_LEN &&
+        !CAM_APP_RetentionPush(&CAM_APP_Retention.Tiers[Tier], Base, Size, CAM_APP_RetentionNow()))
+    {
+        CFE_EVS_SendEvent(CAM_APP_RETENTION_ERR_EID, CFE_EVS_EventType_ERROR,
+                          "CAM_APP: Out of memory indexing %s, it will not be evicted", Name);
+    }
+
+    if (CAM_APP_RETENTION_HIGH_WATERMARK != 0 && CAM_APP_Retention.Retained > CAM_APP_RETENTION_HIGH_WATERMARK)
+    {
+        CAM_APP_RetentionEvict();
+    }
+
+    pthread_mutex_unlock(&CAM_APP_Retention.Lock);
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Report free space on the card and what is retained and evicted  */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+void CAM_APP_RetentionStats(uint32 *FreeSpaceKb, uint32 *RetainedKb, uint32 *FilesEvicted, uint32 *EvictedKb)
+{
+    struct statvfs Fs;
+    uint64         Free = 0;
+
+    pthread_mutex_lock(&CAM_APP_Retention.Lock);
+
+    if (CAM_APP_Retention.Indexed && statvfs(CAM_APP_Retention.PhotoDir, &Fs) == 0)
+    {
+        Free = (uint64)Fs.f_bavail * Fs.f_frsize;
+    }
+
+    *FreeSpaceKb  = (uint32)(Free / 1024);
+    *RetainedKb   = (uint32)(CAM_APP_Retention.Retained / 1024);
+    *FilesEvicted = CAM_APP_Retention.FilesEvicted;
+    *EvictedKb    = (uint32)(CAM_APP_Retention.BytesEvicted / 1024);
+
+    pthread_mutex_unlock(&CAM_APP_Retention.Lock);
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Clear the eviction counters                                     */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+void CAM_APP_RetentionResetStats(void)
+{
+    pthread_mutex_lock(&CAM_APP_Retention.Lock);
+
+    CAM_APP_Retention.FilesEvicted = 0;
+    CAM_APP_Retention.BytesEvicted = 0;
+
+    pthread_mutex_unlock(&CAM_APP_Retention.Lock);
+}
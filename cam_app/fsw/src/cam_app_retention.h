@@ -0,0 +1,55 @@
+/************************************************************************
+ * NASA Docket No. GSC-18,719-1, and identified as “core Flight System: Bootes”
+ *
+ * Copyright (c) 2020 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License. You may obtain
+ * a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ************************************************************************/
+
+/**
+ * @file
+ *   This file contains the prototypes for the Cam App retention manager
+ *
+ *   The manager keeps the files stored under the photo directory within
+ *   the budget set by the retention watermarks.  It holds an index of
+ *   them per output tier, oldest first, in memory, so it knows what is
+ *   stored and which file goes next without reading the directories.
+ *   The index is built from the directories once, when shooting first
+ *   starts with a given photo directory, and kept up to date as files are
+ *   stored after that.
+ *
+ *   All functions may be called from any thread.
+ */
+
+#ifndef CAM_APP_RETENTION_H
+#define CAM_APP_RETENTION_H
+
+/*
+** Required header files.
+*/
+#include "cam_app.h"
+
+/*
+** Output tiers, lowest priority first
+*/
+#define CAM_APP_RETENTION_TIER_ORIGINAL  0 /**< \brief Original_Photo, frames as captured */
+#define CAM_APP_RETENTION_TIER_ENCRYPTED 1 /**< \brief Encrypt_Photo, one container per frame */
+#define CAM_APP_RETENTION_TIER_SEGMENT   2 /**< \brief Segments, the segment log */
+#define CAM_APP_RETENTION_TIERS          3
+
+CFE_Status_t CAM_APP_RetentionStart(const char *PhotoDir);
+void         CAM_APP_RetentionAdd(uint32 Tier, const char *Name, uint64 Size);
+void         CAM_APP_RetentionStats(uint32 *FreeSpaceKb, uint32 *RetainedKb, uint32 *FilesEvicted, uint32 *EvictedKb);
+void         CAM_APP_RetentionResetStats(void);
+
+#endif /* CAM_APP_RETENTION_H */
@@ -0,0 +1,250 @@
+/************************************************************************
+ * NASA Docket No. GSC-18,719-1, and identified as “core Flight System: Bootes”
+ *
+ * Copyright (c) 2020 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License. You may obtain
+ * a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ************************************************************************/
+
+/**
+ * \file
+ *   This file contains the source code for the Cam App shot scheduler.
+ */
+
+/*
+** Include Files:
+*/
+#include "cam_app_sched.h"
+
+#define CAM_APP_SCHED_NSEC_PER_SEC  1000000000LL
+#define CAM_APP_SCHED_NSEC_PER_MSEC 1000000LL
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Convert a timespec to nanoseconds                               */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+static int64 CAM_APP_SchedToNsec(const struct timespec *Ts)
+{
+    return (int64)Ts->tv_sec * CAM_APP_SCHED_NSEC_PER_SEC + Ts->tv_nsec;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Convert nanoseconds to a timespec                               */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+static void CAM_APP_SchedFromNsec(struct timespec *Ts, int64 Nsec)
+{
+    Ts->tv_sec  = Nsec / CAM_APP_SCHED_NSEC_PER_SEC;
+    Ts->tv_nsec = Nsec % CAM_APP_SCHED_NSEC_PER_SEC;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Set up a scheduler whose condition variable uses the monotonic  */
+/* clock, so deadlines are immune to wall clock changes            */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+int32 CAM_APP_SchedInit(CAM_APP_Sched_t *Sched)
+{
+    pthread_condattr_t Attr;
+    int32              Result = -1;
+
+    if (pthread_mutex_init(&Sched->Lock, NULL) != 0)
+    {
+        return -1;
+    }
+
+    if (pthread_condattr_init(&Attr) == 0)
+    {
+        if (pthread_condattr_setclock(&Attr, CLOCK_MONOTONIC) == 0 && pthread_cond_init(&Sched->Wake, &Attr) == 0)
+        {
+            Result = 0;
+        }
+        pthread_condattr_destroy(&Attr);
+    }
+
+    if (Result != 0)
+    {
+        pthread_mutex_destroy(&Sched->Lock);
+    }
+
+    atomic_store(&Sched->MissedDeadlines, 0);
+    Sched->Cancelled = false;
+    Sched->Kicked    = false;
+    Sched->First     = true;
+
+    return Result;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Release the scheduler's synchronization objects                 */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+void CAM_APP_SchedDestroy(CAM_APP_Sched_t *Sched)
+{
+    pthread_cond_destroy(&Sched->Wake);
+    pthread_mutex_destroy(&Sched->Lock);
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* (Re)start the schedule: the next wait fires at once             */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+void CAM_APP_SchedStart(CAM_APP_Sched_t *Sched)
+{
+    pthread_mutex_lock(&Sched->Lock);
+    Sched->First     = true;
+    Sched->Cancelled = false;
+    pthread_cond_broadcast(&Sched->Wake);
+    pthread_mutex_unlock(&Sched->Lock);
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Wait for the next deadline                                      */
+/*                                                                 */
+/* The first call after start returns at once.  Later calls wait   */
+/* until one period after the last firing, skipping (and counting) */
+/* deadlines that already passed; with PeriodMs of 0 they wait     */
+/* indefinitely.  A kick ends the wait early without consuming a   */
+/* deadline and is reported through Kicked.  Returns false once    */
+/* cancelled.                                                      */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+bool CAM_APP_SchedWait(CAM_APP_Sched_t *Sched, uint32 PeriodMs, bool *Kicked)
+{
+    struct timespec Now;
+    struct timespec Deadline;
+    int64           PeriodNs = (int64)PeriodMs * CAM_APP_SCHED_NSEC_PER_MSEC;
+    int64           DeadlineNs;
+    int64           NowNs;
+    int64           Missed;
+    bool            TimedOut = false;
+    bool            Fire;
+
+    pthread_mutex_lock(&Sched->Lock);
+
+    *Kicked = false;
+
+    if (!Sched->First && PeriodNs > 0)
+    {
+        DeadlineNs = CAM_APP_SchedToNsec(&Sched->LastFire) + PeriodNs;
+
+        clock_gettime(CLOCK_MONOTONIC, &Now);
+        NowNs = CAM_APP_SchedToNsec(&Now);
+
+        if (NowNs > DeadlineNs)
+        {
+            /* Overran: stay in phase by moving to the next deadline still ahead */
+            Missed = (NowNs - DeadlineNs) / PeriodNs + 1;
+            DeadlineNs += Missed * PeriodNs;
+            atomic_fetch_add(&Sched->MissedDeadlines, (unsigned int)Missed);
+
+            /* The skipped deadlines are spent, so a kick ending this wait cannot count them again */
+            CAM_APP_SchedFromNsec(&Sched->LastFire, DeadlineNs - PeriodNs);
+        }
+
+        CAM_APP_SchedFromNsec(&Deadline, DeadlineNs);
+    }
+
+    while (!Sched->First && !Sched->Kicked && !Sched->Cancelled && !TimedOut)
+    {
+        if (PeriodNs > 0)
+        {
+            TimedOut = (pthread_cond_timedwait(&Sched->Wake, &Sched->Lock, &Deadline) != 0);
+        }
+        else
+        {
+            pthread_cond_wait(&Sched->Wake, &Sched->Lock);
+        }
+    }
+
+    if (Sched->First)
+    {
+        clock_gettime(CLOCK_MONOTONIC, &Sched->LastFire);
+        Sched->First = false;
+    }
+    else if (Sched->Kicked)
+    {
+        Sched->Kicked = false;
+        *Kicked       = true;
+    }
+    else if (TimedOut)
+    {
+        Sched->LastFire = Deadline;
+    }
+
+    Fire = !Sched->Cancelled;
+
+    pthread_mutex_unlock(&Sched->Lock);
+
+    return Fire;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* End the current or next wait early                              */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+void CAM_APP_SchedKick(CAM_APP_Sched_t *Sched)
+{
+    pthread_mutex_lock(&Sched->Lock);
+    Sched->Kicked = true;
+    pthread_cond_broadcast(&Sched->Wake);
+    pthread_mutex_unlock(&Sched->Lock);
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Sleep until an absolute CLOCK_MONOTONIC deadline                */
+/*                                                                 */
+/* Kicks are left for the next periodic wait.  Returns false as    */
+/* soon as the scheduler is cancelled, without waiting out the     */
+/* rest of the sleep.                                              */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+bool CAM_APP_SchedSleepUntil(CAM_APP_Sched_t *Sched, const struct timespec *Deadline)
+{
+    bool TimedOut = false;
+    bool Slept;
+
+    pthread_mutex_lock(&Sched->Lock);
+
+    while (!Sched->Cancelled && !TimedOut)
+    {
+        TimedOut = (pthread_cond_timedwait(&Sched->Wake, &Sched->Lock, Deadline) != 0);
+    }
+
+    Slept = !Sched->Cancelled;
+
+    pthread_mutex_unlock(&Sched->Lock);
+
+    return Slept;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Wake the waiter and make every further wait fail                */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+void CAM_APP_SchedCancel(CAM_APP_Sched_t *Sched)
+{
+    pthread_mutex_lock(&Sched->Lock);
+    Sched->Cancelled = true;
+    pthread_cond_broadcast(&Sched->Wake);
+    pthread_mutex_unlock(&Sched->Lock);
+}
@@ -0,0 +1,65 @@
+/************************************************************************
+ * NASA Docket No. GSC-18,719-1, and identified as “core Flight System: Bootes”
+ *
+ * Copyright (c) 2020 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License. You may obtain
+ * a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ************************************************************************/
+
+/**
+ * @file
+ *   This file contains the prototypes for the Cam App shot scheduler
+ *
+ *   Shots fire on absolute CLOCK_MONOTONIC deadlines spaced one period
+ *   apart, so the time spent capturing does not add to the interval.
+ *   A deadline that has already passed when the next wait starts is
+ *   skipped and counted as missed, keeping the schedule in phase.
+ *
+ *   A wait can also be ended early by a kick (for one-off work such as a
+ *   burst) without disturbing the periodic deadlines.  One-off work can
+ *   pace itself with sleeps that a cancel ends just as promptly.
+ */
+
+#ifndef CAM_APP_SCHED_H
+#define CAM_APP_SCHED_H
+
+/*
+** Required header files.
+*/
+#include "common_types.h"
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <time.h>
+
+typedef struct
+{
+    struct timespec LastFire; /* Time of the last periodic firing */
+    bool            First;    /* Next wait fires at once and re-anchors the schedule */
+    bool            Kicked;   /* Next wait returns at once without consuming a deadline */
+    bool            Cancelled;
+    pthread_mutex_t Lock;
+    pthread_cond_t  Wake;
+
+    atomic_uint MissedDeadlines;
+} CAM_APP_Sched_t;
+
+int32 CAM_APP_SchedInit(CAM_APP_Sched_t *Sched);
+void  CAM_APP_SchedDestroy(CAM_APP_Sched_t *Sched);
+void  CAM_APP_SchedStart(CAM_APP_Sched_t *Sched);
+bool  CAM_APP_SchedWait(CAM_APP_Sched_t *Sched, uint32 PeriodMs, bool *Kicked);
+void  CAM_APP_SchedKick(CAM_APP_Sched_t *Sched);
+bool  CAM_APP_SchedSleepUntil(CAM_APP_Sched_t *Sched, const struct timespec *Deadline);
+void  CAM_APP_SchedCancel(CAM_APP_Sched_t *Sched);
+
+#endif /* CAM_APP_SCHED_H */
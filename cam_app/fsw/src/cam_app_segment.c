@@ -0,0 +1,538 @@
+/************************************************************************
+ * NASA Docket No. GSC-18,719-1, and identified as “core Flight System: Bootes”
+ *
+ * Copyright (c) 2020 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License. You may obtain
+ * a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ************************************************************************/
+
+/**
+ * \file
+ *   This file contains the source code for the Cam App segment log.
+ */
+
+/*
+** Include Files:
+*/
+#include "cam_app_container.h"
+#include "cam_app_crc.h"
+#include "cam_app_eventids.h"
+#include "cam_app_retention.h"
+#include "cam_app_segment.h"
+
+#include "common_fnc.h"
+
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#define CAM_APP_SEGMENT_MAGIC   "CAMR"
+#define CAM_APP_SEGMENT_VERSION 1
+#define CAM_APP_SEGMENT_PREFIX  "segment_"
+#define CAM_APP_SEGMENT_SUFFIX  ".log"
+
+#define CAM_APP_SEGMENT_SCAN_SIZE 4096 /* Bytes read at a time when looking for the next header */
+
+/*
+** The segment records are being appended to; only the storage stage
+** touches this
+*/
+static CAM_APP_Segment_t *CAM_APP_SegmentCurrent;
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Store a Size byte big-endian field                              */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+static void CAM_APP_SegmentPut(uint8 *Out, uint64 Value, size_t Size)
+{
+    while (Size-- > 0)
+    {
+        Out[Size] = (uint8)Value;
+        Value >>= 8;
+    }
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Load a Size byte big-endian field                               */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+static uint64 CAM_APP_SegmentGet(const uint8 *In, size_t Size)
+{
+    uint64 Value = 0;
+    size_t i;
+
+    for (i = 0; i < Size; i++)
+    {
+        Value = (Value << 8) | In[i];
+    }
+
+    return Value;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Lay out a record header                                         */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+void CAM_APP_SegmentEncodeRecord(const CAM_APP_SegmentRecord_t *Record, uint8 *Image)
+{
+    memcpy(Image, CAM_APP_SEGMENT_MAGIC, 4);
+    Image[4] = CAM_APP_SEGMENT_VERSION;
+    Image[5] = Record->Kind;
+    CAM_APP_SegmentPut(Image + 6, CAM_APP_SEGMENT_RECORD_SIZE, 2);
+    CAM_APP_SegmentPut(Image + 8, Record->Sequence, 4);
+    CAM_APP_SegmentPut(Image + 12, Record->Length, 4);
+    CAM_APP_SegmentPut(Image + 16, Record->CaptureTimeUs, 8);
+    CAM_APP_SegmentPut(Image + 24, Record->Crc, 4);
+    CAM_APP_SegmentPut(Image + 28, CAM_APP_Crc32(0, Image, 28), 4);
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Read a record header back                                       */
+/*                                                                 */
+/* Returns false for anything that is not a whole, intact header,  */
+/* which is also how the unused end of a segment reads.            */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+static bool CAM_APP_SegmentDecodeRecord(CAM_APP_SegmentRecord_t *Record, const uint8 *Image)
+{
+    if (memcmp(Image, CAM_APP_SEGMENT_MAGIC, 4) != 0 || Image[4] != CAM_APP_SEGMENT_VERSION ||
+        CAM_APP_SegmentGet(Image + 6, 2) != CAM_APP_SEGMENT_RECORD_SIZE ||
+        CAM_APP_SegmentGet(Image + 28, 4) != CAM_APP_Crc32(0, Image, 28))
+    {
+        return false;
+    }
+
+    Record->Kind          = Image[5];
+    Record->Sequence      = (uint32)CAM_APP_SegmentGet(Image + 8, 4);
+    Record->Length        = (uint32)CAM_APP_SegmentGet(Image + 12, 4);
+    Record->CaptureTimeUs = CAM_APP_SegmentGet(Image + 16, 8);
+    Record->Crc           = (uint32)CAM_APP_SegmentGet(Image + 24, 4);
+
+    return true;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Name segment Number under PhotoDir                              */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+static void CAM_APP_SegmentName(char *Name, size_t Size, const char *PhotoDir, uint32 Number)
+{
+    snprintf(Name, Size, "%s/Segments/" CAM_APP_SEGMENT_PREFIX "%06lu" CAM_APP_SEGMENT_SUFFIX, PhotoDir,
+             (unsigned long)Number);
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Find the highest segment number under PhotoDir, 0 if none       */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+static uint32 CAM_APP_SegmentHighest(const char *PhotoDir)
+{
+    char           Dir[CAM_APP_SEGMENT_NAME_LEN];
+    DIR           *Stream;
+    struct dirent *Entry;
+    char          *End;
+    unsigned long  Number;
+    uint32         Highest = 0;
+
+    snprintf(Dir, sizeof(Dir), "%s/Segments", PhotoDir);
+
+    Stream = opendir(Dir);
+    if (Stream == NULL)
+    {
+        return 0;
+    }
+
+    while ((Entry = readdir(Stream)) != NULL)
+    {
+        if (strncmp(Entry->d_name, CAM_APP_SEGMENT_PREFIX, sizeof(CAM_APP_SEGMENT_PREFIX) - 1) != 0)
+        {
+            continue;
+        }
+
+        Number = strtoul(Entry->d_name + sizeof(CAM_APP_SEGMENT_PREFIX) - 1, &End, 10);
+        if (strcmp(End, CAM_APP_SEGMENT_SUFFIX) == 0 && Number > Highest && Number <= UINT32_MAX)
+        {
+            Highest = (uint32)Number;
+        }
+    }
+
+    closedir(Stream);
+
+    return Highest;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Start the segment after the highest one on the card             */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+static CAM_APP_Segment_t *CAM_APP_SegmentOpen(const char *PhotoDir)
+{
+    CAM_APP_Segment_t *Segment;
+    char               Dir[CAM_APP_SEGMENT_NAME_LEN];
+    int                DirFd;
+
+    snprintf(Dir, sizeof(Dir), "%s/Segments", PhotoDir);
+    mkdir(Dir, 0755);
+
+    Segment = calloc(1, sizeof(*Segment));
+    if (Segment == NULL)
+    {
+        CFE_EVS_SendEvent(CAM_APP_SEGMENT_ERR_EID, CFE_EVS_EventType_ERROR,
+                          "CAM_APP: Failed to start a segment, out of memory");
+        return NULL;
+    }
+
+    Segment->Number = CAM_APP_SegmentHighest(PhotoDir) + 1;
+    CAM_APP_SegmentName(Segment->Name, sizeof(Segment->Name), PhotoDir, Segment->Number);
+
+    Segment->Fd = open(Segment->Name, O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC, 0644);
+    if (Segment->Fd < 0)
+    {
+        CFE_EVS_SendEvent(CAM_APP_SEGMENT_ERR_EID, CFE_EVS_EventType_ERROR, "CAM_APP: Failed to create %s: %s",
+                          Segment->Name, strerror(errno));
+        free(Segment);
+        return NULL;
+    }
+
+    /* Allocate the whole segment up front without changing its length, so appends do not
+       allocate and a reader never sees past the last record; best effort */
+    fallocate(Segment->Fd, FALLOC_FL_KEEP_SIZE, 0, CAM_APP_SEGMENT_SIZE);
+
+    /* Records are committed with the segment's data only, so make its entry durable now; best effort */
+    if (atomic_load(&CAM_APP_Data.Durability) != CAM_APP_DURABILITY_NONE)
+    {
+        DirFd = open(Dir, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+        if (DirFd >= 0)
+        {
+            fsync(DirFd);
+            close(DirFd);
+        }
+    }
+
+    atomic_init(&Segment->Users, 1);
+
+    CFE_EVS_SendEvent(CAM_APP_SEGMENT_INF_EID, CFE_EVS_EventType_INFORMATION, "CAM_APP: Appending frames to %s",
+                      Segment->Name);
+
+    return Segment;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Reserve room for a RecordSize byte record, header included      */
+/*                                                                 */
+/* Starts a new segment if the record does not fit in the current  */
+/* one.  Returns the segment with a use taken for the write, and   */
+/* the record's offset in it, or NULL if no segment could be       */
+/* opened.  Called from the storage stage only.                    */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+CAM_APP_Segment_t *CAM_APP_SegmentReserve(const char *PhotoDir, size_t RecordSize, uint64 *Offset)
+{
+    CAM_APP_Segment_t *Segment = CAM_APP_SegmentCurrent;
+
+    /* A record larger than a whole segment still gets one to itself */
+    if (Segment != NULL && Segment->Used > 0 && Segment->Used + RecordSize > CAM_APP_SEGMENT_SIZE)
+    {
+        CAM_APP_SegmentClose();
+        Segment = NULL;
+    }
+
+    if (Segment == NULL)
+    {
+        Segment = CAM_APP_SegmentOpen(PhotoDir);
+        if (Segment == NULL)
+        {
+            return NULL;
+        }
+        CAM_APP_SegmentCurrent = Segment;
+    }
+
+    *Offset = Segment->Used;
+    Segment->Used += RecordSize;
+    atomic_fetch_add(&Segment->Users, 1);
+
+    return Segment;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Drop a use of a segment                                         */
+/*                                                                 */
+/* The last one trims the unused preallocation, closes the segment */
+/* and frees it.                                                   */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+void CAM_APP_SegmentRelease(CAM_APP_Segment_t *Segment)
+{
+    if (atomic_fetch_sub(&Segment->Users, 1) != 1)
+    {
+        return;
+    }
+
+    if (ftruncate(Segment->Fd, (off_t)Segment->Used) != 0 || close(Segment->Fd) != 0)
+    {
+        CFE_EVS_SendEvent(CAM_APP_SEGMENT_ERR_EID, CFE_EVS_EventType_ERROR, "CAM_APP: Failed to close %s: %s",
+                          Segment->Name, strerror(errno));
+    }
+
+    CAM_APP_RetentionAdd(CAM_APP_RETENTION_TIER_SEGMENT, Segment->Name, Segment->Used);
+
+    free(Segment);
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Stop adding to the current segment                              */
+/*                                                                 */
+/* It is closed once writes still in flight to it are done.  The   */
+/* next record starts a new segment.                               */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+void CAM_APP_SegmentClose(void)
+{
+    if (CAM_APP_SegmentCurrent != NULL)
+    {
+        CAM_APP_SegmentRelease(CAM_APP_SegmentCurrent);
+        CAM_APP_SegmentCurrent = NULL;
+    }
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Read the record header at Offset in a Size byte segment         */
+/*                                                                 */
+/* Only a header whose record ends within the segment counts.      */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+static bool CAM_APP_SegmentReadRecord(int Fd, uint64 Size, uint64 Offset, CAM_APP_SegmentRecord_t *Record)
+{
+    uint8 Image[CAM_APP_SEGMENT_RECORD_SIZE];
+
+    return pread(Fd, Image, sizeof(Image), (off_t)Offset) == (ssize_t)sizeof(Image) &&
+           CAM_APP_SegmentDecodeRecord(Record, Image) &&
+           Offset + CAM_APP_SEGMENT_RECORD_SIZE + (uint64)Record->Length <= Size;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Find the first intact record header after Offset                */
+/*                                                                 */
+/* Records are reserved before they are written and land out of    */
+/* order, so a write that failed, tore or was cut off by a power   */
+/* loss leaves a hole of zeros or garbage with good records after  */
+/* it.  The hole is skipped by looking for the next magic whose    */
+/* header CRC checks.                                              */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+static bool CAM_APP_SegmentResync(int Fd, uint64 Size, uint64 *Offset, CAM_APP_SegmentRecord_t *Record)
+{
+    uint8   Scan[CAM_APP_SEGMENT_SCAN_SIZE];
+    uint8  *Hit;
+    uint64  Start = *Offset + 1;
+    ssize_t Len;
+    size_t  i;
+
+    while (Start + CAM_APP_SEGMENT_RECORD_SIZE <= Size)
+    {
+        Len = pread(Fd, Scan, sizeof(Scan), (off_t)Start);
+        if (Len < CAM_APP_SEGMENT_RECORD_SIZE)
+        {
+            return false;
+        }
+
+        /* Only headers that start early enough to be read whole from this block are tried */
+        for (i = 0; i + CAM_APP_SEGMENT_RECORD_SIZE <= (size_t)Len; i = (size_t)(Hit - Scan) + 1)
+        {
+            Hit = memmem(Scan + i, (size_t)Len - i, CAM_APP_SEGMENT_MAGIC, 4);
+            if (Hit == NULL || (size_t)(Hit - Scan) + CAM_APP_SEGMENT_RECORD_SIZE > (size_t)Len)
+            {
+                break;
+            }
+
+            if (CAM_APP_SegmentReadRecord(Fd, Size, Start + (uint64)(Hit - Scan), Record))
+            {
+                *Offset = Start + (uint64)(Hit - Scan);
+                return true;
+            }
+        }
+
+        Start += (uint64)Len - CAM_APP_SEGMENT_RECORD_SIZE + 1;
+    }
+
+    return false;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Look through one segment for the record of frame Sequence       */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+static bool CAM_APP_SegmentFind(const char *Name, uint32 Sequence, CAM_APP_SegmentRecord_t *Record, uint64 *Offset)
+{
+    struct stat St;
+    uint64      Next  = 0;
+    bool        Found = false;
+    bool        Valid;
+    int         Fd;
+
+    Fd = open(Name, O_RDONLY | O_CLOEXEC);
+    if (Fd < 0)
+    {
+        return false;
+    }
+
+    if (fstat(Fd, &St) != 0)
+    {
+        close(Fd);
+        return false;
+    }
+
+    /* Hop from header to header, skipping any hole left by a write that did not make it */
+    Valid = CAM_APP_SegmentReadRecord(Fd, (uint64)St.st_size, Next, Record) ||
+            CAM_APP_SegmentResync(Fd, (uint64)St.st_size, &Next, Record);
+    while (!Found && Valid)
+    {
+        Found = Record->Sequence == Sequence;
+        if (!Found)
+        {
+            Next += CAM_APP_SEGMENT_RECORD_SIZE + (uint64)Record->Length;
+            Valid = CAM_APP_SegmentReadRecord(Fd, (uint64)St.st_size, Next, Record) ||
+                    CAM_APP_SegmentResync(Fd, (uint64)St.st_size, &Next, Record);
+        }
+    }
+
+    close(Fd);
+
+    *Offset = Next;
+
+    return Found;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Copy the record of frame Sequence out of the segment log into a */
+/* file of its own, named as FILE or MEMORY mode would have        */
+/*                                                                 */
+/* Looks in segment SegmentNumber, or with 0 in every segment from */
+/* the newest down, since sequence numbers restart each time       */
+/* shooting starts.  Name receives the file written.               */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+CFE_Status_t CAM_APP_SegmentExtract(const char *PhotoDir, uint32 SegmentNumber, uint32 Sequence, char *Name,
+                                    size_t NameSize)
+{
+    CAM_APP_SegmentRecord_t Record;
+    mapped_file_t           Payload;
+    char                    SegmentName[CAM_APP_SEGMENT_NAME_LEN];
+    char                    Timestamp[24];
+    struct tm               CaptureTm;
+    struct stat             St;
+    time_t                  CaptureSec;
+    uint64                  Offset;
+    uint32                  Number;
+    uint32                  Lowest;
+    bool                    Found = false;
+    bool                    Written;
+
+    Number = SegmentNumber != 0 ? SegmentNumber : CAM_APP_SegmentHighest(PhotoDir);
+    Lowest = SegmentNumber != 0 ? SegmentNumber : 1;
+
+    for (; Number >= Lowest && Number > 0 && !Found; Number--)
+    {
+        CAM_APP_SegmentName(SegmentName, sizeof(SegmentName), PhotoDir, Number);
+        Found = CAM_APP_SegmentFind(SegmentName, Sequence, &Record, &Offset);
+    }
+
+    if (!Found)
+    {
+        CFE_EVS_SendEvent(CAM_APP_SEGMENT_ERR_EID, CFE_EVS_EventType_ERROR,
+                          "CAM_APP: Frame %lu not found in the segment log", (unsigned long)Sequence);
+        return CFE_STATUS_RANGE_ERROR;
+    }
+
+    if ((Record.Kind != CAM_APP_SEGMENT_KIND_CONTAINER && Record.Kind != CAM_APP_SEGMENT_KIND_PLAIN) ||
+        (Record.Kind == CAM_APP_SEGMENT_KIND_CONTAINER && Record.Length < CAM_APP_CONTAINER_HEADER_SIZE) ||
+        !map_file_range(&Payload, SegmentName, (off_t)(Offset + CAM_APP_SEGMENT_RECORD_SIZE), Record.Length))
+    {
+        CFE_EVS_SendEvent(CAM_APP_SEGMENT_ERR_EID, CFE_EVS_EventType_ERROR,
+                          "CAM_APP: Frame %lu in %s is unreadable", (unsigned long)Sequence, SegmentName);
+        return CFE_STATUS_EXTERNAL_RESOURCE_FAIL;
+    }
+
+    /* A torn write at the end of a segment, or a frame still being written */
+    if (CAM_APP_Crc32(0, Payload.data, Payload.size) != Record.Crc)
+    {
+        unmap_file(&Payload);
+        CFE_EVS_SendEvent(CAM_APP_SEGMENT_ERR_EID, CFE_EVS_EventType_ERROR,
+                          "CAM_APP: Frame %lu in %s is damaged", (unsigned long)Sequence, SegmentName);
+        return CFE_STATUS_EXTERNAL_RESOURCE_FAIL;
+    }
+
+    CaptureSec = (time_t)(Record.CaptureTimeUs / 1000000u);
+    localtime_r(&CaptureSec, &CaptureTm);
+    strftime(Timestamp, sizeof(Timestamp), "%Y%m%d_%H:%M:%S", &CaptureTm);
+    snprintf(Timestamp + strlen(Timestamp), sizeof(Timestamp) - strlen(Timestamp), ".%03u",
+             (unsigned int)(Record.CaptureTimeUs / 1000u % 1000u));
+
+    if (Record.Kind == CAM_APP_SEGMENT_KIND_PLAIN)
+    {
+        snprintf(Name, NameSize, "%s/Original_Photo/photo_%s.jpeg", PhotoDir, Timestamp);
+        Written = write_image_data(Payload.data, Payload.size, Name);
+    }
+    else
+    {
+        snprintf(Name, NameSize, "%s/Encrypt_Photo/encrypted_photo_%s.enc", PhotoDir, Timestamp);
+#if CAM_APP_ENCRYPTED_FORMAT == CAM_APP_ENCRYPTED_FORMAT_HEX
+        Written = write_encrypted_hex(Payload.data, CAM_APP_CONTAINER_HEADER_SIZE,
+                                      Payload.data + CAM_APP_CONTAINER_HEADER_SIZE,
+                                      Payload.size - CAM_APP_CONTAINER_HEADER_SIZE, Name);
+#else
+        Written = write_encrypted_data(Payload.data, CAM_APP_CONTAINER_HEADER_SIZE,
+                                       Payload.data + CAM_APP_CONTAINER_HEADER_SIZE,
+                                       Payload.size - CAM_APP_CONTAINER_HEADER_SIZE, Name);
+#endif
+    }
+
+    unmap_file(&Payload);
+
+    if (!Written)
+    {
+        CFE_EVS_SendEvent(CAM_APP_SEGMENT_ERR_EID, CFE_EVS_EventType_ERROR, "CAM_APP: Failed to write %s", Name);
+        return CFE_STATUS_EXTERNAL_RESOURCE_FAIL;
+    }
+
+    if (stat(Name, &St) == 0)
+    {
+        CAM_APP_RetentionAdd(Record.Kind == CAM_APP_SEGMENT_KIND_PLAIN ? CAM_APP_RETENTION_TIER_ORIGINAL
+                                                                       : CAM_APP_RETENTION_TIER_ENCRYPTED,
+                             Name, (uint64)St.st_size);
+    }
+
+    CFE_EVS_SendEvent(CAM_APP_SEGMENT_INF_EID, CFE_EVS_EventType_INFORMATION,
+                      "CAM_APP: Extracted frame %lu from %s to %s", (unsigned long)Sequence, SegmentName, Name);
+
+    return CFE_SUCCESS;
+}
@@ -0,0 +1,93 @@
+/************************************************************************
+ * NASA Docket No. GSC-18,719-1, and identified as “core Flight System: Bootes”
+ *
+ * Copyright (c) 2020 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License. You may obtain
+ * a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ************************************************************************/
+
+/**
+ * @file
+ *   This file contains the prototypes for the Cam App segment log
+ *
+ *   In SEGMENT storage mode frames are appended as records to large
+ *   segment files, <PhotoDir>/Segments/segment_NNNNNN.log, numbered from
+ *   1 upwards.  Each segment is preallocated when it is opened, and a new
+ *   one is started when a record would not fit and whenever shooting
+ *   starts.  A record is a fixed size header followed by the payload,
+ *   multi-byte fields big-endian:
+ *
+ *     Offset  Size  Field
+ *          0     4  Magic, "CAMR"
+ *          4     1  Version, currently 1
+ *          5     1  Kind, 1 = encrypted container, 2 = plain JPEG
+ *          6     2  Header size in bytes
+ *          8     4  Capture sequence number since shooting started
+ *         12     4  Payload length in bytes
+ *         16     8  Capture time, microseconds since the Unix epoch
+ *         24     4  CRC-32 of the payload
+ *         28     4  CRC-32 of the 28 header bytes before it
+ *
+ *   An encrypted payload is exactly the file FILE and MEMORY modes would
+ *   have written (see cam_app_container.h), so an extracted record can be
+ *   handled like any other stored frame.
+ */
+
+#ifndef CAM_APP_SEGMENT_H
+#define CAM_APP_SEGMENT_H
+
+/*
+** Required header files.
+*/
+#include "cam_app.h"
+
+#include <stdatomic.h>
+
+#define CAM_APP_SEGMENT_RECORD_SIZE 32 /**< \brief Bytes in front of each payload */
+#define CAM_APP_SEGMENT_NAME_LEN    (CAM_APP_PHOTO_DIR_LEN + 32)
+
+#define CAM_APP_SEGMENT_KIND_CONTAINER 1 /**< \brief Payload is an encrypted container */
+#define CAM_APP_SEGMENT_KIND_PLAIN     2 /**< \brief Payload is the frame as captured */
+
+/*
+** Header fields of one record
+*/
+typedef struct
+{
+    uint8  Kind;
+    uint32 Sequence;
+    uint32 Length;        /**< \brief Payload length in bytes */
+    uint64 CaptureTimeUs; /**< \brief Capture time, microseconds since the Unix epoch */
+    uint32 Crc;           /**< \brief CRC-32 of the payload */
+} CAM_APP_SegmentRecord_t;
+
+/*
+** An open segment, freed once it is full and its last write is done
+*/
+typedef struct
+{
+    int         Fd;
+    uint32      Number;
+    uint64      Used;  /**< \brief Where the next record goes */
+    atomic_uint Users; /**< \brief Writes in flight, plus one while records may still be added */
+    char        Name[CAM_APP_SEGMENT_NAME_LEN];
+} CAM_APP_Segment_t;
+
+CAM_APP_Segment_t *CAM_APP_SegmentReserve(const char *PhotoDir, size_t RecordSize, uint64 *Offset);
+void               CAM_APP_SegmentRelease(CAM_APP_Segment_t *Segment);
+void               CAM_APP_SegmentClose(void);
+void               CAM_APP_SegmentEncodeRecord(const CAM_APP_SegmentRecord_t *Record, uint8 *Image);
+CFE_Status_t       CAM_APP_SegmentExtract(const char *PhotoDir, uint32 SegmentNumber, uint32 Sequence, char *Name,
+                                          size_t NameSize);
+
+#endif /* CAM_APP_SEGMENT_H */
@@ -26,31 +26,163 @@
 */
 #include "cam_app.h"
 #include "cam_app_eventids.h"
+#include "cam_app_pipeline.h"
 #include "cam_app_tbl.h"
 #include "cam_app_utils.h"
 
+#include <string.h>
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Largest frame a profile can produce, used to size its buffers   */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+uint32 CAM_APP_CaptureProfileFrameSize(const CAM_APP_CaptureProfile_t *Profile)
+{
+    uint32 Pixels = (uint32)Profile->Width * Profile->Height;
+
+    if (Profile->Format == CAM_APP_CAPTURE_FORMAT_YUYV)
+    {
+        return Pixels * 2;
+    }
+
+    /* JPEG stays well under 1.5 bytes per pixel even at the highest quality */
+    return Pixels + Pixels / 2;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Check one capture profile                                       */
+/*                                                                 */
 /* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+static bool CAM_APP_CaptureProfileIsValid(const CAM_APP_CaptureProfile_t *Profile)
+{
+    return Profile->Width != 0 && Profile->Width <= CAM_APP_CAPTURE_MAX_DIMENSION && Profile->Height != 0 &&
+           Profile->Height <= CAM_APP_CAPTURE_MAX_DIMENSION && Profile->FrameRate != 0 &&
+           Profile->PeriodMs >= CAM_APP_MIN_SHOT_PERIOD_MS &&
+           (Profile->Format == CAM_APP_CAPTURE_FORMAT_MJPEG || Profile->Format == CAM_APP_CAPTURE_FORMAT_YUYV) &&
+           Profile->Quality >= 1 && Profile->Quality <= 100 &&
+           (Profile->StorageMode == CAM_APP_STORAGE_MODE_FILE || Profile->StorageMode == CAM_APP_STORAGE_MODE_MEMORY ||
+            Profile->StorageMode == CAM_APP_STORAGE_MODE_SEGMENT) &&
+           (Profile->Stages & ~CAM_APP_CAPTURE_STAGE_ENCRYPT) == 0 &&
+           memchr(Profile->Name, '\0', sizeof(Profile->Name)) != NULL &&
+           CAM_APP_CaptureProfileFrameSize(Profile) <= CAM_APP_CAPTURE_MAX_FRAME_SIZE;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Verify contents of the Capture Table buffer                     */
 /*                                                                 */
-/* Verify contents of First Example Table buffer contents                  */
+/* Every profile is checked, not just the active one, so a later   */
+/* table update that only changes ActiveProfile cannot select a    */
+/* bad profile.                                                    */
 /*                                                                 */
 /* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
 CFE_Status_t CAM_APP_TblValidationFunc(void *TblData)
 {
-    CFE_Status_t               ReturnCode = CFE_SUCCESS;
-    CAM_APP_ExampleTable_t *TblDataPtr = (CAM_APP_ExampleTable_t *)TblData;
+    CFE_Status_t            ReturnCode = CFE_SUCCESS;
+    CAM_APP_CaptureTable_t *TblDataPtr = (CAM_APP_CaptureTable_t *)TblData;
+    uint32                  i;
 
     /*
-    ** Cam Example Table Validation
+    ** Cam Capture Table Validation
     */
-    if (TblDataPtr->Int1 > CAM_APP_TBL_ELEMENT_1_MAX)
+    if (TblDataPtr->ActiveProfile >= CAM_APP_CAPTURE_PROFILE_COUNT || TblDataPtr->PhotoDir[0] == '\0' ||
+        memchr(TblDataPtr->PhotoDir, '\0', sizeof(TblDataPtr->PhotoDir)) == NULL)
     {
-        /* First element is out of range, return an appropriate error code */
         ReturnCode = CAM_APP_TABLE_OUT_OF_RANGE_ERR_CODE;
     }
 
+    for (i = 0; i < CAM_APP_CAPTURE_PROFILE_COUNT && ReturnCode == CFE_SUCCESS; i++)
+    {
+        if (!CAM_APP_CaptureProfileIsValid(&TblDataPtr->Profiles[i]))
+        {
+            CFE_EVS_SendEvent(CAM_APP_PROFILE_ERR_EID, CFE_EVS_EventType_ERROR,
+                              "Cam App: Capture profile %lu is out of range", (unsigned long)i);
+            ReturnCode = CAM_APP_TABLE_OUT_OF_RANGE_ERR_CODE;
+        }
+    }
+
     return ReturnCode;
 }
 
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Make a capture table profile the active one                     */
+/*                                                                 */
+/* Frame buffers are resized here, at load time, so capture never  */
+/* allocates.  Commands can still change the period, storage mode  */
+/* and encryption afterwards.                                      */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+static CFE_Status_t CAM_APP_CaptureProfileApply(const CAM_APP_CaptureTable_t *Table)
+{
+    const CAM_APP_CaptureProfile_t *Profile = &Table->Profiles[Table->ActiveProfile];
+    uint32                          FrameSize;
+    CFE_Status_t                    status;
+
+    FrameSize = CAM_APP_CaptureProfileFrameSize(Profile);
+
+    status = CAM_APP_PipelineConfigure(FrameSize);
+    if (status != CFE_SUCCESS)
+    {
+        CFE_EVS_SendEvent(CAM_APP_PROFILE_ERR_EID, CFE_EVS_EventType_ERROR,
+                          "Cam App: Failed to allocate frame buffers for profile '%s', RC = 0x%08lX", Profile->Name,
+                          (unsigned long)status);
+        return status;
+    }
+
+    CAM_APP_Data.Profile         = *Profile;
+    CAM_APP_Data.FrameBufferSize = FrameSize;
+    atomic_store(&CAM_APP_Data.ShotPeriodMs, Profile->PeriodMs);
+    atomic_store(&CAM_APP_Data.StorageMode, Profile->StorageMode);
+    atomic_store(&CAM_APP_Data.SecurityEnabled, (Profile->Stages & CAM_APP_CAPTURE_STAGE_ENCRYPT) != 0);
+    atomic_store(&CAM_APP_Data.VerifyInterval, Profile->VerifyInterval);
+    strncpy(CAM_APP_Data.PhotoDir, Table->PhotoDir, sizeof(CAM_APP_Data.PhotoDir) - 1);
+    CAM_APP_Data.PhotoDir[sizeof(CAM_APP_Data.PhotoDir) - 1] = '\0';
+
+    CFE_EVS_SendEvent(CAM_APP_PROFILE_INF_EID, CFE_EVS_EventType_INFORMATION,
+                      "Cam App: Capture profile '%s' active, %ux%u, %lu byte frame buffers", Profile->Name,
+                      Profile->Width, Profile->Height, (unsigned long)FrameSize);
+
+    return CFE_SUCCESS;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Pick up a new or changed capture table                          */
+/*                                                                 */
+/* The profile in use cannot change under a running pipeline, so   */
+/* an update that arrives while shooting is held until shooting    */
+/* stops.                                                          */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+CFE_Status_t CAM_APP_CaptureTableUpdate(void)
+{
+    CFE_Status_t status;
+    void        *TblAddr;
+
+    status = CFE_TBL_GetAddress(&TblAddr, CAM_APP_Data.TblHandles[0]);
+    if (status < CFE_SUCCESS)
+    {
+        return status;
+    }
+
+    if (status == CFE_TBL_INFO_UPDATED || CAM_APP_Data.ProfilePending)
+    {
+        CAM_APP_Data.ProfilePending = CAM_APP_PipelineIsRunning();
+
+        if (!CAM_APP_Data.ProfilePending)
+        {
+            status = CAM_APP_CaptureProfileApply(TblAddr);
+        }
+    }
+
+    CFE_TBL_ReleaseAddress(CAM_APP_Data.TblHandles[0]);
+
+    return (status == CFE_TBL_INFO_UPDATED) ? CFE_SUCCESS : status;
+}
+
 /* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
 /*                                                                 */
 /* Output CRC                                                      */
@@ -65,7 +197,7 @@ void CAM_APP_GetCrc(const char *TableName)
     status = CFE_TBL_GetInfo(&TblInfoPtr, TableName);
     if (status != CFE_SUCCESS)
     {
-        CFE_ES_WriteToSysLog("Cam App: Error Getting Example Table Info");
+        CFE_ES_WriteToSysLog("Cam App: Error Getting Capture Table Info");
     }
     else
     {
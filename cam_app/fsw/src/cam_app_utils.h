@@ -31,5 +31,7 @@
 
 CFE_Status_t CAM_APP_TblValidationFunc(void *TblData);
 void         CAM_APP_GetCrc(const char *TableName);
+uint32       CAM_APP_CaptureProfileFrameSize(const CAM_APP_CaptureProfile_t *Profile);
+CFE_Status_t CAM_APP_CaptureTableUpdate(void);
 
 #endif /* CAM_APP_UTILS_H */
\ No newline at end of file
@@ -0,0 +1,1296 @@
+/************************************************************************
+ * NASA Docket No. GSC-18,719-1, and identified as “core Flight System: Bootes”
+ *
+ * Copyright (c) 2020 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License. You may obtain
+ * a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ************************************************************************/
+
+/**
+ * \file
+ *   This file contains the source code for the Cam App storage writer.
+ */
+
+/*
+** Include Files:
+*/
+#include "cam_app.h"
+#include "cam_app_histogram.h"
+#include "cam_app_platform_cfg.h"
+#include "cam_app_queue.h"
+#include "cam_app_writer.h"
+
+#include "common_fnc.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#if defined(__linux__) && defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#endif
+#endif
+
+/* Opening into a registered file slot needs Linux 5.15; the 5.17 feature flag stands in for a version check */
+#if defined(IORING_FEAT_CQE_SKIP) && defined(__NR_io_uring_setup)
+#define CAM_APP_WRITER_HAVE_IO_URING 1
+#else
+#define CAM_APP_WRITER_HAVE_IO_URING 0
+#endif
+
+#if CAM_APP_WRITER_HAVE_IO_URING
+
+/*
+** The linked requests that make up one file, in order
+*/
+enum
+{
+    CAM_APP_WRITER_STEP_OPEN,
+    CAM_APP_WRITER_STEP_ALLOCATE,
+    CAM_APP_WRITER_STEP_WRITE,
+    CAM_APP_WRITER_STEP_CLOSE,
+    CAM_APP_WRITER_STEPS
+};
+
+#define CAM_APP_WRITER_DRAIN UINT64_MAX /* Tag of the no-op sent behind the last file at stop */
+
+/*
+** A file in flight; its index is also its registered file slot
+*/
+typedef struct
+{
+    CAM_APP_WriteRequest_t *Request;
+    size_t                  Size;      /* Bytes the write must cover */
+    uint32                  Remaining; /* Completions still to come */
+    bool                    Opened;
+} CAM_APP_WriterChain_t;
+
+typedef struct
+{
+    int Fd;
+
+    void                *RingMap;
+    size_t               RingMapSize;
+    struct io_uring_sqe *Sqes;
+    size_t               SqesSize;
+
+    unsigned *SqHead;
+    unsigned *SqTail;
+    unsigned *SqArray;
+    unsigned  SqMask;
+    unsigned  SqEntries;
+    unsigned  SqLocalTail; /* SQEs prepared so far, published to the kernel on submit */
+
+    unsigned            *CqHead;
+    unsigned            *CqTail;
+    unsigned             CqMask;
+    struct io_uring_cqe *Cqes;
+
+    pthread_t ReapThread;
+
+    CAM_APP_Queue_t       ChainFreeQueue;
+    void                 *ChainFreeRing[CAM_APP_WRITER_MAX_PENDING];
+    CAM_APP_WriterChain_t Chains[CAM_APP_WRITER_MAX_PENDING];
+} CAM_APP_WriterRing_t;
+
+#endif /* CAM_APP_WRITER_HAVE_IO_URING */
+
+typedef enum
+{
+    CAM_APP_WRITER_BACKEND_NONE,
+    CAM_APP_WRITER_BACKEND_IO_URING,
+    CAM_APP_WRITER_BACKEND_THREADS
+} CAM_APP_WriterBackend_t;
+
+#define CAM_APP_WRITER_POLICIES (CAM_APP_DURABILITY_GROUP + 1)
+
+typedef struct
+{
+    CAM_APP_WriterBackend_t Backend;
+    CAM_APP_WriterDone_t    Done;
+
+    atomic_uint Pending; /* Files submitted and not yet reported back */
+
+    /* Durability, fixed for a run */
+    uint8           Durability;
+    uint16          GroupFiles;
+    uint32          GroupMs;
+    bool            Committing;
+    CAM_APP_Queue_t CommitQueue; /* Written files waiting to be committed */
+    void           *CommitRing[CAM_APP_WRITER_MAX_PENDING];
+    pthread_t       CommitThread;
+
+    /* Thread backend */
+    CAM_APP_Queue_t Queue;
+    void           *QueueRing[CAM_APP_WRITER_MAX_PENDING];
+    pthread_t       Threads[CAM_APP_WRITER_THREADS];
+    uint32          ThreadCount;
+
+#if CAM_APP_WRITER_HAVE_IO_URING
+    CAM_APP_WriterRing_t Ring;
+#endif
+
+    /* Kept across runs for housekeeping, cleared by CAM_APP_WriterResetStats */
+    atomic_uint   PeakPending;
+    atomic_uint   Errors;
+    atomic_uint   LatencyMaxUs;
+    atomic_ullong LatencyTotalUs;
+    atomic_ullong Completed;
+    atomic_ullong BytesWritten;
+
+    /* Per durability policy: commits, files they covered and time spent in them */
+    atomic_ullong Syncs[CAM_APP_WRITER_POLICIES];
+    atomic_ullong SyncedFiles[CAM_APP_WRITER_POLICIES];
+    atomic_ullong SyncTotalUs[CAM_APP_WRITER_POLICIES];
+    atomic_uint   SyncMaxUs[CAM_APP_WRITER_POLICIES];
+} CAM_APP_Writer_t;
+
+static CAM_APP_Writer_t CAM_APP_Writer;
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Monotonic time in nanoseconds                                   */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+static uint64 CAM_APP_WriterNowNs(void)
+{
+    struct timespec Now;
+
+    clock_gettime(CLOCK_MONOTONIC, &Now);
+
+    return (uint64)Now.tv_sec * 1000000000u + (uint64)Now.tv_nsec;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Raise Value to at least Sample                                  */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+static void CAM_APP_WriterRaise(atomic_uint *Value, uint32 Sample)
+{
+    unsigned int Seen = atomic_load(Value);
+
+    while (Sample > Seen && !atomic_compare_exchange_weak(Value, &Seen, Sample))
+    {
+    }
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Count a file as in flight                                       */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+static void CAM_APP_WriterBegin(CAM_APP_WriteRequest_t *Request)
+{
+    Request->Status       = 0;
+    Request->SubmitTimeNs = CAM_APP_WriterNowNs();
+
+    /* Only new files need a temporary name; writes into an open file are committed where they are */
+    if (CAM_APP_Writer.Durability != CAM_APP_DURABILITY_NONE && Request->Fd < 0)
+    {
+        snprintf(Request->TempName, sizeof(Request->TempName), "%s.tmp", Request->Name);
+    }
+    else
+    {
+        Request->TempName[0] = '\0';
+    }
+
+    CAM_APP_WriterRaise(&CAM_APP_Writer.PeakPending, atomic_fetch_add(&CAM_APP_Writer.Pending, 1) + 1);
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Record a finished file and report it back                       */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+static void CAM_APP_WriterFinish(CAM_APP_WriteRequest_t *Request)
+{
+    uint64 LatencyUs = (CAM_APP_WriterNowNs() - Request->SubmitTimeNs) / 1000u;
+    uint64 Size      = 0;
+    uint32 i;
+
+    if (Request->Status != 0)
+    {
+        atomic_fetch_add(&CAM_APP_Writer.Errors, 1);
+    }
+    else
+    {
+        for (i = 0; i < Request->PartCount; i++)
+        {
+            Size += Request->Parts[i].iov_len;
+        }
+        atomic_fetch_add(&CAM_APP_Writer.BytesWritten, Size);
+        CAM_APP_HistogramRecord(CAM_APP_LATENCY_WRITE, LatencyUs);
+    }
+
+    atomic_fetch_add(&CAM_APP_Writer.LatencyTotalUs, LatencyUs);
+    atomic_fetch_add(&CAM_APP_Writer.Completed, 1);
+    CAM_APP_WriterRaise(&CAM_APP_Writer.LatencyMaxUs, LatencyUs > UINT32_MAX ? UINT32_MAX : (uint32)LatencyUs);
+
+    CAM_APP_Writer.Done(Request);
+
+    /* Last, so that stopping waits for the callback too */
+    atomic_fetch_sub(&CAM_APP_Writer.Pending, 1);
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* The name a new file is written under                            */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+static const char *CAM_APP_WriterPath(const CAM_APP_WriteRequest_t *Request)
+{
+    return Request->TempName[0] != '\0' ? Request->TempName : Request->Name;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Pass on a file whose data has been written                      */
+/*                                                                 */
+/* It goes to the commit thread unless it failed or the policy     */
+/* needs no commit.                                                */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+static void CAM_APP_WriterWritten(CAM_APP_WriteRequest_t *Request)
+{
+    if (Request->Status != 0 || !CAM_APP_Writer.Committing)
+    {
+        if (Request->Status != 0 && Request->TempName[0] != '\0')
+        {
+            unlink(Request->TempName);
+        }
+        CAM_APP_WriterFinish(Request);
+        return;
+    }
+
+    /* The commit thread never waits on a backend, so this only waits while it syncs */
+    CAM_APP_QueuePush(&CAM_APP_Writer.CommitQueue, Request, true);
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Thread backend: write one file with ordinary system calls       */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+static bool CAM_APP_WriterWriteFile(const CAM_APP_WriteRequest_t *Request)
+{
+    if (Request->Fd < 0)
+    {
+        return write_file_parts(Request->Parts, (int)Request->PartCount, CAM_APP_WriterPath(Request), false);
+    }
+
+    return write_parts_at(Request->Fd, Request->Parts, (int)Request->PartCount, (off_t)Request->Offset);
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Thread backend: write queued files one at a time                */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+static void *CAM_APP_WriterThread(void *Arg)
+{
+    CAM_APP_WriteRequest_t *Request;
+    void                   *Item;
+
+    while (CAM_APP_QueuePop(&CAM_APP_Writer.Queue, &Item, true))
+    {
+        Request = Item;
+
+        CFE_ES_PerfLogEntry(CAM_APP_WRITE_PERF_ID);
+        errno = 0;
+        if (!CAM_APP_WriterWriteFile(Request))
+        {
+            Request->Status = errno != 0 ? errno : EIO;
+        }
+        CFE_ES_PerfLogExit(CAM_APP_WRITE_PERF_ID);
+
+        CAM_APP_WriterWritten(Request);
+    }
+
+    return NULL;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Thread backend: start the writer threads                        */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+static bool CAM_APP_WriterThreadsStart(void)
+{
+    if (CAM_APP_QueueInit(&CAM_APP_Writer.Queue, CAM_APP_Writer.QueueRing, CAM_APP_WRITER_MAX_PENDING) != 0)
+    {
+        return false;
+    }
+
+    CAM_APP_Writer.ThreadCount = 0;
+    while (CAM_APP_Writer.ThreadCount < CAM_APP_WRITER_THREADS &&
+           pthread_create(&CAM_APP_Writer.Threads[CAM_APP_Writer.ThreadCount], NULL, CAM_APP_WriterThread, NULL) == 0)
+    {
+        CAM_APP_Writer.ThreadCount++;
+    }
+
+    /* One thread is slower but still writes everything */
+    if (CAM_APP_Writer.ThreadCount == 0)
+    {
+        CAM_APP_QueueDestroy(&CAM_APP_Writer.Queue);
+        return false;
+    }
+
+    return true;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Thread backend: write what is queued, then stop the threads     */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+static void CAM_APP_WriterThreadsStop(void)
+{
+    uint32 i;
+
+    CAM_APP_QueueClose(&CAM_APP_Writer.Queue);
+
+    for (i = 0; i < CAM_APP_Writer.ThreadCount; i++)
+    {
+        pthread_join(CAM_APP_Writer.Threads[i], NULL);
+    }
+
+    CAM_APP_Writer.ThreadCount = 0;
+    CAM_APP_QueueDestroy(&CAM_APP_Writer.Queue);
+}
+
+#if CAM_APP_WRITER_HAVE_IO_URING
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* io_uring backend: release the ring's mappings and descriptor    */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+static void CAM_APP_WriterRingClose(CAM_APP_WriterRing_t *Ring)
+{
+    if (Ring->Sqes != NULL)
+    {
+        munmap(Ring->Sqes, Ring->SqesSize);
+        Ring->Sqes = NULL;
+    }
+    if (Ring->RingMap != NULL)
+    {
+        munmap(Ring->RingMap, Ring->RingMapSize);
+        Ring->RingMap = NULL;
+    }
+    close(Ring->Fd);
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* io_uring backend: set up a ring with a registered file slot for */
+/* every file that may be in flight                                */
+/*                                                                 */
+/* Returns false if the kernel lacks io_uring, has it disabled or  */
+/* is too old for opening straight into a registered slot.         */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+static bool CAM_APP_WriterRingOpen(CAM_APP_WriterRing_t *Ring)
+{
+    const unsigned         Required = IORING_FEAT_SINGLE_MMAP | IORING_FEAT_NODROP | IORING_FEAT_CQE_SKIP;
+    struct io_uring_params Params;
+    int                    Slots[CAM_APP_WRITER_MAX_PENDING];
+    size_t                 SqSize;
+    size_t                 CqSize;
+    uint8                 *Base;
+    uint32                 i;
+
+    memset(&Params, 0, sizeof(Params));
+    memset(Ring, 0, offsetof(CAM_APP_WriterRing_t, ReapThread));
+
+    /* Every file takes one entry per step, plus one for the no-op sent at stop */
+    Ring->Fd = (int)syscall(__NR_io_uring_setup, CAM_APP_WRITER_MAX_PENDING * CAM_APP_WRITER_STEPS + 1, &Params);
+    if (Ring->Fd < 0)
+    {
+        return false;
+    }
+
+    if ((Params.features & Required) != Required)
+    {
+        close(Ring->Fd);
+        return false;
+    }
+
+    /* With SINGLE_MMAP one mapping covers both rings */
+    SqSize            = Params.sq_off.array + Params.sq_entries * sizeof(unsigned);
+    CqSize            = Params.cq_off.cqes + Params.cq_entries * sizeof(struct io_uring_cqe);
+    Ring->RingMapSize = SqSize > CqSize ? SqSize : CqSize;
+    Ring->SqesSize    = Params.sq_entries * sizeof(struct io_uring_sqe);
+
+    Ring->RingMap = mmap(NULL, Ring->RingMapSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, Ring->Fd,
+                         IORING_OFF_SQ_RING);
+    Ring->Sqes    = mmap(NULL, Ring->SqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, Ring->Fd,
+                         IORING_OFF_SQES);
+    if (Ring->RingMap == MAP_FAILED || Ring->Sqes == MAP_FAILED)
+    {
+        Ring->RingMap = Ring->RingMap == MAP_FAILED ? NULL : Ring->RingMap;
+        Ring->Sqes    = Ring->Sqes == MAP_FAILED ? NULL : Ring->Sqes;
+        CAM_APP_WriterRingClose(Ring);
+        return false;
+    }
+
+    Base            = Ring->RingMap;
+    Ring->SqHead    = (unsigned *)(Base + Params.sq_off.head);
+    Ring->SqTail    = (unsigned *)(Base + Params.sq_off.tail);
+    Ring->SqArray   = (unsigned *)(Base + Params.sq_off.array);
+    Ring->SqMask    = *(unsigned *)(Base + Params.sq_off.ring_mask);
+    Ring->SqEntries = Params.sq_entries;
+    Ring->CqHead    = (unsigned *)(Base + Params.cq_off.head);
+    Ring->CqTail    = (unsigned *)(Base + Params.cq_off.tail);
+    Ring->CqMask    = *(unsigned *)(Base + Params.cq_off.ring_mask);
+    Ring->Cqes      = (struct io_uring_cqe *)(Base + Params.cq_off.cqes);
+
+    Ring->SqLocalTail = *Ring->SqTail;
+
+    /* Empty slots, filled by each file's open and emptied by its close */
+    for (i = 0; i < CAM_APP_WRITER_MAX_PENDING; i++)
+    {
+        Slots[i] = -1;
+    }
+    if (syscall(__NR_io_uring_register, Ring->Fd, IORING_REGISTER_FILES, Slots, CAM_APP_WRITER_MAX_PENDING) != 0)
+    {
+        CAM_APP_WriterRingClose(Ring);
+        return false;
+    }
+
+    return true;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* io_uring backend: claim and clear the next submission entry     */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+static struct io_uring_sqe *CAM_APP_WriterRingSqe(CAM_APP_WriterRing_t *Ring, uint8 Opcode, uint64 UserData)
+{
+    unsigned             Index = Ring->SqLocalTail & Ring->SqMask;
+    struct io_uring_sqe *Sqe   = &Ring->Sqes[Index];
+
+    memset(Sqe, 0, sizeof(*Sqe));
+    Sqe->opcode    = Opcode;
+    Sqe->user_data = UserData;
+
+    Ring->SqArray[Index] = Index;
+    Ring->SqLocalTail++;
+
+    return Sqe;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* io_uring backend: queue the chain that writes one file          */
+/*                                                                 */
+/* The steps are hard-linked so that each runs after the one       */
+/* before even if it failed; the close then always frees the slot. */
+/* A file the caller holds open only gets the write.               */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+static void CAM_APP_WriterRingPrepare(CAM_APP_WriterRing_t *Ring, uint32 Slot, CAM_APP_WriteRequest_t *Request)
+{
+    CAM_APP_WriterChain_t *Chain = &Ring->Chains[Slot];
+    struct io_uring_sqe   *Sqe;
+    uint64                 Tag = (uint64)Slot << 8;
+    uint32                 i;
+
+    Chain->Request   = Request;
+    Chain->Size      = 0;
+    Chain->Remaining = 0;
+    Chain->Opened    = false;
+    for (i = 0; i < Request->PartCount; i++)
+    {
+        Chain->Size += Request->Parts[i].iov_len;
+    }
+
+    if (Request->Fd >= 0)
+    {
+        Sqe        = CAM_APP_WriterRingSqe(Ring, IORING_OP_WRITEV, Tag | CAM_APP_WRITER_STEP_WRITE);
+        Sqe->fd    = Request->Fd;
+        Sqe->addr  = (uintptr_t)Request->Parts;
+        Sqe->len   = Request->PartCount;
+        Sqe->off   = Request->Offset;
+        Chain->Remaining++;
+        return;
+    }
+
+    Sqe                  = CAM_APP_WriterRingSqe(Ring, IORING_OP_OPENAT, Tag | CAM_APP_WRITER_STEP_OPEN);
+    Sqe->fd              = AT_FDCWD;
+    Sqe->addr            = (uintptr_t)CAM_APP_WriterPath(Request);
+    Sqe->len             = 0644;
+    Sqe->open_flags      = O_WRONLY | O_CREAT | O_TRUNC; /* Not O_CLOEXEC, which a registered slot refuses */
+    Sqe->file_index      = Slot + 1;
+    Sqe->flags           = IOSQE_IO_HARDLINK;
+    Chain->Remaining++;
+
+    /* Running out of space shows up here rather than part way through the write */
+    if (Chain->Size > 0)
+    {
+        Sqe        = CAM_APP_WriterRingSqe(Ring, IORING_OP_FALLOCATE, Tag | CAM_APP_WRITER_STEP_ALLOCATE);
+        Sqe->fd    = (int)Slot;
+        Sqe->addr  = Chain->Size;
+        Sqe->flags = IOSQE_FIXED_FILE | IOSQE_IO_HARDLINK;
+        Chain->Remaining++;
+    }
+
+    Sqe        = CAM_APP_WriterRingSqe(Ring, IORING_OP_WRITEV, Tag | CAM_APP_WRITER_STEP_WRITE);
+    Sqe->fd    = (int)Slot;
+    Sqe->addr  = (uintptr_t)Request->Parts;
+    Sqe->len   = Request->PartCount;
+    Sqe->flags = IOSQE_FIXED_FILE | IOSQE_IO_HARDLINK;
+    Chain->Remaining++;
+
+    Sqe             = CAM_APP_WriterRingSqe(Ring, IORING_OP_CLOSE, Tag | CAM_APP_WRITER_STEP_CLOSE);
+    Sqe->file_index = Slot + 1;
+    Chain->Remaining++;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* io_uring backend: hand everything prepared to the kernel        */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+static void CAM_APP_WriterRingEnter(CAM_APP_WriterRing_t *Ring)
+{
+    unsigned ToSubmit;
+    long     Submitted;
+
+    __atomic_store_n(Ring->SqTail, Ring->SqLocalTail, __ATOMIC_RELEASE);
+
+    ToSubmit = Ring->SqLocalTail - __atomic_load_n(Ring->SqHead, __ATOMIC_ACQUIRE);
+    while (ToSubmit > 0)
+    {
+        Submitted = syscall(__NR_io_uring_enter, Ring->Fd, ToSubmit, 0, 0, NULL, 0);
+        if (Submitted > 0)
+        {
+            ToSubmit -= (unsigned)Submitted;
+        }
+        else if (Submitted < 0 && (errno == EAGAIN || errno == EBUSY))
+        {
+            /* Short of kernel memory or completion room; give the reaper a moment */
+            usleep(1000);
+        }
+        else if (!(Submitted < 0 && errno == EINTR))
+        {
+            /* Left in the ring, the entries go in with the next submission */
+            break;
+        }
+    }
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* io_uring backend: account for one completed step of a file      */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+static void CAM_APP_WriterRingComplete(CAM_APP_WriterRing_t *Ring, uint32 Slot, uint32 Step, int32 Result)
+{
+    CAM_APP_WriterChain_t  *Chain   = &Ring->Chains[Slot];
+    CAM_APP_WriteRequest_t *Request = Chain->Request;
+    int32                   Error   = Result < 0 ? -Result : 0;
+
+    switch (Step)
+    {
+        case CAM_APP_WRITER_STEP_OPEN:
+            Chain->Opened = Result >= 0;
+            break;
+
+        case CAM_APP_WRITER_STEP_ALLOCATE:
+            /* As with posix_fallocate, only a lack of space matters; some file systems cannot preallocate */
+            Error = Error == ENOSPC ? ENOSPC : 0;
+            break;
+
+        case CAM_APP_WRITER_STEP_WRITE:
+            if (Result >= 0 && (size_t)Result != Chain->Size)
+            {
+                Error = EIO;
+            }
+            break;
+
+        default:
+            break;
+    }
+
+    /* Later steps fail too once one has; the first error is the one worth reporting */
+    if (Request->Status == 0)
+    {
+        Request->Status = Error;
+    }
+
+    if (--Chain->Remaining > 0)
+    {
+        return;
+    }
+
+    /* Do not leave a partial file behind */
+    if (Request->Status != 0 && Chain->Opened)
+    {
+        unlink(CAM_APP_WriterPath(Request));
+    }
+
+    CAM_APP_WriterWritten(Request);
+
+    Chain->Request = NULL;
+    CAM_APP_QueuePush(&Ring->ChainFreeQueue, Chain, false);
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* io_uring backend: reap completions until stopped with no file   */
+/* left in the ring                                                */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+static void *CAM_APP_WriterReap(void *Arg)
+{
+    CAM_APP_WriterRing_t *Ring     = &CAM_APP_Writer.Ring;
+    bool                  Draining = false;
+    struct io_uring_cqe  *Cqe;
+    unsigned              Head;
+    unsigned              Tail;
+
+    /* Files already handed to the commit thread no longer hold a slot */
+    while (!Draining || CAM_APP_QueueCount(&Ring->ChainFreeQueue) < CAM_APP_WRITER_MAX_PENDING)
+    {
+        /* Pairs with the kernel's release, so what was written about a file before its submission is seen */
+        Head = *Ring->CqHead;
+        Tail = __atomic_load_n(Ring->CqTail, __ATOMIC_ACQUIRE);
+
+        if (Head == Tail)
+        {
+            syscall(__NR_io_uring_enter, Ring->Fd, 0, 1, IORING_ENTER_GETEVENTS, NULL, 0);
+            continue;
+        }
+
+        for (; Head != Tail; Head++)
+        {
+            Cqe = &Ring->Cqes[Head & Ring->CqMask];
+
+            if (Cqe->user_data == CAM_APP_WRITER_DRAIN)
+            {
+                Draining = true;
+            }
+            else
+            {
+                CAM_APP_WriterRingComplete(Ring, (uint32)(Cqe->user_data >> 8), (uint32)(Cqe->user_data & 0xFF),
+                                           Cqe->res);
+            }
+        }
+
+        __atomic_store_n(Ring->CqHead, Head, __ATOMIC_RELEASE);
+    }
+
+    return NULL;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* io_uring backend: open the ring and start reaping               */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+static bool CAM_APP_WriterRingStart(void)
+{
+    CAM_APP_WriterRing_t *Ring = &CAM_APP_Writer.Ring;
+    uint32                i;
+
+    if (!CAM_APP_WriterRingOpen(Ring))
+    {
+        return false;
+    }
+
+    if (CAM_APP_QueueInit(&Ring->ChainFreeQueue, Ring->ChainFreeRing, CAM_APP_WRITER_MAX_PENDING) != 0)
+    {
+        CAM_APP_WriterRingClose(Ring);
+        return false;
+    }
+
+    for (i = 0; i < CAM_APP_WRITER_MAX_PENDING; i++)
+    {
+        CAM_APP_QueuePush(&Ring->ChainFreeQueue, &Ring->Chains[i], false);
+    }
+
+    if (pthread_create(&Ring->ReapThread, NULL, CAM_APP_WriterReap, NULL) != 0)
+    {
+        CAM_APP_QueueDestroy(&Ring->ChainFreeQueue);
+        CAM_APP_WriterRingClose(Ring);
+        return false;
+    }
+
+    return true;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* io_uring backend: queue files and submit them in one call       */
+/*                                                                 */
+/* Waits for a file slot when the most files are already in        */
+/* flight.                                                         */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+static void CAM_APP_WriterRingSubmit(CAM_APP_WriteRequest_t **Requests, uint32 Count)
+{
+    CAM_APP_WriterRing_t *Ring = &CAM_APP_Writer.Ring;
+    void                 *Item;
+    uint32                i;
+
+    for (i = 0; i < Count; i++)
+    {
+        CAM_APP_QueuePop(&Ring->ChainFreeQueue, &Item, true);
+
+        CAM_APP_WriterBegin(Requests[i]);
+        CAM_APP_WriterRingPrepare(Ring, (uint32)((CAM_APP_WriterChain_t *)Item - Ring->Chains), Requests[i]);
+    }
+
+    /* The kernel does the writes themselves; only handing them over takes this thread's time */
+    CFE_ES_PerfLogEntry(CAM_APP_WRITE_PERF_ID);
+    CAM_APP_WriterRingEnter(Ring);
+    CFE_ES_PerfLogExit(CAM_APP_WRITE_PERF_ID);
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* io_uring backend: wait for files in flight, then tear down      */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+static void CAM_APP_WriterRingStop(void)
+{
+    CAM_APP_WriterRing_t *Ring = &CAM_APP_Writer.Ring;
+
+    /* Completes behind nothing in particular; the reaper keeps going until the last file is in too */
+    CAM_APP_WriterRingSqe(Ring, IORING_OP_NOP, CAM_APP_WRITER_DRAIN);
+    CAM_APP_WriterRingEnter(Ring);
+
+    pthread_join(Ring->ReapThread, NULL);
+
+    CAM_APP_QueueDestroy(&Ring->ChainFreeQueue);
+    CAM_APP_WriterRingClose(Ring);
+}
+
+#endif /* CAM_APP_WRITER_HAVE_IO_URING */
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Length of the directory part of a file name                     */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+static size_t CAM_APP_WriterDirLen(const char *Name)
+{
+    const char *Slash = strrchr(Name, '/');
+
+    return Slash == NULL ? 0 : (size_t)(Slash - Name);
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Open the directory a file is in                                 */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+static int CAM_APP_WriterOpenDir(const char *Name)
+{
+    char   Dir[CAM_APP_WRITER_NAME_LEN];
+    size_t Len = CAM_APP_WriterDirLen(Name);
+
+    if (Len == 0)
+    {
+        return open(Name[0] == '/' ? "/" : ".", O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    }
+
+    memcpy(Dir, Name, Len);
+    Dir[Len] = '\0';
+
+    return open(Dir, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Flush the directory a file is in, so that its entry survives    */
+/* a power cut.  Returns 0 or an errno value.                      */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+static int CAM_APP_WriterSyncDir(const char *Name)
+{
+    int DirFd  = CAM_APP_WriterOpenDir(Name);
+    int Status = 0;
+
+    if (DirFd < 0 || fsync(DirFd) != 0)
+    {
+        Status = errno;
+    }
+
+    if (DirFd >= 0)
+    {
+        close(DirFd);
+    }
+
+    return Status;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Record the time one commit of Files files took                  */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+static void CAM_APP_WriterSyncSample(uint8 Policy, uint64 StartNs, uint32 Files)
+{
+    uint64 ElapsedUs = (CAM_APP_WriterNowNs() - StartNs) / 1000u;
+
+    atomic_fetch_add(&CAM_APP_Writer.Syncs[Policy], 1);
+    atomic_fetch_add(&CAM_APP_Writer.SyncedFiles[Policy], Files);
+    atomic_fetch_add(&CAM_APP_Writer.SyncTotalUs[Policy], ElapsedUs);
+    CAM_APP_HistogramRecord(CAM_APP_LATENCY_COMMIT, ElapsedUs);
+    CAM_APP_WriterRaise(&CAM_APP_Writer.SyncMaxUs[Policy], ElapsedUs > UINT32_MAX ? UINT32_MAX : (uint32)ElapsedUs);
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Commit one file on its own                                      */
+/*                                                                 */
+/* A new file is synced under its temporary name, renamed into     */
+/* place and its directory synced.  Data written into an open file */
+/* is synced where it is.                                          */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+static void CAM_APP_WriterCommitFile(CAM_APP_WriteRequest_t *Request)
+{
+    uint64 StartNs = CAM_APP_WriterNowNs();
+    int    Fd;
+
+    CFE_ES_PerfLogEntry(CAM_APP_COMMIT_PERF_ID);
+
+    if (Request->Fd >= 0)
+    {
+        if (fdatasync(Request->Fd) != 0)
+        {
+            Request->Status = errno;
+        }
+    }
+    else
+    {
+        Fd = open(Request->TempName, O_WRONLY | O_CLOEXEC);
+        if (Fd < 0 || fdatasync(Fd) != 0)
+        {
+            Request->Status = errno;
+        }
+        if (Fd >= 0)
+        {
+            close(Fd);
+        }
+
+        if (Request->Status == 0 && rename(Request->TempName, Request->Name) != 0)
+        {
+            Request->Status = errno;
+        }
+        if (Request->Status != 0)
+        {
+            unlink(Request->TempName);
+        }
+        else
+        {
+            Request->Status = CAM_APP_WriterSyncDir(Request->Name);
+        }
+    }
+
+    CAM_APP_WriterSyncSample(CAM_APP_DURABILITY_FILE, StartNs, 1);
+    CFE_ES_PerfLogExit(CAM_APP_COMMIT_PERF_ID);
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Commit a group of files together                                */
+/*                                                                 */
+/* One syncfs flushes the data of every file in the group, then    */
+/* each new file is renamed into place and each directory they     */
+/* went into is synced once.                                       */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+static void CAM_APP_WriterCommitGroup(CAM_APP_WriteRequest_t **Group, uint32 Count)
+{
+    uint64 StartNs = CAM_APP_WriterNowNs();
+    int    Status  = 0;
+    int    DirFd;
+    size_t DirLen;
+    uint32 i;
+    uint32 j;
+
+    CFE_ES_PerfLogEntry(CAM_APP_COMMIT_PERF_ID);
+
+    /* Every file of the group is on the same card as the photo directory */
+    DirFd = CAM_APP_WriterOpenDir(Group[0]->Name);
+    if (DirFd < 0 || syncfs(DirFd) != 0)
+    {
+        Status = errno;
+    }
+    if (DirFd >= 0)
+    {
+        close(DirFd);
+    }
+
+    for (i = 0; i < Count; i++)
+    {
+        if (Group[i]->TempName[0] == '\0')
+        {
+            Group[i]->Status = Status;
+            continue;
+        }
+
+        if (Status != 0 || rename(Group[i]->TempName, Group[i]->Name) != 0)
+        {
+            Group[i]->Status = Status != 0 ? Status : errno;
+            unlink(Group[i]->TempName);
+        }
+    }
+
+    for (i = 0; i < Count; i++)
+    {
+        if (Group[i]->TempName[0] == '\0' || Group[i]->Status != 0)
+        {
+            continue;
+        }
+
+        /* Skip a directory an earlier file of the group already covered */
+        DirLen = CAM_APP_WriterDirLen(Group[i]->Name);
+        for (j = 0; j < i; j++)
+        {
+            if (Group[j]->TempName[0] != '\0' && CAM_APP_WriterDirLen(Group[j]->Name) == DirLen &&
+                strncmp(Group[j]->Name, Group[i]->Name, DirLen) == 0)
+            {
+                break;
+            }
+        }
+
+        if (j == i)
+        {
+            Status = CAM_APP_WriterSyncDir(Group[i]->Name);
+        }
+
+        /* A file shares the outcome of its directory's sync */
+        for (j = i; j < Count && Status != 0; j++)
+        {
+            if (Group[j]->TempName[0] != '\0' && Group[j]->Status == 0 &&
+                CAM_APP_WriterDirLen(Group[j]->Name) == DirLen && strncmp(Group[j]->Name, Group[i]->Name, DirLen) == 0)
+            {
+                Group[j]->Status = Status;
+            }
+        }
+        Status = 0;
+    }
+
+    CAM_APP_WriterSyncSample(CAM_APP_DURABILITY_GROUP, StartNs, Count);
+    CFE_ES_PerfLogExit(CAM_APP_COMMIT_PERF_ID);
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Commit written files until the commit queue is closed           */
+/*                                                                 */
+/* Under the group policy a group closes when it holds the set     */
+/* number of files or the set time has passed since its first.     */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+static void *CAM_APP_WriterCommitThread(void *Arg)
+{
+    CAM_APP_WriteRequest_t *Group[CAM_APP_WRITER_MAX_PENDING];
+    struct timespec         Deadline;
+    void                   *Item;
+    uint32                  Count;
+    uint32                  i;
+
+    while (CAM_APP_QueuePop(&CAM_APP_Writer.CommitQueue, &Item, true))
+    {
+        Group[0] = Item;
+        Count    = 1;
+
+        if (CAM_APP_Writer.Durability == CAM_APP_DURABILITY_GROUP)
+        {
+            clock_gettime(CLOCK_MONOTONIC, &Deadline);
+            Deadline.tv_sec += CAM_APP_Writer.GroupMs / 1000;
+            Deadline.tv_nsec += (long)(CAM_APP_Writer.GroupMs % 1000) * 1000000L;
+            if (Deadline.tv_nsec >= 1000000000L)
+            {
+                Deadline.tv_sec++;
+                Deadline.tv_nsec -= 1000000000L;
+            }
+
+            while (Count < CAM_APP_Writer.GroupFiles &&
+                   CAM_APP_QueuePopUntil(&CAM_APP_Writer.CommitQueue, &Item, &Deadline))
+            {
+                Group[Count++] = Item;
+            }
+
+            CAM_APP_WriterCommitGroup(Group, Count);
+        }
+        else
+        {
+            CAM_APP_WriterCommitFile(Group[0]);
+        }
+
+        for (i = 0; i < Count; i++)
+        {
+            CAM_APP_WriterFinish(Group[i]);
+        }
+    }
+
+    return NULL;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Commit what is queued, then stop the commit thread              */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+static void CAM_APP_WriterCommitStop(void)
+{
+    if (!CAM_APP_Writer.Committing)
+    {
+        return;
+    }
+
+    CAM_APP_QueueClose(&CAM_APP_Writer.CommitQueue);
+    pthread_join(CAM_APP_Writer.CommitThread, NULL);
+    CAM_APP_QueueDestroy(&CAM_APP_Writer.CommitQueue);
+
+    CAM_APP_Writer.Committing = false;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Start the writer, reporting each finished file to Done          */
+/*                                                                 */
+/* Uses io_uring when configured and the kernel supports it, and   */
+/* writer threads otherwise.  Files are committed as Durability    */
+/* says, a group holding at most GroupFiles files or GroupMs of    */
+/* them.  Returns 0, or -1 if the writer could not be started.     */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+int32 CAM_APP_WriterStart(CAM_APP_WriterDone_t Done, uint8 Durability, uint16 GroupFiles, uint32 GroupMs)
+{
+    if (CAM_APP_Writer.Backend != CAM_APP_WRITER_BACKEND_NONE || Durability > CAM_APP_DURABILITY_GROUP ||
+        (Durability == CAM_APP_DURABILITY_GROUP &&
+         (GroupFiles == 0 || GroupFiles > CAM_APP_WRITER_MAX_PENDING || GroupMs == 0)))
+    {
+        return -1;
+    }
+
+    CAM_APP_Writer.Done       = Done;
+    CAM_APP_Writer.Durability = Durability;
+    CAM_APP_Writer.GroupFiles = GroupFiles;
+    CAM_APP_Writer.GroupMs    = GroupMs;
+    atomic_store(&CAM_APP_Writer.Pending, 0);
+
+    CAM_APP_Writer.Committing = Durability != CAM_APP_DURABILITY_NONE;
+    if (CAM_APP_Writer.Committing)
+    {
+        if (CAM_APP_QueueInit(&CAM_APP_Writer.CommitQueue, CAM_APP_Writer.CommitRing, CAM_APP_WRITER_MAX_PENDING) !=
+            0)
+        {
+            return -1;
+        }
+
+        if (pthread_create(&CAM_APP_Writer.CommitThread, NULL, CAM_APP_WriterCommitThread, NULL) != 0)
+        {
+            CAM_APP_QueueDestroy(&CAM_APP_Writer.CommitQueue);
+            return -1;
+        }
+    }
+
+#if CAM_APP_WRITER_HAVE_IO_URING
+    if (CAM_APP_WRITER_USE_IO_URING && CAM_APP_WriterRingStart())
+    {
+        CAM_APP_Writer.Backend = CAM_APP_WRITER_BACKEND_IO_URING;
+        return 0;
+    }
+#endif
+
+    if (CAM_APP_WriterThreadsStart())
+    {
+        CAM_APP_Writer.Backend = CAM_APP_WRITER_BACKEND_THREADS;
+        return 0;
+    }
+
+    CAM_APP_WriterCommitStop();
+    return -1;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Wait for every submitted file to be reported, then stop         */
+/*                                                                 */
+/* Must be called from the submitting thread, or once it has       */
+/* stopped submitting.  Does nothing if the writer is not running. */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+void CAM_APP_WriterStop(void)
+{
+    switch (CAM_APP_Writer.Backend)
+    {
+#if CAM_APP_WRITER_HAVE_IO_URING
+        case CAM_APP_WRITER_BACKEND_IO_URING:
+            CAM_APP_WriterRingStop();
+            break;
+#endif
+
+        case CAM_APP_WRITER_BACKEND_THREADS:
+            CAM_APP_WriterThreadsStop();
+            break;
+
+        default:
+            return;
+    }
+
+    /* The backends have handed over every file by now */
+    CAM_APP_WriterCommitStop();
+
+    CAM_APP_Writer.Backend = CAM_APP_WRITER_BACKEND_NONE;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Write Count files in the background                             */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+void CAM_APP_WriterSubmit(CAM_APP_WriteRequest_t **Requests, uint32 Count)
+{
+    uint32 i;
+
+#if CAM_APP_WRITER_HAVE_IO_URING
+    if (CAM_APP_Writer.Backend == CAM_APP_WRITER_BACKEND_IO_URING)
+    {
+        CAM_APP_WriterRingSubmit(Requests, Count);
+        return;
+    }
+#endif
+
+    for (i = 0; i < Count; i++)
+    {
+        CAM_APP_WriterBegin(Requests[i]);
+        CAM_APP_QueuePush(&CAM_APP_Writer.Queue, Requests[i], true);
+    }
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Name the backend in use, for events                             */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+const char *CAM_APP_WriterBackendName(void)
+{
+    switch (CAM_APP_Writer.Backend)
+    {
+        case CAM_APP_WRITER_BACKEND_IO_URING:
+            return "io_uring";
+        case CAM_APP_WRITER_BACKEND_THREADS:
+            return "threads";
+        default:
+            return "stopped";
+    }
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Report files in flight now and at most, the mean and longest    */
+/* time from submission to completion, failed files and KiB        */
+/* written                                                         */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+void CAM_APP_WriterStats(uint32 *Depth, uint32 *PeakDepth, uint32 *LatencyAvgUs, uint32 *LatencyMaxUs,
+                         uint32 *Errors, uint32 *WrittenKb)
+{
+    unsigned long long Completed = atomic_load(&CAM_APP_Writer.Completed);
+
+    *Depth        = atomic_load(&CAM_APP_Writer.Pending);
+    *PeakDepth    = atomic_load(&CAM_APP_Writer.PeakPending);
+    *LatencyAvgUs = Completed == 0 ? 0 : (uint32)(atomic_load(&CAM_APP_Writer.LatencyTotalUs) / Completed);
+    *LatencyMaxUs = atomic_load(&CAM_APP_Writer.LatencyMaxUs);
+    *Errors       = atomic_load(&CAM_APP_Writer.Errors);
+    *WrittenKb    = (uint32)(atomic_load(&CAM_APP_Writer.BytesWritten) / 1024u);
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Clear the statistics reported in housekeeping                   */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+void CAM_APP_WriterResetStats(void)
+{
+    uint32 i;
+
+    atomic_store(&CAM_APP_Writer.PeakPending, atomic_load(&CAM_APP_Writer.Pending));
+    atomic_store(&CAM_APP_Writer.Errors, 0);
+    atomic_store(&CAM_APP_Writer.LatencyMaxUs, 0);
+    atomic_store(&CAM_APP_Writer.LatencyTotalUs, 0);
+    atomic_store(&CAM_APP_Writer.Completed, 0);
+    atomic_store(&CAM_APP_Writer.BytesWritten, 0);
+
+    for (i = 0; i < CAM_APP_WRITER_POLICIES; i++)
+    {
+        atomic_store(&CAM_APP_Writer.Syncs[i], 0);
+        atomic_store(&CAM_APP_Writer.SyncedFiles[i], 0);
+        atomic_store(&CAM_APP_Writer.SyncTotalUs[i], 0);
+        atomic_store(&CAM_APP_Writer.SyncMaxUs[i], 0);
+    }
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Report the mean and longest time a commit took under each of    */
+/* the file and group policies, and the mean files per group       */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+void CAM_APP_WriterSyncStats(uint32 *FileAvgUs, uint32 *FileMaxUs, uint32 *GroupAvgUs, uint32 *GroupMaxUs,
+                             uint32 *GroupFiles)
+{
+    unsigned long long FileSyncs  = atomic_load(&CAM_APP_Writer.Syncs[CAM_APP_DURABILITY_FILE]);
+    unsigned long long GroupSyncs = atomic_load(&CAM_APP_Writer.Syncs[CAM_APP_DURABILITY_GROUP]);
+
+    *FileAvgUs =
+        FileSyncs == 0 ? 0 : (uint32)(atomic_load(&CAM_APP_Writer.SyncTotalUs[CAM_APP_DURABILITY_FILE]) / FileSyncs);
+    *FileMaxUs  = atomic_load(&CAM_APP_Writer.SyncMaxUs[CAM_APP_DURABILITY_FILE]);
+    *GroupAvgUs = GroupSyncs == 0
+                      ? 0
+                      : (uint32)(atomic_load(&CAM_APP_Writer.SyncTotalUs[CAM_APP_DURABILITY_GROUP]) / GroupSyncs);
+    *GroupMaxUs = atomic_load(&CAM_APP_Writer.SyncMaxUs[CAM_APP_DURABILITY_GROUP]);
+    *GroupFiles = GroupSyncs == 0
+                      ? 0
+                      : (uint32)(atomic_load(&CAM_APP_Writer.SyncedFiles[CAM_APP_DURABILITY_GROUP]) / GroupSyncs);
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Name a durability policy, for events                            */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+const char *CAM_APP_WriterDurabilityName(uint8 Durability)
+{
+    switch (Durability)
+    {
+        case CAM_APP_DURABILITY_NONE:
+            return "none";
+        case CAM_APP_DURABILITY_FILE:
+            return "per-file";
+        case CAM_APP_DURABILITY_GROUP:
+            return "group";
+        default:
+            return "unknown";
+    }
+}
@@ -0,0 +1,94 @@
+/************************************************************************
+ * NASA Docket No. GSC-18,719-1, and identified as “core Flight System: Bootes”
+ *
+ * Copyright (c) 2020 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License. You may obtain
+ * a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ************************************************************************/
+
+/**
+ * @file
+ *   This file contains the prototypes for the Cam App storage writer
+ *
+ *   The writer creates, writes and closes whole files in the background
+ *   and reports each one back through a callback, so the thread that
+ *   hands it files never waits on the card.  It can also write into a
+ *   file the caller keeps open, at an offset of its choosing.  Where the
+ *   kernel offers io_uring every file becomes one linked chain of
+ *   requests and the files of one call go to the kernel together;
+ *   elsewhere a few threads write them with ordinary system calls.
+ *
+ *   Under the FILE and GROUP durability policies a new file is written
+ *   under a temporary name and only renamed into place once its data is
+ *   on the card, so a power cut leaves either the whole file or none of
+ *   it.  A commit thread does the syncing and renaming, for each file on
+ *   its own or for a group of files at once, and the file is reported
+ *   once it is committed.
+ *
+ *   Only one thread may submit files.  The callback runs on a writer
+ *   thread, possibly several at once for different files.
+ */
+
+#ifndef CAM_APP_WRITER_H
+#define CAM_APP_WRITER_H
+
+/*
+** Required header files.
+*/
+#include "common_types.h"
+#include "cam_app_mission_cfg.h"
+
+#include <sys/uio.h>
+
+#define CAM_APP_WRITER_MAX_PARTS 3 /**< \brief Most buffers gathered into one file */
+#define CAM_APP_WRITER_NAME_LEN  (CAM_APP_PHOTO_DIR_LEN + 72)
+
+typedef struct CAM_APP_WriteRequest CAM_APP_WriteRequest_t;
+
+/*
+** Called once per file when it has been written, or has failed
+*/
+typedef void (*CAM_APP_WriterDone_t)(CAM_APP_WriteRequest_t *Request);
+
+/*
+** One file to write; the name and buffers must stay put until it is done
+**
+** With Fd at -1 the file called Name is created or truncated.  Otherwise
+** the parts go into the open file Fd starting at Offset, and Name is only
+** used in reports.
+*/
+struct CAM_APP_WriteRequest
+{
+    const char  *Name;
+    int          Fd;
+    uint64       Offset;
+    struct iovec Parts[CAM_APP_WRITER_MAX_PARTS];
+    uint32       PartCount;
+    void        *Context;                           /**< \brief Left alone for the caller */
+    int32        Status;                            /**< \brief 0, or the errno the file failed with */
+    uint64       SubmitTimeNs;                      /**< \brief Set by the writer */
+    char         TempName[CAM_APP_WRITER_NAME_LEN]; /**< \brief Set by the writer */
+};
+
+int32       CAM_APP_WriterStart(CAM_APP_WriterDone_t Done, uint8 Durability, uint16 GroupFiles, uint32 GroupMs);
+void        CAM_APP_WriterStop(void);
+void        CAM_APP_WriterSubmit(CAM_APP_WriteRequest_t **Requests, uint32 Count);
+const char *CAM_APP_WriterBackendName(void);
+const char *CAM_APP_WriterDurabilityName(uint8 Durability);
+void        CAM_APP_WriterStats(uint32 *Depth, uint32 *PeakDepth, uint32 *LatencyAvgUs, uint32 *LatencyMaxUs,
+                                uint32 *Errors, uint32 *WrittenKb);
+void        CAM_APP_WriterSyncStats(uint32 *FileAvgUs, uint32 *FileMaxUs, uint32 *GroupAvgUs, uint32 *GroupMaxUs,
+                                    uint32 *GroupFiles);
+void        CAM_APP_WriterResetStats(void);
+
+#endif /* CAM_APP_WRITER_H */
@@ -3,90 +3,253 @@
 This is common_function file for Encrypt
 */
 
-#define BLOCK_SIZE 16
 #include <common_fnc.h>
 #include <security.h>
 
-// 이미지 데이터를 읽는 함수
-void read_image_data(byte** data, size_t* size, const char* filename)
+#include "cam_app_hex.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// write_file_parts 한 번에 넘길 수 있는 조각 수
+#define WRITE_FILE_MAX_PARTS 8
+
+// 파일의 offset부터 length 바이트를 매핑하는 함수 (length가 0이면 파일 끝까지)
+// 쓰기 시 복사 매핑이라 복호화나 hex 변환을 버퍼 복사 없이 그 자리에서 할 수 있음
+bool map_file_range(mapped_file_t* file, const char* filename, off_t offset, size_t length)
 {
-    FILE* file = fopen(filename, "rb");
-    if (file == NULL)
+    struct stat st;
+    void* addr = MAP_FAILED;
+    size_t lead = (size_t)(offset % sysconf(_SC_PAGESIZE));
+
+    file->data = NULL;
+    file->size = 0;
+    file->map_size = 0;
+    file->map_offset = 0;
+
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0)
     {
-        perror("Failed to open image file");
-        return;
+        printf("Failed to open file: %s\n", filename);
+        return false;
     }
 
-    fseek(file, 0, SEEK_END);
-    *size = ftell(file);
-    fseek(file, 0, SEEK_SET);
+    // 빈 범위나 파일 끝을 넘는 범위는 매핑할 수 없으므로 실패로 처리
+    if (fstat(fd, &st) == 0 && offset < st.st_size)
+    {
+        if (length == 0)
+        {
+            length = (size_t)(st.st_size - offset);
+        }
+        if ((off_t)length <= st.st_size - offset)
+        {
+            addr = mmap(NULL, lead + length, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, offset - (off_t)lead);
+        }
+    }
+    close(fd);
 
-    *data = (byte*)malloc(*size);
-    if (*data == NULL)
+    if (addr == MAP_FAILED)
     {
-        perror("Failed to allocate memory");
-        fclose(file);
-        return;
+        printf("Failed to map file: %s\n", filename);
+        return false;
     }
 
-    fread(*data, 1, *size, file);
-    fclose(file);
+    madvise(addr, lead + length, MADV_SEQUENTIAL);
+
+    file->data = (byte*)addr + lead;
+    file->size = length;
+    file->map_size = lead + length;
+    file->map_offset = lead;
+    return true;
 }
 
-void write_image_data(const byte* data, size_t size, const char* filename)
+// 파일 전체를 한 번에 매핑해 순차 읽기로 미리 읽어 오게 하는 함수
+bool map_file(mapped_file_t* file, const char* filename)
 {
-    FILE* file = fopen(filename, "wb");
-    if (file == NULL)
+    return map_file_range(file, filename, 0, 0);
+}
+
+void unmap_file(mapped_file_t* file)
+{
+    if (file->data != NULL)
     {
-        perror("Failed to open file for writing");
-        return;
+        munmap(file->data - file->map_offset, file->map_size);
     }
+    file->data = NULL;
+    file->size = 0;
+    file->map_size = 0;
+    file->map_offset = 0;
+}
 
-    fwrite(data, 1, size, file);
-    fclose(file);
+// 여러 조각을 열려 있는 파일의 offset부터 pwritev로 쓰는 함수
+// 짧게 쓰이면 남은 부분부터 이어서 씀
+bool write_parts_at(int fd, const struct iovec* parts, int count, off_t offset)
+{
+    struct iovec iov[WRITE_FILE_MAX_PARTS];
+    struct iovec* next = iov;
+    size_t left = 0;
+    ssize_t written;
+    int i;
+
+    if (count < 1 || count > WRITE_FILE_MAX_PARTS)
+    {
+        errno = EINVAL;
+        return false;
+    }
+
+    for (i = 0; i < count; i++)
+    {
+        iov[i] = parts[i];
+        left += parts[i].iov_len;
+    }
+
+    while (left > 0)
+    {
+        written = pwritev(fd, next, count, offset);
+        if (written < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (written <= 0)
+        {
+            if (written == 0)
+            {
+                errno = EIO;
+            }
+            return false;
+        }
+
+        offset += written;
+        left -= (size_t)written;
+
+        // 다 쓴 조각은 건너뛰고 일부만 쓴 조각은 남은 부분부터
+        while (count > 0 && (size_t)written >= next->iov_len)
+        {
+            written -= (ssize_t)next->iov_len;
+            next++;
+            count--;
+        }
+        if (count > 0)
+        {
+            next->iov_base = (byte*)next->iov_base + written;
+            next->iov_len -= (size_t)written;
+        }
+    }
+
+    return true;
 }
 
-void pad_data(byte** data, size_t* size)
+// 여러 조각(헤더, 본문 등)을 pwritev로 한 파일에 저장하는 함수
+// 전체 길이를 미리 할당해 두고 쓰며, sync가 참이면 닫기 전에 데이터를 저장 장치까지 내려 보냄
+bool write_file_parts(const struct iovec* parts, int count, const char* filename, bool sync)
 {
-    size_t pad_size = BLOCK_SIZE - (*size % BLOCK_SIZE);
-    *data = (byte*)realloc(*data, *size + pad_size);
-    if (*data == NULL)
+    size_t total = 0;
+    bool ok;
+    int i;
+
+    if (count < 1 || count > WRITE_FILE_MAX_PARTS)
     {
-        perror("Failed to reallocate memory");
-        return;
+        return false;
     }
-    memset(*data + *size, pad_size, pad_size);
-    *size += pad_size;
+
+    for (i = 0; i < count; i++)
+    {
+        total += parts[i].iov_len;
+    }
+
+    int fd = open(filename, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0)
+    {
+        printf("Failed to open file for writing: %s\n", filename);
+        return false;
+    }
+
+    // 공간 부족은 쓰기 전에 알 수 있음, 미리 할당을 지원하지 않는 파일 시스템이면 그냥 진행
+    if (total > 0 && posix_fallocate(fd, 0, (off_t)total) == ENOSPC)
+    {
+        printf("No space for file: %s\n", filename);
+        close(fd);
+        unlink(filename);
+        errno = ENOSPC;
+        return false;
+    }
+
+    ok = write_parts_at(fd, parts, count, 0) && (!sync || fdatasync(fd) == 0);
+
+    if (close(fd) != 0 || !ok)
+    {
+        printf("Failed to write file: %s\n", filename);
+        return false;
+    }
+    return true;
 }
 
-void unpad_data(byte** data, size_t* size)
+// 이미지 데이터를 한 번에 저장하는 함수
+bool write_image_data(const byte* data, size_t size, const char* filename)
 {
-    size_t pad_size = (*data)[*size - 1];
-    *size -= pad_size;
-    *data = (byte*)realloc(*data, *size);
+    struct iovec part = { (void*)data, size };
+
+    return write_file_parts(&part, 1, filename, false);
 }
 
-void read_encrypted_data(byte** data, size_t* size, const char* filename)
+// 암호화된 파일(헤더 + 암호문)을 매핑해 그대로 넘기는 함수
+bool read_encrypted_data(mapped_file_t* file, const char* filename)
 {
-    FILE* file = fopen(filename, "rb");
-    if (file == NULL) 
+    return map_file(file, filename);
+}
+
+// 헤더와 암호문을 따로 둔 채 pwritev 한 번으로 저장
+bool write_encrypted_data(const byte* header, size_t header_size, const byte* data, size_t size, const char* filename)
+{
+    struct iovec parts[2] = { { (void*)header, header_size }, { (void*)data, size } };
+
+    return write_file_parts(parts, 2, filename, false);
+}
+
+// 16진수 문자열로 저장된 암호화 파일을 매핑해 그 자리에서 바이너리로 변환
+bool read_encrypted_hex(mapped_file_t* file, const char* filename)
+{
+    if (!map_file(file, filename))
     {
-        printf("Failed to open file: %s\n", filename);
-        return;
+        return false;
     }
 
-    fseek(file, 0, SEEK_END);
-    *size = ftell(file) / 2; // 16진수 문자열을 바이너리로 변환할 것이므로 크기를 반으로 줄임
-    fseek(file, 0, SEEK_SET);
+    if (!CAM_APP_HexDecode((const char*)file->data, file->size, file->data))
+    {
+        printf("Invalid hex data in file: %s\n", filename);
+        unmap_file(file);
+        return false;
+    }
+    file->size /= 2;
+    return true;
+}
 
-    *data = (byte*)malloc(*size);
-    char buffer[3] = {0};
-    for (size_t i = 0; i < *size; i++)
+// 헤더와 암호문을 이어서 호출한 쪽 버퍼(2 * (header_size + size) 바이트)에 16진수 문자열로 바꾸고 길이를 반환
+size_t encode_encrypted_hex(const byte* header, size_t header_size, const byte* data, size_t size, char* text)
+{
+    CAM_APP_HexEncode(header, header_size, text);
+    CAM_APP_HexEncode(data, size, text + 2 * header_size);
+
+    return 2 * (header_size + size);
+}
+
+// 헤더와 암호문을 16진수 문자열로 바꿔 pwritev 한 번으로 저장
+bool write_encrypted_hex(const byte* header, size_t header_size, const byte* data, size_t size, const char* filename)
+{
+    char* text = (char*)malloc(2 * (header_size + size));
+    if (text == NULL)
     {
-        fread(buffer, 1, 2, file);
-        (*data)[i] = (byte)strtol(buffer, NULL, 16);
+        printf("Failed to allocate memory for: %s\n", filename);
+        return false;
     }
-    fclose(file);
+
+    struct iovec part = { text, encode_encrypted_hex(header, header_size, data, size, text) };
+    bool ok = write_file_parts(&part, 1, filename, false);
+    free(text);
+    return ok;
 }
 
 /*
@@ -14,17 +14,40 @@ typedef unsigned char byte;
 #include <stdio.h>
 #include <string.h>
 #include <stdlib.h>
+#include <sys/uio.h>
 #include <security.h>
 
-bool read_image_data(byte** data, size_t* size, const char* filename);
+// 읽기 전용 파일을 쓰기 시 복사(copy-on-write)로 매핑한 것
+// data는 그 자리에서 복호화/변환해도 디스크의 파일은 바뀌지 않음
+typedef struct
+{
+    byte*  data;     // 매핑 시작 주소
+    size_t size;       // 유효한 바이트 수 (hex 변환 후 줄어듦)
+    size_t map_size;   // 매핑 길이
+    size_t map_offset; // 매핑 시작에서 data까지 (페이지 정렬 때문에 생기는 앞부분)
+} mapped_file_t;
 
-void read_encrypted_data(byte** data, size_t* size, const char* filename);
+bool map_file(mapped_file_t* file, const char* filename);
 
-void write_image_data(const byte* data, size_t size, const char* filename);
+bool map_file_range(mapped_file_t* file, const char* filename, off_t offset, size_t length);
 
-void pad_data(byte** data, size_t* size);
+void unmap_file(mapped_file_t* file);
 
-void unpad_data(byte** data, size_t* size);
+bool write_parts_at(int fd, const struct iovec* parts, int count, off_t offset);
+
+bool write_file_parts(const struct iovec* parts, int count, const char* filename, bool sync);
+
+bool read_encrypted_data(mapped_file_t* file, const char* filename);
+
+bool write_encrypted_data(const byte* header, size_t header_size, const byte* data, size_t size, const char* filename);
+
+bool read_encrypted_hex(mapped_file_t* file, const char* filename);
+
+size_t encode_encrypted_hex(const byte* header, size_t header_size, const byte* data, size_t size, char* text);
+
+bool write_encrypted_hex(const byte* header, size_t header_size, const byte* data, size_t size, const char* filename);
+
+bool write_image_data(const byte* data, size_t size, const char* filename);
 
 //void read_hex_data(byte** data, size_t* size, const char* filename);
 
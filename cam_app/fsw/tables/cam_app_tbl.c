@@ -18,18 +18,67 @@
 
 #include "cfe_tbl_filedef.h" /* Required to obtain the CFE_TBL_FILEDEF macro definition */
 #include "cam_app_tbl.h"
+#include "cam_app_msgdefs.h"
 
 /*
-** The following is an example of the declaration statement that defines the desired
-** contents of the table image.
+** Capture profiles.  The first one matches the app's original behaviour:
+** small JPEGs every ten seconds, encrypted only after CAM_APP_SECURITY_START_CC,
+** with every encrypted file read back and checked.  The fast profile checks
+** one file in fifty so verification stays in the background.
 */
-CAM_APP_ExampleTable_t ExampleTable = {1, 2};
+CAM_APP_CaptureTable_t CaptureTable = {
+    .ActiveProfile = 0,
+    .PhotoDir      = "/home/cansat/Photo",
+    .Profiles      = {{.Name           = "default",
+                  .Width          = 320,
+                  .Height         = 240,
+                  .FrameRate      = 5,
+                  .WarmupMs       = 1000,
+                  .PeriodMs       = 10000,
+                  .Format         = CAM_APP_CAPTURE_FORMAT_MJPEG,
+                  .Quality        = 85,
+                  .StorageMode    = CAM_APP_STORAGE_MODE_FILE,
+                  .Stages         = 0,
+                  .VerifyInterval = 1},
+                 {.Name           = "hires",
+                  .Width          = 1640,
+                  .Height         = 1232,
+                  .FrameRate      = 2,
+                  .WarmupMs       = 1000,
+                  .PeriodMs       = 10000,
+                  .Format         = CAM_APP_CAPTURE_FORMAT_MJPEG,
+                  .Quality        = 90,
+                  .StorageMode    = CAM_APP_STORAGE_MODE_MEMORY,
+                  .Stages         = CAM_APP_CAPTURE_STAGE_ENCRYPT,
+                  .VerifyInterval = 0},
+                 {.Name           = "fast",
+                  .Width          = 640,
+                  .Height         = 480,
+                  .FrameRate      = 30,
+                  .WarmupMs       = 200,
+                  .PeriodMs       = 100,
+                  .Format         = CAM_APP_CAPTURE_FORMAT_MJPEG,
+                  .Quality        = 75,
+                  .StorageMode    = CAM_APP_STORAGE_MODE_MEMORY,
+                  .Stages         = CAM_APP_CAPTURE_STAGE_ENCRYPT,
+                  .VerifyInterval = 50},
+                 {.Name           = "raw",
+                  .Width          = 320,
+                  .Height         = 240,
+                  .FrameRate      = 5,
+                  .WarmupMs       = 0,
+                  .PeriodMs       = 1000,
+                  .Format         = CAM_APP_CAPTURE_FORMAT_YUYV,
+                  .Quality        = 100,
+                  .StorageMode    = CAM_APP_STORAGE_MODE_FILE,
+                  .Stages         = CAM_APP_CAPTURE_STAGE_ENCRYPT,
+                  .VerifyInterval = 1}}};
 
 /*
 ** The macro below identifies:
 **    1) the data structure type to use as the table image format
-**    2) the name of the table to be placed into the cFE Example Table File Header
+**    2) the name of the table to be placed into the cFE Table File Header
 **    3) a brief description of the contents of the file image
 **    4) the desired name of the table image binary file that is cFE compatible
 */
-CFE_TBL_FILEDEF(ExampleTable, CAM_APP.ExampleTable, Table Utility Test Table, cam_app_tbl.tbl)
+CFE_TBL_FILEDEF(CaptureTable, CAM_APP.CaptureTable, Capture profiles, cam_app_tbl.tbl)
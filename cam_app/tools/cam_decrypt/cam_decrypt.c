@@ -0,0 +1,584 @@
+/************************************************************************
+ * NASA Docket No. GSC-18,719-1, and identified as “core Flight System: Bootes”
+ *
+ * Copyright (c) 2020 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License. You may obtain
+ * a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ************************************************************************/
+
+/**
+ * \file
+ *   Ground tool that decrypts Cam App encrypted photos in bulk.
+ *
+ *   Usage: cam_decrypt [-j threads] (-k keyfile | -K key) -o outdir input...
+ *
+ *   Each input is a file or a directory whose *.enc files are all
+ *   decrypted.  Every file is mapped rather than read, and files are
+ *   decrypted in parallel, one per worker thread, each written out with
+ *   as few large writes as the kernel allows.  Three formats are
+ *   recognised from the file contents:
+ *
+ *     container      the binary file format in cam_app_container.h; the
+ *                    MAC is checked before anything is written
+ *     hex container  the same container written as hex text
+ *     legacy hex     hex text of Security_lib encrypt_data output from
+ *                    before the container format; there is nothing to
+ *                    check it against
+ *
+ *   The key is either 32 raw bytes read from a file or given on the
+ *   command line as 32 characters, as sent in CAM_APP_SECURITY_KEY_CC, or
+ *   as 64 hex digits.  decrypted_photo_<time>.jpeg is written to outdir
+ *   for every encrypted_photo_<time>.enc.
+ */
+
+/*
+** Include Files:
+*/
+#include "cam_app_aes.h"
+#include "cam_app_container.h"
+#include "cam_app_crypto.h"
+#include "cam_app_hex.h"
+
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#define CAM_DECRYPT_MAX_THREADS 64
+
+#define CAM_DECRYPT_ENC_SUFFIX    ".enc"
+#define CAM_DECRYPT_IN_PREFIX     "encrypted_"
+#define CAM_DECRYPT_OUT_PREFIX    "decrypted_"
+#define CAM_DECRYPT_OUT_SUFFIX    ".jpeg"
+#define CAM_DECRYPT_CONTAINER_TAG "CAMF"
+
+typedef struct
+{
+    char                **Files;
+    size_t                FileCount;
+    size_t                FileCapacity;
+    const char           *OutDir;
+    CAM_APP_CryptoKey_t  *Key;
+    CAM_APP_AesSchedule_t Legacy; /* Same key, for files from before the container format */
+
+    atomic_size_t NextFile;
+    atomic_size_t Decrypted;
+    atomic_size_t Failed;
+    atomic_ullong BytesIn;
+    atomic_ullong BytesOut;
+} CAM_DECRYPT_Batch_t;
+
+static CAM_DECRYPT_Batch_t CAM_DECRYPT_Batch;
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Print usage and exit                                            */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+static void CAM_DECRYPT_Usage(const char *Program)
+{
+    fprintf(stderr,
+            "usage: %s [-j threads] (-k keyfile | -K key) -o outdir input...\n"
+            "  input    encrypted file, or directory of *.enc files\n"
+            "  -j       worker threads (default: online CPUs)\n"
+            "  -k       file holding the 32 byte key\n"
+            "  -K       key as 32 characters or 64 hex digits\n"
+            "  -o       directory for the decrypted files\n",
+            Program);
+    exit(2);
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Add one file to the batch                                       */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+static void CAM_DECRYPT_AddFile(const char *Dir, const char *Name)
+{
+    CAM_DECRYPT_Batch_t *Batch = &CAM_DECRYPT_Batch;
+    char               **Grown;
+    char                *Path;
+
+    if (Batch->FileCount == Batch->FileCapacity)
+    {
+        Batch->FileCapacity = Batch->FileCapacity ? 2 * Batch->FileCapacity : 256;
+        Grown               = realloc(Batch->Files, Batch->FileCapacity * sizeof(*Batch->Files));
+        if (Grown == NULL)
+        {
+            fprintf(stderr, "cam_decrypt: out of memory\n");
+            exit(1);
+        }
+        Batch->Files = Grown;
+    }
+
+    if (Dir != NULL)
+    {
+        Path = malloc(strlen(Dir) + strlen(Name) + 2);
+        if (Path != NULL)
+        {
+            sprintf(Path, "%s/%s", Dir, Name);
+        }
+    }
+    else
+    {
+        Path = strdup(Name);
+    }
+
+    if (Path == NULL)
+    {
+        fprintf(stderr, "cam_decrypt: out of memory\n");
+        exit(1);
+    }
+
+    Batch->Files[Batch->FileCount++] = Path;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Add a file, or every *.enc file in a directory                  */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+static bool CAM_DECRYPT_AddInput(const char *Input)
+{
+    struct stat    Info;
+    DIR           *Dir;
+    struct dirent *Entry;
+    size_t         Len;
+
+    if (stat(Input, &Info) != 0)
+    {
+        fprintf(stderr, "cam_decrypt: %s: %s\n", Input, strerror(errno));
+        return false;
+    }
+
+    if (!S_ISDIR(Info.st_mode))
+    {
+        CAM_DECRYPT_AddFile(NULL, Input);
+        return true;
+    }
+
+    Dir = opendir(Input);
+    if (Dir == NULL)
+    {
+        fprintf(stderr, "cam_decrypt: %s: %s\n", Input, strerror(errno));
+        return false;
+    }
+
+    while ((Entry = readdir(Dir)) != NULL)
+    {
+        Len = strlen(Entry->d_name);
+        if (Len > strlen(CAM_DECRYPT_ENC_SUFFIX) &&
+            strcmp(Entry->d_name + Len - strlen(CAM_DECRYPT_ENC_SUFFIX), CAM_DECRYPT_ENC_SUFFIX) == 0)
+        {
+            CAM_DECRYPT_AddFile(Input, Entry->d_name);
+        }
+    }
+
+    closedir(Dir);
+
+    return true;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Parse a key given as 32 characters or 64 hex digits, or read    */
+/* one from a file                                                 */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+static bool CAM_DECRYPT_ParseKey(const char *Text, uint8_t *Key)
+{
+    size_t Len = strlen(Text);
+
+    if (Len == 2 * CAM_APP_CRYPTO_KEY_SIZE)
+    {
+        return CAM_APP_HexDecode(Text, Len, Key);
+    }
+
+    if (Len == CAM_APP_CRYPTO_KEY_SIZE)
+    {
+        memcpy(Key, Text, CAM_APP_CRYPTO_KEY_SIZE);
+        return true;
+    }
+
+    return false;
+}
+
+static bool CAM_DECRYPT_ReadKey(const char *Path, uint8_t *Key)
+{
+    FILE  *File = fopen(Path, "rb");
+    size_t Got  = 0;
+
+    if (File != NULL)
+    {
+        Got = fread(Key, 1, CAM_APP_CRYPTO_KEY_SIZE, File);
+        fclose(File);
+    }
+
+    return Got == CAM_APP_CRYPTO_KEY_SIZE;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Name the output after the input, with the photo prefix and      */
+/* suffix swapped                                                  */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+static void CAM_DECRYPT_OutputName(const char *Input, char *Output, size_t Size)
+{
+    const char *Base = strrchr(Input, '/');
+    size_t      Len;
+
+    Base = (Base != NULL) ? Base + 1 : Input;
+    if (strncmp(Base, CAM_DECRYPT_IN_PREFIX, strlen(CAM_DECRYPT_IN_PREFIX)) == 0)
+    {
+        Base += strlen(CAM_DECRYPT_IN_PREFIX);
+    }
+
+    Len = strlen(Base);
+    if (Len > strlen(CAM_DECRYPT_ENC_SUFFIX) &&
+        strcmp(Base + Len - strlen(CAM_DECRYPT_ENC_SUFFIX), CAM_DECRYPT_ENC_SUFFIX) == 0)
+    {
+        Len -= strlen(CAM_DECRYPT_ENC_SUFFIX);
+    }
+
+    snprintf(Output, Size, "%s/%s%.*s%s", CAM_DECRYPT_Batch.OutDir, CAM_DECRYPT_OUT_PREFIX, (int)Len, Base,
+             CAM_DECRYPT_OUT_SUFFIX);
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Write Len bytes, carrying on after short writes                 */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+static bool CAM_DECRYPT_Write(const char *Path, const uint8_t *Data, size_t Len)
+{
+    ssize_t Written;
+    int     Fd;
+    bool    Ok = true;
+
+    Fd = open(Path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (Fd < 0)
+    {
+        return false;
+    }
+
+    while (Ok && Len > 0)
+    {
+        Written = write(Fd, Data, Len);
+        if (Written < 0 && errno == EINTR)
+        {
+            continue;
+        }
+
+        Ok = Written > 0;
+        if (Ok)
+        {
+            Data += Written;
+            Len -= (size_t)Written;
+        }
+    }
+
+    return close(Fd) == 0 && Ok;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Decrypt a pre-container file in place                           */
+/*                                                                 */
+/* These were encrypted block by block with Security_lib after     */
+/* padding to a whole number of blocks.  The padding is stripped   */
+/* when it is valid PKCS#7; otherwise every block is kept.         */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+static bool CAM_DECRYPT_Legacy(uint8_t *Data, size_t *Len)
+{
+    size_t  Pad;
+    size_t  i;
+    uint8_t Bad = 0;
+
+    if (*Len == 0 || *Len % CAM_APP_AES_BLOCK_SIZE != 0)
+    {
+        return false;
+    }
+
+    CAM_APP_AesDecryptBlocks(&CAM_DECRYPT_Batch.Legacy, Data, Data, *Len / CAM_APP_AES_BLOCK_SIZE);
+
+    Pad = Data[*Len - 1];
+    if (Pad >= 1 && Pad <= CAM_APP_AES_BLOCK_SIZE)
+    {
+        for (i = *Len - Pad; i < *Len; i++)
+        {
+            Bad |= Data[i] ^ (uint8_t)Pad;
+        }
+
+        if (Bad == 0)
+        {
+            *Len -= Pad;
+        }
+    }
+
+    return true;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Decrypt one file                                                */
+/*                                                                 */
+/* The file is mapped copy-on-write so hex decoding and decryption */
+/* can both run in place without touching the input on disk.       */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+static bool CAM_DECRYPT_File(const char *Path)
+{
+    CAM_APP_ContainerHeader_t Header;
+    CAM_APP_ContainerStatus_t Status;
+    struct stat               Info;
+    char                      Output[PATH_MAX];
+    const char               *Error = NULL;
+    const uint8_t            *Plain = NULL;
+    uint8_t                  *Map;
+    size_t                    Size;
+    size_t                    PlainSize = 0;
+    int                       Fd;
+
+    Fd = open(Path, O_RDONLY);
+    if (Fd < 0)
+    {
+        fprintf(stderr, "cam_decrypt: %s: %s\n", Path, strerror(errno));
+        return false;
+    }
+
+    Map = MAP_FAILED;
+    if (fstat(Fd, &Info) == 0 && Info.st_size > 0)
+    {
+        Map = mmap(NULL, (size_t)Info.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, Fd, 0);
+    }
+    close(Fd);
+
+    if (Map == MAP_FAILED)
+    {
+        fprintf(stderr, "cam_decrypt: %s: unreadable or empty\n", Path);
+        return false;
+    }
+
+    Size = (size_t)Info.st_size;
+    madvise(Map, Size, MADV_SEQUENTIAL);
+
+    atomic_fetch_add(&CAM_DECRYPT_Batch.BytesIn, Size);
+
+    /* Anything not starting with the binary container tag must be hex text */
+    if (Size < 4 || memcmp(Map, CAM_DECRYPT_CONTAINER_TAG, 4) != 0)
+    {
+        while (Size > 0 && (Map[Size - 1] == '\n' || Map[Size - 1] == '\r'))
+        {
+            Size--;
+        }
+
+        if (Size % 2 != 0 || !CAM_APP_HexDecode((const char *)Map, Size, Map))
+        {
+            Error = "neither a container nor hex text";
+        }
+        Size /= 2;
+    }
+
+    if (Error == NULL && Size >= 4 && memcmp(Map, CAM_DECRYPT_CONTAINER_TAG, 4) == 0)
+    {
+        Status = CAM_APP_ContainerOpen(CAM_DECRYPT_Batch.Key, &Header, Map, Size);
+        if (Status == CAM_APP_CONTAINER_OK)
+        {
+            Plain     = Map + CAM_APP_CONTAINER_HEADER_SIZE;
+            PlainSize = (size_t)Header.PlainSize;
+        }
+        else
+        {
+            Error = CAM_APP_ContainerStatusText(Status);
+        }
+    }
+    else if (Error == NULL)
+    {
+        PlainSize = Size;
+        if (CAM_DECRYPT_Legacy(Map, &PlainSize))
+        {
+            Plain = Map;
+        }
+        else
+        {
+            Error = "legacy file is not a whole number of blocks";
+        }
+    }
+
+    if (Error == NULL)
+    {
+        CAM_DECRYPT_OutputName(Path, Output, sizeof(Output));
+        if (!CAM_DECRYPT_Write(Output, Plain, PlainSize))
+        {
+            Path  = Output;
+            Error = "write failed";
+        }
+    }
+
+    munmap(Map, (size_t)Info.st_size);
+
+    if (Error != NULL)
+    {
+        fprintf(stderr, "cam_decrypt: %s: %s\n", Path, Error);
+        return false;
+    }
+
+    atomic_fetch_add(&CAM_DECRYPT_Batch.BytesOut, PlainSize);
+
+    return true;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Worker thread: take files from the batch until none are left    */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+static void *CAM_DECRYPT_Worker(void *Arg)
+{
+    CAM_DECRYPT_Batch_t *Batch = &CAM_DECRYPT_Batch;
+    size_t               i;
+
+    while ((i = atomic_fetch_add(&Batch->NextFile, 1)) < Batch->FileCount)
+    {
+        if (CAM_DECRYPT_File(Batch->Files[i]))
+        {
+            atomic_fetch_add(&Batch->Decrypted, 1);
+        }
+        else
+        {
+            atomic_fetch_add(&Batch->Failed, 1);
+        }
+    }
+
+    return NULL;
+}
+
+int main(int argc, char *argv[])
+{
+    CAM_DECRYPT_Batch_t *Batch = &CAM_DECRYPT_Batch;
+    pthread_t            Threads[CAM_DECRYPT_MAX_THREADS];
+    uint8_t              Key[CAM_APP_CRYPTO_KEY_SIZE];
+    bool                 HaveKey  = false;
+    bool                 InputsOk = true;
+    long                 Count    = sysconf(_SC_NPROCESSORS_ONLN);
+    unsigned int         Started;
+    struct timespec      Start;
+    struct timespec      End;
+    double               Seconds;
+    int                  Opt;
+    int                  i;
+
+    while ((Opt = getopt(argc, argv, "j:k:K:o:")) != -1)
+    {
+        switch (Opt)
+        {
+            case 'j':
+                Count = strtol(optarg, NULL, 10);
+                break;
+            case 'k':
+                HaveKey = CAM_DECRYPT_ReadKey(optarg, Key);
+                break;
+            case 'K':
+                HaveKey = CAM_DECRYPT_ParseKey(optarg, Key);
+                break;
+            case 'o':
+                Batch->OutDir = optarg;
+                break;
+            default:
+                CAM_DECRYPT_Usage(argv[0]);
+        }
+    }
+
+    if (!HaveKey || Batch->OutDir == NULL || optind == argc)
+    {
+        CAM_DECRYPT_Usage(argv[0]);
+    }
+
+    /* A missing input is reported and fails the run, but the others are still decrypted */
+    for (i = optind; i < argc; i++)
+    {
+        if (!CAM_DECRYPT_AddInput(argv[i]))
+        {
+            InputsOk = false;
+        }
+    }
+
+    if (Count < 1)
+    {
+        Count = 1;
+    }
+    if (Count > CAM_DECRYPT_MAX_THREADS)
+    {
+        Count = CAM_DECRYPT_MAX_THREADS;
+    }
+    if ((size_t)Count > Batch->FileCount && Batch->FileCount > 0)
+    {
+        Count = (long)Batch->FileCount;
+    }
+
+    Batch->Key = CAM_APP_CryptoKeyCreate(Key);
+    CAM_APP_AesExpandKey(&Batch->Legacy, Key);
+    memset(Key, 0, sizeof(Key));
+    if (Batch->Key == NULL)
+    {
+        fprintf(stderr, "cam_decrypt: out of memory\n");
+        return 1;
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &Start);
+
+    for (Started = 0; Started < (unsigned int)Count; Started++)
+    {
+        if (pthread_create(&Threads[Started], NULL, CAM_DECRYPT_Worker, NULL) != 0)
+        {
+            break;
+        }
+    }
+
+    /* With no thread to run them the files are decrypted here */
+    if (Started == 0)
+    {
+        CAM_DECRYPT_Worker(NULL);
+    }
+
+    while (Started > 0)
+    {
+        pthread_join(Threads[--Started], NULL);
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &End);
+    Seconds = (double)(End.tv_sec - Start.tv_sec) + (double)(End.tv_nsec - Start.tv_nsec) / 1e9;
+
+    printf("%zu decrypted, %zu failed, %.1f MB in, %.1f MB out in %.3f s, %.1f MB/s (%ld threads, %s AES, %s hex)\n",
+           atomic_load(&Batch->Decrypted), atomic_load(&Batch->Failed), atomic_load(&Batch->BytesIn) / 1e6,
+           atomic_load(&Batch->BytesOut) / 1e6, Seconds,
+           Seconds > 0 ? atomic_load(&Batch->BytesOut) / 1e6 / Seconds : 0.0, Count, CAM_APP_AesBackendName(),
+           CAM_APP_HexBackendName());
+
+    CAM_APP_CryptoKeyRelease(Batch->Key);
+    memset(&Batch->Legacy, 0, sizeof(Batch->Legacy));
+
+    return InputsOk && atomic_load(&Batch->Failed) == 0 ? 0 : 1;
+}
@@ -0,0 +1,222 @@
+/************************************************************************
+ * NASA Docket No. GSC-18,719-1, and identified as “core Flight System: Bootes”
+ *
+ * Copyright (c) 2020 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License. You may obtain
+ * a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ************************************************************************/
+
+/*
+** File: coveragetest_cam_app_aes.c
+**
+** Purpose:
+** Coverage Unit Test cases for the Cam App AES-256 block cipher
+**
+** Every backend the CPU can run is checked against the known-answer
+** vectors of FIPS-197 and SP 800-38A, one block at a time and in runs
+** long enough to fill the hardware backends' lanes.
+*/
+
+/*
+ * Includes
+ */
+
+#include "cam_app_coveragetest_common.h"
+#include "cam_app_aes.h"
+
+/*
+ * Backends that produce standard AES; Security_lib is left out as it is
+ * only selectable when forced and is not a reference implementation
+ */
+static const char *const CAM_APP_UT_AesBackends[] = {"aesni", "armv8-ce", "neon", "portable"};
+
+#define CAM_APP_UT_AES_BACKEND_COUNT (sizeof(CAM_APP_UT_AesBackends) / sizeof(CAM_APP_UT_AesBackends[0]))
+
+/*
+ * FIPS-197 appendix C.3, AES-256
+ */
+static const uint8_t CAM_APP_UT_Fips197Key[CAM_APP_AES_KEY_SIZE] = {
+    0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f,
+    0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x19, 0x1a, 0x1b, 0x1c, 0x1d, 0x1e, 0x1f};
+
+static const uint8_t CAM_APP_UT_Fips197Plain[CAM_APP_AES_BLOCK_SIZE] = {
+    0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77, 0x88, 0x99, 0xaa, 0xbb, 0xcc, 0xdd, 0xee, 0xff};
+
+static const uint8_t CAM_APP_UT_Fips197Cipher[CAM_APP_AES_BLOCK_SIZE] = {
+    0x8e, 0xa2, 0xb7, 0xca, 0x51, 0x67, 0x45, 0xbf, 0xea, 0xfc, 0x49, 0x90, 0x4b, 0x49, 0x60, 0x89};
+
+/*
+ * SP 800-38A F.1.5, ECB-AES256
+ */
+static const uint8_t CAM_APP_UT_EcbKey[CAM_APP_AES_KEY_SIZE] = {
+    0x60, 0x3d, 0xeb, 0x10, 0x15, 0xca, 0x71, 0xbe, 0x2b, 0x73, 0xae, 0xf0, 0x85, 0x7d, 0x77, 0x81,
+    0x1f, 0x35, 0x2c, 0x07, 0x3b, 0x61, 0x08, 0xd7, 0x2d, 0x98, 0x10, 0xa3, 0x09, 0x14, 0xdf, 0xf4};
+
+static const uint8_t CAM_APP_UT_EcbPlain[4 * CAM_APP_AES_BLOCK_SIZE] = {
+    0x6b, 0xc1, 0xbe, 0xe2, 0x2e, 0x40, 0x9f, 0x96, 0xe9, 0x3d, 0x7e, 0x11, 0x73, 0x93, 0x17, 0x2a,
+    0xae, 0x2d, 0x8a, 0x57, 0x1e, 0x03, 0xac, 0x9c, 0x9e, 0xb7, 0x6f, 0xac, 0x45, 0xaf, 0x8e, 0x51,
+    0x30, 0xc8, 0x1c, 0x46, 0xa3, 0x5c, 0xe4, 0x11, 0xe5, 0xfb, 0xc1, 0x19, 0x1a, 0x0a, 0x52, 0xef,
+    0xf6, 0x9f, 0x24, 0x45, 0xdf, 0x4f, 0x9b, 0x17, 0xad, 0x2b, 0x41, 0x7b, 0xe6, 0x6c, 0x37, 0x10};
+
+static const uint8_t CAM_APP_UT_EcbCipher[4 * CAM_APP_AES_BLOCK_SIZE] = {
+    0xf3, 0xee, 0xd1, 0xbd, 0xb5, 0xd2, 0xa0, 0x3c, 0x06, 0x4b, 0x5a, 0x7e, 0x3d, 0xb1, 0x81, 0xf8,
+    0x59, 0x1c, 0xcb, 0x10, 0xd4, 0x10, 0xed, 0x26, 0xdc, 0x5b, 0xa7, 0x4a, 0x31, 0x36, 0x28, 0x70,
+    0xb6, 0xed, 0x21, 0xb9, 0x9c, 0xa6, 0xf4, 0xf9, 0xf1, 0x53, 0xe7, 0xb1, 0xbe, 0xaf, 0xed, 0x1d,
+    0x23, 0x30, 0x4b, 0x7a, 0x39, 0xf9, 0xf3, 0xff, 0x06, 0x7d, 0x8d, 0x8f, 0x9e, 0x24, 0xec, 0xc7};
+
+/*
+ * Blocks in the long run, more than one pass of the hardware lanes plus
+ * a partial one
+ */
+#define CAM_APP_UT_AES_RUN_BLOCKS 11
+
+/*
+**********************************************************************************
+**          TEST CASE FUNCTIONS
+**********************************************************************************
+*/
+
+void Test_CAM_APP_AesSelectBackend(void)
+{
+    /*
+     * Test Case For:
+     * bool CAM_APP_AesSelectBackend(const char *Name)
+     * const char *CAM_APP_AesBackendName(void)
+     */
+    const char *Automatic;
+
+    /* The automatic choice is always one of the standard backends */
+    Automatic = CAM_APP_AesBackendName();
+    UtAssert_NOT_NULL(Automatic);
+    UtPrintf("Automatic AES backend: %s", Automatic);
+
+    /* Portable runs everywhere; an unknown name leaves the backend alone */
+    UtAssert_BOOL_TRUE(CAM_APP_AesSelectBackend("portable"));
+    UtAssert_StrCmp(CAM_APP_AesBackendName(), "portable", "Backend is portable");
+    UtAssert_BOOL_FALSE(CAM_APP_AesSelectBackend("rot13"));
+    UtAssert_StrCmp(CAM_APP_AesBackendName(), "portable", "Backend is still portable");
+
+    UtAssert_BOOL_TRUE(CAM_APP_AesSelectBackend(Automatic));
+}
+
+void Test_CAM_APP_AesFips197(void)
+{
+    /*
+     * Test Case For:
+     * void CAM_APP_AesExpandKey(CAM_APP_AesSchedule_t *Schedule, const uint8_t *Key)
+     * void CAM_APP_AesEncryptBlocks(const CAM_APP_AesSchedule_t *Schedule, const uint8_t *In, uint8_t *Out,
+     *                               size_t Blocks)
+     * void CAM_APP_AesDecryptBlocks(const CAM_APP_AesSchedule_t *Schedule, const uint8_t *In, uint8_t *Out,
+     *                               size_t Blocks)
+     */
+    CAM_APP_AesSchedule_t Schedule;
+    uint8_t               Block[CAM_APP_AES_BLOCK_SIZE];
+    size_t                i;
+
+    CAM_APP_AesExpandKey(&Schedule, CAM_APP_UT_Fips197Key);
+
+    for (i = 0; i < CAM_APP_UT_AES_BACKEND_COUNT; i++)
+    {
+        if (!CAM_APP_AesSelectBackend(CAM_APP_UT_AesBackends[i]))
+        {
+            UtAssert_MIR("AES backend %s not supported on this CPU", CAM_APP_UT_AesBackends[i]);
+            continue;
+        }
+
+        CAM_APP_AesEncryptBlocks(&Schedule, CAM_APP_UT_Fips197Plain, Block, 1);
+        UtAssert_MemCmp(Block, CAM_APP_UT_Fips197Cipher, sizeof(Block), "%s encrypts FIPS-197 C.3",
+                        CAM_APP_UT_AesBackends[i]);
+
+        CAM_APP_AesDecryptBlocks(&Schedule, CAM_APP_UT_Fips197Cipher, Block, 1);
+        UtAssert_MemCmp(Block, CAM_APP_UT_Fips197Plain, sizeof(Block), "%s decrypts FIPS-197 C.3",
+                        CAM_APP_UT_AesBackends[i]);
+    }
+}
+
+void Test_CAM_APP_AesEcbRun(void)
+{
+    /*
+     * Test Case For:
+     * void CAM_APP_AesEncryptBlocks(const CAM_APP_AesSchedule_t *Schedule, const uint8_t *In, uint8_t *Out,
+     *                               size_t Blocks)
+     * void CAM_APP_AesDecryptBlocks(const CAM_APP_AesSchedule_t *Schedule, const uint8_t *In, uint8_t *Out,
+     *                               size_t Blocks)
+     */
+    CAM_APP_AesSchedule_t Schedule;
+    uint8_t               Plain[CAM_APP_UT_AES_RUN_BLOCKS * CAM_APP_AES_BLOCK_SIZE];
+    uint8_t               Cipher[CAM_APP_UT_AES_RUN_BLOCKS * CAM_APP_AES_BLOCK_SIZE];
+    uint8_t               Buffer[CAM_APP_UT_AES_RUN_BLOCKS * CAM_APP_AES_BLOCK_SIZE];
+    size_t                i;
+    size_t                j;
+
+    CAM_APP_AesExpandKey(&Schedule, CAM_APP_UT_EcbKey);
+
+    /* The four SP 800-38A blocks repeated, so every lane and the tail see a known block */
+    for (j = 0; j < CAM_APP_UT_AES_RUN_BLOCKS; j++)
+    {
+        memcpy(Plain + j * CAM_APP_AES_BLOCK_SIZE, CAM_APP_UT_EcbPlain + (j % 4) * CAM_APP_AES_BLOCK_SIZE,
+               CAM_APP_AES_BLOCK_SIZE);
+        memcpy(Cipher + j * CAM_APP_AES_BLOCK_SIZE, CAM_APP_UT_EcbCipher + (j % 4) * CAM_APP_AES_BLOCK_SIZE,
+               CAM_APP_AES_BLOCK_SIZE);
+    }
+
+    for (i = 0; i < CAM_APP_UT_AES_BACKEND_COUNT; i++)
+    {
+        if (!CAM_APP_AesSelectBackend(CAM_APP_UT_AesBackends[i]))
+        {
+            UtAssert_MIR("AES backend %s not supported on this CPU", CAM_APP_UT_AesBackends[i]);
+            continue;
+        }
+
+        CAM_APP_AesEncryptBlocks(&Schedule, CAM_APP_UT_EcbPlain, Buffer, 4);
+        UtAssert_MemCmp(Buffer, CAM_APP_UT_EcbCipher, sizeof(CAM_APP_UT_EcbCipher), "%s encrypts SP 800-38A F.1.5",
+                        CAM_APP_UT_AesBackends[i]);
+
+        CAM_APP_AesDecryptBlocks(&Schedule, CAM_APP_UT_EcbCipher, Buffer, 4);
+        UtAssert_MemCmp(Buffer, CAM_APP_UT_EcbPlain, sizeof(CAM_APP_UT_EcbPlain), "%s decrypts SP 800-38A F.1.6",
+                        CAM_APP_UT_AesBackends[i]);
+
+        /* In place, over a run that does not divide into whole lane groups */
+        memcpy(Buffer, Plain, sizeof(Buffer));
+        CAM_APP_AesEncryptBlocks(&Schedule, Buffer, Buffer, CAM_APP_UT_AES_RUN_BLOCKS);
+        UtAssert_MemCmp(Buffer, Cipher, sizeof(Buffer), "%s encrypts %d blocks in place", CAM_APP_UT_AesBackends[i],
+                        CAM_APP_UT_AES_RUN_BLOCKS);
+
+        CAM_APP_AesDecryptBlocks(&Schedule, Buffer, Buffer, CAM_APP_UT_AES_RUN_BLOCKS);
+        UtAssert_MemCmp(Buffer, Plain, sizeof(Buffer), "%s decrypts %d blocks in place", CAM_APP_UT_AesBackends[i],
+                        CAM_APP_UT_AES_RUN_BLOCKS);
+    }
+}
+
+/*
+ * Setup function prior to every test
+ */
+void Cam_UT_Setup(void)
+{
+    UT_ResetState(0);
+}
+
+/*
+ * Teardown function after every test
+ */
+void Cam_UT_TearDown(void) {}
+
+/*
+ * Register the test cases to execute with the unit test tool
+ */
+void UtTest_Setup(void)
+{
+    ADD_TEST(CAM_APP_AesSelectBackend);
+    ADD_TEST(CAM_APP_AesFips197);
+    ADD_TEST(CAM_APP_AesEcbRun);
+}
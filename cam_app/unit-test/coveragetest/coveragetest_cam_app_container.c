@@ -0,0 +1,256 @@
+/************************************************************************
+ * NASA Docket No. GSC-18,719-1, and identified as “core Flight System: Bootes”
+ *
+ * Copyright (c) 2020 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License. You may obtain
+ * a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ************************************************************************/
+
+/*
+** File: coveragetest_cam_app_container.c
+**
+** Purpose:
+** Coverage Unit Test cases for the Cam App encrypted file container
+**
+** Frames are sealed on the crypto worker pool and opened again, and
+** every kind of damage to a file must be refused.
+*/
+
+/*
+ * Includes
+ */
+
+#include "cam_app_coveragetest_common.h"
+#include "cam_app_container.h"
+#include "cam_app_crypto_pool.h"
+
+/*
+ * A frame of several segments, the last one partial and ending part
+ * way through a block
+ */
+#define CAM_APP_UT_CONTAINER_SEGMENT_SIZE 256
+#define CAM_APP_UT_CONTAINER_PLAIN_SIZE   (5 * CAM_APP_UT_CONTAINER_SEGMENT_SIZE + 37)
+#define CAM_APP_UT_CONTAINER_FILE_SIZE    (CAM_APP_CONTAINER_HEADER_SIZE + CAM_APP_UT_CONTAINER_PLAIN_SIZE)
+#define CAM_APP_UT_CONTAINER_TAGS_SIZE \
+    CAM_APP_CONTAINER_TAGS_SIZE(CAM_APP_UT_CONTAINER_PLAIN_SIZE, CAM_APP_UT_CONTAINER_SEGMENT_SIZE)
+
+static uint8_t CAM_APP_UT_Plain[CAM_APP_UT_CONTAINER_PLAIN_SIZE];
+static uint8_t CAM_APP_UT_File[CAM_APP_UT_CONTAINER_FILE_SIZE];
+static uint8_t CAM_APP_UT_Tags[CAM_APP_UT_CONTAINER_TAGS_SIZE];
+
+static CAM_APP_CryptoKey_t *CAM_APP_UT_Key;
+
+/*
+ * Seal the test frame into CAM_APP_UT_File
+ */
+static CAM_APP_ContainerStatus_t CAM_APP_UT_Seal(CAM_APP_ContainerHeader_t *Header, uint32_t SegmentSize)
+{
+    memset(Header, 0, sizeof(*Header));
+    Header->SegmentSize   = SegmentSize;
+    Header->Sequence      = 42;
+    Header->PlainSize     = sizeof(CAM_APP_UT_Plain);
+    Header->CaptureTimeUs = 1700000000123456u;
+
+    return CAM_APP_ContainerSeal(CAM_APP_UT_Key, Header, CAM_APP_UT_Plain, CAM_APP_UT_File,
+                                 CAM_APP_UT_File + CAM_APP_CONTAINER_HEADER_SIZE, CAM_APP_UT_Tags,
+                                 sizeof(CAM_APP_UT_Tags));
+}
+
+/*
+ * Open a copy of CAM_APP_UT_File with byte Offset flipped, or as is for
+ * an Offset past the end
+ */
+static CAM_APP_ContainerStatus_t CAM_APP_UT_OpenFlipped(size_t Offset)
+{
+    static uint8_t            Copy[CAM_APP_UT_CONTAINER_FILE_SIZE];
+    CAM_APP_ContainerHeader_t Header;
+
+    memcpy(Copy, CAM_APP_UT_File, sizeof(Copy));
+    if (Offset < sizeof(Copy))
+    {
+        Copy[Offset] ^= 0x01;
+    }
+
+    return CAM_APP_ContainerOpen(CAM_APP_UT_Key, &Header, Copy, sizeof(Copy));
+}
+
+/*
+**********************************************************************************
+**          TEST CASE FUNCTIONS
+**********************************************************************************
+*/
+
+void Test_CAM_APP_ContainerRoundTrip(void)
+{
+    /*
+     * Test Case For:
+     * CAM_APP_ContainerStatus_t CAM_APP_ContainerSeal(const CAM_APP_CryptoKey_t *Key,
+     *                                                 CAM_APP_ContainerHeader_t *Header, const uint8_t *Plain,
+     *                                                 uint8_t *HeaderImage, uint8_t *Cipher, uint8_t *Tags,
+     *                                                 size_t TagsSize)
+     * CAM_APP_ContainerStatus_t CAM_APP_ContainerOpen(const CAM_APP_CryptoKey_t *Key,
+     *                                                 CAM_APP_ContainerHeader_t *Header, uint8_t *File, size_t Size)
+     */
+    CAM_APP_ContainerHeader_t Sealed;
+    CAM_APP_ContainerHeader_t Opened;
+    uint8_t                   Plain[CAM_APP_UT_CONTAINER_PLAIN_SIZE];
+
+    UtAssert_INT32_EQ(CAM_APP_UT_Seal(&Sealed, CAM_APP_UT_CONTAINER_SEGMENT_SIZE), CAM_APP_CONTAINER_OK);
+
+    /* The ciphertext is plain CTR under the IV written into the header */
+    CAM_APP_CryptoCtr(CAM_APP_UT_Key, Sealed.Iv, 0, CAM_APP_UT_File + CAM_APP_CONTAINER_HEADER_SIZE, Plain,
+                      sizeof(Plain));
+    UtAssert_MemCmp(Plain, CAM_APP_UT_Plain, sizeof(Plain), "Ciphertext is CTR under the header IV");
+
+    UtAssert_INT32_EQ(CAM_APP_ContainerOpen(CAM_APP_UT_Key, &Opened, CAM_APP_UT_File, sizeof(CAM_APP_UT_File)),
+                      CAM_APP_CONTAINER_OK);
+    UtAssert_MemCmp(CAM_APP_UT_File + CAM_APP_CONTAINER_HEADER_SIZE, CAM_APP_UT_Plain, sizeof(CAM_APP_UT_Plain),
+                    "Opened in place to the frame");
+    UtAssert_UINT32_EQ(Opened.SegmentSize, CAM_APP_UT_CONTAINER_SEGMENT_SIZE);
+    UtAssert_UINT32_EQ(Opened.Sequence, 42);
+    UtAssert_True(Opened.PlainSize == sizeof(CAM_APP_UT_Plain), "PlainSize read back");
+    UtAssert_True(Opened.CaptureTimeUs == Sealed.CaptureTimeUs, "CaptureTimeUs read back");
+    UtAssert_MemCmp(Opened.Iv, Sealed.Iv, sizeof(Opened.Iv), "IV read back");
+    UtAssert_MemCmp(Opened.Mac, Sealed.Mac, sizeof(Opened.Mac), "MAC read back");
+
+    /* A segment size that is not a whole number of blocks is rounded down, and 0 up to one block */
+    UtAssert_INT32_EQ(CAM_APP_UT_Seal(&Sealed, CAM_APP_UT_CONTAINER_SEGMENT_SIZE + 15), CAM_APP_CONTAINER_OK);
+    UtAssert_UINT32_EQ(Sealed.SegmentSize, CAM_APP_UT_CONTAINER_SEGMENT_SIZE);
+    UtAssert_INT32_EQ(CAM_APP_UT_OpenFlipped(sizeof(CAM_APP_UT_File)), CAM_APP_CONTAINER_OK);
+
+    UtAssert_INT32_EQ(CAM_APP_UT_Seal(&Sealed, 0), CAM_APP_CONTAINER_TOO_LARGE);
+    UtAssert_UINT32_EQ(Sealed.SegmentSize, CAM_APP_CRYPTO_BLOCK_SIZE);
+}
+
+void Test_CAM_APP_ContainerPool(void)
+{
+    /*
+     * Test Case For:
+     * CAM_APP_ContainerStatus_t CAM_APP_ContainerSeal(const CAM_APP_CryptoKey_t *Key,
+     *                                                 CAM_APP_ContainerHeader_t *Header, const uint8_t *Plain,
+     *                                                 uint8_t *HeaderImage, uint8_t *Cipher, uint8_t *Tags,
+     *                                                 size_t TagsSize)
+     */
+    CAM_APP_ContainerHeader_t Header;
+    int                       i;
+
+    /* Helpers seal segments out of order; the file must still open */
+    UtAssert_UINT32_EQ(CAM_APP_CryptoPoolStart(3), 3);
+
+    for (i = 0; i < 20; i++)
+    {
+        UtAssert_INT32_EQ(CAM_APP_UT_Seal(&Header, CAM_APP_UT_CONTAINER_SEGMENT_SIZE), CAM_APP_CONTAINER_OK);
+        UtAssert_INT32_EQ(CAM_APP_UT_OpenFlipped(sizeof(CAM_APP_UT_File)), CAM_APP_CONTAINER_OK);
+    }
+
+    CAM_APP_CryptoPoolStop();
+}
+
+void Test_CAM_APP_ContainerTamper(void)
+{
+    /*
+     * Test Case For:
+     * CAM_APP_ContainerStatus_t CAM_APP_ContainerOpen(const CAM_APP_CryptoKey_t *Key,
+     *                                                 CAM_APP_ContainerHeader_t *Header, uint8_t *File, size_t Size)
+     */
+    static const size_t       MacOffsets[] = {12, 15, 24, 31, 32, 47, 48, 63};
+    CAM_APP_ContainerHeader_t Header;
+    CAM_APP_CryptoKey_t      *OtherKey;
+    uint8_t                   OtherKeyBytes[CAM_APP_CRYPTO_KEY_SIZE];
+    size_t                    Offset;
+    size_t                    i;
+
+    UtAssert_INT32_EQ(CAM_APP_UT_Seal(&Header, CAM_APP_UT_CONTAINER_SEGMENT_SIZE), CAM_APP_CONTAINER_OK);
+
+    /* A flipped bit in the covered header fields, the MAC itself or any segment fails the MAC */
+    for (i = 0; i < sizeof(MacOffsets) / sizeof(MacOffsets[0]); i++)
+    {
+        UtAssert_INT32_EQ(CAM_APP_UT_OpenFlipped(MacOffsets[i]), CAM_APP_CONTAINER_BAD_MAC);
+    }
+    for (Offset = CAM_APP_CONTAINER_HEADER_SIZE; Offset < sizeof(CAM_APP_UT_File);
+         Offset += CAM_APP_UT_CONTAINER_SEGMENT_SIZE / 2)
+    {
+        UtAssert_INT32_EQ(CAM_APP_UT_OpenFlipped(Offset), CAM_APP_CONTAINER_BAD_MAC);
+    }
+    UtAssert_INT32_EQ(CAM_APP_UT_OpenFlipped(sizeof(CAM_APP_UT_File) - 1), CAM_APP_CONTAINER_BAD_MAC);
+
+    /* Layout damage is caught before the MAC */
+    UtAssert_INT32_EQ(CAM_APP_UT_OpenFlipped(0), CAM_APP_CONTAINER_BAD_HEADER);
+    UtAssert_INT32_EQ(CAM_APP_UT_OpenFlipped(4), CAM_APP_CONTAINER_BAD_HEADER);
+    UtAssert_INT32_EQ(CAM_APP_UT_OpenFlipped(5), CAM_APP_CONTAINER_BAD_HEADER);
+    UtAssert_INT32_EQ(CAM_APP_UT_OpenFlipped(7), CAM_APP_CONTAINER_BAD_HEADER);
+    UtAssert_INT32_EQ(CAM_APP_UT_OpenFlipped(11), CAM_APP_CONTAINER_BAD_HEADER);
+    UtAssert_INT32_EQ(CAM_APP_UT_OpenFlipped(23), CAM_APP_CONTAINER_BAD_SIZE);
+    UtAssert_INT32_EQ(CAM_APP_ContainerOpen(CAM_APP_UT_Key, &Header, CAM_APP_UT_File, sizeof(CAM_APP_UT_File) - 1),
+                      CAM_APP_CONTAINER_BAD_SIZE);
+    UtAssert_INT32_EQ(
+        CAM_APP_ContainerOpen(CAM_APP_UT_Key, &Header, CAM_APP_UT_File, CAM_APP_CONTAINER_HEADER_SIZE - 1),
+        CAM_APP_CONTAINER_BAD_HEADER);
+
+    /* Sealed under another key */
+    memset(OtherKeyBytes, 0xa5, sizeof(OtherKeyBytes));
+    OtherKey = CAM_APP_CryptoKeyCreate(OtherKeyBytes);
+    UtAssert_NOT_NULL(OtherKey);
+    UtAssert_INT32_EQ(CAM_APP_ContainerOpen(OtherKey, &Header, CAM_APP_UT_File, sizeof(CAM_APP_UT_File)),
+                      CAM_APP_CONTAINER_BAD_MAC);
+    CAM_APP_CryptoKeyRelease(OtherKey);
+}
+
+void Test_CAM_APP_ContainerStatusText(void)
+{
+    /*
+     * Test Case For:
+     * const char *CAM_APP_ContainerStatusText(CAM_APP_ContainerStatus_t Status)
+     */
+    UtAssert_StrCmp(CAM_APP_ContainerStatusText(CAM_APP_CONTAINER_OK), "ok", "OK text");
+    UtAssert_StrCmp(CAM_APP_ContainerStatusText(CAM_APP_CONTAINER_BAD_MAC), "MAC mismatch", "BAD_MAC text");
+    UtAssert_StrCmp(CAM_APP_ContainerStatusText((CAM_APP_ContainerStatus_t)99), "unknown status", "Unknown text");
+}
+
+/*
+ * Setup function prior to every test
+ */
+void Cam_UT_Setup(void)
+{
+    static const uint8_t Key[CAM_APP_CRYPTO_KEY_SIZE] = {0x30};
+    size_t               i;
+
+    UT_ResetState(0);
+
+    for (i = 0; i < sizeof(CAM_APP_UT_Plain); i++)
+    {
+        CAM_APP_UT_Plain[i] = (uint8_t)(i * 13 + (i >> 8));
+    }
+
+    CAM_APP_UT_Key = CAM_APP_CryptoKeyCreate(Key);
+}
+
+/*
+ * Teardown function after every test
+ */
+void Cam_UT_TearDown(void)
+{
+    CAM_APP_CryptoKeyRelease(CAM_APP_UT_Key);
+    CAM_APP_UT_Key = NULL;
+}
+
+/*
+ * Register the test cases to execute with the unit test tool
+ */
+void UtTest_Setup(void)
+{
+    ADD_TEST(CAM_APP_ContainerRoundTrip);
+    ADD_TEST(CAM_APP_ContainerPool);
+    ADD_TEST(CAM_APP_ContainerTamper);
+    ADD_TEST(CAM_APP_ContainerStatusText);
+}
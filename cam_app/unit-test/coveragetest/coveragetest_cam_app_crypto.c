@@ -0,0 +1,322 @@
+/************************************************************************
+ * NASA Docket No. GSC-18,719-1, and identified as “core Flight System: Bootes”
+ *
+ * Copyright (c) 2020 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License. You may obtain
+ * a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ************************************************************************/
+
+/*
+** File: coveragetest_cam_app_crypto.c
+**
+** Purpose:
+** Coverage Unit Test cases for the Cam App frame cipher
+**
+** CTR mode is checked against SP 800-38A F.5.5 and, over longer frames
+** cut at block boundaries, against a keystream built one counter block
+** at a time.  CMAC is checked against tags from an independent
+** implementation.
+*/
+
+/*
+ * Includes
+ */
+
+#include "cam_app_coveragetest_common.h"
+#include "cam_app_crypto.h"
+
+/*
+ * SP 800-38A F.5.5, CTR-AES256.Encrypt
+ */
+static const uint8_t CAM_APP_UT_CtrKey[CAM_APP_CRYPTO_KEY_SIZE] = {
+    0x60, 0x3d, 0xeb, 0x10, 0x15, 0xca, 0x71, 0xbe, 0x2b, 0x73, 0xae, 0xf0, 0x85, 0x7d, 0x77, 0x81,
+    0x1f, 0x35, 0x2c, 0x07, 0x3b, 0x61, 0x08, 0xd7, 0x2d, 0x98, 0x10, 0xa3, 0x09, 0x14, 0xdf, 0xf4};
+
+static const uint8_t CAM_APP_UT_CtrIv[CAM_APP_CRYPTO_IV_SIZE] = {
+    0xf0, 0xf1, 0xf2, 0xf3, 0xf4, 0xf5, 0xf6, 0xf7, 0xf8, 0xf9, 0xfa, 0xfb, 0xfc, 0xfd, 0xfe, 0xff};
+
+static const uint8_t CAM_APP_UT_CtrPlain[4 * CAM_APP_CRYPTO_BLOCK_SIZE] = {
+    0x6b, 0xc1, 0xbe, 0xe2, 0x2e, 0x40, 0x9f, 0x96, 0xe9, 0x3d, 0x7e, 0x11, 0x73, 0x93, 0x17, 0x2a,
+    0xae, 0x2d, 0x8a, 0x57, 0x1e, 0x03, 0xac, 0x9c, 0x9e, 0xb7, 0x6f, 0xac, 0x45, 0xaf, 0x8e, 0x51,
+    0x30, 0xc8, 0x1c, 0x46, 0xa3, 0x5c, 0xe4, 0x11, 0xe5, 0xfb, 0xc1, 0x19, 0x1a, 0x0a, 0x52, 0xef,
+    0xf6, 0x9f, 0x24, 0x45, 0xdf, 0x4f, 0x9b, 0x17, 0xad, 0x2b, 0x41, 0x7b, 0xe6, 0x6c, 0x37, 0x10};
+
+static const uint8_t CAM_APP_UT_CtrCipher[4 * CAM_APP_CRYPTO_BLOCK_SIZE] = {
+    0x60, 0x1e, 0xc3, 0x13, 0x77, 0x57, 0x89, 0xa5, 0xb7, 0xa7, 0xf5, 0x04, 0xbb, 0xf3, 0xd2, 0x28,
+    0xf4, 0x43, 0xe3, 0xca, 0x4d, 0x62, 0xb5, 0x9a, 0xca, 0x84, 0xe9, 0x90, 0xca, 0xca, 0xf5, 0xc5,
+    0x2b, 0x09, 0x30, 0xda, 0xa2, 0x3d, 0xe9, 0x4c, 0xe8, 0x70, 0x17, 0xba, 0x2d, 0x84, 0x98, 0x8d,
+    0xdf, 0xc9, 0xc5, 0x8d, 0xb6, 0x7a, 0xad, 0xa6, 0x13, 0xc2, 0xdd, 0x08, 0x45, 0x79, 0x41, 0xa6};
+
+/*
+ * AES-CMAC tags of the first 0, 16, 40 and 64 bytes of the plaintext
+ * above under the MAC key derived from the key above, computed with
+ * OpenSSL's CMAC.  The message lengths are those of SP 800-38B D.3.
+ */
+static const size_t CAM_APP_UT_MacLengths[] = {0, 16, 40, 64};
+
+static const uint8_t CAM_APP_UT_MacTags[][CAM_APP_CRYPTO_MAC_SIZE] = {
+    {0x1a, 0x59, 0x87, 0x42, 0xbb, 0x16, 0x7d, 0x4c, 0x7a, 0xe2, 0xc1, 0x95, 0x53, 0x15, 0xbf, 0x8d},
+    {0x2d, 0xc0, 0x14, 0x60, 0xbb, 0x0e, 0x18, 0x28, 0xc7, 0xea, 0xfd, 0x6a, 0x99, 0x21, 0xf7, 0x0c},
+    {0x67, 0x98, 0xa7, 0x96, 0x37, 0x41, 0x58, 0x56, 0xc7, 0xc1, 0x2a, 0x3e, 0xf4, 0x5c, 0x5e, 0x90},
+    {0x09, 0x5c, 0xb9, 0x80, 0x3d, 0x84, 0x66, 0x47, 0xdd, 0xda, 0xd3, 0x18, 0x72, 0xe7, 0xdc, 0x55}};
+
+/*
+ * A frame longer than one batch of counter blocks, ending part way
+ * through a block
+ */
+#define CAM_APP_UT_CRYPTO_FRAME_SIZE (40 * CAM_APP_CRYPTO_BLOCK_SIZE + 7)
+
+/*
+ * Encrypt Len bytes the long way, one counter block at a time
+ */
+static void CAM_APP_UT_CtrReference(const uint8_t *Key, const uint8_t *Iv, const uint8_t *In, uint8_t *Out, size_t Len)
+{
+    CAM_APP_AesSchedule_t Schedule;
+    uint8_t               Counter[CAM_APP_CRYPTO_BLOCK_SIZE];
+    uint8_t               Stream[CAM_APP_CRYPTO_BLOCK_SIZE];
+    size_t                i;
+    int                   j;
+
+    CAM_APP_AesExpandKey(&Schedule, Key);
+    memcpy(Counter, Iv, sizeof(Counter));
+
+    for (i = 0; i < Len; i++)
+    {
+        if (i % CAM_APP_CRYPTO_BLOCK_SIZE == 0)
+        {
+            CAM_APP_AesEncryptBlocks(&Schedule, Counter, Stream, 1);
+            for (j = CAM_APP_CRYPTO_BLOCK_SIZE - 1; j >= CAM_APP_CRYPTO_NONCE_SIZE; j--)
+            {
+                if (++Counter[j] != 0)
+                {
+                    break;
+                }
+            }
+        }
+        Out[i] = In[i] ^ Stream[i % CAM_APP_CRYPTO_BLOCK_SIZE];
+    }
+}
+
+/*
+**********************************************************************************
+**          TEST CASE FUNCTIONS
+**********************************************************************************
+*/
+
+void Test_CAM_APP_CryptoCtr(void)
+{
+    /*
+     * Test Case For:
+     * void CAM_APP_CryptoCtr(const CAM_APP_CryptoKey_t *Key, const uint8_t *Iv, size_t Offset, const uint8_t *In,
+     *                        uint8_t *Out, size_t Len)
+     */
+    CAM_APP_CryptoKey_t *Key;
+    uint8_t              Buffer[sizeof(CAM_APP_UT_CtrPlain)];
+
+    Key = CAM_APP_CryptoKeyCreate(CAM_APP_UT_CtrKey);
+    UtAssert_NOT_NULL(Key);
+
+    CAM_APP_CryptoCtr(Key, CAM_APP_UT_CtrIv, 0, CAM_APP_UT_CtrPlain, Buffer, sizeof(Buffer));
+    UtAssert_MemCmp(Buffer, CAM_APP_UT_CtrCipher, sizeof(Buffer), "Encrypts SP 800-38A F.5.5");
+
+    /* Decryption is the same operation, here in place */
+    CAM_APP_CryptoCtr(Key, CAM_APP_UT_CtrIv, 0, Buffer, Buffer, sizeof(Buffer));
+    UtAssert_MemCmp(Buffer, CAM_APP_UT_CtrPlain, sizeof(Buffer), "Decrypts SP 800-38A F.5.6");
+
+    /* A segment starting part way into the frame picks up the counter where the one before it left off */
+    memset(Buffer, 0, sizeof(Buffer));
+    CAM_APP_CryptoCtr(Key, CAM_APP_UT_CtrIv, 3 * CAM_APP_CRYPTO_BLOCK_SIZE,
+                      CAM_APP_UT_CtrPlain + 3 * CAM_APP_CRYPTO_BLOCK_SIZE, Buffer + 3 * CAM_APP_CRYPTO_BLOCK_SIZE,
+                      CAM_APP_CRYPTO_BLOCK_SIZE);
+    CAM_APP_CryptoCtr(Key, CAM_APP_UT_CtrIv, CAM_APP_CRYPTO_BLOCK_SIZE, CAM_APP_UT_CtrPlain + CAM_APP_CRYPTO_BLOCK_SIZE,
+                      Buffer + CAM_APP_CRYPTO_BLOCK_SIZE, 2 * CAM_APP_CRYPTO_BLOCK_SIZE);
+    CAM_APP_CryptoCtr(Key, CAM_APP_UT_CtrIv, 0, CAM_APP_UT_CtrPlain, Buffer, CAM_APP_CRYPTO_BLOCK_SIZE);
+    UtAssert_MemCmp(Buffer, CAM_APP_UT_CtrCipher, sizeof(Buffer), "Segments encrypted out of order match");
+
+    CAM_APP_CryptoKeyRelease(Key);
+}
+
+void Test_CAM_APP_CryptoCtrFrame(void)
+{
+    /*
+     * Test Case For:
+     * void CAM_APP_CryptoCtr(const CAM_APP_CryptoKey_t *Key, const uint8_t *Iv, size_t Offset, const uint8_t *In,
+     *                        uint8_t *Out, size_t Len)
+     */
+    static uint8_t       Plain[CAM_APP_UT_CRYPTO_FRAME_SIZE];
+    static uint8_t       Expected[CAM_APP_UT_CRYPTO_FRAME_SIZE];
+    static uint8_t       Buffer[CAM_APP_UT_CRYPTO_FRAME_SIZE];
+    CAM_APP_CryptoKey_t *Key;
+    uint8_t              Iv[CAM_APP_CRYPTO_IV_SIZE];
+    size_t               Offset;
+    size_t               i;
+
+    for (i = 0; i < sizeof(Plain); i++)
+    {
+        Plain[i] = (uint8_t)(i * 31 + 7);
+    }
+
+    /* A counter close enough to wrapping that the frame carries it into the upper counter bytes */
+    memcpy(Iv, CAM_APP_UT_CtrIv, sizeof(Iv));
+    Iv[14] = 0xff;
+    Iv[15] = 0xf0;
+
+    Key = CAM_APP_CryptoKeyCreate(CAM_APP_UT_CtrKey);
+    UtAssert_NOT_NULL(Key);
+
+    CAM_APP_UT_CtrReference(CAM_APP_UT_CtrKey, Iv, Plain, Expected, sizeof(Expected));
+
+    CAM_APP_CryptoCtr(Key, Iv, 0, Plain, Buffer, sizeof(Buffer));
+    UtAssert_MemCmp(Buffer, Expected, sizeof(Buffer), "Whole frame matches the reference keystream");
+
+    /* Cut into five-block segments, as the crypto pool hands them out */
+    memset(Buffer, 0, sizeof(Buffer));
+    for (Offset = 0; Offset < sizeof(Buffer); Offset += 5 * CAM_APP_CRYPTO_BLOCK_SIZE)
+    {
+        CAM_APP_CryptoCtr(Key, Iv, Offset, Plain + Offset, Buffer + Offset,
+                          sizeof(Buffer) - Offset < 5 * CAM_APP_CRYPTO_BLOCK_SIZE ? sizeof(Buffer) - Offset
+                                                                                  : 5 * CAM_APP_CRYPTO_BLOCK_SIZE);
+    }
+    UtAssert_MemCmp(Buffer, Expected, sizeof(Buffer), "Segmented frame matches the reference keystream");
+
+    CAM_APP_CryptoKeyRelease(Key);
+}
+
+void Test_CAM_APP_CryptoKeyInstall(void)
+{
+    /*
+     * Test Case For:
+     * void CAM_APP_CryptoKeyInstall(CAM_APP_CryptoKey_t *Key)
+     * CAM_APP_CryptoKey_t *CAM_APP_CryptoKeyAcquire(void)
+     * void CAM_APP_CryptoKeyRetain(CAM_APP_CryptoKey_t *Key)
+     * void CAM_APP_CryptoKeyRelease(CAM_APP_CryptoKey_t *Key)
+     */
+    CAM_APP_CryptoKey_t *First;
+    CAM_APP_CryptoKey_t *Second;
+    CAM_APP_CryptoKey_t *Held;
+    uint8_t              OtherKey[CAM_APP_CRYPTO_KEY_SIZE];
+    uint8_t              Buffer[sizeof(CAM_APP_UT_CtrPlain)];
+
+    UtAssert_NULL(CAM_APP_CryptoKeyAcquire());
+
+    First = CAM_APP_CryptoKeyCreate(CAM_APP_UT_CtrKey);
+    UtAssert_NOT_NULL(First);
+    CAM_APP_CryptoKeyInstall(First);
+
+    Held = CAM_APP_CryptoKeyAcquire();
+    UtAssert_True(Held == First, "Acquire returns the installed key");
+
+    /* A frame still holding the old key finishes under it after a new one is installed */
+    memset(OtherKey, 0x5a, sizeof(OtherKey));
+    Second = CAM_APP_CryptoKeyCreate(OtherKey);
+    UtAssert_NOT_NULL(Second);
+    CAM_APP_CryptoKeyInstall(Second);
+
+    CAM_APP_CryptoCtr(Held, CAM_APP_UT_CtrIv, 0, CAM_APP_UT_CtrPlain, Buffer, sizeof(Buffer));
+    UtAssert_MemCmp(Buffer, CAM_APP_UT_CtrCipher, sizeof(Buffer), "Replaced key still encrypts");
+    CAM_APP_CryptoKeyRelease(Held);
+
+    Held = CAM_APP_CryptoKeyAcquire();
+    UtAssert_True(Held == Second, "Acquire returns the new key");
+    CAM_APP_CryptoKeyRelease(Held);
+
+    /* NULL is accepted, and releases the last reference to the installed key */
+    CAM_APP_CryptoKeyRelease(NULL);
+    CAM_APP_CryptoKeyInstall(NULL);
+    UtAssert_NULL(CAM_APP_CryptoKeyAcquire());
+}
+
+void Test_CAM_APP_CryptoMakeIv(void)
+{
+    /*
+     * Test Case For:
+     * void CAM_APP_CryptoMakeIv(uint8_t *Iv)
+     */
+    static const uint8_t Zero[CAM_APP_CRYPTO_IV_SIZE - CAM_APP_CRYPTO_NONCE_SIZE] = {0};
+    uint8_t              First[CAM_APP_CRYPTO_IV_SIZE];
+    uint8_t              Second[CAM_APP_CRYPTO_IV_SIZE];
+
+    memset(First, 0xff, sizeof(First));
+    memset(Second, 0xff, sizeof(Second));
+    CAM_APP_CryptoMakeIv(First);
+    CAM_APP_CryptoMakeIv(Second);
+
+    UtAssert_MemCmp(First + CAM_APP_CRYPTO_NONCE_SIZE, Zero, sizeof(Zero), "Block counter starts at zero");
+    UtAssert_True(memcmp(First, Second, CAM_APP_CRYPTO_NONCE_SIZE) != 0, "Each IV gets its own nonce");
+}
+
+void Test_CAM_APP_CryptoMac(void)
+{
+    /*
+     * Test Case For:
+     * void CAM_APP_CryptoMacInit(CAM_APP_CryptoMac_t *Mac, const CAM_APP_CryptoKey_t *Key)
+     * void CAM_APP_CryptoMacUpdate(CAM_APP_CryptoMac_t *Mac, const uint8_t *Data, size_t Len)
+     * void CAM_APP_CryptoMacFinal(CAM_APP_CryptoMac_t *Mac, uint8_t *Tag)
+     */
+    CAM_APP_CryptoKey_t *Key;
+    CAM_APP_CryptoMac_t  Mac;
+    uint8_t              Tag[CAM_APP_CRYPTO_MAC_SIZE];
+    size_t               Len;
+    size_t               i;
+    size_t               j;
+
+    Key = CAM_APP_CryptoKeyCreate(CAM_APP_UT_CtrKey);
+    UtAssert_NOT_NULL(Key);
+
+    for (i = 0; i < sizeof(CAM_APP_UT_MacLengths) / sizeof(CAM_APP_UT_MacLengths[0]); i++)
+    {
+        Len = CAM_APP_UT_MacLengths[i];
+
+        CAM_APP_CryptoMacInit(&Mac, Key);
+        CAM_APP_CryptoMacUpdate(&Mac, CAM_APP_UT_CtrPlain, Len);
+        CAM_APP_CryptoMacFinal(&Mac, Tag);
+        UtAssert_MemCmp(Tag, CAM_APP_UT_MacTags[i], sizeof(Tag), "Tag of %lu bytes in one piece", (unsigned long)Len);
+
+        /* Pieces that straddle block boundaries, including empty ones, give the same tag */
+        CAM_APP_CryptoMacInit(&Mac, Key);
+        for (j = 0; j < Len; j += 7)
+        {
+            CAM_APP_CryptoMacUpdate(&Mac, CAM_APP_UT_CtrPlain + j, Len - j < 7 ? Len - j : 7);
+            CAM_APP_CryptoMacUpdate(&Mac, CAM_APP_UT_CtrPlain, 0);
+        }
+        CAM_APP_CryptoMacFinal(&Mac, Tag);
+        UtAssert_MemCmp(Tag, CAM_APP_UT_MacTags[i], sizeof(Tag), "Tag of %lu bytes in pieces", (unsigned long)Len);
+    }
+
+    CAM_APP_CryptoKeyRelease(Key);
+}
+
+/*
+ * Setup function prior to every test
+ */
+void Cam_UT_Setup(void)
+{
+    UT_ResetState(0);
+}
+
+/*
+ * Teardown function after every test
+ */
+void Cam_UT_TearDown(void) {}
+
+/*
+ * Register the test cases to execute with the unit test tool
+ */
+void UtTest_Setup(void)
+{
+    ADD_TEST(CAM_APP_CryptoCtr);
+    ADD_TEST(CAM_APP_CryptoCtrFrame);
+    ADD_TEST(CAM_APP_CryptoKeyInstall);
+    ADD_TEST(CAM_APP_CryptoMakeIv);
+    ADD_TEST(CAM_APP_CryptoMac);
+}
@@ -0,0 +1,508 @@
+/************************************************************************
+ * NASA Docket No. GSC-18,719-1, and identified as “core Flight System: Bootes”
+ *
+ * Copyright (c) 2020 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License. You may obtain
+ * a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ************************************************************************/
+
+/*
+** File: coveragetest_cam_app_downlink.c
+**
+** Purpose:
+** Coverage Unit Test cases for the Cam App downlink queue
+**
+** Frames are queued from files in a scratch directory under /tmp and
+** every packet handed to the software bus is checked against the file.
+** The token bucket runs on the real monotonic clock; the tests keep the
+** rate either far above or far below what a test can spend in the time
+** it takes, so what a wakeup sends does not depend on scheduling.
+*/
+
+/*
+ * Includes
+ */
+
+#include "cam_app_coveragetest_common.h"
+#include "cam_app_downlink.h"
+#include "cam_app_hex.h"
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+/*
+ * Stored frame: three packets, the last one short, after some bytes the
+ * frame does not own
+ */
+#define CAM_APP_UT_FRAME_LEN    (2 * CAM_APP_IMAGE_CHUNK_SIZE + 100)
+#define CAM_APP_UT_FRAME_OFFSET 100
+
+/* Budget for exactly Packets full packets */
+#define CAM_APP_UT_BURST(Packets) ((uint32)((Packets) * sizeof(CAM_APP_ImageTlm_t)))
+
+/* A rate that refills any burst in well under a millisecond */
+#define CAM_APP_UT_RATE_UNLIMITED UINT32_MAX
+
+/* Packets the tests send at most */
+#define CAM_APP_UT_MAX_PACKETS (CAM_APP_DOWNLINK_QUEUE_DEPTH + 16)
+
+static uint8 CAM_APP_UT_Frame[CAM_APP_UT_FRAME_LEN];
+
+/*
+ * Scratch directory with the frame stored as raw bytes and as hex text
+ */
+static char CAM_APP_UT_Dir[64];
+static char CAM_APP_UT_RawName[128];
+static char CAM_APP_UT_HexName[128];
+
+/*
+ * The bus buffer the downlink fills, and what it held each time it was sent
+ */
+static union
+{
+    CFE_SB_Buffer_t    SBBuf;
+    CAM_APP_ImageTlm_t Tlm;
+} CAM_APP_UT_Packet;
+
+typedef struct
+{
+    uint32 Sequence;
+    uint32 Offset;
+    uint32 DataLength;
+    uint32 TotalLength;
+    bool   Intact; /* Data matches the stored frame at Offset */
+} CAM_APP_UT_Sent_t;
+
+static CAM_APP_UT_Sent_t CAM_APP_UT_Sent[CAM_APP_UT_MAX_PACKETS];
+static uint32            CAM_APP_UT_SentCount;
+
+/* Allocations still to fail, as when the bus is out of buffers */
+static uint32 CAM_APP_UT_AllocFailures;
+
+/*
+ * Handler for CFE_SB_AllocateMessageBuffer: hand out the one test buffer
+ */
+static void UT_Handler_CFE_SB_AllocateMessageBuffer(void *UserObj, UT_EntryKey_t FuncKey,
+                                                    const UT_StubContext_t *Context)
+{
+    CFE_SB_Buffer_t *BufPtr = &CAM_APP_UT_Packet.SBBuf;
+
+    if (CAM_APP_UT_AllocFailures > 0)
+    {
+        CAM_APP_UT_AllocFailures--;
+        BufPtr = NULL;
+    }
+
+    UT_Stub_SetReturnValue(FuncKey, BufPtr);
+}
+
+/*
+ * Handler for CFE_SB_TransmitBuffer: note what went out
+ */
+static void UT_Handler_CFE_SB_TransmitBuffer(void *UserObj, UT_EntryKey_t FuncKey, const UT_StubContext_t *Context)
+{
+    const CAM_APP_ImageTlm_Payload_t *Payload = &CAM_APP_UT_Packet.Tlm.Payload;
+    CAM_APP_UT_Sent_t                *Sent;
+
+    if (CAM_APP_UT_SentCount == CAM_APP_UT_MAX_PACKETS)
+    {
+        return;
+    }
+
+    Sent              = &CAM_APP_UT_Sent[CAM_APP_UT_SentCount++];
+    Sent->Sequence    = Payload->Sequence;
+    Sent->Offset      = Payload->Offset;
+    Sent->DataLength  = Payload->DataLength;
+    Sent->TotalLength = Payload->TotalLength;
+    Sent->Intact      = (uint64)Payload->Offset + Payload->DataLength <= CAM_APP_UT_FRAME_LEN &&
+                        memcmp(Payload->Data, &CAM_APP_UT_Frame[Payload->Offset], Payload->DataLength) == 0;
+}
+
+/*
+ * Write Len bytes to a new file Name
+ */
+static void CAM_APP_UT_WriteFile(const char *Name, const void *Data, size_t Len)
+{
+    FILE *File;
+
+    File = fopen(Name, "wb");
+    UtAssert_True(File != NULL && fwrite(Data, 1, Len, File) == Len && fclose(File) == 0, "Wrote %s", Name);
+}
+
+/*
+ * Fill the bucket to Burst, then leave Rate to top it up
+ *
+ * The queue must be empty or held, as the wakeup that fills the bucket
+ * sends whatever is waiting.
+ */
+static void CAM_APP_UT_FillBucket(uint32 Rate, uint32 Burst)
+{
+    UtAssert_INT32_EQ(CAM_APP_DownlinkSetRate(CAM_APP_UT_RATE_UNLIMITED, Burst), CFE_SUCCESS);
+    usleep(1000);
+    CAM_APP_DownlinkWakeup();
+    UtAssert_INT32_EQ(CAM_APP_DownlinkSetRate(Rate, Burst), CFE_SUCCESS);
+}
+
+/*
+ * Check packets First to First + Count - 1 were frame Sequence, of
+ * TotalLength bytes, in order from Offset on
+ */
+static void CAM_APP_UT_CheckSent(uint32 First, uint32 Count, uint32 Sequence, uint32 TotalLength, uint32 Offset)
+{
+    uint32 Wrong = 0;
+    uint32 i;
+
+    UtAssert_True(First + Count <= CAM_APP_UT_SentCount, "%lu packets sent, %lu expected",
+                  (unsigned long)CAM_APP_UT_SentCount, (unsigned long)(First + Count));
+    if (First + Count > CAM_APP_UT_SentCount)
+    {
+        return;
+    }
+
+    for (i = First; i < First + Count; i++)
+    {
+        if (CAM_APP_UT_Sent[i].Sequence != Sequence || CAM_APP_UT_Sent[i].TotalLength != TotalLength ||
+            CAM_APP_UT_Sent[i].Offset != Offset || !CAM_APP_UT_Sent[i].Intact)
+        {
+            Wrong++;
+        }
+        Offset += CAM_APP_UT_Sent[i].DataLength;
+    }
+
+    UtAssert_UINT32_EQ(Wrong, 0);
+}
+
+/*
+ * Remove every file in Dir, then Dir itself
+ */
+static void CAM_APP_UT_RemoveDir(const char *Dir)
+{
+    struct dirent *Entry;
+    DIR           *Handle;
+    char           Name[sizeof(CAM_APP_UT_Dir) + 256];
+
+    Handle = opendir(Dir);
+    if (Handle != NULL)
+    {
+        while ((Entry = readdir(Handle)) != NULL)
+        {
+            if (strcmp(Entry->d_name, ".") != 0 && strcmp(Entry->d_name, "..") != 0)
+            {
+                snprintf(Name, sizeof(Name), "%s/%s", Dir, Entry->d_name);
+                unlink(Name);
+            }
+        }
+        closedir(Handle);
+    }
+
+    rmdir(Dir);
+}
+
+/*
+**********************************************************************************
+**          TEST CASE FUNCTIONS
+**********************************************************************************
+*/
+
+void Test_CAM_APP_DownlinkSend(void)
+{
+    /*
+     * Test Case For:
+     * void CAM_APP_DownlinkQueue(uint32 Priority, uint32 Sequence, const char *Name, uint64 Offset, uint32 Length,
+     *                            bool Hex)
+     * void CAM_APP_DownlinkWakeup(void)
+     */
+    uint32 ChunksSent, ChunkErrors, QueuedBytes, Throttles, FramesDropped;
+
+    CAM_APP_UT_FillBucket(CAM_APP_DOWNLINK_RATE, CAM_APP_UT_BURST(8));
+
+    CAM_APP_DownlinkQueue(1, 1, CAM_APP_UT_RawName, CAM_APP_UT_FRAME_OFFSET, CAM_APP_UT_FRAME_LEN, false);
+    CAM_APP_DownlinkQueue(1, 2, CAM_APP_UT_HexName, 2 * CAM_APP_UT_FRAME_OFFSET, CAM_APP_UT_FRAME_LEN, true);
+    CAM_APP_DownlinkStats(&ChunksSent, &ChunkErrors, &QueuedBytes, &Throttles, &FramesDropped);
+    UtAssert_UINT32_EQ(QueuedBytes, 2 * CAM_APP_UT_FRAME_LEN);
+
+    CAM_APP_DownlinkWakeup();
+
+    /* Raw and hex frames go out alike, each whole before the next */
+    UtAssert_UINT32_EQ(CAM_APP_UT_SentCount, 6);
+    CAM_APP_UT_CheckSent(0, 3, 1, CAM_APP_UT_FRAME_LEN, 0);
+    CAM_APP_UT_CheckSent(3, 3, 2, CAM_APP_UT_FRAME_LEN, 0);
+    UtAssert_UINT32_EQ(CAM_APP_UT_Sent[2].DataLength, CAM_APP_UT_FRAME_LEN - 2 * CAM_APP_IMAGE_CHUNK_SIZE);
+
+    CAM_APP_DownlinkStats(&ChunksSent, &ChunkErrors, &QueuedBytes, &Throttles, &FramesDropped);
+    UtAssert_UINT32_EQ(ChunksSent, 6);
+    UtAssert_UINT32_EQ(ChunkErrors, 0);
+    UtAssert_UINT32_EQ(QueuedBytes, 0);
+    UtAssert_UINT32_EQ(Throttles, 0);
+    UtAssert_UINT32_EQ(FramesDropped, 0);
+}
+
+void Test_CAM_APP_DownlinkBudget(void)
+{
+    /*
+     * Test Case For:
+     * void CAM_APP_DownlinkWakeup(void)
+     * CFE_Status_t CAM_APP_DownlinkSetRate(uint32 RateBytesPerSec, uint32 BurstBytes)
+     */
+    uint32 ChunksSent, ChunkErrors, QueuedBytes, Throttles, FramesDropped;
+
+    /* At a byte a second nothing is earned back while the test runs */
+    CAM_APP_UT_FillBucket(1, CAM_APP_UT_BURST(2));
+    CAM_APP_DownlinkQueue(0, 1, CAM_APP_UT_RawName, CAM_APP_UT_FRAME_OFFSET, CAM_APP_UT_FRAME_LEN, false);
+
+    CAM_APP_DownlinkWakeup();
+    UtAssert_UINT32_EQ(CAM_APP_UT_SentCount, 2);
+    CAM_APP_DownlinkWakeup();
+    UtAssert_UINT32_EQ(CAM_APP_UT_SentCount, 2);
+
+    CAM_APP_DownlinkStats(&ChunksSent, &ChunkErrors, &QueuedBytes, &Throttles, &FramesDropped);
+    UtAssert_UINT32_EQ(Throttles, 2);
+    UtAssert_UINT32_EQ(QueuedBytes, CAM_APP_UT_FRAME_LEN - 2 * CAM_APP_IMAGE_CHUNK_SIZE);
+
+    /* A rate of 0 holds the frame however long it waits */
+    UtAssert_INT32_EQ(CAM_APP_DownlinkSetRate(0, CAM_APP_UT_BURST(2)), CFE_SUCCESS);
+    usleep(1000);
+    CAM_APP_DownlinkWakeup();
+    UtAssert_UINT32_EQ(CAM_APP_UT_SentCount, 2);
+
+    UtAssert_INT32_EQ(CAM_APP_DownlinkSetRate(CAM_APP_UT_RATE_UNLIMITED, CAM_APP_UT_BURST(2)), CFE_SUCCESS);
+    usleep(1000);
+    CAM_APP_DownlinkWakeup();
+    UtAssert_UINT32_EQ(CAM_APP_UT_SentCount, 3);
+    CAM_APP_UT_CheckSent(0, 3, 1, CAM_APP_UT_FRAME_LEN, 0);
+
+    CAM_APP_DownlinkStats(&ChunksSent, &ChunkErrors, &QueuedBytes, &Throttles, &FramesDropped);
+    UtAssert_UINT32_EQ(Throttles, 3);
+    UtAssert_UINT32_EQ(QueuedBytes, 0);
+}
+
+void Test_CAM_APP_DownlinkSetRate(void)
+{
+    /*
+     * Test Case For:
+     * CFE_Status_t CAM_APP_DownlinkSetRate(uint32 RateBytesPerSec, uint32 BurstBytes)
+     */
+
+    /* The burst must hold a full packet */
+    UtAssert_INT32_EQ(CAM_APP_DownlinkSetRate(CAM_APP_DOWNLINK_RATE, CAM_APP_UT_BURST(1) - 1), CFE_STATUS_RANGE_ERROR);
+    UtAssert_INT32_EQ(CAM_APP_DownlinkSetRate(CAM_APP_DOWNLINK_RATE, 0), CFE_STATUS_RANGE_ERROR);
+    UtAssert_INT32_EQ(CAM_APP_DownlinkSetRate(CAM_APP_DOWNLINK_RATE, CAM_APP_UT_BURST(1)), CFE_SUCCESS);
+    UtAssert_INT32_EQ(CAM_APP_DownlinkSetRate(0, UINT32_MAX), CFE_SUCCESS);
+
+    /* Shrinking the burst takes away what no longer fits */
+    CAM_APP_UT_FillBucket(1, CAM_APP_UT_BURST(4));
+    UtAssert_INT32_EQ(CAM_APP_DownlinkSetRate(1, CAM_APP_UT_BURST(1)), CFE_SUCCESS);
+    CAM_APP_DownlinkQueue(0, 1, CAM_APP_UT_RawName, CAM_APP_UT_FRAME_OFFSET, CAM_APP_UT_FRAME_LEN, false);
+    CAM_APP_DownlinkWakeup();
+    UtAssert_UINT32_EQ(CAM_APP_UT_SentCount, 1);
+}
+
+void Test_CAM_APP_DownlinkHold(void)
+{
+    /*
+     * Test Case For:
+     * CFE_Status_t CAM_APP_DownlinkSetRate(uint32 RateBytesPerSec, uint32 BurstBytes)
+     */
+
+    /* A rate of 0 stops the downlink at once, budget already earned included */
+    CAM_APP_UT_FillBucket(0, CAM_APP_UT_BURST(4));
+    CAM_APP_DownlinkQueue(0, 1, CAM_APP_UT_RawName, CAM_APP_UT_FRAME_OFFSET, CAM_APP_UT_FRAME_LEN, false);
+    CAM_APP_DownlinkWakeup();
+    UtAssert_UINT32_EQ(CAM_APP_UT_SentCount, 0);
+}
+
+void Test_CAM_APP_DownlinkPriority(void)
+{
+    /*
+     * Test Case For:
+     * void CAM_APP_DownlinkQueue(uint32 Priority, uint32 Sequence, const char *Name, uint64 Offset, uint32 Length,
+     *                            bool Hex)
+     * void CAM_APP_DownlinkWakeup(void)
+     */
+
+    /* Budget for the first packet of a routine frame */
+    CAM_APP_UT_FillBucket(1, CAM_APP_UT_BURST(1));
+    CAM_APP_DownlinkQueue(1, 1, CAM_APP_UT_RawName, CAM_APP_UT_FRAME_OFFSET, CAM_APP_UT_FRAME_LEN, false);
+    CAM_APP_DownlinkWakeup();
+    UtAssert_UINT32_EQ(CAM_APP_UT_SentCount, 1);
+
+    /* An urgent frame waits for the one started to finish, then goes ahead of routine ones queued earlier */
+    CAM_APP_DownlinkQueue(1, 2, CAM_APP_UT_RawName, CAM_APP_UT_FRAME_OFFSET, CAM_APP_UT_FRAME_LEN, false);
+    CAM_APP_DownlinkQueue(0, 3, CAM_APP_UT_HexName, 2 * CAM_APP_UT_FRAME_OFFSET, CAM_APP_UT_FRAME_LEN, true);
+    UtAssert_INT32_EQ(CAM_APP_DownlinkSetRate(CAM_APP_UT_RATE_UNLIMITED, CAM_APP_UT_BURST(16)), CFE_SUCCESS);
+    usleep(1000);
+    CAM_APP_DownlinkWakeup();
+
+    UtAssert_UINT32_EQ(CAM_APP_UT_SentCount, 9);
+    CAM_APP_UT_CheckSent(0, 3, 1, CAM_APP_UT_FRAME_LEN, 0);
+    CAM_APP_UT_CheckSent(3, 3, 3, CAM_APP_UT_FRAME_LEN, 0);
+    CAM_APP_UT_CheckSent(6, 3, 2, CAM_APP_UT_FRAME_LEN, 0);
+
+    /* Out of range priorities and empty frames are not queued */
+    CAM_APP_DownlinkQueue(CAM_APP_DOWNLINK_PRIORITIES, 4, CAM_APP_UT_RawName, 0, CAM_APP_UT_FRAME_LEN, false);
+    CAM_APP_DownlinkQueue(0, 5, CAM_APP_UT_RawName, 0, 0, false);
+    usleep(1000);
+    CAM_APP_DownlinkWakeup();
+    UtAssert_UINT32_EQ(CAM_APP_UT_SentCount, 9);
+}
+
+void Test_CAM_APP_DownlinkDrop(void)
+{
+    /*
+     * Test Case For:
+     * void CAM_APP_DownlinkQueue(uint32 Priority, uint32 Sequence, const char *Name, uint64 Offset, uint32 Length,
+     *                            bool Hex)
+     * void CAM_APP_DownlinkWakeup(void)
+     */
+    uint32 ChunksSent, ChunkErrors, QueuedBytes, Throttles, FramesDropped;
+    char   Missing[sizeof(CAM_APP_UT_RawName) + 16];
+    uint32 i;
+
+    snprintf(Missing, sizeof(Missing), "%s/evicted.bin", CAM_APP_UT_Dir);
+
+    /* Held while the queue fills */
+    UtAssert_INT32_EQ(CAM_APP_DownlinkSetRate(0, CAM_APP_UT_BURST(16)), CFE_SUCCESS);
+
+    /* Gone before its turn, and cut short */
+    CAM_APP_DownlinkQueue(0, 1, Missing, 0, CAM_APP_UT_FRAME_LEN, false);
+    CAM_APP_DownlinkQueue(0, 2, CAM_APP_UT_RawName, CAM_APP_UT_FRAME_OFFSET + 10, CAM_APP_UT_FRAME_LEN, false);
+
+    for (i = 2; i < CAM_APP_DOWNLINK_QUEUE_DEPTH; i++)
+    {
+        CAM_APP_DownlinkQueue(0, 10 + i, CAM_APP_UT_RawName, CAM_APP_UT_FRAME_OFFSET, 10, false);
+    }
+    UtAssert_UINT32_EQ(UT_GetStubCount(UT_KEY(CFE_EVS_SendEvent)), 0);
+
+    /* A full queue turns the next frame away */
+    CAM_APP_DownlinkQueue(0, 1000, CAM_APP_UT_RawName, CAM_APP_UT_FRAME_OFFSET, 10, false);
+    CAM_APP_DownlinkStats(&ChunksSent, &ChunkErrors, &QueuedBytes, &Throttles, &FramesDropped);
+    UtAssert_UINT32_EQ(FramesDropped, 1);
+    UtAssert_UINT32_EQ(QueuedBytes, 2 * CAM_APP_UT_FRAME_LEN + 10 * (CAM_APP_DOWNLINK_QUEUE_DEPTH - 2));
+
+    UtAssert_INT32_EQ(CAM_APP_DownlinkSetRate(CAM_APP_UT_RATE_UNLIMITED, CAM_APP_UT_BURST(16)), CFE_SUCCESS);
+    usleep(1000);
+    CAM_APP_DownlinkWakeup();
+
+    /* The truncated frame's first packet reads in full and is sent before the short read is found */
+    CAM_APP_DownlinkStats(&ChunksSent, &ChunkErrors, &QueuedBytes, &Throttles, &FramesDropped);
+    UtAssert_UINT32_EQ(FramesDropped, 3);
+    UtAssert_UINT32_EQ(ChunksSent, CAM_APP_DOWNLINK_QUEUE_DEPTH - 2 + 2);
+    UtAssert_UINT32_EQ(QueuedBytes, 0);
+    UtAssert_UINT32_EQ(UT_GetStubCount(UT_KEY(CFE_EVS_SendEvent)), 3);
+    CAM_APP_UT_CheckSent(2, 1, 12, 10, 0);
+}
+
+void Test_CAM_APP_DownlinkRetry(void)
+{
+    /*
+     * Test Case For:
+     * void CAM_APP_DownlinkWakeup(void)
+     * void CAM_APP_DownlinkResetStats(void)
+     */
+    uint32 ChunksSent, ChunkErrors, QueuedBytes, Throttles, FramesDropped;
+
+    CAM_APP_UT_FillBucket(CAM_APP_UT_RATE_UNLIMITED, CAM_APP_UT_BURST(8));
+    CAM_APP_DownlinkQueue(0, 1, CAM_APP_UT_RawName, CAM_APP_UT_FRAME_OFFSET, CAM_APP_UT_FRAME_LEN, false);
+
+    /* No bus buffer: the packet waits for the next wakeup */
+    CAM_APP_UT_AllocFailures = 1;
+    CAM_APP_DownlinkWakeup();
+    UtAssert_UINT32_EQ(CAM_APP_UT_SentCount, 0);
+
+    CAM_APP_DownlinkWakeup();
+    CAM_APP_UT_CheckSent(0, 3, 1, CAM_APP_UT_FRAME_LEN, 0);
+
+    CAM_APP_DownlinkStats(&ChunksSent, &ChunkErrors, &QueuedBytes, &Throttles, &FramesDropped);
+    UtAssert_UINT32_EQ(ChunksSent, 3);
+    UtAssert_UINT32_EQ(ChunkErrors, 1);
+    UtAssert_UINT32_EQ(FramesDropped, 0);
+
+    CAM_APP_DownlinkResetStats();
+    CAM_APP_DownlinkStats(&ChunksSent, &ChunkErrors, &QueuedBytes, &Throttles, &FramesDropped);
+    UtAssert_UINT32_EQ(ChunksSent, 0);
+    UtAssert_UINT32_EQ(ChunkErrors, 0);
+}
+
+/*
+ * Setup function prior to every test
+ */
+void Cam_UT_Setup(void)
+{
+    static char HexText[2 * (CAM_APP_UT_FRAME_OFFSET + CAM_APP_UT_FRAME_LEN)];
+    static uint8 Stored[CAM_APP_UT_FRAME_OFFSET + CAM_APP_UT_FRAME_LEN];
+    size_t       i;
+
+    UT_ResetState(0);
+    UT_SetHandlerFunction(UT_KEY(CFE_SB_AllocateMessageBuffer), UT_Handler_CFE_SB_AllocateMessageBuffer, NULL);
+    UT_SetHandlerFunction(UT_KEY(CFE_SB_TransmitBuffer), UT_Handler_CFE_SB_TransmitBuffer, NULL);
+
+    CAM_APP_UT_SentCount     = 0;
+    CAM_APP_UT_AllocFailures = 0;
+
+    for (i = 0; i < sizeof(Stored); i++)
+    {
+        Stored[i] = (uint8)(i * 131 + (i >> 8));
+    }
+    memcpy(CAM_APP_UT_Frame, &Stored[CAM_APP_UT_FRAME_OFFSET], sizeof(CAM_APP_UT_Frame));
+    CAM_APP_HexEncode(Stored, sizeof(Stored), HexText);
+
+    snprintf(CAM_APP_UT_Dir, sizeof(CAM_APP_UT_Dir), "/tmp/cam_app_ut_XXXXXX");
+    UtAssert_NOT_NULL(mkdtemp(CAM_APP_UT_Dir));
+
+    snprintf(CAM_APP_UT_RawName, sizeof(CAM_APP_UT_RawName), "%s/frame.bin", CAM_APP_UT_Dir);
+    snprintf(CAM_APP_UT_HexName, sizeof(CAM_APP_UT_HexName), "%s/frame.hex", CAM_APP_UT_Dir);
+    CAM_APP_UT_WriteFile(CAM_APP_UT_RawName, Stored, sizeof(Stored));
+    CAM_APP_UT_WriteFile(CAM_APP_UT_HexName, HexText, sizeof(HexText));
+}
+
+/*
+ * Teardown function after every test
+ */
+void Cam_UT_TearDown(void)
+{
+    uint32 ChunksSent, ChunkErrors, QueuedBytes, Throttles, FramesDropped;
+    uint32 Wakeups = 0;
+
+    /* The queue outlives a test; send whatever is left so the next one starts empty */
+    CAM_APP_UT_AllocFailures = 0;
+    CAM_APP_DownlinkSetRate(CAM_APP_UT_RATE_UNLIMITED, CAM_APP_UT_BURST(CAM_APP_UT_MAX_PACKETS));
+    do
+    {
+        usleep(1000);
+        CAM_APP_DownlinkWakeup();
+        CAM_APP_DownlinkStats(&ChunksSent, &ChunkErrors, &QueuedBytes, &Throttles, &FramesDropped);
+    } while (QueuedBytes != 0 && ++Wakeups < 100);
+
+    CAM_APP_DownlinkSetRate(CAM_APP_DOWNLINK_RATE, CAM_APP_DOWNLINK_BURST);
+    CAM_APP_DownlinkResetStats();
+
+    CAM_APP_UT_RemoveDir(CAM_APP_UT_Dir);
+}
+
+/*
+ * Register the test cases to execute with the unit test tool
+ */
+void UtTest_Setup(void)
+{
+    ADD_TEST(CAM_APP_DownlinkSend);
+    ADD_TEST(CAM_APP_DownlinkBudget);
+    ADD_TEST(CAM_APP_DownlinkSetRate);
+    ADD_TEST(CAM_APP_DownlinkHold);
+    ADD_TEST(CAM_APP_DownlinkPriority);
+    ADD_TEST(CAM_APP_DownlinkDrop);
+    ADD_TEST(CAM_APP_DownlinkRetry);
+}
@@ -0,0 +1,244 @@
+/************************************************************************
+ * NASA Docket No. GSC-18,719-1, and identified as “core Flight System: Bootes”
+ *
+ * Copyright (c) 2020 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License. You may obtain
+ * a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ************************************************************************/
+
+/*
+** File: coveragetest_cam_app_hex.c
+**
+** Purpose:
+** Coverage Unit Test cases for the Cam App hex codec
+**
+** Every backend the CPU can run is checked against printf's hex over
+** all byte values and every length up to a few vector widths, so both
+** the vector loops and their scalar tails are covered.
+*/
+
+/*
+ * Includes
+ */
+
+#include "cam_app_coveragetest_common.h"
+#include "cam_app_hex.h"
+
+#include <stdio.h>
+
+static const char *const CAM_APP_UT_HexBackends[] = {"avx2", "sse2", "neon", "scalar"};
+
+#define CAM_APP_UT_HEX_BACKEND_COUNT (sizeof(CAM_APP_UT_HexBackends) / sizeof(CAM_APP_UT_HexBackends[0]))
+
+/*
+ * Longest run checked, past three AVX2 blocks of input
+ */
+#define CAM_APP_UT_HEX_MAX_LEN 100
+
+/*
+ * Characters either side of each range of hex digits, and ones that
+ * only differ from a digit in the bit case folding sets
+ */
+static const char CAM_APP_UT_HexInvalid[] = {'/', ':', '@', 'G', '`', 'g', ' ', '\0', '\x80', '\xb0', '\xe1', '\x10'};
+
+/*
+ * Select backend Index, reporting it when the CPU cannot run it
+ */
+static bool CAM_APP_UT_HexSelect(size_t Index)
+{
+    if (!CAM_APP_HexSelectBackend(CAM_APP_UT_HexBackends[Index]))
+    {
+        UtAssert_MIR("Hex backend %s not supported on this CPU", CAM_APP_UT_HexBackends[Index]);
+        return false;
+    }
+
+    return true;
+}
+
+/*
+**********************************************************************************
+**          TEST CASE FUNCTIONS
+**********************************************************************************
+*/
+
+void Test_CAM_APP_HexSelectBackend(void)
+{
+    /*
+     * Test Case For:
+     * bool CAM_APP_HexSelectBackend(const char *Name)
+     * const char *CAM_APP_HexBackendName(void)
+     */
+    const char *Automatic;
+
+    Automatic = CAM_APP_HexBackendName();
+    UtAssert_NOT_NULL(Automatic);
+    UtPrintf("Automatic hex backend: %s", Automatic);
+
+    UtAssert_BOOL_TRUE(CAM_APP_HexSelectBackend("scalar"));
+    UtAssert_StrCmp(CAM_APP_HexBackendName(), "scalar", "Backend is scalar");
+    UtAssert_BOOL_FALSE(CAM_APP_HexSelectBackend("base64"));
+    UtAssert_StrCmp(CAM_APP_HexBackendName(), "scalar", "Backend is still scalar");
+
+    UtAssert_BOOL_TRUE(CAM_APP_HexSelectBackend(Automatic));
+}
+
+void Test_CAM_APP_HexEncode(void)
+{
+    /*
+     * Test Case For:
+     * void CAM_APP_HexEncode(const uint8_t *In, size_t Len, char *Out)
+     */
+    uint8_t Bytes[256];
+    char    Expected[2 * sizeof(Bytes) + 1];
+    char    Text[2 * sizeof(Bytes) + 1];
+    size_t  Wrong;
+    size_t  Len;
+    size_t  i;
+
+    for (i = 0; i < sizeof(Bytes); i++)
+    {
+        Bytes[i] = (uint8_t)(i * 167 + 3);
+        snprintf(Expected + 2 * i, 3, "%02x", Bytes[i]);
+    }
+
+    for (i = 0; i < CAM_APP_UT_HEX_BACKEND_COUNT; i++)
+    {
+        if (!CAM_APP_UT_HexSelect(i))
+        {
+            continue;
+        }
+
+        memset(Text, '#', sizeof(Text));
+        CAM_APP_HexEncode(Bytes, sizeof(Bytes), Text);
+        UtAssert_MemCmp(Text, Expected, 2 * sizeof(Bytes), "%s encodes every byte value", CAM_APP_UT_HexBackends[i]);
+
+        /* Every length comes out right, with nothing written past 2 * Len characters */
+        Wrong = 0;
+        for (Len = 0; Len <= CAM_APP_UT_HEX_MAX_LEN; Len++)
+        {
+            memset(Text, '#', sizeof(Text));
+            CAM_APP_HexEncode(Bytes, Len, Text);
+            Wrong += memcmp(Text, Expected, 2 * Len) != 0 || Text[2 * Len] != '#';
+        }
+        UtAssert_UINT32_EQ(Wrong, 0);
+    }
+}
+
+void Test_CAM_APP_HexDecode(void)
+{
+    /*
+     * Test Case For:
+     * bool CAM_APP_HexDecode(const char *In, size_t Len, uint8_t *Out)
+     */
+    uint8_t Expected[CAM_APP_UT_HEX_MAX_LEN];
+    uint8_t Bytes[CAM_APP_UT_HEX_MAX_LEN + 1];
+    char    Lower[2 * CAM_APP_UT_HEX_MAX_LEN + 1];
+    char    Upper[2 * CAM_APP_UT_HEX_MAX_LEN + 1];
+    char    Text[2 * CAM_APP_UT_HEX_MAX_LEN];
+    size_t  Wrong;
+    size_t  Len;
+    size_t  i;
+    size_t  j;
+
+    for (j = 0; j < sizeof(Expected); j++)
+    {
+        Expected[j] = (uint8_t)(j * 89 + 200);
+        snprintf(Lower + 2 * j, 3, "%02x", Expected[j]);
+        snprintf(Upper + 2 * j, 3, "%02X", Expected[j]);
+    }
+
+    for (i = 0; i < CAM_APP_UT_HEX_BACKEND_COUNT; i++)
+    {
+        if (!CAM_APP_UT_HexSelect(i))
+        {
+            continue;
+        }
+
+        Wrong = 0;
+        for (Len = 0; Len <= CAM_APP_UT_HEX_MAX_LEN; Len++)
+        {
+            memset(Bytes, 0xee, sizeof(Bytes));
+            Wrong += !CAM_APP_HexDecode(Lower, 2 * Len, Bytes) || memcmp(Bytes, Expected, Len) != 0 ||
+                     Bytes[Len] != 0xee;
+        }
+        UtAssert_UINT32_EQ(Wrong, 0);
+
+        /* Uppercase, decoded in place */
+        memcpy(Text, Upper, sizeof(Text));
+        UtAssert_BOOL_TRUE(CAM_APP_HexDecode(Text, sizeof(Text), (uint8_t *)Text));
+        UtAssert_MemCmp(Text, Expected, sizeof(Expected), "%s decodes uppercase in place", CAM_APP_UT_HexBackends[i]);
+
+        UtAssert_BOOL_FALSE(CAM_APP_HexDecode(Lower, 2 * CAM_APP_UT_HEX_MAX_LEN - 1, Bytes));
+    }
+}
+
+void Test_CAM_APP_HexDecodeInvalid(void)
+{
+    /*
+     * Test Case For:
+     * bool CAM_APP_HexDecode(const char *In, size_t Len, uint8_t *Out)
+     */
+    uint8_t Bytes[CAM_APP_UT_HEX_MAX_LEN];
+    char    Text[2 * CAM_APP_UT_HEX_MAX_LEN];
+    size_t  Rejected;
+    size_t  Position;
+    size_t  i;
+    size_t  j;
+
+    memset(Text, 'a', sizeof(Text));
+
+    for (i = 0; i < CAM_APP_UT_HEX_BACKEND_COUNT; i++)
+    {
+        if (!CAM_APP_UT_HexSelect(i))
+        {
+            continue;
+        }
+
+        /* A bad character anywhere, in a vector block or in the tail, is caught */
+        Rejected = 0;
+        for (Position = 0; Position < sizeof(Text); Position++)
+        {
+            for (j = 0; j < sizeof(CAM_APP_UT_HexInvalid); j++)
+            {
+                Text[Position] = CAM_APP_UT_HexInvalid[j];
+                Rejected += !CAM_APP_HexDecode(Text, sizeof(Text), Bytes);
+            }
+            Text[Position] = 'a';
+        }
+        UtAssert_UINT32_EQ(Rejected, sizeof(Text) * sizeof(CAM_APP_UT_HexInvalid));
+    }
+}
+
+/*
+ * Setup function prior to every test
+ */
+void Cam_UT_Setup(void)
+{
+    UT_ResetState(0);
+}
+
+/*
+ * Teardown function after every test
+ */
+void Cam_UT_TearDown(void) {}
+
+/*
+ * Register the test cases to execute with the unit test tool
+ */
+void UtTest_Setup(void)
+{
+    ADD_TEST(CAM_APP_HexSelectBackend);
+    ADD_TEST(CAM_APP_HexEncode);
+    ADD_TEST(CAM_APP_HexDecode);
+    ADD_TEST(CAM_APP_HexDecodeInvalid);
+}
@@ -0,0 +1,254 @@
+/************************************************************************
+ * NASA Docket No. GSC-18,719-1, and identified as “core Flight System: Bootes”
+ *
+ * Copyright (c) 2020 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License. You may obtain
+ * a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ************************************************************************/
+
+/*
+** File: coveragetest_cam_app_histogram.c
+**
+** Purpose:
+** Coverage Unit Test cases for the Cam App latency histograms
+**
+** Reported percentiles are checked against the bound the telemetry
+** promises: exact below 16 us, otherwise at most 12.5% above the true
+** value, and never above the maximum recorded.
+*/
+
+/*
+ * Includes
+ */
+
+#include "cam_app_coveragetest_common.h"
+#include "cam_app_histogram.h"
+
+#include <pthread.h>
+
+/* Latencies each recording thread adds */
+#define CAM_APP_UT_THREADS        4
+#define CAM_APP_UT_THREAD_SAMPLES 100000
+
+/*
+ * Median reported when Us is recorded alongside a larger latency, so the
+ * median is Us's bucket and not clipped to the maximum
+ */
+static uint32 CAM_APP_UT_Reported(uint32 Us)
+{
+    CAM_APP_LatencyStats_t Stats;
+
+    CAM_APP_HistogramReset();
+    CAM_APP_HistogramRecord(CAM_APP_LATENCY_CAPTURE, Us);
+    CAM_APP_HistogramRecord(CAM_APP_LATENCY_CAPTURE, UINT32_MAX);
+    CAM_APP_HistogramSummary(CAM_APP_LATENCY_CAPTURE, &Stats);
+
+    return Stats.P50Us;
+}
+
+/*
+ * Record latencies 1 to CAM_APP_UT_THREAD_SAMPLES into the write stage,
+ * offset by the thread's number so each has a different maximum
+ */
+static void *CAM_APP_UT_RecordThread(void *Arg)
+{
+    uint32 Offset = *(const uint32 *)Arg;
+    uint32 i;
+
+    for (i = 1; i <= CAM_APP_UT_THREAD_SAMPLES; i++)
+    {
+        CAM_APP_HistogramRecord(CAM_APP_LATENCY_WRITE, i + Offset);
+    }
+
+    return NULL;
+}
+
+/*
+**********************************************************************************
+**          TEST CASE FUNCTIONS
+**********************************************************************************
+*/
+
+void Test_CAM_APP_HistogramExact(void)
+{
+    /*
+     * Test Case For:
+     * void CAM_APP_HistogramRecord(uint32 Stage, uint64 LatencyUs)
+     * void CAM_APP_HistogramSummary(uint32 Stage, CAM_APP_LatencyStats_t *Stats)
+     */
+    CAM_APP_LatencyStats_t Stats;
+    uint32                 Us;
+
+    for (Us = 0; Us < 16; Us++)
+    {
+        CAM_APP_HistogramRecord(CAM_APP_LATENCY_FRAME, Us);
+    }
+    CAM_APP_HistogramSummary(CAM_APP_LATENCY_FRAME, &Stats);
+
+    /* The 8th, 15th and 16th smallest */
+    UtAssert_UINT32_EQ(Stats.Count, 16);
+    UtAssert_UINT32_EQ(Stats.P50Us, 7);
+    UtAssert_UINT32_EQ(Stats.P90Us, 14);
+    UtAssert_UINT32_EQ(Stats.P99Us, 15);
+    UtAssert_UINT32_EQ(Stats.MaxUs, 15);
+}
+
+void Test_CAM_APP_HistogramBound(void)
+{
+    /*
+     * Test Case For:
+     * void CAM_APP_HistogramRecord(uint32 Stage, uint64 LatencyUs)
+     * void CAM_APP_HistogramSummary(uint32 Stage, CAM_APP_LatencyStats_t *Stats)
+     */
+    uint64 Us;
+    uint32 Reported;
+    uint32 Previous = 0;
+    uint32 Wrong    = 0;
+    uint32 Ragged   = 0;
+
+    /*
+     * Every value up to 2^16, then a sparse sweep to the top of the range.
+     * Where the reported value changes, the one before must have been a
+     * bucket's upper edge, i.e. exact.
+     */
+    for (Us = 0; Us <= UINT32_MAX; Us += Us < 65536 ? 1 : Us / 997)
+    {
+        Reported = CAM_APP_UT_Reported((uint32)Us);
+
+        if (Reported < Us || (Us < 16 && Reported != Us) || Reported - Us > Us / 8)
+        {
+            Wrong++;
+        }
+        if (Us > 0 && Us < 65536 && Reported != Previous && Previous != Us - 1)
+        {
+            Ragged++;
+        }
+        Previous = Reported;
+    }
+
+    UtAssert_UINT32_EQ(Wrong, 0);
+    UtAssert_UINT32_EQ(Ragged, 0);
+    UtAssert_UINT32_EQ(CAM_APP_UT_Reported(UINT32_MAX), UINT32_MAX);
+}
+
+void Test_CAM_APP_HistogramPercentiles(void)
+{
+    /*
+     * Test Case For:
+     * void CAM_APP_HistogramSummary(uint32 Stage, CAM_APP_LatencyStats_t *Stats)
+     */
+    CAM_APP_LatencyStats_t Stats;
+    uint32                 Us;
+
+    for (Us = 100; Us >= 1; Us--)
+    {
+        CAM_APP_HistogramRecord(CAM_APP_LATENCY_ENCRYPT, Us);
+    }
+    CAM_APP_HistogramSummary(CAM_APP_LATENCY_ENCRYPT, &Stats);
+
+    /* Upper edges of the buckets 48-51 and 88-95; 96-103 is clipped to the maximum */
+    UtAssert_UINT32_EQ(Stats.Count, 100);
+    UtAssert_UINT32_EQ(Stats.P50Us, 51);
+    UtAssert_UINT32_EQ(Stats.P90Us, 95);
+    UtAssert_UINT32_EQ(Stats.P99Us, 100);
+    UtAssert_UINT32_EQ(Stats.MaxUs, 100);
+
+    /* Latencies past the uint32 range count as the largest there is */
+    CAM_APP_HistogramRecord(CAM_APP_LATENCY_COMMIT, (uint64)1 << 40);
+    CAM_APP_HistogramSummary(CAM_APP_LATENCY_COMMIT, &Stats);
+    UtAssert_UINT32_EQ(Stats.Count, 1);
+    UtAssert_UINT32_EQ(Stats.P50Us, UINT32_MAX);
+    UtAssert_UINT32_EQ(Stats.P99Us, UINT32_MAX);
+    UtAssert_UINT32_EQ(Stats.MaxUs, UINT32_MAX);
+}
+
+void Test_CAM_APP_HistogramReset(void)
+{
+    /*
+     * Test Case For:
+     * void CAM_APP_HistogramReset(void)
+     * void CAM_APP_HistogramSummary(uint32 Stage, CAM_APP_LatencyStats_t *Stats)
+     */
+    CAM_APP_LatencyStats_t Stats;
+
+    /* Stages are kept apart; an empty one reports all zeros */
+    CAM_APP_HistogramRecord(CAM_APP_LATENCY_WRITE, 1234);
+    CAM_APP_HistogramSummary(CAM_APP_LATENCY_COMMIT, &Stats);
+    UtAssert_UINT32_EQ(Stats.Count, 0);
+    UtAssert_UINT32_EQ(Stats.P50Us, 0);
+    UtAssert_UINT32_EQ(Stats.P99Us, 0);
+    UtAssert_UINT32_EQ(Stats.MaxUs, 0);
+
+    CAM_APP_HistogramSummary(CAM_APP_LATENCY_WRITE, &Stats);
+    UtAssert_UINT32_EQ(Stats.Count, 1);
+    UtAssert_UINT32_EQ(Stats.MaxUs, 1234);
+
+    CAM_APP_HistogramReset();
+    CAM_APP_HistogramSummary(CAM_APP_LATENCY_WRITE, &Stats);
+    UtAssert_UINT32_EQ(Stats.Count, 0);
+    UtAssert_UINT32_EQ(Stats.P50Us, 0);
+    UtAssert_UINT32_EQ(Stats.MaxUs, 0);
+}
+
+void Test_CAM_APP_HistogramThreads(void)
+{
+    /*
+     * Test Case For:
+     * void CAM_APP_HistogramRecord(uint32 Stage, uint64 LatencyUs)
+     */
+    CAM_APP_LatencyStats_t Stats;
+    pthread_t              Threads[CAM_APP_UT_THREADS];
+    uint32                 Offsets[CAM_APP_UT_THREADS];
+    uint32                 i;
+
+    /* Recording takes no lock; no sample or maximum may be lost to a race */
+    for (i = 0; i < CAM_APP_UT_THREADS; i++)
+    {
+        Offsets[i] = i;
+        UtAssert_INT32_EQ(pthread_create(&Threads[i], NULL, CAM_APP_UT_RecordThread, &Offsets[i]), 0);
+    }
+    for (i = 0; i < CAM_APP_UT_THREADS; i++)
+    {
+        pthread_join(Threads[i], NULL);
+    }
+
+    CAM_APP_HistogramSummary(CAM_APP_LATENCY_WRITE, &Stats);
+    UtAssert_UINT32_EQ(Stats.Count, CAM_APP_UT_THREADS * CAM_APP_UT_THREAD_SAMPLES);
+    UtAssert_UINT32_EQ(Stats.MaxUs, CAM_APP_UT_THREAD_SAMPLES + CAM_APP_UT_THREADS - 1);
+}
+
+/*
+ * Setup function prior to every test
+ */
+void Cam_UT_Setup(void)
+{
+    UT_ResetState(0);
+    CAM_APP_HistogramReset();
+}
+
+/*
+ * Teardown function after every test
+ */
+void Cam_UT_TearDown(void) {}
+
+/*
+ * Register the test cases to execute with the unit test tool
+ */
+void UtTest_Setup(void)
+{
+    ADD_TEST(CAM_APP_HistogramExact);
+    ADD_TEST(CAM_APP_HistogramBound);
+    ADD_TEST(CAM_APP_HistogramPercentiles);
+    ADD_TEST(CAM_APP_HistogramReset);
+    ADD_TEST(CAM_APP_HistogramThreads);
+}
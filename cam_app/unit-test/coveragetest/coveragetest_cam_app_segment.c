@@ -0,0 +1,377 @@
+/************************************************************************
+ * NASA Docket No. GSC-18,719-1, and identified as “core Flight System: Bootes”
+ *
+ * Copyright (c) 2020 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License. You may obtain
+ * a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ************************************************************************/
+
+/*
+** File: coveragetest_cam_app_segment.c
+**
+** Purpose:
+** Coverage Unit Test cases for the Cam App segment log
+**
+** Records are appended through the same reserve/release calls the
+** storage stage uses, some deliberately left unwritten or damaged, and
+** then extracted again.  The tests run in a scratch photo directory
+** under /tmp.
+*/
+
+/*
+ * Includes
+ */
+
+#include "cam_app_coveragetest_common.h"
+#include "cam_app_segment.h"
+#include "cam_app_container.h"
+#include "cam_app_crc.h"
+#include "common_fnc.h"
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/*
+ * The segment log reads the durability policy from the app data
+ */
+CAM_APP_Data_t CAM_APP_Data;
+
+/*
+ * Scratch photo directory, made fresh for every test
+ */
+static char CAM_APP_UT_PhotoDir[CAM_APP_PHOTO_DIR_LEN];
+
+/*
+ * Capture time of the first record appended; each one after it is a
+ * second later so extracted files never share a name
+ */
+#define CAM_APP_UT_SEGMENT_EPOCH_US 1700000000000000u
+
+static uint64 CAM_APP_UT_CaptureTimeUs;
+
+/*
+ * Append a record of Len payload bytes, as the storage stage would
+ *
+ * With Write false the record's room is reserved but nothing is written,
+ * leaving the hole a failed write leaves.  Crc is the payload CRC put in
+ * the header, or 0 to use the right one.  Returns the record's offset.
+ */
+static uint64 CAM_APP_UT_Append(uint8 Kind, uint32 Sequence, const uint8 *Payload, uint32 Len, bool Write,
+                                uint32 Crc)
+{
+    CAM_APP_SegmentRecord_t Record;
+    CAM_APP_Segment_t      *Segment;
+    uint8                   Image[CAM_APP_SEGMENT_RECORD_SIZE];
+    uint64                  Offset = 0;
+
+    Segment = CAM_APP_SegmentReserve(CAM_APP_UT_PhotoDir, CAM_APP_SEGMENT_RECORD_SIZE + Len, &Offset);
+    UtAssert_NOT_NULL(Segment);
+    if (Segment == NULL)
+    {
+        return 0;
+    }
+
+    Record.Kind          = Kind;
+    Record.Sequence      = Sequence;
+    Record.Length        = Len;
+    Record.CaptureTimeUs = CAM_APP_UT_CaptureTimeUs;
+    Record.Crc           = Crc != 0 ? Crc : CAM_APP_Crc32(0, Payload, Len);
+    CAM_APP_UT_CaptureTimeUs += 1000000u;
+
+    if (Write)
+    {
+        CAM_APP_SegmentEncodeRecord(&Record, Image);
+        UtAssert_True(pwrite(Segment->Fd, Image, sizeof(Image), (off_t)Offset) == (ssize_t)sizeof(Image) &&
+                          pwrite(Segment->Fd, Payload, Len, (off_t)(Offset + sizeof(Image))) == (ssize_t)Len,
+                      "Record %lu written", (unsigned long)Sequence);
+    }
+
+    CAM_APP_SegmentRelease(Segment);
+
+    return Offset;
+}
+
+/*
+ * Write Len bytes at Offset in segment Number, over what is there
+ */
+static void CAM_APP_UT_Overwrite(uint32 Number, uint64 Offset, const void *Data, size_t Len)
+{
+    char Name[CAM_APP_SEGMENT_NAME_LEN];
+    int  Fd;
+
+    snprintf(Name, sizeof(Name), "%s/Segments/segment_%06lu.log", CAM_APP_UT_PhotoDir, (unsigned long)Number);
+
+    Fd = open(Name, O_WRONLY);
+    UtAssert_True(Fd >= 0 && pwrite(Fd, Data, Len, (off_t)Offset) == (ssize_t)Len, "Overwrote %s", Name);
+    if (Fd >= 0)
+    {
+        close(Fd);
+    }
+}
+
+/*
+ * Extract frame Sequence and check it comes back as Payload
+ */
+static void CAM_APP_UT_CheckExtract(uint32 SegmentNumber, uint32 Sequence, const uint8 *Payload, size_t Len)
+{
+    CFE_Status_t  Status;
+    mapped_file_t File;
+    char          Name[CAM_APP_SEGMENT_NAME_LEN + 64];
+    bool          Read;
+
+    Status = CAM_APP_SegmentExtract(CAM_APP_UT_PhotoDir, SegmentNumber, Sequence, Name, sizeof(Name));
+    UtAssert_INT32_EQ(Status, CFE_SUCCESS);
+    if (Status != CFE_SUCCESS)
+    {
+        return;
+    }
+
+    if (strstr(Name, "/Encrypt_Photo/") != NULL)
+    {
+#if CAM_APP_ENCRYPTED_FORMAT == CAM_APP_ENCRYPTED_FORMAT_HEX
+        Read = read_encrypted_hex(&File, Name);
+#else
+        Read = read_encrypted_data(&File, Name);
+#endif
+    }
+    else
+    {
+        UtAssert_NOT_NULL(strstr(Name, "/Original_Photo/"));
+        Read = map_file(&File, Name);
+    }
+
+    UtAssert_True(Read, "Read back %s", Name);
+    if (Read)
+    {
+        UtAssert_True(File.size == Len && memcmp(File.data, Payload, Len) == 0, "Frame %lu extracted intact",
+                      (unsigned long)Sequence);
+        unmap_file(&File);
+    }
+}
+
+/*
+ * Remove every file in Dir, then Dir itself
+ */
+static void CAM_APP_UT_RemoveDir(const char *Dir)
+{
+    struct dirent *Entry;
+    DIR           *Handle;
+    char           Name[CAM_APP_SEGMENT_NAME_LEN + 256];
+
+    Handle = opendir(Dir);
+    if (Handle != NULL)
+    {
+        while ((Entry = readdir(Handle)) != NULL)
+        {
+            if (strcmp(Entry->d_name, ".") != 0 && strcmp(Entry->d_name, "..") != 0)
+            {
+                snprintf(Name, sizeof(Name), "%s/%s", Dir, Entry->d_name);
+                unlink(Name);
+            }
+        }
+        closedir(Handle);
+    }
+
+    rmdir(Dir);
+}
+
+/*
+**********************************************************************************
+**          TEST CASE FUNCTIONS
+**********************************************************************************
+*/
+
+void Test_CAM_APP_SegmentExtract(void)
+{
+    /*
+     * Test Case For:
+     * CFE_Status_t CAM_APP_SegmentExtract(const char *PhotoDir, uint32 SegmentNumber, uint32 Sequence, char *Name,
+     *                                     size_t NameSize)
+     * void CAM_APP_SegmentEncodeRecord(const CAM_APP_SegmentRecord_t *Record, uint8 *Image)
+     */
+    static const uint8 First[]  = "first frame";
+    static const uint8 Second[] = "second frame, a little longer";
+    uint8              Container[CAM_APP_CONTAINER_HEADER_SIZE + 40];
+    char               Name[CAM_APP_SEGMENT_NAME_LEN + 64];
+    size_t             i;
+
+    for (i = 0; i < sizeof(Container); i++)
+    {
+        Container[i] = (uint8)(i * 7);
+    }
+
+    CAM_APP_UT_Append(CAM_APP_SEGMENT_KIND_PLAIN, 1, First, sizeof(First), true, 0);
+    CAM_APP_UT_Append(CAM_APP_SEGMENT_KIND_PLAIN, 2, Second, sizeof(Second), true, 0);
+    CAM_APP_UT_Append(CAM_APP_SEGMENT_KIND_CONTAINER, 3, Container, sizeof(Container), true, 0);
+    CAM_APP_SegmentClose();
+
+    CAM_APP_UT_CheckExtract(0, 2, Second, sizeof(Second));
+    CAM_APP_UT_CheckExtract(0, 1, First, sizeof(First));
+    CAM_APP_UT_CheckExtract(1, 3, Container, sizeof(Container));
+
+    /* Not in the log, or not in the segment asked for */
+    UtAssert_INT32_EQ(CAM_APP_SegmentExtract(CAM_APP_UT_PhotoDir, 0, 4, Name, sizeof(Name)), CFE_STATUS_RANGE_ERROR);
+    UtAssert_INT32_EQ(CAM_APP_SegmentExtract(CAM_APP_UT_PhotoDir, 2, 1, Name, sizeof(Name)), CFE_STATUS_RANGE_ERROR);
+}
+
+void Test_CAM_APP_SegmentNewest(void)
+{
+    /*
+     * Test Case For:
+     * CFE_Status_t CAM_APP_SegmentExtract(const char *PhotoDir, uint32 SegmentNumber, uint32 Sequence, char *Name,
+     *                                     size_t NameSize)
+     * void CAM_APP_SegmentClose(void)
+     */
+    static const uint8 Old[] = "from the first shoot";
+    static const uint8 New[] = "from the second shoot";
+
+    /* Sequence numbers restart with each shoot, which starts a new segment */
+    CAM_APP_UT_Append(CAM_APP_SEGMENT_KIND_PLAIN, 1, Old, sizeof(Old), true, 0);
+    CAM_APP_SegmentClose();
+    CAM_APP_UT_Append(CAM_APP_SEGMENT_KIND_PLAIN, 1, New, sizeof(New), true, 0);
+    CAM_APP_SegmentClose();
+
+    CAM_APP_UT_CheckExtract(0, 1, New, sizeof(New));
+    CAM_APP_UT_CheckExtract(1, 1, Old, sizeof(Old));
+    CAM_APP_UT_CheckExtract(2, 1, New, sizeof(New));
+}
+
+void Test_CAM_APP_SegmentResync(void)
+{
+    /*
+     * Test Case For:
+     * CFE_Status_t CAM_APP_SegmentExtract(const char *PhotoDir, uint32 SegmentNumber, uint32 Sequence, char *Name,
+     *                                     size_t NameSize)
+     */
+    static uint8            Payload[9000];
+    static const uint32     HoleSizes[] = {1, 4080 - CAM_APP_SEGMENT_RECORD_SIZE, 9000};
+    CAM_APP_SegmentRecord_t Decoy;
+    uint8                   Image[CAM_APP_SEGMENT_RECORD_SIZE];
+    char                    Name[CAM_APP_SEGMENT_NAME_LEN + 64];
+    uint64                  Hole;
+    uint32                  Sequence = 1;
+    size_t                  i;
+
+    for (i = 0; i < sizeof(Payload); i++)
+    {
+        Payload[i] = (uint8)(i ^ (i >> 8));
+    }
+
+    /*
+     * Holes a short one, one that puts the next header across the end of
+     * the first block read while scanning, and one longer than a block
+     */
+    CAM_APP_UT_Append(CAM_APP_SEGMENT_KIND_PLAIN, Sequence++, Payload, 100, true, 0);
+    for (i = 0; i < sizeof(HoleSizes) / sizeof(HoleSizes[0]); i++)
+    {
+        Hole = CAM_APP_UT_Append(CAM_APP_SEGMENT_KIND_PLAIN, Sequence++, Payload, HoleSizes[i], false, 0);
+        CAM_APP_UT_Append(CAM_APP_SEGMENT_KIND_PLAIN, Sequence++, Payload + i, 200 + i, true, 0);
+    }
+    CAM_APP_SegmentClose();
+
+    /* Garbage in the last hole that starts like a header: a bad header CRC, and a record running off the end */
+    memset(&Decoy, 0, sizeof(Decoy));
+    Decoy.Kind     = CAM_APP_SEGMENT_KIND_PLAIN;
+    Decoy.Sequence = 1000;
+    Decoy.Length   = 0x7fffffff;
+    CAM_APP_SegmentEncodeRecord(&Decoy, Image);
+    CAM_APP_UT_Overwrite(1, Hole + 100, Image, sizeof(Image));
+    Image[10] ^= 0x01;
+    CAM_APP_UT_Overwrite(1, Hole + 3000, Image, sizeof(Image));
+
+    CAM_APP_UT_CheckExtract(0, 1, Payload, 100);
+    for (i = 0; i < sizeof(HoleSizes) / sizeof(HoleSizes[0]); i++)
+    {
+        CAM_APP_UT_CheckExtract(0, 3 + 2 * (uint32)i, Payload + i, 200 + i);
+        UtAssert_INT32_EQ(CAM_APP_SegmentExtract(CAM_APP_UT_PhotoDir, 0, 2 + 2 * (uint32)i, Name, sizeof(Name)),
+                          CFE_STATUS_RANGE_ERROR);
+    }
+    UtAssert_INT32_EQ(CAM_APP_SegmentExtract(CAM_APP_UT_PhotoDir, 0, 1000, Name, sizeof(Name)), CFE_STATUS_RANGE_ERROR);
+}
+
+void Test_CAM_APP_SegmentDamaged(void)
+{
+    /*
+     * Test Case For:
+     * CFE_Status_t CAM_APP_SegmentExtract(const char *PhotoDir, uint32 SegmentNumber, uint32 Sequence, char *Name,
+     *                                     size_t NameSize)
+     */
+    static const uint8 Payload[CAM_APP_CONTAINER_HEADER_SIZE] = "a frame whose payload does not match its CRC";
+    char               Name[CAM_APP_SEGMENT_NAME_LEN + 64];
+
+    CAM_APP_UT_Append(CAM_APP_SEGMENT_KIND_PLAIN, 1, Payload, sizeof(Payload), true, 0x12345678);
+    CAM_APP_UT_Append(7, 2, Payload, sizeof(Payload), true, 0);
+    CAM_APP_UT_Append(CAM_APP_SEGMENT_KIND_CONTAINER, 3, Payload, CAM_APP_CONTAINER_HEADER_SIZE - 1, true, 0);
+    CAM_APP_SegmentClose();
+
+    UtAssert_INT32_EQ(CAM_APP_SegmentExtract(CAM_APP_UT_PhotoDir, 0, 1, Name, sizeof(Name)),
+                      CFE_STATUS_EXTERNAL_RESOURCE_FAIL);
+    UtAssert_INT32_EQ(CAM_APP_SegmentExtract(CAM_APP_UT_PhotoDir, 0, 2, Name, sizeof(Name)),
+                      CFE_STATUS_EXTERNAL_RESOURCE_FAIL);
+    UtAssert_INT32_EQ(CAM_APP_SegmentExtract(CAM_APP_UT_PhotoDir, 0, 3, Name, sizeof(Name)),
+                      CFE_STATUS_EXTERNAL_RESOURCE_FAIL);
+}
+
+/*
+ * Setup function prior to every test
+ */
+void Cam_UT_Setup(void)
+{
+    char Dir[CAM_APP_SEGMENT_NAME_LEN];
+
+    UT_ResetState(0);
+
+    memset(&CAM_APP_Data, 0, sizeof(CAM_APP_Data));
+    CAM_APP_UT_CaptureTimeUs = CAM_APP_UT_SEGMENT_EPOCH_US;
+
+    snprintf(CAM_APP_UT_PhotoDir, sizeof(CAM_APP_UT_PhotoDir), "/tmp/cam_app_ut_XXXXXX");
+    UtAssert_NOT_NULL(mkdtemp(CAM_APP_UT_PhotoDir));
+
+    snprintf(Dir, sizeof(Dir), "%s/Original_Photo", CAM_APP_UT_PhotoDir);
+    mkdir(Dir, 0755);
+    snprintf(Dir, sizeof(Dir), "%s/Encrypt_Photo", CAM_APP_UT_PhotoDir);
+    mkdir(Dir, 0755);
+}
+
+/*
+ * Teardown function after every test
+ */
+void Cam_UT_TearDown(void)
+{
+    char Dir[CAM_APP_SEGMENT_NAME_LEN];
+
+    CAM_APP_SegmentClose();
+
+    snprintf(Dir, sizeof(Dir), "%s/Segments", CAM_APP_UT_PhotoDir);
+    CAM_APP_UT_RemoveDir(Dir);
+    snprintf(Dir, sizeof(Dir), "%s/Original_Photo", CAM_APP_UT_PhotoDir);
+    CAM_APP_UT_RemoveDir(Dir);
+    snprintf(Dir, sizeof(Dir), "%s/Encrypt_Photo", CAM_APP_UT_PhotoDir);
+    CAM_APP_UT_RemoveDir(Dir);
+    CAM_APP_UT_RemoveDir(CAM_APP_UT_PhotoDir);
+}
+
+/*
+ * Register the test cases to execute with the unit test tool
+ */
+void UtTest_Setup(void)
+{
+    ADD_TEST(CAM_APP_SegmentExtract);
+    ADD_TEST(CAM_APP_SegmentNewest);
+    ADD_TEST(CAM_APP_SegmentResync);
+    ADD_TEST(CAM_APP_SegmentDamaged);
+}